@@ -0,0 +1,39 @@
+-- This file is hand generated.
+
+-- Spatial index of the bounding boxes of the areas of use, so that the
+-- areas that intersect an area of interest can be found without testing
+-- each of them.
+--
+-- area has no INTEGER PRIMARY KEY, and its rowid may change with VACUUM,
+-- so the R*Tree entries refer to area_index.id. Areas crossing the
+-- antimeridian are split into two boxes, whose R*Tree ids are 2 * id and
+-- 2 * id + 1. Areas without a bounding box are not indexed.
+
+CREATE TABLE area_index(
+    id INTEGER NOT NULL PRIMARY KEY,
+    auth_name TEXT NOT NULL,
+    code TEXT NOT NULL,
+    CONSTRAINT unique_area_index UNIQUE (auth_name, code)
+);
+
+INSERT INTO area_index(auth_name, code)
+    SELECT auth_name, code FROM area
+        WHERE south_lat IS NOT NULL AND north_lat IS NOT NULL AND
+              west_lon IS NOT NULL AND east_lon IS NOT NULL
+        ORDER BY auth_name, code;
+
+CREATE VIRTUAL TABLE area_rtree USING rtree(
+    id, min_lon, max_lon, min_lat, max_lat);
+
+INSERT INTO area_rtree(id, min_lon, max_lon, min_lat, max_lat)
+    SELECT 2 * i.id, a.west_lon,
+           CASE WHEN a.east_lon < a.west_lon THEN 180 ELSE a.east_lon END,
+           a.south_lat, a.north_lat
+        FROM area_index i JOIN area a
+            ON a.auth_name = i.auth_name AND a.code = i.code;
+
+INSERT INTO area_rtree(id, min_lon, max_lon, min_lat, max_lat)
+    SELECT 2 * i.id + 1, -180, a.east_lon, a.south_lat, a.north_lat
+        FROM area_index i JOIN area a
+            ON a.auth_name = i.auth_name AND a.code = i.code
+        WHERE a.east_lon < a.west_lon;
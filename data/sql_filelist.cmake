@@ -29,4 +29,5 @@ set(SQL_FILES     "${SQL_DIR}/begin.sql"
                   "${SQL_DIR}/grid_alternatives.sql"
                   "${SQL_DIR}/grid_alternatives_generated.sql"
                   "${SQL_DIR}/customizations.sql"
+                  "${SQL_DIR}/area_index.sql"
                   "${SQL_DIR}/commit.sql")
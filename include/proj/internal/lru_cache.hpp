@@ -68,6 +68,17 @@ class KeyNotFound : public std::invalid_argument {
 KeyNotFound::~KeyNotFound() = default;
 #endif
 
+/**
+ * counters of a Cache, as returned by Cache::getStats()
+ */
+struct Stats {
+  size_t maxSize = 0;
+  size_t size = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+};
+
 template <typename K, typename V>
 struct KeyValuePair {
  public:
@@ -141,8 +152,10 @@ class Cache {
     Guard g(lock_);
     const auto iter = cache_.find(kIn);
     if (iter == cache_.end()) {
+      ++misses_;
       return false;
     }
+    ++hits_;
     keys_.splice(keys_.begin(), keys_, iter->second);
     vOut = iter->second->value;
     return true;
@@ -155,8 +168,10 @@ class Cache {
     Guard g(lock_);
     const auto iter = cache_.find(k);
     if (iter == cache_.end()) {
+      ++misses_;
       throw KeyNotFound();
     }
+    ++hits_;
     keys_.splice(keys_.begin(), keys_, iter->second);
     return iter->second->value;
   }
@@ -181,9 +196,39 @@ class Cache {
     return cache_.find(k) != cache_.end();
   }
 
-  size_t getMaxSize() const { return maxSize_; }
+  size_t getMaxSize() const {
+    Guard g(lock_);
+    return maxSize_;
+  }
   size_t getElasticity() const { return elasticity_; }
-  size_t getMaxAllowedSize() const { return maxSize_ + elasticity_; }
+  size_t getMaxAllowedSize() const {
+    Guard g(lock_);
+    return maxSize_ + elasticity_;
+  }
+  /**
+   * changes the max size, evicting the least recently used keys beyond it
+   * (ERO: added)
+   */
+  void setMaxSize(size_t maxSize) {
+    Guard g(lock_);
+    maxSize_ = maxSize;
+    if (maxSize_ != 0) {
+      evict();
+    }
+  }
+  /**
+   * returns the hit / miss / eviction counters (ERO: added)
+   */
+  Stats getStats() const {
+    Guard g(lock_);
+    Stats stats;
+    stats.maxSize = maxSize_;
+    stats.size = cache_.size();
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    return stats;
+  }
   template <typename F>
   void cwalk(F& f) const {
     Guard g(lock_);
@@ -196,12 +241,17 @@ class Cache {
     if (maxSize_ == 0 || cache_.size() <= maxAllowed) { /* ERO: changed < to <= */
       return 0;
     }
+    return evict();
+  }
+
+  size_t evict() {
     size_t count = 0;
     while (cache_.size() > maxSize_) {
       cache_.erase(keys_.back().key);
       keys_.pop_back();
       ++count;
     }
+    evictions_ += count;
     return count;
   }
 
@@ -215,6 +265,9 @@ class Cache {
   list_type keys_{};
   size_t maxSize_;
   size_t elasticity_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
 };
 
 } // namespace LRUCache11
@@ -237,6 +237,8 @@ class PROJ_GCC_DLL WKTFormatter {
         PROJ_DLL WKTFormatter &
         setOutputId(bool outputIdIn);
 
+    PROJ_INTERNAL WKTFormatter &setOutputIdOnAllNodes(bool outputIdOnAllNodes);
+
     PROJ_INTERNAL void enter();
     PROJ_INTERNAL void leave();
 
@@ -740,6 +742,31 @@ class PROJ_GCC_DLL DatabaseContext {
     getNonDeprecated(const std::string &tableName, const std::string &authName,
                      const std::string &code) const;
 
+    /** Cache of objects built from the database. */
+    enum class CacheType {
+        UNIT_OF_MEASURE,
+        CRS,
+        GEODETIC_DATUM,
+        PRIME_MERIDIAN,
+        COORDINATE_SYSTEM,
+        EXTENT,
+        GRID_INFO,
+        CRS_TO_CRS_OPERATIONS,
+    };
+
+    /** Counters of a cache. */
+    struct CacheStats {
+        size_t maxSize = 0;
+        size_t size = 0;
+        unsigned long long hits = 0;
+        unsigned long long misses = 0;
+        unsigned long long evictions = 0;
+    };
+
+    PROJ_INTERNAL void setCacheSize(CacheType type, size_t maxSize);
+
+    PROJ_INTERNAL CacheStats getCacheStats(CacheType type) const;
+
     //! @endcond
 
   protected:
@@ -823,6 +850,10 @@ class PROJ_GCC_DLL AuthorityFactory {
     PROJ_DLL crs::CRSNNPtr
     createCoordinateReferenceSystem(const std::string &code) const;
 
+    PROJ_DLL std::vector<crs::CRSNNPtr>
+    createCoordinateReferenceSystems(
+        const std::vector<std::string> &codes) const;
+
     PROJ_DLL operation::CoordinateOperationNNPtr
     createCoordinateOperation(const std::string &code,
                               bool usePROJAlternativeGridNames) const;
@@ -944,8 +975,24 @@ class PROJ_GCC_DLL AuthorityFactory {
     PROJ_INTERNAL std::list<crs::ProjectedCRSNNPtr>
     createProjectedCRSFromExisting(const crs::ProjectedCRSNNPtr &crs) const;
 
+    PROJ_INTERNAL std::list<crs::ProjectedCRSNNPtr>
+    createProjectedCRSFromFingerprint(
+        const crs::ProjectedCRSNNPtr &crs,
+        const std::list<std::pair<crs::GeodeticCRSNNPtr, int>>
+            &candidatesBaseCRS) const;
+
     PROJ_INTERNAL std::list<crs::CompoundCRSNNPtr>
     createCompoundCRSFromExisting(const crs::CompoundCRSNNPtr &crs) const;
+
+    PROJ_DLL std::vector<operation::CoordinateOperationNNPtr>
+    createFromCRSCodesWithIntermediates(
+        const std::string &sourceCRSAuthName, const std::string &sourceCRSCode,
+        const std::string &targetCRSAuthName, const std::string &targetCRSCode,
+        bool usePROJAlternativeGridNames, bool discardIfMissingGrid,
+        bool discardSuperseded,
+        const std::vector<std::pair<std::string, std::string>>
+            &intermediateCRSAuthCodes,
+        const metadata::ExtentPtr &areaOfInterest) const;
     //! @endcond
 
   protected:
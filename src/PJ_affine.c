@@ -170,11 +170,17 @@ static void computeReverseParameters(PJ* P)
     }
 }
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque_affine));
+}
+
+
 PJ *TRANSFORMATION(affine,0 /* no need for ellipsoid */) {
     struct pj_opaque_affine *Q = initQ();
     if (0==Q)
         return pj_default_destructor(P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
     P->fwd4d = forward_4d;
     P->inv4d = reverse_4d;
@@ -226,6 +232,7 @@ PJ *TRANSFORMATION(geogoffset,0 /* no need for ellipsoid */) {
     if (0==Q)
         return pj_default_destructor(P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
     P->fwd4d = forward_4d;
     P->inv4d = reverse_4d;
@@ -158,6 +158,69 @@ static PJ_COORD reverse_4d(PJ_COORD coo, PJ *P) {
 }
 
 
+/* Batch versions: Swap the first n axes of each coordinate in the block */
+static void forward_array(PJ_COORD *coo, size_t n, unsigned int naxes, PJ *P) {
+    struct pj_opaque *Q = (struct pj_opaque *) P->opaque;
+    size_t i;
+    unsigned int j;
+    PJ_COORD in;
+
+    for (i=0; i<n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        in = coo[i];
+        for (j=0; j<naxes; j++)
+            coo[i].v[j] = in.v[Q->axis[j]] * Q->sign[j];
+    }
+}
+
+
+static void reverse_array(PJ_COORD *coo, size_t n, unsigned int naxes, PJ *P) {
+    struct pj_opaque *Q = (struct pj_opaque *) P->opaque;
+    size_t i;
+    unsigned int j;
+    PJ_COORD in;
+
+    for (i=0; i<n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        in = coo[i];
+        for (j=0; j<naxes; j++)
+            coo[i].v[Q->axis[j]] = in.v[j] * Q->sign[j];
+    }
+}
+
+
+static void forward_2d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    forward_array(coo, n, 2, P);
+}
+
+static void reverse_2d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    reverse_array(coo, n, 2, P);
+}
+
+static void forward_3d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    forward_array(coo, n, 3, P);
+}
+
+static void reverse_3d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    reverse_array(coo, n, 3, P);
+}
+
+static void forward_4d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    forward_array(coo, n, 4, P);
+}
+
+static void reverse_4d_array(PJ_COORD *coo, size_t n, PJ *P) {
+    reverse_array(coo, n, 4, P);
+}
+
+
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque));
+}
+
+
 /***********************************************************************/
 PJ *CONVERSION(axisswap,0) {
 /***********************************************************************/
@@ -168,6 +231,7 @@ PJ *CONVERSION(axisswap,0) {
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
 
     /* +order and +axis are mutually exclusive */
@@ -262,14 +326,20 @@ PJ *CONVERSION(axisswap,0) {
     if (n == 4) {
         P->fwd4d = forward_4d;
         P->inv4d = reverse_4d;
+        P->fwd4d_array = forward_4d_array;
+        P->inv4d_array = reverse_4d_array;
     }
     if (n == 3 && Q->axis[0] < 3 && Q->axis[1] < 3 && Q->axis[2] < 3) {
         P->fwd3d  = forward_3d;
         P->inv3d  = reverse_3d;
+        P->fwd4d_array = forward_3d_array;
+        P->inv4d_array = reverse_3d_array;
     }
     if (n == 2 && Q->axis[0] < 2 && Q->axis[1] < 2) {
         P->fwd    = forward_2d;
         P->inv    = reverse_2d;
+        P->fwd4d_array = forward_2d_array;
+        P->inv4d_array = reverse_2d_array;
     }
 
 
@@ -206,13 +206,37 @@ static LP cart_reverse (XY xy, PJ *P) {
 
 
 
+/* Batch versions, for proj_trans_array and proj_trans_generic */
+static void cartesian_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++) {
+        if (HUGE_VAL==coo[i].v[0])
+            continue;
+        coo[i].xyz = cartesian (coo[i].lpz, P);
+    }
+}
+
+static void geodetic_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++) {
+        if (HUGE_VAL==coo[i].v[0])
+            continue;
+        coo[i].lpz = geodetic (coo[i].xyz, P);
+    }
+}
+
+
+
 /*********************************************************************/
 PJ *CONVERSION(cart,1) {
 /*********************************************************************/
     P->fwd3d  =  cartesian;
     P->inv3d  =  geodetic;
+    P->copier =  pj_default_copier;
     P->fwd    =  cart_forward;
     P->inv    =  cart_reverse;
+    P->fwd4d_array = cartesian_array;
+    P->inv4d_array = geodetic_array;
     P->left   =  PJ_IO_UNITS_ANGULAR;
     P->right  =  PJ_IO_UNITS_CARTESIAN;
     return P;
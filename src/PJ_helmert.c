@@ -471,15 +471,42 @@ static PJ_COORD helmert_reverse_4d (PJ_COORD point, PJ *P) {
     return point;
 }
 
+/* Batch versions. The parameters are only updated when t changes, */
+/* so blocks of observations from the same epoch are cheap          */
+static void helmert_forward_4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++) {
+        if (HUGE_VAL==coo[i].v[0])
+            continue;
+        coo[i] = helmert_forward_4d (coo[i], P);
+    }
+}
+
+
+static void helmert_reverse_4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++) {
+        if (HUGE_VAL==coo[i].v[0])
+            continue;
+        coo[i] = helmert_reverse_4d (coo[i], P);
+    }
+}
+
 /* Arcsecond to radians */
 #define ARCSEC_TO_RAD (DEG_TO_RAD / 3600.0)
 
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque_helmert));
+}
+
+
 static PJ* init_helmert_six_parameters(PJ* P) {
     struct pj_opaque_helmert *Q = pj_calloc (1, sizeof (struct pj_opaque_helmert));
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
     /* In most cases, we work on 3D cartesian coordinates */
     P->left  = PJ_IO_UNITS_CARTESIAN;
@@ -569,6 +596,8 @@ PJ *TRANSFORMATION(helmert, 0) {
 
     P->fwd4d  = helmert_forward_4d;
     P->inv4d  = helmert_reverse_4d;
+    P->fwd4d_array = helmert_forward_4d_array;
+    P->inv4d_array = helmert_reverse_4d_array;
     P->fwd3d  = helmert_forward_3d;
     P->inv3d  = helmert_reverse_3d;
     P->fwd    = helmert_forward;
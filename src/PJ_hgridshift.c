@@ -78,11 +78,17 @@ static PJ_COORD reverse_4d(PJ_COORD obs, PJ *P) {
 }
 
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque_hgridshift));
+}
+
+
 PJ *TRANSFORMATION(hgridshift,0) {
     struct pj_opaque_hgridshift *Q = pj_calloc (1, sizeof (struct pj_opaque_hgridshift));
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
     P->fwd4d  = forward_4d;
     P->inv4d  = reverse_4d;
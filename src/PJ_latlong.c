@@ -90,6 +90,7 @@ static PJ_COORD latlong_inverse_4d (PJ_COORD obs, PJ *P) {
 
 static PJ *latlong_setup (PJ *P) {
     P->is_latlong = 1;
+    P->copier = pj_default_copier;
     P->x0 = 0;
     P->y0 = 0;
     P->inv = latlong_inverse;
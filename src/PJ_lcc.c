@@ -75,6 +75,28 @@ static LP e_inverse (XY xy, PJ *P) {          /* Ellipsoidal, inverse */
 }
 
 
+/* Batch versions, for proj_trans_array and proj_trans_generic */
+static void e_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = e_forward (coo[i].lp, P);
+}
+
+
+static void e_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = e_inverse (coo[i].xy, P);
+}
+
+
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque));
+}
+
+
 PJ *PROJECTION(lcc) {
     double cosphi, sinphi;
     int secant;
@@ -83,6 +105,7 @@ PJ *PROJECTION(lcc) {
     if (0 == Q)
         return pj_default_destructor(P, ENOMEM);
     P->opaque = Q;
+    P->copier = copy;
 
     Q->phi1 = pj_param(P->ctx, P->params, "rlat_1").f;
     if (pj_param(P->ctx, P->params, "tlat_2").i)
@@ -123,6 +146,8 @@ PJ *PROJECTION(lcc) {
 
     P->inv = e_inverse;
     P->fwd = e_forward;
+    P->inv4d_array = e_inverse_array;
+    P->fwd4d_array = e_forward_array;
 
     return P;
 }
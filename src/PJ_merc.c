@@ -63,10 +63,45 @@ static LP s_inverse (XY xy, PJ *P) {           /* Spheroidal, inverse */
 }
 
 
+/* Batch versions, for proj_trans_array and proj_trans_generic */
+static void e_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = e_forward (coo[i].lp, P);
+}
+
+
+static void s_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = s_forward (coo[i].lp, P);
+}
+
+
+static void e_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = e_inverse (coo[i].xy, P);
+}
+
+
+static void s_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = s_inverse (coo[i].xy, P);
+}
+
+
 PJ *PROJECTION(merc) {
     double phits=0.0;
     int is_phits;
 
+    P->copier = pj_default_copier;
+
     if( (is_phits = pj_param(P->ctx, P->params, "tlat_ts").i) ) {
         phits = fabs(pj_param(P->ctx, P->params, "rlat_ts").f);
         if (phits >= M_HALFPI)
@@ -78,6 +113,8 @@ PJ *PROJECTION(merc) {
             P->k0 = pj_msfn(sin(phits), cos(phits), P->es);
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->inv4d_array = e_inverse_array;
+        P->fwd4d_array = e_forward_array;
     }
 
     else { /* sphere */
@@ -85,6 +122,8 @@ PJ *PROJECTION(merc) {
             P->k0 = cos(phits);
         P->inv = s_inverse;
         P->fwd = s_forward;
+        P->inv4d_array = s_inverse_array;
+        P->fwd4d_array = s_forward_array;
     }
 
     return P;
@@ -94,8 +133,11 @@ PJ *PROJECTION(webmerc) {
 
     /* Overriding k_0 with fixed parameter */
     P->k0 = 1.0;
+    P->copier = pj_default_copier;
 
     P->inv = s_inverse;
     P->fwd = s_forward;
+    P->inv4d_array = s_inverse_array;
+    P->fwd4d_array = s_forward_array;
     return P;
 }
@@ -120,6 +120,8 @@ struct pj_opaque {
 
 static PJ_COORD pipeline_forward_4d (PJ_COORD point, PJ *P);
 static PJ_COORD pipeline_reverse_4d (PJ_COORD point, PJ *P);
+static void   pipeline_forward_4d_array (PJ_COORD *coo, size_t n, PJ *P);
+static void   pipeline_reverse_4d_array (PJ_COORD *coo, size_t n, PJ *P);
 static XYZ    pipeline_forward_3d (LPZ lpz, PJ *P);
 static LPZ    pipeline_reverse_3d (XYZ xyz, PJ *P);
 static XY     pipeline_forward (LP lp, PJ *P);
@@ -154,6 +156,24 @@ static PJ_COORD pipeline_reverse_4d (PJ_COORD point, PJ *P) {
 }
 
 
+/* The batch versions hand the full block from step to step, so steps having */
+/* batch kernels of their own get to use them                                */
+static void pipeline_forward_4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+    int i;
+
+    for (i = 1;  i <= P->opaque->steps;  i++)
+        pj_trans_block (P->opaque->pipeline[i], 1, n, coo);
+}
+
+
+static void pipeline_reverse_4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+    int i;
+
+    for (i = P->opaque->steps;  i > 0 ;  i--)
+        pj_trans_block (P->opaque->pipeline[i], -1, n, coo);
+}
+
+
 
 
 static XYZ pipeline_forward_3d (LPZ lpz, PJ *P) {
@@ -241,6 +261,28 @@ static PJ *pj_create_pipeline (PJ *P, size_t steps) {
 }
 
 
+static PJ *copy (PJ *Q, const PJ *P) {
+    int i;
+
+    Q->opaque = pj_calloc (1, sizeof(struct pj_opaque));
+    if (0==Q->opaque)
+        return destructor (Q, ENOMEM);
+
+    /* The argument lists are only needed while setting up the steps */
+    if (0==pj_create_pipeline (Q, P->opaque->steps))
+        return destructor (Q, ENOMEM);
+
+    /* Each step is copied as any operation, in the context of Q */
+    for (i = 1;  i <= P->opaque->steps;  i++) {
+        Q->opaque->pipeline[i] = pj_copy (Q->ctx, P->opaque->pipeline[i]);
+        if (0==Q->opaque->pipeline[i])
+            return destructor (Q, proj_context_errno (Q->ctx));
+    }
+
+    return Q;
+}
+
+
 
 
 /* count the number of args in pipeline definition, and mark all args as used */
@@ -335,11 +377,14 @@ PJ *OPERATION(pipeline,0) {
 
     P->fwd4d  =  pipeline_forward_4d;
     P->inv4d  =  pipeline_reverse_4d;
+    P->fwd4d_array = pipeline_forward_4d_array;
+    P->inv4d_array = pipeline_reverse_4d_array;
     P->fwd3d  =  pipeline_forward_3d;
     P->inv3d  =  pipeline_reverse_3d;
     P->fwd    =  pipeline_forward;
     P->inv    =  pipeline_reverse;
     P->destructor  =  destructor;
+    P->copier      =  copy;
     P->is_pipeline =  1;
 
     /* Currently, the pipeline driver is a raw bit mover, enabling other operations */
@@ -473,6 +518,7 @@ PJ *OPERATION(pipeline,0) {
             P->inv   = 0;
             P->inv3d = 0;
             P->inv4d = 0;
+            P->inv4d_array = 0;
             break;
         }
     }
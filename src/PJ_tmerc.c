@@ -164,6 +164,39 @@ static LP s_inverse (XY xy, PJ *P) {           /* Spheroidal, inverse */
 }
 
 
+/* Batch versions, for proj_trans_array and proj_trans_generic */
+static void e_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = e_forward (coo[i].lp, P);
+}
+
+
+static void s_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = s_forward (coo[i].lp, P);
+}
+
+
+static void e_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = e_inverse (coo[i].xy, P);
+}
+
+
+static void s_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = s_inverse (coo[i].xy, P);
+}
+
+
 static void *destructor(PJ *P, int errlev) {                       /* Destructor */
     if (0==P)
         return 0;
@@ -176,6 +209,18 @@ static void *destructor(PJ *P, int errlev) {                       /* Destructor
 }
 
 
+static PJ *copy(PJ *Q, const PJ *P) {                               /* Copy hook */
+    Q = pj_copy_opaque(Q, P, sizeof(struct pj_opaque));
+    if (0==Q || 0==P->opaque->en)
+        return Q;
+
+    /* The meridian distance coefficients, whose number is private to pj_mlfn.c */
+    if (!(Q->opaque->en = pj_enfn(Q->es)))
+        return destructor(Q, ENOMEM);
+    return Q;
+}
+
+
 static PJ *setup(PJ *P) {                   /* general initialization */
     struct pj_opaque *Q = P->opaque;
     if (P->es != 0.0) {
@@ -186,11 +231,15 @@ static PJ *setup(PJ *P) {                   /* general initialization */
         Q->esp = P->es / (1. - P->es);
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->inv4d_array = e_inverse_array;
+        P->fwd4d_array = e_forward_array;
     } else {
         Q->esp = P->k0;
         Q->ml0 = .5 * Q->esp;
         P->inv = s_inverse;
         P->fwd = s_forward;
+        P->inv4d_array = s_inverse_array;
+        P->fwd4d_array = s_forward_array;
     }
     return P;
 }
@@ -203,6 +252,7 @@ PJ *PROJECTION(tmerc) {
 
     P->opaque = Q;
     P->destructor = destructor;
+    P->copier = copy;
 
     return setup(P);
 }
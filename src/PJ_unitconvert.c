@@ -382,6 +382,65 @@ static PJ_COORD reverse_4d(PJ_COORD obs, PJ *P) {
     return out;
 }
 
+/***********************************************************************/
+static void forward_4d_array(PJ_COORD *coo, size_t n, PJ *P) {
+/************************************************************************
+    Forward conversion of a block of coordinates
+************************************************************************/
+    struct pj_opaque_unitconvert *Q = (struct pj_opaque_unitconvert *) P->opaque;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        coo[i].xyz.x *= Q->xy_factor;
+        coo[i].xyz.y *= Q->xy_factor;
+        coo[i].xyz.z *= Q->z_factor;
+    }
+
+    if (Q->t_in_id < 0 && Q->t_out_id < 0)
+        return;
+
+    for (i = 0; i < n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        if (Q->t_in_id >= 0)
+            coo[i].xyzt.t = time_units[Q->t_in_id].t_in( coo[i].xyzt.t );
+        if (Q->t_out_id >= 0)
+            coo[i].xyzt.t = time_units[Q->t_out_id].t_out( coo[i].xyzt.t );
+    }
+}
+
+
+/***********************************************************************/
+static void reverse_4d_array(PJ_COORD *coo, size_t n, PJ *P) {
+/************************************************************************
+    Reverse conversion of a block of coordinates
+************************************************************************/
+    struct pj_opaque_unitconvert *Q = (struct pj_opaque_unitconvert *) P->opaque;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        coo[i].xyz.x /= Q->xy_factor;
+        coo[i].xyz.y /= Q->xy_factor;
+        coo[i].xyz.z /= Q->z_factor;
+    }
+
+    if (Q->t_in_id < 0 && Q->t_out_id < 0)
+        return;
+
+    for (i = 0; i < n; i++) {
+        if (coo[i].v[0] == HUGE_VAL)
+            continue;
+        if (Q->t_out_id >= 0)
+            coo[i].xyzt.t = time_units[Q->t_out_id].t_in( coo[i].xyzt.t );
+        if (Q->t_in_id >= 0)
+            coo[i].xyzt.t = time_units[Q->t_in_id].t_out( coo[i].xyzt.t );
+    }
+}
+
 /***********************************************************************/
 static double get_unit_conversion_factor(const char* name,
                                          int* p_is_linear,
@@ -428,6 +487,11 @@ static double get_unit_conversion_factor(const char* name,
     return 0.0;
 }
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque_unitconvert));
+}
+
+
 /***********************************************************************/
 PJ *CONVERSION(unitconvert,0) {
 /***********************************************************************/
@@ -443,9 +507,12 @@ PJ *CONVERSION(unitconvert,0) {
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
     P->fwd4d  = forward_4d;
     P->inv4d  = reverse_4d;
+    P->fwd4d_array = forward_4d_array;
+    P->inv4d_array = reverse_4d_array;
     P->fwd3d  = forward_3d;
     P->inv3d  = reverse_3d;
     P->fwd    = forward_2d;
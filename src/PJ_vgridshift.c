@@ -82,11 +82,17 @@ static PJ_COORD reverse_4d(PJ_COORD obs, PJ *P) {
 }
 
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque_vgridshift));
+}
+
+
 PJ *TRANSFORMATION(vgridshift,0) {
     struct pj_opaque_vgridshift *Q = pj_calloc (1, sizeof (struct pj_opaque_vgridshift));
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = (void *) Q;
+    P->copier = copy;
 
    if (!pj_param(P->ctx, P->params, "tgrids").i) {
         proj_log_error(P, "vgridshift: +grids parameter missing.");
@@ -218,6 +218,7 @@ int proj_context_set_database_path(PJ_CONTEXT *ctx, const char *dbPath,
     (void)options;
     delete ctx->cpp_context;
     ctx->cpp_context = nullptr;
+    pj_free_operation_cache(ctx);
     try {
         ctx->cpp_context = new projCppContext(ctx, dbPath, auxDbPaths);
         return true;
@@ -271,6 +272,94 @@ const char *proj_context_get_database_metadata(PJ_CONTEXT *ctx,
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+static DatabaseContext::CacheType toCacheType(PJ_DATABASE_CACHE cache) {
+    switch (cache) {
+    case PJ_DATABASE_CACHE_UNIT_OF_MEASURE:
+        return DatabaseContext::CacheType::UNIT_OF_MEASURE;
+    case PJ_DATABASE_CACHE_CRS:
+        return DatabaseContext::CacheType::CRS;
+    case PJ_DATABASE_CACHE_GEODETIC_DATUM:
+        return DatabaseContext::CacheType::GEODETIC_DATUM;
+    case PJ_DATABASE_CACHE_PRIME_MERIDIAN:
+        return DatabaseContext::CacheType::PRIME_MERIDIAN;
+    case PJ_DATABASE_CACHE_COORDINATE_SYSTEM:
+        return DatabaseContext::CacheType::COORDINATE_SYSTEM;
+    case PJ_DATABASE_CACHE_EXTENT:
+        return DatabaseContext::CacheType::EXTENT;
+    case PJ_DATABASE_CACHE_GRID_INFO:
+        return DatabaseContext::CacheType::GRID_INFO;
+    case PJ_DATABASE_CACHE_CRS_TO_CRS_OPERATIONS:
+        break;
+    }
+    return DatabaseContext::CacheType::CRS_TO_CRS_OPERATIONS;
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** \brief Set the maximum number of entries of a cache of objects built from
+ * the database.
+ *
+ * Each cache holds 128 entries by default. The caches of objects
+ * (all but PJ_DATABASE_CACHE_GRID_INFO and
+ * PJ_DATABASE_CACHE_CRS_TO_CRS_OPERATIONS) are shared by the contexts using
+ * the same database without auxiliary databases, and so is their size.
+ * The other caches, and the size given to them, belong to the database of ctx,
+ * until proj_context_set_database_path() is called.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param cache Cache to resize.
+ * @param max_size Maximum number of entries, or 0 for no limit.
+ * @return TRUE in case of success
+ */
+int proj_context_set_database_cache_size(PJ_CONTEXT *ctx,
+                                         PJ_DATABASE_CACHE cache,
+                                         size_t max_size) {
+    SANITIZE_CTX(ctx);
+    try {
+        getDBcontext(ctx)->setCacheSize(toCacheType(cache), max_size);
+        return true;
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+        return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the size and the counters of a cache of objects built from
+ * the database.
+ *
+ * The counters start when the database is opened. For the caches shared by
+ * several contexts, see proj_context_set_database_cache_size(), they include
+ * the lookups made through all of them.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param cache Cache to query.
+ * @return cache information, zeroed in case of error.
+ */
+PJ_DATABASE_CACHE_INFO
+proj_context_get_database_cache_info(PJ_CONTEXT *ctx,
+                                     PJ_DATABASE_CACHE cache) {
+    SANITIZE_CTX(ctx);
+    PJ_DATABASE_CACHE_INFO info;
+    memset(&info, 0, sizeof(info));
+    try {
+        const auto stats = getDBcontext(ctx)->getCacheStats(toCacheType(cache));
+        info.max_size = stats.maxSize;
+        info.size = stats.size;
+        info.hits = static_cast<unsigned long>(stats.hits);
+        info.misses = static_cast<unsigned long>(stats.misses);
+        info.evictions = static_cast<unsigned long>(stats.evictions);
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+    return info;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Guess the "dialect" of the WKT string.
  *
  * @param ctx PROJ context, or NULL for default context
@@ -466,6 +555,28 @@ PJ_OBJ *proj_obj_create_from_proj_string(PJ_CONTEXT *ctx,
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+static IdentifiedObjectNNPtr
+createFromDatabase(const AuthorityFactoryNNPtr &factory,
+                   const std::string &code, PJ_OBJ_CATEGORY category,
+                   bool usePROJAlternativeGridNames) {
+    switch (category) {
+    case PJ_OBJ_CATEGORY_ELLIPSOID:
+        return factory->createEllipsoid(code);
+    case PJ_OBJ_CATEGORY_DATUM:
+        return factory->createDatum(code);
+    case PJ_OBJ_CATEGORY_CRS:
+        return factory->createCoordinateReferenceSystem(code);
+    case PJ_OBJ_CATEGORY_COORDINATE_OPERATION:
+        break;
+    }
+    return factory->createCoordinateOperation(code,
+                                              usePROJAlternativeGridNames);
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 /** \brief Instanciate an object from a database lookup.
  *
  * The returned object must be unreferenced with proj_obj_unref() after use.
@@ -494,26 +605,46 @@ PJ_OBJ *proj_obj_create_from_database(PJ_CONTEXT *ctx, const char *auth_name,
     const std::string codeStr(code);
     try {
         auto factory = AuthorityFactory::create(getDBcontext(ctx), auth_name);
-        IdentifiedObjectPtr obj;
-        switch (category) {
-        case PJ_OBJ_CATEGORY_ELLIPSOID:
-            obj = factory->createEllipsoid(codeStr).as_nullable();
-            break;
-        case PJ_OBJ_CATEGORY_DATUM:
-            obj = factory->createDatum(codeStr).as_nullable();
-            break;
-        case PJ_OBJ_CATEGORY_CRS:
-            obj =
-                factory->createCoordinateReferenceSystem(codeStr).as_nullable();
-            break;
-        case PJ_OBJ_CATEGORY_COORDINATE_OPERATION:
-            obj = factory
-                      ->createCoordinateOperation(
-                          codeStr, usePROJAlternativeGridNames != 0)
-                      .as_nullable();
-            break;
+        return PJ_OBJ::create(createFromDatabase(
+            factory, codeStr, category, usePROJAlternativeGridNames != 0));
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Instanciate CRS from a database lookup of several codes.
+ *
+ * This gives the same objects as calling proj_obj_create_from_database()
+ * with PJ_OBJ_CATEGORY_CRS on each code, but the database is read with
+ * set-based queries, which is faster for many codes.
+ *
+ * @param ctx Context, or NULL for default context.
+ * @param auth_name Authority name (must not be NULL)
+ * @param codes NULL-terminated list of CRS codes (must not be NULL)
+ * @param options should be set to NULL for now
+ * @return a result set, in the order of codes, that must be unreferenced
+ * with proj_obj_list_unref(), or NULL in case of error, such as a code
+ * that is not found.
+ */
+PJ_OBJ_LIST *
+proj_obj_create_crs_list_from_database(PJ_CONTEXT *ctx, const char *auth_name,
+                                       const char *const *codes,
+                                       const char *const *options) {
+    SANITIZE_CTX(ctx);
+    assert(auth_name);
+    assert(codes);
+    (void)options;
+    try {
+        auto factory = AuthorityFactory::create(getDBcontext(ctx), auth_name);
+        std::vector<IdentifiedObjectNNPtr> objects;
+        for (const auto &crs : factory->createCoordinateReferenceSystems(
+                 projCppContext::toVector(codes))) {
+            objects.emplace_back(crs);
         }
-        return PJ_OBJ::create(NN_NO_CHECK(obj));
+        return new PJ_OBJ_LIST(std::move(objects));
     } catch (const std::exception &e) {
         proj_log_error(ctx, __FUNCTION__, e.what());
     }
@@ -522,6 +653,60 @@ PJ_OBJ *proj_obj_create_from_database(PJ_CONTEXT *ctx, const char *auth_name,
 
 // ---------------------------------------------------------------------------
 
+/** \brief Build objects from the database, so that they are found in the
+ * caches when used afterwards.
+ *
+ * The objects are built as with proj_obj_create_from_database(), which then
+ * finds them in the caches. The caches should be first sized with
+ * proj_context_set_database_cache_size() to hold them.
+ * Codes that are not found are skipped.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param auth_name Authority name (must not be NULL)
+ * @param codes NULL-terminated list of object codes (must not be NULL)
+ * @param category Object category
+ * @param options should be set to NULL for now
+ * @return number of objects built.
+ */
+int proj_context_warm_database_cache(PJ_CONTEXT *ctx, const char *auth_name,
+                                     const char *const *codes,
+                                     PJ_OBJ_CATEGORY category,
+                                     const char *const *options) {
+    SANITIZE_CTX(ctx);
+    assert(auth_name);
+    assert(codes);
+    (void)options;
+    int count = 0;
+    try {
+        auto factory = AuthorityFactory::create(getDBcontext(ctx), auth_name);
+        if (category == PJ_OBJ_CATEGORY_CRS) {
+            try {
+                return static_cast<int>(
+                    factory
+                        ->createCoordinateReferenceSystems(
+                            projCppContext::toVector(codes))
+                        .size());
+            } catch (const std::exception &e) {
+                // Retry code by code, to build all the other ones
+                proj_log_debug(ctx, __FUNCTION__, e.what());
+            }
+        }
+        for (auto iter = codes; *iter; ++iter) {
+            try {
+                createFromDatabase(factory, *iter, category, false);
+                count++;
+            } catch (const std::exception &e) {
+                proj_log_debug(ctx, __FUNCTION__, e.what());
+            }
+        }
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Return GeodeticCRS that use the specified datum.
  *
  * @param ctx Context, or NULL for default context.
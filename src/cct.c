@@ -84,13 +84,51 @@ Thomas Knudsen, thokn@sdfe.dk, 2016-05-25/2017-10-26
 #include "projects.h"
 #include "optargpm.h"
 
+#if defined(MSDOS) || defined(OS2) || defined(WIN32) || defined(__WIN32__)
+#  include <fcntl.h>
+#  include <io.h>
+#  define SET_BINARY_MODE(file) _setmode(_fileno(file), O_BINARY)
+#else
+#  define SET_BINARY_MODE(file)
+#endif
+
+/* Number of binary records read, transformed and written in one go */
+#define BINARY_BLOCK_SIZE 65536
+
+/* Number of text lines transformed by a worker thread of the -j mode in one go */
+#define CHUNK_SIZE 4096
+
+/* Settings applying to all records */
+typedef struct {
+    const char *progname;
+    int columns_xyzt[4];
+    int comment_column;
+    double fixed_z, fixed_time;
+    int decimals_angles, decimals_distances;
+    int binary_output;
+} CCT_SETTINGS;
+
+/* Growable buffer, collecting the output of a series of records */
+typedef struct {
+    char *data;
+    size_t size, capacity;
+} CCT_BUFFER;
 
 static void logger(void *data, int level, const char *msg);
 static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...);
 
 /* Prototypes from functions in this file */
 char *column (char *buf, int n);
-PJ_COORD parse_input_line (char *buf, int *columns, double fixed_height, double fixed_time);
+PJ_COORD parse_input_line (char *buf, const int *columns, double fixed_height, double fixed_time);
+static int buffer_reserve (CCT_BUFFER *b, size_t n);
+static int buffer_write (CCT_BUFFER *b, const void *data, size_t n);
+static void buffer_printf (CCT_BUFFER *b, const char *fmt, ...);
+static void buffer_flush (CCT_BUFFER *b, FILE *stream);
+static void format_point (CCT_BUFFER *out, PJ *P, PJ_COORD point, const CCT_SETTINGS *s, const char *comment);
+static void write_binary (PJ_COORD *coord, size_t n);
+static void transform_line (PJ *P, char *buf, int record, const char *filename, const CCT_SETTINGS *s, CCT_BUFFER *out, CCT_BUFFER *err);
+static int transform_binary (PJ *P, OPTARGS *o, const CCT_SETTINGS *s);
+static int transform_text_parallel (PJ *P, OPTARGS *o, const CCT_SETTINGS *s, int skip_lines, int n_workers, char *buf);
 
 
 static const char usage[] = {
@@ -102,7 +140,10 @@ static const char usage[] = {
     "    -c x,y,z,t        Specify input columns for (up to) 4 input parameters.\n"
     "                      Defaults to 1,2,3,4\n"
     "    -d n              Specify number of decimals in output.\n"
+    "    -b                Binary input and output: records of 4 little-endian\n"
+    "                      IEEE 754 doubles (x, y, z, t)\n"
     "    -I                Do the inverse transformation\n"
+    "    -j n              Transform using n worker threads\n"
     "    -o /path/to/file  Specify output file name\n"
     "    -t value          Provide a fixed t value for all input data (e.g. -t 0)\n"
     "    -z value          Provide a fixed z value for all input data (e.g. -z 0)\n"
@@ -119,6 +160,10 @@ static const char usage[] = {
     "    --time            Alias for -t\n"
     "    --verbose         Alias for -v\n"
     "    --inverse         Alias for -I\n"
+    "    --jobs            Alias for -j\n"
+    "    --binary          Alias for -b\n"
+    "    --binary-input    Binary input, text output\n"
+    "    --binary-output   Text input, binary output\n"
     "    --skip-lines      Alias for -s\n"
     "    --help            Alias for -h\n"
     "    --version         Print version number\n"
@@ -150,6 +195,8 @@ static const char usage[] = {
     "    cct -c 5,2,1,4  +proj=utm +ellps=GRS80 +zone=32\n"
     "4. as (1) but specify fixed height and time, hence needing only 2 cols in input:\n"
     "    cct -t 0 -z 0  +proj=utm  +ellps=GRS80  +zone=32\n"
+    "5. as (1) but read and write binary records:\n"
+    "    cct -b -o out.bin  +proj=utm  +ellps=GRS80  +zone=32  in.bin\n"
     "--------------------------------------------------------------------------------\n"
 };
 
@@ -203,20 +250,18 @@ static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...) {
 
 int main(int argc, char **argv) {
     PJ *P;
-    PJ_COORD point;
     PJ_PROJ_INFO info;
     OPTARGS *o;
-    char blank_comment[] = "";
-    char whitespace[] = " ";
-    char *comment;
-    char *comment_delimiter;
+    CCT_SETTINGS settings;
+    CCT_BUFFER out = {0, 0, 0}, err = {0, 0, 0};
     char *buf;
-    int i, nfields = 4, direction = 1, skip_lines = 0, verbose;
+    int i, nfields = 4, direction = 1, skip_lines = 0, verbose, jobs = 1, status;
+    int binary_input, binary_output;
     double fixed_z = HUGE_VAL, fixed_time = HUGE_VAL;
     int decimals_angles = 10;
     int decimals_distances = 4;
     int columns_xyzt[] = {1, 2, 3, 4};
-    const char *longflags[]  = {"v=verbose", "h=help", "I=inverse", "version", 0};
+    const char *longflags[]  = {"v=verbose", "h=help", "I=inverse", "b=binary", "binary-input", "binary-output", "version", 0};
     const char *longkeys[]   = {
         "o=output",
         "c=columns",
@@ -224,11 +269,12 @@ int main(int argc, char **argv) {
         "z=height",
         "t=time",
         "s=skip-lines",
+        "j=jobs",
         0};
 
     fout = stdout;
 
-    o = opt_parse (argc, argv, "hvI", "cdozts", longflags, longkeys);
+    o = opt_parse (argc, argv, "hvIb", "cdoztsj", longflags, longkeys);
     if (0==o)
         return 0;
 
@@ -248,8 +294,20 @@ int main(int argc, char **argv) {
         return 0;
     }
 
+    binary_input  = opt_given (o, "b") || opt_given (o, "binary-input");
+    binary_output = opt_given (o, "b") || opt_given (o, "binary-output");
+
+    if (binary_input && (opt_given (o, "c") || opt_given (o, "s"))) {
+        print (PJ_LOG_ERROR, "%s: Options -c and -s do not apply to binary input\n", o->progname);
+        free (o);
+        return 1;
+    }
+
     if (opt_given (o, "o"))
-        fout = fopen (opt_arg (o, "output"), "wt");
+        fout = fopen (opt_arg (o, "output"), binary_output? "wb": "wt");
+    else if (binary_output) {
+        SET_BINARY_MODE (stdout);
+    }
     if (0==fout) {
         print (PJ_LOG_ERROR, "%s: Cannot open '%s' for output\n", o->progname, opt_arg (o, "output"));
         free (o);
@@ -278,6 +336,17 @@ int main(int argc, char **argv) {
         skip_lines = atoi (opt_arg(o, "s"));
     }
 
+    if (opt_given (o, "j")) {
+        jobs = atoi (opt_arg (o, "j"));
+        if (jobs < 1) {
+            print (PJ_LOG_ERROR, "%s: Invalid number of jobs: '%s'\n", o->progname, opt_arg (o, "j"));
+            free (o);
+            if (stdout != fout)
+                fclose (fout);
+            return 1;
+        }
+    }
+
     if (opt_given (o, "c")) {
         int ncols;
         /* reset column numbers to ease comment output later on */
@@ -322,6 +391,34 @@ int main(int argc, char **argv) {
     }
     direction = 1;
 
+    settings.progname = o->progname;
+    for (i=0; i<4; i++)
+        settings.columns_xyzt[i] = columns_xyzt[i];
+    settings.comment_column = nfields+1;
+    if (opt_given(o, "c")) {
+        /* what number is the last coordinate column in the input data? */
+        int colmax = 0;
+        for (i=0; i<4; i++)
+            colmax = MAX(colmax, columns_xyzt[i]);
+        settings.comment_column = colmax+1;
+    }
+    settings.fixed_z = fixed_z;
+    settings.fixed_time = fixed_time;
+    settings.decimals_angles = decimals_angles;
+    settings.decimals_distances = decimals_distances;
+    settings.binary_output = binary_output;
+
+    if (binary_input) {
+        /* binary records are transformed in blocks, which the batch API splits over the threads */
+        proj_context_set_thread_count (PJ_DEFAULT_CTX, jobs);
+        status = transform_binary (P, o, &settings);
+        pj_free (P);
+        if (stdout != fout)
+            fclose (fout);
+        free (o);
+        return status;
+    }
+
     /* Allocate input buffer */
     buf = calloc (1, 10000);
     if (0==buf) {
@@ -334,86 +431,43 @@ int main(int argc, char **argv) {
     }
 
 
+    if (jobs > 1) {
+        status = transform_text_parallel (P, o, &settings, skip_lines, jobs, buf);
+        pj_free (P);
+        if (stdout != fout)
+            fclose (fout);
+        free (o);
+        free (buf);
+        return status;
+    }
+
     /* Loop over all records of all input files */
     while (opt_input_loop (o, optargs_file_format_text)) {
-        int err;
         void *ret = fgets (buf, 10000, o->input);
-        char *c = column (buf, 1);
         opt_eof_handler (o);
         if (0==ret) {
             print (PJ_LOG_ERROR, "Read error in record %d\n", (int) o->record_index);
             continue;
         }
-        point = parse_input_line (buf, columns_xyzt, fixed_z, fixed_time);
         if (skip_lines > 0) {
             skip_lines--;
             continue;
         }
 
-        /* if it's a comment or blank line, we reflect it */
-        if (c && ((*c=='\0') || (*c=='#'))) {
-            fprintf (fout, "%s", buf);
-            continue;
-        }
-
-        if (HUGE_VAL==point.xyzt.x) {
-            /* otherwise, it must be a syntax error */
-            print (PJ_LOG_NONE, "# Record %d UNREADABLE: %s", (int) o->record_index, buf);
-            print (PJ_LOG_ERROR, "%s: Could not parse file '%s' line %d\n", o->progname, opt_filename (o), opt_record (o));
-            continue;
-        }
-
-        if (proj_angular_input (P, direction)) {
-            point.lpzt.lam = proj_torad (point.lpzt.lam);
-            point.lpzt.phi = proj_torad (point.lpzt.phi);
-        }
-        err = proj_errno_reset (P);
-        point = proj_trans (P, direction, point);
-
-        if (HUGE_VAL==point.xyzt.x) {
-            /* transformation error */
-            print (PJ_LOG_NONE, "# Record %d TRANSFORMATION ERROR: %s (%s)",
-                   (int) o->record_index, buf, pj_strerrno (proj_errno(P)));
-            proj_errno_restore (P, err);
-            continue;
-        }
-        proj_errno_restore (P, err);
-
-        /* handle comment string */
-        comment = column(buf, nfields+1);
-        if (opt_given(o, "c")) {
-            /* what number is the last coordinate column in the input data? */
-            int colmax = 0;
-            for (i=0; i<4; i++)
-                colmax = MAX(colmax, columns_xyzt[i]);
-            comment = column(buf, colmax+1);
-        }
-        comment_delimiter = (comment && *comment) ? whitespace : blank_comment;
-
-        /* Time to print the result */
-        if (proj_angular_output (P, direction)) {
-            point.lpzt.lam = proj_todeg (point.lpzt.lam);
-            point.lpzt.phi = proj_todeg (point.lpzt.phi);
-            print (PJ_LOG_NONE, "%14.*f  %14.*f  %12.*f  %12.4f%s%s\n",
-                   decimals_angles, point.xyzt.x,
-                   decimals_angles, point.xyzt.y,
-                   decimals_distances, point.xyzt.z,
-                   point.xyzt.t, comment_delimiter, comment
-            );
-        }
-        else
-            print (PJ_LOG_NONE, "%13.*f  %13.*f  %12.*f  %12.4f%s%s\n",
-                   decimals_distances, point.xyzt.x,
-                   decimals_distances, point.xyzt.y,
-                   decimals_distances, point.xyzt.z,
-                   point.xyzt.t, comment_delimiter, comment
-            );
+        transform_line (P, buf, (int) o->record_index, opt_filename (o), &settings, &out, &err);
+        buffer_flush (&err, stderr);
+        if (out.size > 65536)
+            buffer_flush (&out, fout);
     }
+    buffer_flush (&out, fout);
 
+    pj_free (P);
     if (stdout != fout)
         fclose (fout);
     free (o);
     free (buf);
+    free (out.data);
+    free (err.data);
     return 0;
 }
 
@@ -449,7 +503,7 @@ static double cold (char *args, int col) {
     return d;
 }
 
-PJ_COORD parse_input_line (char *buf, int *columns, double fixed_height, double fixed_time) {
+PJ_COORD parse_input_line (char *buf, const int *columns, double fixed_height, double fixed_time) {
     PJ_COORD err = proj_coord (HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL);
     PJ_COORD result = err;
     int prev_errno = errno;
@@ -470,3 +524,447 @@ PJ_COORD parse_input_line (char *buf, int *columns, double fixed_height, double
     errno = prev_errno;
     return result;
 }
+
+
+/* make room for n more bytes in b */
+static int buffer_reserve (CCT_BUFFER *b, size_t n) {
+    size_t capacity = b->capacity? b->capacity: 4096;
+    char *data;
+
+    if (b->size + n <= b->capacity)
+        return 1;
+    while (capacity < b->size + n)
+        capacity *= 2;
+    data = (char *) realloc (b->data, capacity);
+    if (0==data)
+        return 0;
+    b->data = data;
+    b->capacity = capacity;
+    return 1;
+}
+
+
+/* append n bytes to b */
+static int buffer_write (CCT_BUFFER *b, const void *data, size_t n) {
+    if (!buffer_reserve (b, n))
+        return 0;
+    memcpy (b->data + b->size, data, n);
+    b->size += n;
+    return 1;
+}
+
+
+/* append formatted text to b */
+static void buffer_printf (CCT_BUFFER *b, const char *fmt, ...) {
+    va_list args;
+    int n;
+
+    if (!buffer_reserve (b, 256))
+        return;
+
+    va_start (args, fmt);
+    n = vsnprintf (b->data + b->size, b->capacity - b->size, fmt, args);
+    va_end (args);
+    if (n < 0)
+        return;
+
+    /* the text did not fit: grow, and try again */
+    if (b->size + n >= b->capacity) {
+        if (!buffer_reserve (b, (size_t) n + 1))
+            return;
+        va_start (args, fmt);
+        vsnprintf (b->data + b->size, b->capacity - b->size, fmt, args);
+        va_end (args);
+    }
+    b->size += n;
+}
+
+
+/* write the contents of b to stream, and empty b */
+static void buffer_flush (CCT_BUFFER *b, FILE *stream) {
+    if (b->size > 0 && fwrite (b->data, 1, b->size, stream) != b->size)
+        print (PJ_LOG_ERROR, "Write error\n");
+    b->size = 0;
+}
+
+
+/* format a transformed point, followed by the (possibly empty) comment */
+static void format_point (CCT_BUFFER *out, PJ *P, PJ_COORD point, const CCT_SETTINGS *s, const char *comment) {
+    const char *comment_delimiter = (comment && *comment) ? " " : "";
+    if (0==comment)
+        comment = "";
+
+    if (proj_angular_output (P, PJ_FWD)) {
+        point.lpzt.lam = proj_todeg (point.lpzt.lam);
+        point.lpzt.phi = proj_todeg (point.lpzt.phi);
+        buffer_printf (out, "%14.*f  %14.*f  %12.*f  %12.4f%s%s\n",
+               s->decimals_angles, point.xyzt.x,
+               s->decimals_angles, point.xyzt.y,
+               s->decimals_distances, point.xyzt.z,
+               point.xyzt.t, comment_delimiter, comment
+        );
+    }
+    else
+        buffer_printf (out, "%13.*f  %13.*f  %12.*f  %12.4f%s%s\n",
+               s->decimals_distances, point.xyzt.x,
+               s->decimals_distances, point.xyzt.y,
+               s->decimals_distances, point.xyzt.z,
+               point.xyzt.t, comment_delimiter, comment
+        );
+}
+
+
+/* Binary records are stored as little-endian IEEE 754 doubles: swap on big-endian hosts */
+static void swap_to_little_endian (PJ_COORD *coord, size_t n) {
+    const unsigned int one = 1;
+    size_t i, j, k;
+
+    if (1 == *((const unsigned char *) &one))
+        return;
+
+    for (i = 0;  i < n;  i++) {
+        for (j = 0;  j < 4;  j++) {
+            unsigned char *b = (unsigned char *) (coord[i].v + j);
+            for (k = 0;  k < 4;  k++) {
+                unsigned char tmp = b[k];
+                b[k] = b[7 - k];
+                b[7 - k] = tmp;
+            }
+        }
+    }
+}
+
+
+/* write n coordinates as binary records, clobbering coord on big-endian hosts */
+static void write_binary (PJ_COORD *coord, size_t n) {
+    swap_to_little_endian (coord, n);
+    if (fwrite (coord, sizeof (PJ_COORD), n, fout) != n)
+        print (PJ_LOG_ERROR, "Write error\n");
+}
+
+
+/* Transform one line of text input, appending the result to out, and error messages to err */
+static void transform_line (PJ *P, char *buf, int record, const char *filename, const CCT_SETTINGS *s, CCT_BUFFER *out, CCT_BUFFER *err) {
+    PJ_COORD point;
+    char *c = column (buf, 1);
+    int errno_saved;
+
+    /* if it's a comment or blank line, we reflect it */
+    if (c && ((*c=='\0') || (*c=='#'))) {
+        if (!s->binary_output)
+            buffer_printf (out, "%s", buf);
+        return;
+    }
+
+    point = parse_input_line (buf, s->columns_xyzt, s->fixed_z, s->fixed_time);
+    if (HUGE_VAL==point.xyzt.x) {
+        /* otherwise, it must be a syntax error */
+        if (s->binary_output) {
+            /* keep the output records in step with the input records */
+            point = proj_coord (HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL);
+            swap_to_little_endian (&point, 1);
+            buffer_write (out, &point, sizeof (PJ_COORD));
+        }
+        else
+            buffer_printf (out, "# Record %d UNREADABLE: %s", record, buf);
+        buffer_printf (err, "%s: Could not parse file '%s' line %d\n", s->progname, filename, record + 1);
+        return;
+    }
+
+    if (proj_angular_input (P, PJ_FWD)) {
+        point.lpzt.lam = proj_torad (point.lpzt.lam);
+        point.lpzt.phi = proj_torad (point.lpzt.phi);
+    }
+    errno_saved = proj_errno_reset (P);
+    point = proj_trans (P, PJ_FWD, point);
+
+    if (s->binary_output) {
+        /* transformation errors are passed on as HUGE_VAL records */
+        if (HUGE_VAL != point.xyzt.x && proj_angular_output (P, PJ_FWD)) {
+            point.lpzt.lam = proj_todeg (point.lpzt.lam);
+            point.lpzt.phi = proj_todeg (point.lpzt.phi);
+        }
+        proj_errno_restore (P, errno_saved);
+        swap_to_little_endian (&point, 1);
+        buffer_write (out, &point, sizeof (PJ_COORD));
+        return;
+    }
+
+    if (HUGE_VAL==point.xyzt.x) {
+        /* transformation error */
+        buffer_printf (out, "# Record %d TRANSFORMATION ERROR: %s (%s)",
+                       record, buf, pj_strerrno (proj_errno(P)));
+        proj_errno_restore (P, errno_saved);
+        return;
+    }
+    proj_errno_restore (P, errno_saved);
+
+    /* Time to print the result, followed by the comment string */
+    format_point (out, P, point, s, column (buf, s->comment_column));
+}
+
+
+/* Read, transform and write binary records, in blocks of BINARY_BLOCK_SIZE */
+static int transform_binary (PJ *P, OPTARGS *o, const CCT_SETTINGS *s) {
+    CCT_BUFFER out = {0, 0, 0};
+    PJ_COORD *coord;
+    size_t i, n, nbytes;
+    size_t stride = sizeof (PJ_COORD);
+    int angular_input = proj_angular_input (P, PJ_FWD);
+    int ret = 0;
+
+    coord = (PJ_COORD *) malloc (BINARY_BLOCK_SIZE * sizeof (PJ_COORD));
+    if (0==coord) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+        return 1;
+    }
+
+    if (0==o->fargc) {
+        SET_BINARY_MODE (stdin);
+    }
+
+    while (opt_input_loop (o, optargs_file_format_binary)) {
+        nbytes = fread (coord, 1, BINARY_BLOCK_SIZE * sizeof (PJ_COORD), o->input);
+        n = nbytes / sizeof (PJ_COORD);
+        if (ferror (o->input)) {
+            print (PJ_LOG_ERROR, "%s: Read error in file '%s'\n", o->progname, opt_filename (o));
+            ret = 1;
+            break;
+        }
+        if (0 != nbytes % sizeof (PJ_COORD))
+            print (PJ_LOG_ERROR, "%s: Ignoring truncated record at end of file '%s'\n", o->progname, opt_filename (o));
+        if (0==n)
+            continue;
+
+        swap_to_little_endian (coord, n);
+        for (i = 0;  i < n;  i++) {
+            if (HUGE_VAL != s->fixed_z)
+                coord[i].xyzt.z = s->fixed_z;
+            if (HUGE_VAL != s->fixed_time)
+                coord[i].xyzt.t = s->fixed_time;
+            if (angular_input) {
+                coord[i].lpzt.lam = proj_torad (coord[i].lpzt.lam);
+                coord[i].lpzt.phi = proj_torad (coord[i].lpzt.phi);
+            }
+        }
+
+        /* Failed coordinates come back as HUGE_VAL, and are passed on as such */
+        proj_errno_reset (P);
+        proj_trans_generic (P, PJ_FWD,
+                            &(coord[0].xyzt.x), stride, n,
+                            &(coord[0].xyzt.y), stride, n,
+                            &(coord[0].xyzt.z), stride, n,
+                            &(coord[0].xyzt.t), stride, n);
+
+        if (s->binary_output) {
+            if (proj_angular_output (P, PJ_FWD)) {
+                for (i = 0;  i < n;  i++) {
+                    if (HUGE_VAL == coord[i].xyzt.x)
+                        continue;
+                    coord[i].lpzt.lam = proj_todeg (coord[i].lpzt.lam);
+                    coord[i].lpzt.phi = proj_todeg (coord[i].lpzt.phi);
+                }
+            }
+            write_binary (coord, n);
+            continue;
+        }
+
+        for (i = 0;  i < n;  i++) {
+            if (HUGE_VAL == coord[i].xyzt.x) {
+                buffer_printf (&out, "# TRANSFORMATION ERROR\n");
+                continue;
+            }
+            format_point (&out, P, coord[i], s, 0);
+        }
+        buffer_flush (&out, fout);
+    }
+
+    free (coord);
+    free (out.data);
+    return ret;
+}
+
+
+/* A chunk of text input lines, and the output of their transformation */
+typedef struct {
+    CCT_BUFFER text;                        /* the lines, each one NUL-terminated */
+    size_t line[CHUNK_SIZE];                /* offset of each line in text */
+    int record[CHUNK_SIZE];                 /* record number of each line */
+    const char *filename[CHUNK_SIZE];       /* input file of each line */
+    size_t n;
+    CCT_BUFFER out, err;
+} CHUNK;
+
+/* State of the -j mode. Input is handled in batches of one chunk per worker */
+typedef struct {
+    OPTARGS *o;
+    const CCT_SETTINGS *settings;
+    PJ **workers;           /* one transformation object per worker thread */
+    int n_workers;
+    CHUNK *batch[2];        /* batch[current] is being transformed */
+    int current;
+    int skip_lines;
+    int end_of_input;
+    char *buf;
+} PIPELINE;
+
+typedef struct {
+    PIPELINE *pipeline;
+    int index;
+} PIPELINE_JOB;
+
+
+/* Read the next lines of input into the chunks of batch */
+static void read_batch (PIPELINE *p, CHUNK *batch) {
+    OPTARGS *o = p->o;
+    int k;
+
+    for (k = 0;  k < p->n_workers;  k++) {
+        batch[k].n = 0;
+        batch[k].text.size = 0;
+    }
+
+    k = 0;
+    while (k < p->n_workers && !p->end_of_input) {
+        CHUNK *chunk = batch + k;
+        void *ret;
+
+        /* once exhausted, the input loop must not be called again */
+        if (!opt_input_loop (o, optargs_file_format_text)) {
+            p->end_of_input = 1;
+            break;
+        }
+
+        ret = fgets (p->buf, 10000, o->input);
+        opt_eof_handler (o);
+        if (0==ret) {
+            print (PJ_LOG_ERROR, "Read error in record %d\n", (int) o->record_index);
+            continue;
+        }
+        if (p->skip_lines > 0) {
+            p->skip_lines--;
+            continue;
+        }
+
+        chunk->line[chunk->n] = chunk->text.size;
+        if (!buffer_write (&chunk->text, p->buf, strlen (p->buf) + 1)) {
+            print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+            continue;
+        }
+        chunk->record[chunk->n] = (int) o->record_index;
+        chunk->filename[chunk->n] = opt_filename (o);
+        if (++chunk->n == CHUNK_SIZE)
+            k++;
+    }
+}
+
+
+/* Write the output of batch, in input order */
+static void write_batch (PIPELINE *p, CHUNK *batch) {
+    int k;
+    for (k = 0;  k < p->n_workers;  k++) {
+        buffer_flush (&batch[k].err, stderr);
+        buffer_flush (&batch[k].out, fout);
+    }
+}
+
+
+/* Thread body of the -j mode: job 0 does the I/O, the others transform a chunk each */
+static void pipeline_job (void *arg) {
+    PIPELINE_JOB *job = (PIPELINE_JOB *) arg;
+    PIPELINE *p = job->pipeline;
+    CHUNK *chunk;
+    size_t i;
+
+    if (0==job->index) {
+        CHUNK *batch = p->batch[1 - p->current];
+        write_batch (p, batch);
+        read_batch (p, batch);
+        return;
+    }
+
+    chunk = p->batch[p->current] + job->index - 1;
+    for (i = 0;  i < chunk->n;  i++)
+        transform_line (p->workers[job->index - 1], chunk->text.data + chunk->line[i],
+                        chunk->record[i], chunk->filename[i], p->settings, &chunk->out, &chunk->err);
+}
+
+
+/**************************************************************************************
+    Transform text input using n_workers threads, each with its own copy of P.
+
+    Input is read in batches of n_workers chunks of CHUNK_SIZE lines. While the
+    workers transform one batch, the calling thread writes the output of the
+    previous batch, and reads the next batch in its place. Output is written in
+    input order, hence identical to that of the single threaded mode.
+**************************************************************************************/
+static int transform_text_parallel (PJ *P, OPTARGS *o, const CCT_SETTINGS *s, int skip_lines, int n_workers, char *buf) {
+    PIPELINE p;
+    PIPELINE_JOB *jobs;
+    int i, k, ret = 0;
+
+    memset (&p, 0, sizeof (PIPELINE));
+    p.o = o;
+    p.settings = s;
+    p.n_workers = n_workers;
+    p.skip_lines = skip_lines;
+    p.buf = buf;
+
+    p.workers  = (PJ **) calloc (n_workers, sizeof (PJ *));
+    p.batch[0] = (CHUNK *) calloc (n_workers, sizeof (CHUNK));
+    p.batch[1] = (CHUNK *) calloc (n_workers, sizeof (CHUNK));
+    jobs = (PIPELINE_JOB *) calloc (n_workers + 1, sizeof (PIPELINE_JOB));
+    if (0==p.workers || 0==p.batch[0] || 0==p.batch[1] || 0==jobs) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+        ret = 1;
+    }
+
+    /* PJ objects cannot be shared between threads, so each worker gets its own */
+    for (i = 0;  0==ret && i < n_workers;  i++) {
+        PJ_CONTEXT *ctx = proj_context_create ();
+        if (0 != ctx)
+            p.workers[i] = proj_create_argv (ctx, o->pargc, o->pargv);
+        if (0==p.workers[i]) {
+            print (PJ_LOG_ERROR, "%s: Cannot create transformation for worker %d\n", o->progname, i);
+            if (0 != ctx)
+                proj_context_destroy (ctx);
+            ret = 1;
+            break;
+        }
+        p.workers[i]->inverted = P->inverted;
+    }
+
+    if (0==ret) {
+        for (i = 0;  i <= n_workers;  i++) {
+            jobs[i].pipeline = &p;
+            jobs[i].index = i;
+        }
+
+        read_batch (&p, p.batch[0]);
+        while (p.batch[p.current][0].n > 0) {
+            pj_run_in_threads (n_workers + 1, pipeline_job, jobs, sizeof (PIPELINE_JOB));
+            p.current = 1 - p.current;
+        }
+        write_batch (&p, p.batch[1 - p.current]);
+    }
+
+    for (i = 0;  p.workers && i < n_workers;  i++) {
+        PJ_CONTEXT *ctx;
+        if (0==p.workers[i])
+            continue;
+        ctx = p.workers[i]->ctx;
+        proj_destroy (p.workers[i]);
+        proj_context_destroy (ctx);
+    }
+    for (k = 0;  k < 2;  k++) {
+        for (i = 0;  p.batch[k] && i < n_workers;  i++) {
+            free (p.batch[k][i].text.data);
+            free (p.batch[k][i].out.data);
+            free (p.batch[k][i].err.data);
+        }
+        free (p.batch[k]);
+    }
+    free (p.workers);
+    free (jobs);
+    return ret;
+}
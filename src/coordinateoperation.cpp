@@ -47,6 +47,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -8998,6 +8999,21 @@ struct CoordinateOperationFactory::Private {
         const CoordinateOperationContextNNPtr &context;
         bool inCreateOperationsWithDatumPivotAntiRecursion = false;
 
+        // Results of the createOperations() calls made by
+        // createOperationsWithDatumPivot() from the source CRS to its
+        // candidates, and from the target candidates to the target CRS,
+        // keyed by the identity of their source and target CRS. They are
+        // otherwise redone for each pair of candidates.
+        struct PivotSubResult {
+            // Hold the CRS so that their addresses are not reused
+            crs::CRSNNPtr sourceCRS;
+            crs::CRSNNPtr targetCRS;
+            std::vector<CoordinateOperationNNPtr> res;
+        };
+        std::map<std::pair<const crs::CRS *, const crs::CRS *>,
+                 PivotSubResult>
+            mapPivotSubResults{};
+
         Context(const crs::CRSNNPtr &sourceCRSIn,
                 const crs::CRSNNPtr &targetCRSIn,
                 const CoordinateOperationContextNNPtr &contextIn)
@@ -9015,6 +9031,11 @@ struct CoordinateOperationFactory::Private {
         const crs::CRSNNPtr &sourceCRS, const crs::CRSNNPtr &targetCRS,
         const crs::GeographicCRS *geogSrc, const crs::GeographicCRS *geogDst);
 
+    static const std::vector<CoordinateOperationNNPtr> &
+    createOperationsForDatumPivot(const crs::CRSNNPtr &sourceCRS,
+                                  const crs::CRSNNPtr &targetCRS,
+                                  Context &context);
+
     static void createOperationsWithDatumPivot(
         std::vector<CoordinateOperationNNPtr> &res,
         const crs::CRSNNPtr &sourceCRS, const crs::CRSNNPtr &targetCRS,
@@ -9764,6 +9785,12 @@ static std::vector<CoordinateOperationNNPtr> findsOpsInRegistryWithIntermediate(
     const auto &authFactory = context->getAuthorityFactory();
     assert(authFactory);
     const auto &authFactoryName = authFactory->getAuthority();
+    const bool usePROJAlternativeGridNames =
+        context->getUsePROJAlternativeGridNames();
+    const bool discardIfMissingGrid =
+        context->getGridAvailabilityUse() ==
+        CoordinateOperationContext::GridAvailabilityUse::
+            DISCARD_OPERATION_IF_MISSING_GRID;
 
     for (const auto &idSrc : sourceCRS->identifiers()) {
         const auto &srcAuthName = *(idSrc->codeSpace());
@@ -9793,17 +9820,29 @@ static std::vector<CoordinateOperationNNPtr> findsOpsInRegistryWithIntermediate(
                                 authFactory->databaseContext(),
                                 authority == "any" ? std::string() : authority);
 
-                        auto res =
-                            tmpAuthFactory->createFromCRSCodesWithIntermediates(
-                                srcAuthName, srcCode, targetAuthName,
-                                targetCode,
-                                context->getUsePROJAlternativeGridNames(),
-                                context->getGridAvailabilityUse() ==
-                                    CoordinateOperationContext::
-                                        GridAvailabilityUse::
-                                            DISCARD_OPERATION_IF_MISSING_GRID,
-                                context->getDiscardSuperseded(),
-                                context->getIntermediateCRS());
+                        const auto search =
+                            [&](const metadata::ExtentPtr &areaOfInterest) {
+                                return tmpAuthFactory
+                                    ->createFromCRSCodesWithIntermediates(
+                                        srcAuthName, srcCode, targetAuthName,
+                                        targetCode, usePROJAlternativeGridNames,
+                                        discardIfMissingGrid,
+                                        context->getDiscardSuperseded(),
+                                        context->getIntermediateCRS(),
+                                        areaOfInterest);
+                            };
+
+                        // Operations whose area of use does not intersect
+                        // the area of interest are discarded afterwards, so
+                        // skip them in the database. The search is redone
+                        // without it if none remains, so that callers see an
+                        // empty result only when the database has none.
+                        const auto &areaOfInterest =
+                            context->getAreaOfInterest();
+                        auto res = search(areaOfInterest);
+                        if (res.empty() && areaOfInterest) {
+                            res = search(nullptr);
+                        }
                         if (!res.empty()) {
                             return res;
                         }
@@ -10332,6 +10371,28 @@ static bool isNullTransformation(const std::string &name) {
 
 // ---------------------------------------------------------------------------
 
+const std::vector<CoordinateOperationNNPtr> &
+CoordinateOperationFactory::Private::createOperationsForDatumPivot(
+    const crs::CRSNNPtr &sourceCRS, const crs::CRSNNPtr &targetCRS,
+    Private::Context &context) {
+
+    // Only valid while inCreateOperationsWithDatumPivotAntiRecursion is set,
+    // since createOperations() does not search for datum pivots then.
+    assert(context.inCreateOperationsWithDatumPivotAntiRecursion);
+    const auto key = std::make_pair(sourceCRS.get(), targetCRS.get());
+    auto iter = context.mapPivotSubResults.find(key);
+    if (iter == context.mapPivotSubResults.end()) {
+        auto res = createOperations(sourceCRS, targetCRS, context);
+        iter = context.mapPivotSubResults
+                   .emplace(key, Context::PivotSubResult{sourceCRS, targetCRS,
+                                                         std::move(res)})
+                   .first;
+    }
+    return iter->second.res;
+}
+
+// ---------------------------------------------------------------------------
+
 void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
     std::vector<CoordinateOperationNNPtr> &res, const crs::CRSNNPtr &sourceCRS,
     const crs::CRSNNPtr &targetCRS, const crs::GeodeticCRS *geodSrc,
@@ -10364,10 +10425,12 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
                                      const crs::CRSNNPtr &candidateDstGeod,
                                      const CoordinateOperationNNPtr &opFirst,
                                      bool isNullFirst) {
+        // Not shared, since their CRS may be altered below. Each pair of
+        // candidates is only looked at once anyway.
         const auto opsSecond =
             createOperations(candidateSrcGeod, candidateDstGeod, context);
-        const auto opsThird =
-            createOperations(candidateDstGeod, targetCRS, context);
+        const auto &opsThird =
+            createOperationsForDatumPivot(candidateDstGeod, targetCRS, context);
         assert(!opsThird.empty());
 
         for (auto &opSecond : opsSecond) {
@@ -10409,8 +10472,8 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
         if (candidateSrcGeod->nameStr() == sourceCRS->nameStr()) {
             for (const auto &candidateDstGeod : candidatesDstGeod) {
                 if (candidateDstGeod->nameStr() == targetCRS->nameStr()) {
-                    const auto opsFirst =
-                        createOperations(sourceCRS, candidateSrcGeod, context);
+                    const auto &opsFirst = createOperationsForDatumPivot(
+                        sourceCRS, candidateSrcGeod, context);
                     assert(!opsFirst.empty());
                     const bool isNullFirst =
                         isNullTransformation(opsFirst[0]->nameStr());
@@ -10427,8 +10490,8 @@ void CoordinateOperationFactory::Private::createOperationsWithDatumPivot(
     }
 
     for (const auto &candidateSrcGeod : candidatesSrcGeod) {
-        const auto opsFirst =
-            createOperations(sourceCRS, candidateSrcGeod, context);
+        const auto &opsFirst =
+            createOperationsForDatumPivot(sourceCRS, candidateSrcGeod, context);
         assert(!opsFirst.empty());
         const bool isNullFirst = isNullTransformation(opsFirst[0]->nameStr());
 
@@ -3095,8 +3095,22 @@ ProjectedCRS::identify(const io::AuthorityFactoryPtr &authorityFactory) const {
 
             auto self = NN_NO_CHECK(std::dynamic_pointer_cast<ProjectedCRS>(
                 shared_from_this().as_nullable()));
+            // The CRS with the same fingerprint are looked up first, and
+            // the database is only searched more broadly if none of them is
+            // equivalent.
             auto candidates =
-                authorityFactory->createProjectedCRSFromExisting(self);
+                authorityFactory->createProjectedCRSFromFingerprint(self,
+                                                                    baseRes);
+            if (std::none_of(candidates.begin(), candidates.end(),
+                             [this](const ProjectedCRSNNPtr &crs) {
+                                 return _isEquivalentTo(
+                                     crs.get(),
+                                     util::IComparable::Criterion::
+                                         EQUIVALENT_EXCEPT_AXIS_ORDER_GEOGCRS);
+                             })) {
+                candidates =
+                    authorityFactory->createProjectedCRSFromExisting(self);
+            }
             const auto &ellipsoid = l_baseCRS->ellipsoid();
             for (const auto &crs : candidates) {
                 const auto &ids = crs->identifiers();
@@ -37,6 +37,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include <proj/internal/internal.hpp>
 
@@ -47,8 +48,19 @@
 #include "emess.h"
 // clang-format on
 
+#if defined(MSDOS) || defined(OS2) || defined(WIN32) || defined(__WIN32__)
+#include <fcntl.h>
+#include <io.h>
+#define SET_BINARY_MODE(file) _setmode(_fileno(file), O_BINARY)
+#else
+#define SET_BINARY_MODE(file)
+#endif
+
 #define MAX_LINE 1000
 
+/* Number of binary records read, transformed and written in one go */
+#define BINARY_BLOCK_SIZE 65536
+
 static PJ *transformation = nullptr;
 
 static bool srcIsGeog = false;
@@ -60,6 +72,8 @@ static bool destIsLatLong = false;
 
 static int reversein = 0, /* != 0 reverse input arguments */
     reverseout = 0,       /* != 0 reverse output arguments */
+    bin_in = 0,           /* != 0 then binary input */
+    bin_out = 0,          /* != 0 then binary output */
     echoin = 0,           /* echo input data to output line */
     tag = '#';            /* beginning of line tag character */
 
@@ -68,12 +82,167 @@ static const char *oform =
 static char oform_buffer[16]; /* buffer for oform when using -d */
 static const char *oterr = "*\t*"; /* output line for unprojectable input */
 static const char *usage =
-    "%s\nusage: %s [ -dDeEfIlrstvwW [args] ] [ +opts[=arg] ]\n"
+    "%s\nusage: %s [ -bdDeEfiIlorstvwW [args] ] [ +opts[=arg] ]\n"
     "                   [+to [+opts[=arg] [ files ]\n";
 
 static double (*informat)(const char *,
                           char **); /* input data deformatter function */
 
+/************************************************************************/
+/*                            output_text()                             */
+/*                                                                      */
+/*      Print a transformed coordinate, followed by the remainder s     */
+/*      of the input line.                                              */
+/************************************************************************/
+static void output_text(projUV data, double z, const char *s)
+
+{
+    char pline[40];
+
+    if (data.u == HUGE_VAL) /* error output */
+        fputs(oterr, stdout);
+
+    else if (destIsGeog && !oform) { /*ascii DMS output */
+
+        // rtodms() expect radians: convert from the output SRS unit
+        data.u *= destToRadians;
+        data.v *= destToRadians;
+
+        if (destIsLatLong) {
+            if (reverseout) {
+                fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
+                putchar('\t');
+                fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
+            } else {
+                fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
+                putchar('\t');
+                fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
+            }
+        } else if (reverseout) {
+            fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
+            putchar('\t');
+            fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
+        } else {
+            fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
+            putchar('\t');
+            fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
+        }
+
+    } else { /* x-y or decimal degree ascii output */
+        if (destIsGeog) {
+            data.v *= destToRadians * RAD_TO_DEG;
+            data.u *= destToRadians * RAD_TO_DEG;
+        }
+        if (reverseout) {
+            printf(oform, data.v);
+            putchar('\t');
+            printf(oform, data.u);
+        } else {
+            printf(oform, data.u);
+            putchar('\t');
+            printf(oform, data.v);
+        }
+    }
+
+    putchar(' ');
+    if (oform != nullptr)
+        printf(oform, z);
+    else
+        printf("%.3f", z);
+    if (s)
+        printf("%s", s);
+    else
+        printf("\n");
+}
+
+/************************************************************************/
+/*                           swap_to_little_endian()                    */
+/*                                                                      */
+/*      Binary records are stored as little-endian IEEE 754 doubles:    */
+/*      swap the n values in place on big-endian hosts.                 */
+/************************************************************************/
+static void swap_to_little_endian(double *values, size_t n)
+
+{
+    const unsigned int one = 1;
+    if (*reinterpret_cast<const unsigned char *>(&one) == 1)
+        return;
+
+    for (size_t i = 0; i < n; i++) {
+        unsigned char *b = reinterpret_cast<unsigned char *>(values + i);
+        for (int k = 0; k < 4; k++) {
+            unsigned char tmp = b[k];
+            b[k] = b[7 - k];
+            b[7 - k] = tmp;
+        }
+    }
+}
+
+/************************************************************************/
+/*                            output_binary()                           */
+/*                                                                      */
+/*      Write n records of 3 doubles (x, y, z), clobbering the values   */
+/*      on big-endian hosts.                                            */
+/************************************************************************/
+static void output_binary(double *values, size_t n)
+
+{
+    swap_to_little_endian(values, 3 * n);
+    if (fwrite(values, 3 * sizeof(double), n, stdout) != n)
+        emess(1, "write error");
+}
+
+/************************************************************************/
+/*                           process_binary()                           */
+/*                                                                      */
+/*      Binary file processing function: records of 3 doubles (x, y, z) */
+/*      in the units and axis order of the source CRS are read,         */
+/*      transformed and written in blocks of BINARY_BLOCK_SIZE.         */
+/************************************************************************/
+static void process_binary(FILE *fid)
+
+{
+    const size_t stride = 3 * sizeof(double);
+    std::vector<double> values(3 * BINARY_BLOCK_SIZE);
+
+    for (;;) {
+        size_t nbytes =
+            fread(values.data(), 1, BINARY_BLOCK_SIZE * stride, fid);
+        size_t n = nbytes / stride;
+        if (nbytes % stride != 0)
+            emess(-1, "ignoring truncated record at end of file");
+        if (n == 0)
+            break;
+
+        swap_to_little_endian(values.data(), 3 * n);
+
+        /* Failed coordinates come back as HUGE_VAL, and are passed on */
+        double t = HUGE_VAL;
+        proj_trans_generic(transformation, PJ_FWD, &values[0], stride, n,
+                           &values[1], stride, n, &values[2], stride, n, &t,
+                           0, 1);
+
+        if (bin_out) {
+            output_binary(values.data(), n);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                projUV data;
+                data.u = values[3 * i];
+                data.v = values[3 * i + 1];
+                if (data.v == HUGE_VAL)
+                    data.u = HUGE_VAL;
+                output_text(data, values[3 * i + 2], nullptr);
+            }
+        }
+        emess_dat.File_line += static_cast<int>(n);
+
+        if (n < BINARY_BLOCK_SIZE)
+            break;
+    }
+    if (ferror(fid))
+        emess(-2, "read error");
+}
+
 /************************************************************************/
 /*                              process()                               */
 /*                                                                      */
@@ -82,9 +251,14 @@ static double (*informat)(const char *,
 static void process(FILE *fid)
 
 {
-    char line[MAX_LINE + 3], *s, pline[40];
+    char line[MAX_LINE + 3], *s;
     projUV data;
 
+    if (bin_in) {
+        process_binary(fid);
+        return;
+    }
+
     for (;;) {
         double z;
 
@@ -99,7 +273,8 @@ static void process(FILE *fid)
                 ;
         }
         if (*s == tag) {
-            fputs(line, stdout);
+            if (!bin_out)
+                fputs(line, stdout);
             continue;
         }
 
@@ -119,7 +294,7 @@ static void process(FILE *fid)
         if (!*s && (s > line))
             --s; /* assumed we gobbled \n */
 
-        if (echoin) {
+        if (!bin_out && echoin) {
             char t;
             t = *s;
             *s = '\0';
@@ -148,60 +323,15 @@ static void process(FILE *fid)
             z = coord.xyz.z;
         }
 
-        if (data.u == HUGE_VAL) /* error output */
-            fputs(oterr, stdout);
-
-        else if (destIsGeog && !oform) { /*ascii DMS output */
-
-            // rtodms() expect radians: convert from the output SRS unit
-            data.u *= destToRadians;
-            data.v *= destToRadians;
-
-            if (destIsLatLong) {
-                if (reverseout) {
-                    fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
-                } else {
-                    fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
-                }
-            } else if (reverseout) {
-                fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
-            } else {
-                fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
-            }
-
-        } else { /* x-y or decimal degree ascii output */
-            if (destIsGeog) {
-                data.v *= destToRadians * RAD_TO_DEG;
-                data.u *= destToRadians * RAD_TO_DEG;
-            }
-            if (reverseout) {
-                printf(oform, data.v);
-                putchar('\t');
-                printf(oform, data.u);
-            } else {
-                printf(oform, data.u);
-                putchar('\t');
-                printf(oform, data.v);
-            }
+        if (bin_out) {
+            double values[3] = {data.u, data.v, z};
+            if (data.u == HUGE_VAL)
+                values[1] = values[2] = HUGE_VAL;
+            output_binary(values, 1);
+            continue;
         }
 
-        putchar(' ');
-        if (oform != nullptr)
-            printf(oform, z);
-        else
-            printf("%.3f", z);
-        if (s)
-            printf("%s", s);
-        else
-            printf("\n");
+        output_text(data, z, s);
     }
 }
 
@@ -367,6 +497,15 @@ int main(int argc, char **argv) {
                 case 'v': /* monitor dump of initialization */
                     mon = 1;
                     continue;
+                case 'b': /* binary I/O */
+                    bin_in = bin_out = 1;
+                    continue;
+                case 'i': /* input binary */
+                    bin_in = 1;
+                    continue;
+                case 'o': /* output binary */
+                    bin_out = 1;
+                    continue;
                 case 'I': /* alt. method to spec inverse */
                     inverse = 1;
                     continue;
@@ -609,14 +748,22 @@ int main(int argc, char **argv) {
     if (!destIsGeog && !oform)
         oform = "%.2f";
 
+    if (bin_out) {
+        SET_BINARY_MODE(stdout);
+    }
+
     /* process input file list */
     for (; eargc--; ++eargv) {
         if (**eargv == '-') {
             fid = stdin;
             emess_dat.File_name = const_cast<char *>("<stdin>");
 
+            if (bin_in) {
+                SET_BINARY_MODE(stdin);
+            }
+
         } else {
-            if ((fid = fopen(*eargv, "rt")) == nullptr) {
+            if ((fid = fopen(*eargv, bin_in ? "rb" : "rt")) == nullptr) {
                 emess(-2, *eargv, "input file");
                 continue;
             }
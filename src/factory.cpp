@@ -44,16 +44,24 @@
 #include "proj/internal/io_internal.hpp"
 #include "proj/internal/lru_cache.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iomanip>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <sstream> // std::ostringstream
 #include <string>
 
+#include <sys/stat.h>
+
 #include "proj_constants.h"
 
 // PROJ include order is sensitive
@@ -118,9 +126,10 @@ struct DatabaseContext::Private {
     ~Private();
 
     void open(const std::string &databasePath = std::string());
+    void openShared(const std::string &databasePath = std::string());
     void setHandle(sqlite3 *sqlite_handle);
 
-    sqlite3 *handle() const { return sqlite_handle_; }
+    sqlite3 *handle();
 
     PJ_CONTEXT *pjCtxt() const { return pjCtxt_; }
     void setPjCtxt(PJ_CONTEXT *ctxt) { pjCtxt_ = ctxt; }
@@ -128,6 +137,23 @@ struct DatabaseContext::Private {
     SQLResultSet run(const std::string &sql,
                      const ListOfParams &parameters = ListOfParams());
 
+    // A prepared statement, reused by the queries of the same SQL. inUse
+    // is set while a SQLCursor iterates over its rows.
+    struct CachedStatement {
+        sqlite3_stmt *stmt = nullptr;
+        bool inUse = false;
+    };
+
+    // A connection to the database, with its prepared statements
+    struct Connection {
+        sqlite3 *handle = nullptr;
+        std::map<std::string, CachedStatement> mapSqlToStatement{};
+    };
+
+    class SQLCursor;
+
+    struct SharedDatabase;
+
     std::vector<std::string> getDatabaseStructure();
 
     // cppcheck-suppress functionStatic
@@ -160,6 +186,36 @@ struct DatabaseContext::Private {
         return mapCanonicalizeGRFName_;
     }
 
+    // Whether the area_index and area_rtree tables of
+    // data/sql/area_index.sql can be used.
+    bool hasAreaIndex();
+
+    // Condition on the area_index.id column named idColumn that selects
+    // the areas whose bounding box may intersect the bounding boxes of
+    // areaOfInterest, and the matching parameters. Empty if areaOfInterest
+    // has no bounding box.
+    std::string getAreaIndexFilter(const metadata::Extent &areaOfInterest,
+                                   const std::string &idColumn,
+                                   ListOfParams &params);
+
+    struct NameIndex;
+
+    // Trigram index of the object names of the database, built at its first
+    // use. It is shared by the contexts of a SharedDatabase.
+    std::shared_ptr<const NameIndex> getNameIndex();
+
+    struct OperationGraph;
+
+    // Graph of the coordinate operations of the database, built at its
+    // first use. It is shared by the contexts of a SharedDatabase.
+    std::shared_ptr<const OperationGraph> getOperationGraph();
+
+    struct CRSFingerprintIndex;
+
+    // Fingerprints of the projected CRS of the database, built at their
+    // first use. They are shared by the contexts of a SharedDatabase.
+    std::shared_ptr<const CRSFingerprintIndex> getCRSFingerprintIndex();
+
     // cppcheck-suppress functionStatic
     common::UnitOfMeasurePtr getUOMFromCache(const std::string &code);
     // cppcheck-suppress functionStatic
@@ -202,6 +258,20 @@ struct DatabaseContext::Private {
     void cache(const std::string &code,
                const std::vector<operation::CoordinateOperationNNPtr> &list);
 
+    // Persistent cache of the results of
+    // AuthorityFactory::createFromCoordinateReferenceSystemCodes(), in the
+    // SQLite file pointed by the PROJ_OPERATION_CACHE environment variable.
+    // Operations are stored as single-line WKT2, with the identifiers of all
+    // their components, and grids as rows of (grid name, "1" or "0") with
+    // the availability of the grids on which their selection depended.
+    bool getCRSToCRSCoordOpFromPersistentCache(
+        const std::string &code,
+        std::vector<operation::CoordinateOperationNNPtr> &list);
+    void cacheInPersistentCache(
+        const std::string &code,
+        const std::vector<operation::CoordinateOperationNNPtr> &list,
+        const SQLResultSet &grids);
+
     struct GridInfoCache {
         std::string fullFilename{};
         std::string packageName{};
@@ -222,23 +292,44 @@ struct DatabaseContext::Private {
 
     std::string databasePath_{};
     bool close_handle_ = true;
-    sqlite3 *sqlite_handle_{};
-    std::map<std::string, sqlite3_stmt *> mapSqlToStatement_{};
+    Connection connection_{};
+    // When set, connections are taken from it rather than connection_,
+    // unless handle() pinned one of them to this context.
+    std::shared_ptr<SharedDatabase> shared_{};
+    Connection *pinnedConnection_ = nullptr;
     PJ_CONTEXT *pjCtxt_ = nullptr;
     int recLevel_ = 0;
     bool detach_ = false;
+    int hasAreaIndex_ = -1;
+    std::shared_ptr<const NameIndex> nameIndex_{};
+    std::shared_ptr<const OperationGraph> operationGraph_{};
+    std::shared_ptr<const CRSFingerprintIndex> crsFingerprintIndex_{};
+    sqlite3 *persistentCache_ = nullptr;
+    bool persistentCacheOpened_ = false;
     std::string lastMetadataValue_{};
     std::map<std::string, std::list<SQLRow>> mapCanonicalizeGRFName_{};
 
-    using LRUCacheOfObjects = lru11::Cache<std::string, util::BaseObjectPtr>;
+    using LRUCacheOfObjects =
+        lru11::Cache<std::string, util::BaseObjectPtr, std::mutex>;
 
     static constexpr size_t CACHE_SIZE = 128;
-    LRUCacheOfObjects cacheUOM_{CACHE_SIZE};
-    LRUCacheOfObjects cacheCRS_{CACHE_SIZE};
-    LRUCacheOfObjects cacheGeodeticDatum_{CACHE_SIZE};
-    LRUCacheOfObjects cachePrimeMeridian_{CACHE_SIZE};
-    LRUCacheOfObjects cacheCS_{CACHE_SIZE};
-    LRUCacheOfObjects cacheExtent_{CACHE_SIZE};
+
+    // Objects built from the database. They are not modified afterwards,
+    // so those caches can be shared by the contexts of a SharedDatabase.
+    struct ObjectCaches {
+        LRUCacheOfObjects cacheUOM_{CACHE_SIZE};
+        LRUCacheOfObjects cacheCRS_{CACHE_SIZE};
+        LRUCacheOfObjects cacheGeodeticDatum_{CACHE_SIZE};
+        LRUCacheOfObjects cachePrimeMeridian_{CACHE_SIZE};
+        LRUCacheOfObjects cacheCS_{CACHE_SIZE};
+        LRUCacheOfObjects cacheExtent_{CACHE_SIZE};
+    };
+    std::shared_ptr<ObjectCaches> objectCaches_{
+        std::make_shared<ObjectCaches>()};
+
+    // Coordinate operations may have their CRS altered by
+    // CoordinateOperationFactory, and grid availability depends on the
+    // PJ_CONTEXT, so those caches are specific to this context.
     lru11::Cache<std::string, std::vector<operation::CoordinateOperationNNPtr>>
         cacheCRSToCrsCoordOp_{CACHE_SIZE};
     lru11::Cache<std::string, GridInfoCache> cacheGridInfo_{CACHE_SIZE};
@@ -250,15 +341,29 @@ struct DatabaseContext::Private {
     static void getFromCache(LRUCacheOfObjects &cache, const std::string &code,
                              util::BaseObjectPtr &obj);
 
+    LRUCacheOfObjects *getObjectCache(CacheType type);
+
     void closeDB();
 
-    // cppcheck-suppress functionStatic
-    void registerFunctions();
+    Connection *acquireConnection();
+    void releaseConnection(Connection *connection);
+
+    static std::string getDatabasePath(const std::string &databasePath);
+    static sqlite3 *openConnection(const std::string &path,
+                                   const char *vfsName);
+    static void closeConnection(Connection &connection);
+
+    bool openPersistentCache();
+    std::string getPersistentCacheFingerprint();
+
+    static void registerFunctions(sqlite3 *handle);
 
 #ifdef ENABLE_CUSTOM_LOCKLESS_VFS
     std::string thisNamePtr_{};
     sqlite3_vfs *vfs_{};
-    bool createCustomVFS();
+    static bool createCustomVFS(const void *owner, std::string &name,
+                                sqlite3_vfs *&vfs);
+    static void destroyCustomVFS(sqlite3_vfs *vfs);
 #endif
 
     Private(const Private &) = delete;
@@ -267,6 +372,209 @@ struct DatabaseContext::Private {
 
 // ---------------------------------------------------------------------------
 
+// Connections to a database and caches of its objects, shared by all the
+// DatabaseContext opening the same file without auxiliary databases, so
+// that memory and warm-up do not grow with the number of contexts, and
+// thus of threads. A connection is used by a single SQLCursor at a time.
+struct DatabaseContext::Private::SharedDatabase {
+    explicit SharedDatabase(const std::string &pathIn) : path(pathIn) {}
+    ~SharedDatabase();
+
+    static std::shared_ptr<SharedDatabase> get(const std::string &path);
+
+    Connection *acquire();
+    void release(Connection *connection);
+
+    const std::string path;
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+    std::string vfsName{};
+    sqlite3_vfs *vfs = nullptr;
+#endif
+    const std::shared_ptr<ObjectCaches> objectCaches{
+        std::make_shared<ObjectCaches>()};
+
+    std::mutex nameIndexMutex{};
+    std::shared_ptr<const NameIndex> nameIndex{};
+
+    std::mutex operationGraphMutex{};
+    std::shared_ptr<const OperationGraph> operationGraph{};
+
+    std::mutex crsFingerprintIndexMutex{};
+    std::shared_ptr<const CRSFingerprintIndex> crsFingerprintIndex{};
+
+  private:
+    std::mutex mutex_{};
+    std::vector<Connection *> idleConnections_{};
+
+    SharedDatabase(const SharedDatabase &) = delete;
+    SharedDatabase &operator=(const SharedDatabase &) = delete;
+};
+
+// ---------------------------------------------------------------------------
+
+// Distinct names of the objects of object_view that can be searched by
+// AuthorityFactory::createObjectsFromName(), with their canonical name, and
+// for each 3 byte sequence of the lower case names and of the canonical
+// names, the sorted indices of the names that contain it. The canonical
+// names are the ones of Identifier::canonicalizeName(), so that approximate
+// name lookups match exactly as when canonicalizing every name, without
+// doing it for each lookup.
+struct DatabaseContext::Private::NameIndex {
+    std::vector<std::string> names{};
+    std::vector<std::string> canonicalNames{};
+    std::map<std::string, std::vector<int>> trigrams{};
+
+    static std::shared_ptr<const NameIndex> build(Private *db);
+
+    // Names that contain searchedName, case insensitively, or whose
+    // canonical name contains canonicalizedSearchedName, sorted by number
+    // of characters and then by name.
+    std::vector<std::string>
+    find(const std::string &searchedName,
+         const std::string &canonicalizedSearchedName) const;
+
+  private:
+    // Sorted indices of the names whose lower case or canonical name may
+    // contain str, which must be in lower case.
+    std::vector<int> getCandidates(const std::string &str) const;
+};
+
+// ---------------------------------------------------------------------------
+
+// Non-deprecated coordinate operations of coordinate_operation_view whose
+// area of use has a bounding box, as edges between their source and target
+// CRS, so that the operations through an intermediate CRS can be found
+// without self-joins of the view. CRS are identified by their index in
+// crsIds, and areas of use by their index in areaIds.
+struct DatabaseContext::Private::OperationGraph {
+    using AuthCode = std::pair<std::string, std::string>;
+
+    struct Operation {
+        std::string tableName{};
+        std::string authName{};
+        std::string code{};
+        double accuracy = -1; // negative when unknown
+        int sourceCRS = -1;
+        int targetCRS = -1;
+        int area = -1;
+        metadata::GeographicBoundingBoxPtr bbox{};
+        // Operations of the same table that supersede this one
+        std::vector<int> replacements{};
+    };
+
+    std::vector<Operation> operations{};
+    std::map<AuthCode, int> crsIds{};
+    std::map<AuthCode, int> areaIds{};
+    // Indices in operations of the operations whose source, respectively
+    // target, is a given CRS.
+    std::vector<std::vector<int>> opsFromCRS{};
+    std::vector<std::vector<int>> opsToCRS{};
+
+    static std::shared_ptr<const OperationGraph> build(Private *db);
+
+    // -1 if not found
+    static int getId(const std::map<AuthCode, int> &ids,
+                     const std::string &authName, const std::string &code) {
+        const auto iter = ids.find(AuthCode(authName, code));
+        return iter == ids.end() ? -1 : iter->second;
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+// Fingerprints of the non-deprecated projected CRS of the database whose
+// method and parameters have EPSG codes. A fingerprint is a canonical string
+// made of the ellipsoid and the prime meridian of the base CRS, of the
+// method, and of the parameters with their values rounded, so that the
+// projected CRS that may be equivalent to a given one are found by a lookup.
+struct DatabaseContext::Private::CRSFingerprintIndex {
+    using AuthCode = std::pair<std::string, std::string>;
+
+    struct Parameter {
+        int code;
+        double siValue;
+        common::UnitOfMeasure::Type type;
+    };
+
+    struct ProjectedCRS {
+        AuthCode crs;
+        AuthCode baseCRS;
+    };
+
+    std::map<std::string, std::vector<ProjectedCRS>> projectedCRS{};
+
+    static std::shared_ptr<const CRSFingerprintIndex> build(Private *db);
+
+    // semiMajorAxis is in metre and pmLongitude in radian. params must
+    // have EPSG codes, and are reordered.
+    static std::string
+    getProjectedCRSFingerprint(double semiMajorAxis, double invFlattening,
+                               double pmLongitude, int methodCode,
+                               std::vector<Parameter> &params);
+
+    // Empty if the method or a parameter has no EPSG code.
+    static std::string getProjectedCRSFingerprint(const crs::ProjectedCRS &crs);
+};
+
+// ---------------------------------------------------------------------------
+
+// Forward-only cursor over the result rows of a query, giving typed access
+// to the columns of the current row. Values are read in place from the
+// SQLite statement, without copying the row: pointers returned by cstr()
+// remain valid until the next call to next(), or the end of the cursor.
+class DatabaseContext::Private::SQLCursor {
+  public:
+    SQLCursor(DatabaseContext::Private *db, const std::string &sql,
+              const ListOfParams &parameters = ListOfParams());
+    SQLCursor(SQLCursor &&other) noexcept;
+    ~SQLCursor();
+
+    bool next();
+
+    int columnCount() const { return sqlite3_column_count(stmt_); }
+
+    bool isNull(int i) const {
+        return sqlite3_column_type(stmt_, i) == SQLITE_NULL;
+    }
+
+    // Empty string for NULL values
+    const char *cstr(int i) const {
+        const char *txt =
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt_, i));
+        return txt ? txt : "";
+    }
+
+    std::string str(int i) const {
+        const char *txt = cstr(i);
+        return std::string(txt, static_cast<size_t>(
+                                    sqlite3_column_bytes(stmt_, i)));
+    }
+
+    bool equals(int i, const char *val) const {
+        return strcmp(cstr(i), val) == 0;
+    }
+
+    double getDouble(int i) const;
+
+    sqlite3_int64 getInt64(int i) const {
+        return sqlite3_column_int64(stmt_, i);
+    }
+
+    bool getBool(int i) const { return getInt64(i) != 0; }
+
+  private:
+    DatabaseContext::Private *db_;
+    DatabaseContext::Private::Connection *connection_ = nullptr;
+    const std::string *sql_ = nullptr;
+    sqlite3_stmt *stmt_ = nullptr;
+    bool *inUse_ = nullptr; // null for a statement not in the cache
+
+    SQLCursor(const SQLCursor &) = delete;
+    SQLCursor &operator=(const SQLCursor &) = delete;
+};
+
+// ---------------------------------------------------------------------------
+
 DatabaseContext::Private::Private() = default;
 
 // ---------------------------------------------------------------------------
@@ -276,11 +584,12 @@ DatabaseContext::Private::~Private() {
 
     closeDB();
 
-#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
-    if (vfs_) {
-        sqlite3_vfs_unregister(vfs_);
-        delete vfs_;
+    if (persistentCache_) {
+        sqlite3_close(persistentCache_);
     }
+
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+    destroyCustomVFS(vfs_);
 #endif
 }
 
@@ -304,15 +613,141 @@ void DatabaseContext::Private::closeDB() {
         detach_ = false;
     }
 
-    for (auto &pair : mapSqlToStatement_) {
-        sqlite3_finalize(pair.second);
+    if (pinnedConnection_) {
+        shared_->release(pinnedConnection_);
+        pinnedConnection_ = nullptr;
+    }
+
+    if (close_handle_) {
+        closeConnection(connection_);
+    } else {
+        // Only finalize our statements on the handle of the caller
+        for (auto &pair : connection_.mapSqlToStatement) {
+            assert(!pair.second.inUse);
+            sqlite3_finalize(pair.second.stmt);
+        }
+        connection_.mapSqlToStatement.clear();
+        connection_.handle = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::closeConnection(Connection &connection) {
+    for (auto &pair : connection.mapSqlToStatement) {
+        assert(!pair.second.inUse);
+        sqlite3_finalize(pair.second.stmt);
+    }
+    connection.mapSqlToStatement.clear();
+
+    if (connection.handle != nullptr) {
+        sqlite3_close(connection.handle);
+        connection.handle = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+sqlite3 *DatabaseContext::Private::handle() {
+    if (shared_) {
+        // The caller may use the handle at any time: dedicate a connection
+        // to this context.
+        if (!pinnedConnection_) {
+            pinnedConnection_ = shared_->acquire();
+        }
+        return pinnedConnection_->handle;
+    }
+    return connection_.handle;
+}
+
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::Connection *
+DatabaseContext::Private::acquireConnection() {
+    if (shared_) {
+        return pinnedConnection_ ? pinnedConnection_ : shared_->acquire();
+    }
+    return &connection_;
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::releaseConnection(Connection *connection) {
+    if (shared_ && connection != pinnedConnection_) {
+        shared_->release(connection);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<DatabaseContext::Private::SharedDatabase>
+DatabaseContext::Private::SharedDatabase::get(const std::string &path) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<SharedDatabase>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto iter = registry.find(path);
+    if (iter != registry.end()) {
+        auto shared = iter->second.lock();
+        if (shared) {
+            return shared;
+        }
+        registry.erase(iter);
+    }
+
+    auto shared = std::make_shared<SharedDatabase>(path);
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+    if (!createCustomVFS(shared.get(), shared->vfsName, shared->vfs)) {
+        throw FactoryException("Open of " + path + " failed");
+    }
+#endif
+    // Open a first connection, so that a wrong path is reported now
+    shared->release(shared->acquire());
+    registry[path] = shared;
+    return shared;
+}
+
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::SharedDatabase::~SharedDatabase() {
+    for (auto connection : idleConnections_) {
+        closeConnection(*connection);
+        delete connection;
     }
-    mapSqlToStatement_.clear();
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+    destroyCustomVFS(vfs);
+#endif
+}
 
-    if (close_handle_ && sqlite_handle_ != nullptr) {
-        sqlite3_close(sqlite_handle_);
-        sqlite_handle_ = nullptr;
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::Connection *
+DatabaseContext::Private::SharedDatabase::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idleConnections_.empty()) {
+            auto connection = idleConnections_.back();
+            idleConnections_.pop_back();
+            return connection;
+        }
     }
+    auto connection = internal::make_unique<Connection>();
+    connection->handle = openConnection(path,
+#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
+                                        vfsName.c_str()
+#else
+                                        nullptr
+#endif
+    );
+    return connection.release();
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::SharedDatabase::release(
+    Connection *connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idleConnections_.push_back(connection);
 }
 
 // ---------------------------------------------------------------------------
@@ -349,9 +784,310 @@ void DatabaseContext::Private::cache(
 
 // ---------------------------------------------------------------------------
 
+// Rows are separated by new lines and fields by tabulations, which are
+// escaped in the values.
+static std::string serializeRows(const SQLResultSet &rows) {
+    std::string res;
+    for (const auto &row : rows) {
+        if (!res.empty()) {
+            res += '\n';
+        }
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (i > 0) {
+                res += '\t';
+            }
+            for (const char ch : row[i]) {
+                if (ch == '\\') {
+                    res += "\\\\";
+                } else if (ch == '\n') {
+                    res += "\\n";
+                } else if (ch == '\t') {
+                    res += "\\t";
+                } else {
+                    res += ch;
+                }
+            }
+        }
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+static std::string unescapeField(const std::string &str) {
+    std::string res;
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '\\' && i + 1 < str.size()) {
+            ++i;
+            res += str[i] == 'n' ? '\n' : str[i] == 't' ? '\t' : str[i];
+        } else {
+            res += str[i];
+        }
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+static SQLResultSet deserializeRows(const std::string &str) {
+    SQLResultSet res;
+    if (str.empty()) {
+        return res;
+    }
+    for (const auto &line : split(str, '\n')) {
+        SQLRow row;
+        for (const auto &field : split(line, '\t')) {
+            row.emplace_back(unescapeField(field));
+        }
+        res.emplace_back(std::move(row));
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string DatabaseContext::Private::getPersistentCacheFingerprint() {
+    // Entries are only valid for the PROJ version and the proj.db content
+    // they were computed with.
+    std::string fingerprint("PROJ ");
+    fingerprint += toString(PROJ_VERSION_MAJOR) + '.' +
+                   toString(PROJ_VERSION_MINOR) + '.' +
+                   toString(PROJ_VERSION_PATCH);
+    fingerprint += '\n';
+    fingerprint += databasePath_;
+
+    // The metadata table is not updated by every change of the file, so
+    // also account for its size, modification time and file change
+    // counter, found at offset 24 of the header of SQLite databases.
+    std::ostringstream buffer;
+    buffer.imbue(std::locale::classic());
+    struct stat fileStat;
+    if (stat(databasePath_.c_str(), &fileStat) == 0) {
+        buffer << '\n'
+               << static_cast<long long>(fileStat.st_size) << ' '
+               << static_cast<long long>(fileStat.st_mtime);
+    }
+    FILE *file = fopen(databasePath_.c_str(), "rb");
+    if (file) {
+        unsigned char header[28];
+        if (fread(header, 1, sizeof(header), file) == sizeof(header)) {
+            buffer << ' '
+                   << ((static_cast<unsigned long>(header[24]) << 24) |
+                       (static_cast<unsigned long>(header[25]) << 16) |
+                       (static_cast<unsigned long>(header[26]) << 8) |
+                       static_cast<unsigned long>(header[27]));
+        }
+        fclose(file);
+    }
+    fingerprint += buffer.str();
+
+    for (const auto &row :
+         run("SELECT key, value FROM metadata ORDER BY key")) {
+        fingerprint += '\n';
+        fingerprint += row[0];
+        fingerprint += '=';
+        fingerprint += row[1];
+    }
+    return fingerprint;
+}
+
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::Private::openPersistentCache() {
+    // Auxiliary databases are not accounted for in the fingerprint
+    if (detach_) {
+        return false;
+    }
+    if (persistentCacheOpened_) {
+        return persistentCache_ != nullptr;
+    }
+    persistentCacheOpened_ = true;
+
+    const char *path = getenv("PROJ_OPERATION_CACHE");
+    if (path == nullptr || path[0] == '\0') {
+        return false;
+    }
+    if (sqlite3_open_v2(path, &persistentCache_,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+                            SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        sqlite3_close(persistentCache_);
+        persistentCache_ = nullptr;
+        return false;
+    }
+    // The file is typically shared by many processes
+    sqlite3_busy_timeout(persistentCache_, 1000);
+
+    bool ok = sqlite3_exec(persistentCache_,
+                           "PRAGMA journal_mode = WAL;"
+                           "CREATE TABLE IF NOT EXISTS metadata("
+                           "key TEXT NOT NULL PRIMARY KEY, "
+                           "value TEXT NOT NULL);"
+                           "CREATE TABLE IF NOT EXISTS crs_to_crs_operations("
+                           "cache_key TEXT NOT NULL PRIMARY KEY, "
+                           "operations TEXT NOT NULL, "
+                           "grids TEXT NOT NULL);",
+                           nullptr, nullptr, nullptr) == SQLITE_OK;
+
+    // Empty the cache if it was filled with another proj.db
+    sqlite3_stmt *stmt = nullptr;
+    const auto fingerprint(getPersistentCacheFingerprint());
+    std::string cachedFingerprint;
+    if (ok &&
+        sqlite3_prepare_v2(persistentCache_,
+                           "SELECT value FROM metadata WHERE key = "
+                           "'fingerprint'",
+                           -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            cachedFingerprint = reinterpret_cast<const char *>(
+                sqlite3_column_text(stmt, 0));
+        }
+    }
+    sqlite3_finalize(stmt);
+    stmt = nullptr;
+    if (ok && cachedFingerprint != fingerprint) {
+        ok = sqlite3_exec(persistentCache_,
+                          "BEGIN IMMEDIATE;"
+                          "DELETE FROM crs_to_crs_operations;",
+                          nullptr, nullptr, nullptr) == SQLITE_OK &&
+             sqlite3_prepare_v2(persistentCache_,
+                                "INSERT OR REPLACE INTO metadata "
+                                "VALUES ('fingerprint', ?)",
+                                -1, &stmt, nullptr) == SQLITE_OK &&
+             sqlite3_bind_text(stmt, 1, fingerprint.c_str(),
+                               static_cast<int>(fingerprint.size()),
+                               SQLITE_TRANSIENT) == SQLITE_OK &&
+             sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_finalize(stmt);
+        ok = sqlite3_exec(persistentCache_, ok ? "COMMIT" : "ROLLBACK",
+                          nullptr, nullptr, nullptr) == SQLITE_OK &&
+             ok;
+    }
+
+    if (!ok) {
+        sqlite3_close(persistentCache_);
+        persistentCache_ = nullptr;
+    }
+    return persistentCache_ != nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::Private::getCRSToCRSCoordOpFromPersistentCache(
+    const std::string &code,
+    std::vector<operation::CoordinateOperationNNPtr> &list) {
+    if (!openPersistentCache()) {
+        return false;
+    }
+    SQLResultSet operations;
+    SQLResultSet grids;
+    sqlite3_stmt *stmt = nullptr;
+    bool found = false;
+    if (sqlite3_prepare_v2(persistentCache_,
+                           "SELECT operations, grids FROM "
+                           "crs_to_crs_operations WHERE cache_key = ?",
+                           -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_bind_text(stmt, 1, code.c_str(),
+                          static_cast<int>(code.size()),
+                          SQLITE_TRANSIENT) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        operations = deserializeRows(
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+        grids = deserializeRows(
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+        found = true;
+    }
+    sqlite3_finalize(stmt);
+    if (!found) {
+        return false;
+    }
+
+    // Nothing is looked up in proj.db: the grids are only searched for in
+    // the PROJ search paths, and the operations parsed from their WKT.
+    if (pjCtxt() == nullptr) {
+        setPjCtxt(pj_get_default_ctx());
+    }
+    std::string fullFilename;
+    for (const auto &row : grids) {
+        if (row.size() != 2) {
+            return false;
+        }
+        fullFilename.resize(2048);
+        const bool gridAvailable =
+            pj_find_file(pjCtxt(), row[0].c_str(), &fullFilename[0],
+                         fullFilename.size() - 1) != 0;
+        if (gridAvailable != (row[1] == "1")) {
+            return false;
+        }
+    }
+    std::vector<operation::CoordinateOperationNNPtr> res;
+    for (const auto &row : operations) {
+        // Entries that cannot be parsed back are computed again
+        try {
+            auto op =
+                util::nn_dynamic_pointer_cast<operation::CoordinateOperation>(
+                    WKTParser().createFromWKT(row[0]));
+            if (!op) {
+                return false;
+            }
+            res.emplace_back(NN_NO_CHECK(op));
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    list = std::move(res);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::cacheInPersistentCache(
+    const std::string &code,
+    const std::vector<operation::CoordinateOperationNNPtr> &list,
+    const SQLResultSet &grids) {
+    if (!openPersistentCache()) {
+        return;
+    }
+    SQLResultSet operations;
+    try {
+        for (const auto &op : list) {
+            auto formatter =
+                WKTFormatter::create(WKTFormatter::Convention::WKT2_2018);
+            formatter->setMultiLine(false);
+            formatter->setOutputIdOnAllNodes(true);
+            operations.emplace_back(SQLRow{op->exportToWKT(formatter.get())});
+        }
+    } catch (const std::exception &) {
+        return;
+    }
+    const auto operationsStr(serializeRows(operations));
+    const auto gridsStr(serializeRows(grids));
+    sqlite3_stmt *stmt = nullptr;
+    // Failures, such as a busy database, are ignored: the entry will be
+    // computed again next time.
+    if (sqlite3_prepare_v2(persistentCache_,
+                           "INSERT OR REPLACE INTO crs_to_crs_operations "
+                           "VALUES (?, ?, ?)",
+                           -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_bind_text(stmt, 1, code.c_str(),
+                          static_cast<int>(code.size()),
+                          SQLITE_TRANSIENT) == SQLITE_OK &&
+        sqlite3_bind_text(stmt, 2, operationsStr.c_str(),
+                          static_cast<int>(operationsStr.size()),
+                          SQLITE_TRANSIENT) == SQLITE_OK &&
+        sqlite3_bind_text(stmt, 3, gridsStr.c_str(),
+                          static_cast<int>(gridsStr.size()),
+                          SQLITE_TRANSIENT) == SQLITE_OK) {
+        sqlite3_step(stmt);
+    }
+    sqlite3_finalize(stmt);
+}
+
+// ---------------------------------------------------------------------------
+
 crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCRS_, code, obj);
+    getFromCache(objectCaches_->cacheCRS_, code, obj);
     return std::static_pointer_cast<crs::CRS>(obj);
 }
 
@@ -359,7 +1095,7 @@ crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const crs::CRSNNPtr &crs) {
-    insertIntoCache(cacheCRS_, code, crs.as_nullable());
+    insertIntoCache(objectCaches_->cacheCRS_, code, crs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -367,7 +1103,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 common::UnitOfMeasurePtr
 DatabaseContext::Private::getUOMFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheUOM_, code, obj);
+    getFromCache(objectCaches_->cacheUOM_, code, obj);
     return std::static_pointer_cast<common::UnitOfMeasure>(obj);
 }
 
@@ -375,7 +1111,7 @@ DatabaseContext::Private::getUOMFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const common::UnitOfMeasureNNPtr &uom) {
-    insertIntoCache(cacheUOM_, code, uom.as_nullable());
+    insertIntoCache(objectCaches_->cacheUOM_, code, uom.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -383,7 +1119,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 datum::GeodeticReferenceFramePtr
 DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheGeodeticDatum_, code, obj);
+    getFromCache(objectCaches_->cacheGeodeticDatum_, code, obj);
     return std::static_pointer_cast<datum::GeodeticReferenceFrame>(obj);
 }
 
@@ -391,7 +1127,8 @@ DatabaseContext::Private::getGeodeticDatumFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(
     const std::string &code, const datum::GeodeticReferenceFrameNNPtr &datum) {
-    insertIntoCache(cacheGeodeticDatum_, code, datum.as_nullable());
+    insertIntoCache(objectCaches_->cacheGeodeticDatum_, code,
+                    datum.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -399,7 +1136,7 @@ void DatabaseContext::Private::cache(
 datum::PrimeMeridianPtr
 DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cachePrimeMeridian_, code, obj);
+    getFromCache(objectCaches_->cachePrimeMeridian_, code, obj);
     return std::static_pointer_cast<datum::PrimeMeridian>(obj);
 }
 
@@ -407,7 +1144,7 @@ DatabaseContext::Private::getPrimeMeridianFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const datum::PrimeMeridianNNPtr &pm) {
-    insertIntoCache(cachePrimeMeridian_, code, pm.as_nullable());
+    insertIntoCache(objectCaches_->cachePrimeMeridian_, code, pm.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -415,7 +1152,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
     const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheCS_, code, obj);
+    getFromCache(objectCaches_->cacheCS_, code, obj);
     return std::static_pointer_cast<cs::CoordinateSystem>(obj);
 }
 
@@ -423,7 +1160,7 @@ cs::CoordinateSystemPtr DatabaseContext::Private::getCoordinateSystemFromCache(
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const cs::CoordinateSystemNNPtr &cs) {
-    insertIntoCache(cacheCS_, code, cs.as_nullable());
+    insertIntoCache(objectCaches_->cacheCS_, code, cs.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -431,7 +1168,7 @@ void DatabaseContext::Private::cache(const std::string &code,
 metadata::ExtentPtr
 DatabaseContext::Private::getExtentFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
-    getFromCache(cacheExtent_, code, obj);
+    getFromCache(objectCaches_->cacheExtent_, code, obj);
     return std::static_pointer_cast<metadata::Extent>(obj);
 }
 
@@ -439,7 +1176,7 @@ DatabaseContext::Private::getExtentFromCache(const std::string &code) {
 
 void DatabaseContext::Private::cache(const std::string &code,
                                      const metadata::ExtentNNPtr &extent) {
-    insertIntoCache(cacheExtent_, code, extent.as_nullable());
+    insertIntoCache(objectCaches_->cacheExtent_, code, extent.as_nullable());
 }
 
 // ---------------------------------------------------------------------------
@@ -518,20 +1255,22 @@ static int VFSAccess(sqlite3_vfs *vfs, const char *zName, int flags,
 
 // ---------------------------------------------------------------------------
 
-bool DatabaseContext::Private::createCustomVFS() {
+bool DatabaseContext::Private::createCustomVFS(const void *owner,
+                                               std::string &name,
+                                               sqlite3_vfs *&vfs_) {
 
     sqlite3_vfs *defaultVFS = sqlite3_vfs_find(nullptr);
     assert(defaultVFS);
 
     std::ostringstream buffer;
-    buffer << this;
-    thisNamePtr_ = buffer.str();
+    buffer << owner;
+    name = buffer.str();
 
     vfs_ = new sqlite3_vfs();
     vfs_->iVersion = 1;
     vfs_->szOsFile = defaultVFS->szOsFile + sizeof(ClosePtr);
     vfs_->mxPathname = defaultVFS->mxPathname;
-    vfs_->zName = thisNamePtr_.c_str();
+    vfs_->zName = name.c_str();
     vfs_->pAppData = defaultVFS;
     vfs_->xOpen = VFSOpen;
     vfs_->xDelete = defaultVFS->xDelete;
@@ -549,11 +1288,21 @@ bool DatabaseContext::Private::createCustomVFS() {
     return sqlite3_vfs_register(vfs_, false) == SQLITE_OK;
 }
 
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::destroyCustomVFS(sqlite3_vfs *vfs) {
+    if (vfs) {
+        sqlite3_vfs_unregister(vfs);
+        delete vfs;
+    }
+}
+
 #endif // ENABLE_CUSTOM_LOCKLESS_VFS
 
 // ---------------------------------------------------------------------------
 
-void DatabaseContext::Private::open(const std::string &databasePath) {
+std::string
+DatabaseContext::Private::getDatabasePath(const std::string &databasePath) {
     std::string path(databasePath);
     if (path.empty()) {
         const char *proj_lib = std::getenv("PROJ_LIB");
@@ -568,25 +1317,51 @@ void DatabaseContext::Private::open(const std::string &databasePath) {
         }
         path = std::string(proj_lib) + DIR_CHAR + "proj.db";
     }
+    return path;
+}
 
-    if (
-#ifdef ENABLE_CUSTOM_LOCKLESS_VFS
-        !createCustomVFS() ||
-#endif
-        sqlite3_open_v2(path.c_str(), &sqlite_handle_,
+// ---------------------------------------------------------------------------
+
+sqlite3 *DatabaseContext::Private::openConnection(const std::string &path,
+                                                  const char *vfsName) {
+    sqlite3 *handle = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &handle,
                         SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                        vfsName) != SQLITE_OK ||
+        !handle) {
+        if (handle) {
+            sqlite3_close(handle);
+        }
+        throw FactoryException("Open of " + path + " failed");
+    }
+    registerFunctions(handle);
+    return handle;
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::open(const std::string &databasePath) {
+    std::string path(getDatabasePath(databasePath));
+
 #ifdef ENABLE_CUSTOM_LOCKLESS_VFS
-                        thisNamePtr_.c_str()
-#else
-                        nullptr
-#endif
-                            ) != SQLITE_OK ||
-        !sqlite_handle_) {
+    if (!createCustomVFS(this, thisNamePtr_, vfs_)) {
         throw FactoryException("Open of " + path + " failed");
     }
+    connection_.handle = openConnection(path, thisNamePtr_.c_str());
+#else
+    connection_.handle = openConnection(path, nullptr);
+#endif
 
     databasePath_ = path;
-    registerFunctions();
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::Private::openShared(const std::string &databasePath) {
+    std::string path(getDatabasePath(databasePath));
+    shared_ = SharedDatabase::get(path);
+    objectCaches_ = shared_->objectCaches;
+    databasePath_ = path;
 }
 
 // ---------------------------------------------------------------------------
@@ -594,18 +1369,22 @@ void DatabaseContext::Private::open(const std::string &databasePath) {
 void DatabaseContext::Private::setHandle(sqlite3 *sqlite_handle) {
 
     assert(sqlite_handle);
-    assert(!sqlite_handle_);
-    sqlite_handle_ = sqlite_handle;
+    assert(!connection_.handle);
+    connection_.handle = sqlite_handle;
     close_handle_ = false;
 
-    registerFunctions();
+    registerFunctions(sqlite_handle);
 }
 
 // ---------------------------------------------------------------------------
 
 std::vector<std::string> DatabaseContext::Private::getDatabaseStructure() {
+    // The area index is derived from the other tables when building
+    // proj.db, and is not maintained when inserting into them.
     auto sqlRes = run("SELECT sql FROM sqlite_master WHERE type "
-                      "IN ('table', 'trigger', 'view') ORDER BY type");
+                      "IN ('table', 'trigger', 'view') AND "
+                      "name <> 'area_index' AND name NOT LIKE 'area_rtree%' "
+                      "ORDER BY type");
     std::vector<std::string> res;
     for (const auto &row : sqlRes) {
         res.emplace_back(row[0]);
@@ -618,7 +1397,7 @@ std::vector<std::string> DatabaseContext::Private::getDatabaseStructure() {
 void DatabaseContext::Private::attachExtraDatabases(
     const std::vector<std::string> &auxiliaryDatabasePaths) {
     assert(close_handle_);
-    assert(sqlite_handle_);
+    assert(connection_.handle);
 
     auto tables =
         run("SELECT name FROM sqlite_master WHERE type IN ('table', 'view')");
@@ -635,14 +1414,14 @@ void DatabaseContext::Private::attachExtraDatabases(
 
     closeDB();
 
-    sqlite3_open_v2(":memory:", &sqlite_handle_,
+    sqlite3_open_v2(":memory:", &connection_.handle,
                     SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX
 #ifdef SQLITE_OPEN_URI
                         | SQLITE_OPEN_URI
 #endif
                     ,
                     nullptr);
-    if (!sqlite_handle_) {
+    if (!connection_.handle) {
         throw FactoryException("cannot create in memory database");
     }
 
@@ -693,7 +1472,7 @@ void DatabaseContext::Private::attachExtraDatabases(
         run(sql);
     }
 
-    registerFunctions();
+    registerFunctions(connection_.handle);
 }
 
 // ---------------------------------------------------------------------------
@@ -769,76 +1548,433 @@ static void PROJ_SQLITE_intersects_bbox(sqlite3_context *pContext,
 #define SQLITE_DETERMINISTIC 0
 #endif
 
-void DatabaseContext::Private::registerFunctions() {
-    sqlite3_create_function(sqlite_handle_, "pseudo_area_from_swne", 4,
+void DatabaseContext::Private::registerFunctions(sqlite3 *handle) {
+    sqlite3_create_function(handle, "pseudo_area_from_swne", 4,
                             SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr,
                             PROJ_SQLITE_pseudo_area_from_swne, nullptr,
                             nullptr);
 
-    sqlite3_create_function(sqlite_handle_, "intersects_bbox", 8,
+    sqlite3_create_function(handle, "intersects_bbox", 8,
                             SQLITE_UTF8 | SQLITE_DETERMINISTIC, nullptr,
                             PROJ_SQLITE_intersects_bbox, nullptr, nullptr);
 }
 
 // ---------------------------------------------------------------------------
 
-SQLResultSet DatabaseContext::Private::run(const std::string &sql,
-                                           const ListOfParams &parameters) {
-
-    sqlite3_stmt *stmt = nullptr;
-    auto iter = mapSqlToStatement_.find(sql);
-    if (iter != mapSqlToStatement_.end()) {
-        stmt = iter->second;
-        sqlite3_reset(stmt);
-    } else {
-        if (sqlite3_prepare_v2(sqlite_handle_, sql.c_str(),
-                               static_cast<int>(sql.size()), &stmt,
+DatabaseContext::Private::SQLCursor::SQLCursor(
+    DatabaseContext::Private *db, const std::string &sql,
+    const ListOfParams &parameters)
+    : db_(db), connection_(db->acquireConnection()) {
+
+    auto &mapSqlToStatement = connection_->mapSqlToStatement;
+    auto iter = mapSqlToStatement.find(sql);
+    if (iter == mapSqlToStatement.end()) {
+        iter = mapSqlToStatement
+                   .emplace(sql, DatabaseContext::Private::CachedStatement())
+                   .first;
+    }
+    auto &entry = iter->second;
+    sql_ = &iter->first;
+    if (entry.stmt == nullptr || entry.inUse) {
+        // Not prepared yet, or already iterated over by an enclosing
+        // query of the same SQL: prepare a statement of our own.
+        if (sqlite3_prepare_v2(connection_->handle, sql.c_str(),
+                               static_cast<int>(sql.size()), &stmt_,
                                nullptr) != SQLITE_OK) {
-            throw FactoryException("SQLite error on " + sql + ": " +
-                                   sqlite3_errmsg(sqlite_handle_));
+            sqlite3_finalize(stmt_);
+            const std::string msg(sqlite3_errmsg(connection_->handle));
+            db_->releaseConnection(connection_);
+            throw FactoryException("SQLite error on " + sql + ": " + msg);
         }
-        mapSqlToStatement_.insert(
-            std::pair<std::string, sqlite3_stmt *>(sql, stmt));
+        if (entry.stmt == nullptr) {
+            entry.stmt = stmt_;
+        }
+    } else {
+        stmt_ = entry.stmt;
+    }
+    if (entry.stmt == stmt_) {
+        entry.inUse = true;
+        inUse_ = &entry.inUse;
     }
 
     int nBindField = 1;
     for (const auto &param : parameters) {
         if (param.type() == SQLValues::Type::STRING) {
-            auto strValue = param.stringValue();
-            sqlite3_bind_text(stmt, nBindField, strValue.c_str(),
+            const auto &strValue = param.stringValue();
+            sqlite3_bind_text(stmt_, nBindField, strValue.c_str(),
                               static_cast<int>(strValue.size()),
                               SQLITE_TRANSIENT);
         } else {
             assert(param.type() == SQLValues::Type::DOUBLE);
-            sqlite3_bind_double(stmt, nBindField, param.doubleValue());
+            sqlite3_bind_double(stmt_, nBindField, param.doubleValue());
         }
         nBindField++;
     }
+}
 
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::SQLCursor::SQLCursor(SQLCursor &&other) noexcept
+    : db_(other.db_), connection_(other.connection_), sql_(other.sql_),
+      stmt_(other.stmt_), inUse_(other.inUse_) {
+    other.connection_ = nullptr;
+    other.stmt_ = nullptr;
+    other.inUse_ = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::SQLCursor::~SQLCursor() {
+    if (connection_ == nullptr) {
+        return;
+    }
+    if (inUse_) {
+        // Back to the cache, without holding a read transaction
+        sqlite3_reset(stmt_);
+        *inUse_ = false;
+    } else {
+        sqlite3_finalize(stmt_);
+    }
+    db_->releaseConnection(connection_);
+}
+
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::Private::SQLCursor::next() {
+    int ret = sqlite3_step(stmt_);
+    if (ret == SQLITE_ROW) {
+        return true;
+    }
+    if (ret == SQLITE_DONE) {
+        return false;
+    }
+    throw FactoryException("SQLite error on " + *sql_ + ": " +
+                           sqlite3_errmsg(connection_->handle));
+}
+
+// ---------------------------------------------------------------------------
+
+double DatabaseContext::Private::SQLCursor::getDouble(int i) const {
+    if (isNull(i)) {
+        throw FactoryException("NULL value in column " + toString(i) +
+                               " of " + *sql_);
+    }
+    return sqlite3_column_double(stmt_, i);
+}
+
+// ---------------------------------------------------------------------------
+
+SQLResultSet DatabaseContext::Private::run(const std::string &sql,
+                                           const ListOfParams &parameters) {
+
+    SQLCursor cursor(this, sql, parameters);
     SQLResultSet result;
-    const int column_count = sqlite3_column_count(stmt);
-    while (true) {
-        int ret = sqlite3_step(stmt);
-        if (ret == SQLITE_ROW) {
-            SQLRow row(column_count);
-            for (int i = 0; i < column_count; i++) {
-                const char *txt = reinterpret_cast<const char *>(
-                    sqlite3_column_text(stmt, i));
-                if (txt) {
-                    row[i] = txt;
-                }
+    const int column_count = cursor.columnCount();
+    while (cursor.next()) {
+        SQLRow row(column_count);
+        for (int i = 0; i < column_count; i++) {
+            if (!cursor.isNull(i)) {
+                row[i] = cursor.str(i);
             }
-            result.emplace_back(std::move(row));
-        } else if (ret == SQLITE_DONE) {
-            break;
-        } else {
-            throw FactoryException("SQLite error on " + sql + ": " +
-                                   sqlite3_errmsg(sqlite_handle_));
         }
+        result.emplace_back(std::move(row));
     }
     return result;
 }
 
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::Private::hasAreaIndex() {
+    // area_index.id values are only unique within a database.
+    if (detach_) {
+        return false;
+    }
+    if (hasAreaIndex_ < 0) {
+        try {
+            // Also checks that SQLite has been built with R*Tree support
+            run("SELECT 1 FROM area_rtree LIMIT 0");
+            hasAreaIndex_ = 1;
+        } catch (const FactoryException &) {
+            hasAreaIndex_ = 0;
+        }
+    }
+    return hasAreaIndex_ == 1;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string DatabaseContext::Private::getAreaIndexFilter(
+    const metadata::Extent &areaOfInterest, const std::string &idColumn,
+    ListOfParams &params) {
+    std::string sql;
+    const auto addBox = [&sql, &params](double west, double south,
+                                        double east, double north) {
+        sql += sql.empty() ? "SELECT id / 2 FROM area_rtree WHERE "
+                           : " UNION SELECT id / 2 FROM area_rtree WHERE ";
+        sql += "max_lon >= ? AND min_lon <= ? AND "
+               "max_lat >= ? AND min_lat <= ?";
+        params.emplace_back(west);
+        params.emplace_back(east);
+        params.emplace_back(south);
+        params.emplace_back(north);
+    };
+    for (const auto &geogElt : areaOfInterest.geographicElements()) {
+        auto bbox = dynamic_cast<const metadata::GeographicBoundingBox *>(
+            geogElt.get());
+        if (!bbox) {
+            continue;
+        }
+        const double west = bbox->westBoundLongitude();
+        const double south = bbox->southBoundLatitude();
+        const double east = bbox->eastBoundLongitude();
+        const double north = bbox->northBoundLatitude();
+        if (west <= east) {
+            addBox(west, south, east, north);
+        } else {
+            // Crossing the antimeridian
+            addBox(west, south, 180, north);
+            addBox(-180, south, east, north);
+        }
+    }
+    if (sql.empty()) {
+        return sql;
+    }
+    return idColumn + " IN (" + sql + ")";
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::NameIndex>
+DatabaseContext::Private::NameIndex::build(Private *db) {
+    auto index = std::make_shared<NameIndex>();
+    const auto addTrigrams = [](const std::string &str,
+                                std::set<std::string> &trigrams) {
+        for (size_t i = 0; i + 3 <= str.size(); ++i) {
+            trigrams.insert(str.substr(i, 3));
+        }
+    };
+
+    SQLCursor cursor(db, "SELECT DISTINCT name FROM object_view WHERE "
+                         "table_name IN ("
+                         "'prime_meridian','ellipsoid','geodetic_datum',"
+                         "'vertical_datum','geodetic_crs','projected_crs',"
+                         "'vertical_crs','compound_crs','conversion',"
+                         "'helmert_transformation','grid_transformation',"
+                         "'other_transformation','concatenated_operation')");
+    std::set<std::string> nameTrigrams;
+    while (cursor.next()) {
+        const int id = static_cast<int>(index->names.size());
+        index->names.emplace_back(cursor.str(0));
+        const auto &name = index->names.back();
+        index->canonicalNames.emplace_back(
+            metadata::Identifier::canonicalizeName(name));
+        nameTrigrams.clear();
+        addTrigrams(tolower(name), nameTrigrams);
+        addTrigrams(index->canonicalNames.back(), nameTrigrams);
+        for (const auto &trigram : nameTrigrams) {
+            index->trigrams[trigram].push_back(id);
+        }
+    }
+    return index;
+}
+
+// ---------------------------------------------------------------------------
+
+std::vector<int> DatabaseContext::Private::NameIndex::getCandidates(
+    const std::string &str) const {
+    std::vector<int> candidates;
+    if (str.size() < 3) {
+        candidates.resize(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            candidates[i] = static_cast<int>(i);
+        }
+        return candidates;
+    }
+
+    // Intersect the lists of indices of all the trigrams of str
+    std::vector<const std::vector<int> *> lists;
+    for (size_t i = 0; i + 3 <= str.size(); ++i) {
+        const auto iter = trigrams.find(str.substr(i, 3));
+        if (iter == trigrams.end()) {
+            // The trigram is in no name
+            return candidates;
+        }
+        lists.push_back(&iter->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int> *a, const std::vector<int> *b) {
+                  return a->size() < b->size();
+              });
+    candidates = *lists[0];
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        std::vector<int> intersection;
+        std::set_intersection(candidates.begin(), candidates.end(),
+                              lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(intersection));
+        candidates = std::move(intersection);
+    }
+    return candidates;
+}
+
+// ---------------------------------------------------------------------------
+
+std::vector<std::string> DatabaseContext::Private::NameIndex::find(
+    const std::string &searchedName,
+    const std::string &canonicalizedSearchedName) const {
+    const auto nameCandidates(getCandidates(tolower(searchedName)));
+    const auto canonicalNameCandidates(
+        getCandidates(canonicalizedSearchedName));
+    std::vector<int> candidates;
+    std::set_union(nameCandidates.begin(), nameCandidates.end(),
+                   canonicalNameCandidates.begin(),
+                   canonicalNameCandidates.end(),
+                   std::back_inserter(candidates));
+
+    std::vector<std::string> res;
+    for (const auto id : candidates) {
+        if (ci_find(names[id], searchedName) != std::string::npos ||
+            ci_find(canonicalNames[id], canonicalizedSearchedName) !=
+                std::string::npos) {
+            res.emplace_back(names[id]);
+        }
+    }
+    // As ORDER BY length(name), name: length() counts UTF-8 characters
+    const auto length = [](const std::string &str) {
+        size_t count = 0;
+        for (const char ch : str) {
+            if ((static_cast<unsigned char>(ch) & 0xC0) != 0x80) {
+                ++count;
+            }
+        }
+        return count;
+    };
+    std::sort(res.begin(), res.end(),
+              [&length](const std::string &a, const std::string &b) {
+                  const auto aLength = length(a);
+                  const auto bLength = length(b);
+                  return aLength < bLength || (aLength == bLength && a < b);
+              });
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::NameIndex>
+DatabaseContext::Private::getNameIndex() {
+    if (!nameIndex_) {
+        if (shared_) {
+            std::lock_guard<std::mutex> lock(shared_->nameIndexMutex);
+            if (!shared_->nameIndex) {
+                shared_->nameIndex = NameIndex::build(this);
+            }
+            nameIndex_ = shared_->nameIndex;
+        } else {
+            nameIndex_ = NameIndex::build(this);
+        }
+    }
+    return nameIndex_;
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::OperationGraph>
+DatabaseContext::Private::OperationGraph::build(Private *db) {
+    auto graph = std::make_shared<OperationGraph>();
+    const auto getOrCreateId = [](std::map<AuthCode, int> &ids,
+                                  const char *authName, const char *code) {
+        return ids
+            .emplace(AuthCode(authName, code), static_cast<int>(ids.size()))
+            .first->second;
+    };
+
+    std::map<std::pair<std::string, AuthCode>, int> mapOpToIndex;
+    SQLCursor cursor(
+        db, "SELECT v.table_name, v.auth_name, v.code, v.accuracy, "
+            "v.source_crs_auth_name, v.source_crs_code, "
+            "v.target_crs_auth_name, v.target_crs_code, "
+            "a.auth_name, a.code, "
+            "a.south_lat, a.west_lon, a.north_lat, a.east_lon "
+            "FROM coordinate_operation_view v "
+            "JOIN area a ON v.area_of_use_auth_name = a.auth_name "
+            "AND v.area_of_use_code = a.code "
+            "WHERE v.deprecated = 0 AND a.south_lat IS NOT NULL "
+            "AND a.west_lon IS NOT NULL AND a.north_lat IS NOT NULL "
+            "AND a.east_lon IS NOT NULL");
+    while (cursor.next()) {
+        Operation op;
+        op.tableName = cursor.str(0);
+        op.authName = cursor.str(1);
+        op.code = cursor.str(2);
+        if (!cursor.isNull(3)) {
+            op.accuracy = cursor.getDouble(3);
+        }
+        op.sourceCRS =
+            getOrCreateId(graph->crsIds, cursor.cstr(4), cursor.cstr(5));
+        op.targetCRS =
+            getOrCreateId(graph->crsIds, cursor.cstr(6), cursor.cstr(7));
+        op.area = getOrCreateId(graph->areaIds, cursor.cstr(8), cursor.cstr(9));
+        op.bbox = metadata::GeographicBoundingBox::create(
+                      cursor.getDouble(11), cursor.getDouble(10),
+                      cursor.getDouble(13), cursor.getDouble(12))
+                      .as_nullable();
+        mapOpToIndex[std::pair<std::string, AuthCode>(
+            op.tableName, AuthCode(op.authName, op.code))] =
+            static_cast<int>(graph->operations.size());
+        graph->operations.emplace_back(std::move(op));
+    }
+
+    SQLCursor cursorSupersession(
+        db, "SELECT superseded_table_name, superseded_auth_name, "
+            "superseded_code, replacement_auth_name, replacement_code "
+            "FROM supersession "
+            "WHERE superseded_table_name = replacement_table_name");
+    while (cursorSupersession.next()) {
+        const auto tableName = cursorSupersession.str(0);
+        const auto iterSuperseded =
+            mapOpToIndex.find(std::pair<std::string, AuthCode>(
+                tableName, AuthCode(cursorSupersession.str(1),
+                                    cursorSupersession.str(2))));
+        const auto iterReplacement =
+            mapOpToIndex.find(std::pair<std::string, AuthCode>(
+                tableName, AuthCode(cursorSupersession.str(3),
+                                    cursorSupersession.str(4))));
+        // Deprecated replacements never compete with the superseded
+        // operation
+        if (iterSuperseded != mapOpToIndex.end() &&
+            iterReplacement != mapOpToIndex.end()) {
+            graph->operations[iterSuperseded->second].replacements.push_back(
+                iterReplacement->second);
+        }
+    }
+
+    graph->opsFromCRS.resize(graph->crsIds.size());
+    graph->opsToCRS.resize(graph->crsIds.size());
+    for (size_t i = 0; i < graph->operations.size(); ++i) {
+        const auto &op = graph->operations[i];
+        graph->opsFromCRS[op.sourceCRS].push_back(static_cast<int>(i));
+        graph->opsToCRS[op.targetCRS].push_back(static_cast<int>(i));
+    }
+    return graph;
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::OperationGraph>
+DatabaseContext::Private::getOperationGraph() {
+    if (!operationGraph_) {
+        if (shared_) {
+            std::lock_guard<std::mutex> lock(shared_->operationGraphMutex);
+            if (!shared_->operationGraph) {
+                shared_->operationGraph = OperationGraph::build(this);
+            }
+            operationGraph_ = shared_->operationGraph;
+        } else {
+            operationGraph_ = OperationGraph::build(this);
+        }
+    }
+    return operationGraph_;
+}
+
 //! @endcond
 
 // ---------------------------------------------------------------------------
@@ -860,6 +1996,9 @@ DatabaseContext::DatabaseContext() : d(internal::make_unique<Private>()) {}
  * the pkgdatadir directory of the installation prefix.
  *
  * This database context should be used only by one thread at a time.
+ * Database contexts opening the same file share their SQLite connections and
+ * their cache of objects (CRS, datums, ...), so that creating one per thread
+ * is cheap.
  * @throw FactoryException
  */
 DatabaseContextNNPtr DatabaseContext::create() {
@@ -871,6 +2010,9 @@ DatabaseContextNNPtr DatabaseContext::create() {
 /** \brief Instanciate a database context from a full filename.
  *
  * This database context should be used only by one thread at a time.
+ * Database contexts opening the same file share their SQLite connections and
+ * their cache of objects (CRS, datums, ...), so that creating one per thread
+ * is cheap.
  * @param databasePath Path and filename of the database. Might be empty
  * string for the default rules to locate the default proj.db
  * @throw FactoryException
@@ -894,8 +2036,10 @@ DatabaseContextNNPtr DatabaseContext::create(
     const std::string &databasePath,
     const std::vector<std::string> &auxiliaryDatabasePaths) {
     auto ctxt = DatabaseContext::nn_make_shared<DatabaseContext>();
-    ctxt->getPrivate()->open(databasePath);
-    if (!auxiliaryDatabasePaths.empty()) {
+    if (auxiliaryDatabasePaths.empty()) {
+        ctxt->getPrivate()->openShared(databasePath);
+    } else {
+        ctxt->getPrivate()->open(databasePath);
         ctxt->getPrivate()->attachExtraDatabases(auxiliaryDatabasePaths);
     }
     return ctxt;
@@ -918,6 +2062,9 @@ std::set<std::string> DatabaseContext::getAuthorities() const {
 
 /** \brief Return the list of SQL commands (CREATE TABLE, CREATE TRIGGER,
  * CREATE VIEW) needed to initialize a new database.
+ *
+ * The name search index of proj.db, which is built from the content of the
+ * other tables, is not part of it.
  */
 std::vector<std::string> DatabaseContext::getDatabaseStructure() const {
     return d->getDatabaseStructure();
@@ -957,8 +2104,12 @@ DatabaseContextNNPtr DatabaseContext::create(void *sqlite_handle) {
 
 // ---------------------------------------------------------------------------
 
+// The handle stays usable as long as the context. When the context shares
+// the connections of its database, the one returned is taken out of the
+// pool for the rest of the life of the context, and all the queries of the
+// context then go through it.
 void *DatabaseContext::getSqliteHandle() const {
-    return getPrivate()->handle();
+    return d->handle();
 }
 
 // ---------------------------------------------------------------------------
@@ -1192,6 +2343,65 @@ DatabaseContext::getNonDeprecated(const std::string &tableName,
     return res;
 }
 
+// ---------------------------------------------------------------------------
+
+DatabaseContext::Private::LRUCacheOfObjects *
+DatabaseContext::Private::getObjectCache(CacheType type) {
+    switch (type) {
+    case CacheType::UNIT_OF_MEASURE:
+        return &objectCaches_->cacheUOM_;
+    case CacheType::CRS:
+        return &objectCaches_->cacheCRS_;
+    case CacheType::GEODETIC_DATUM:
+        return &objectCaches_->cacheGeodeticDatum_;
+    case CacheType::PRIME_MERIDIAN:
+        return &objectCaches_->cachePrimeMeridian_;
+    case CacheType::COORDINATE_SYSTEM:
+        return &objectCaches_->cacheCS_;
+    case CacheType::EXTENT:
+        return &objectCaches_->cacheExtent_;
+    case CacheType::GRID_INFO:
+    case CacheType::CRS_TO_CRS_OPERATIONS:
+        break;
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+// Set the maximum number of entries of a cache, 0 meaning unbounded.
+// The caches of objects are shared by the contexts opening the same database
+// without auxiliary databases, and so is their size.
+void DatabaseContext::setCacheSize(CacheType type, size_t maxSize) {
+    auto objectCache = d->getObjectCache(type);
+    if (objectCache) {
+        objectCache->setMaxSize(maxSize);
+    } else if (type == CacheType::GRID_INFO) {
+        d->cacheGridInfo_.setMaxSize(maxSize);
+    } else {
+        d->cacheCRSToCrsCoordOp_.setMaxSize(maxSize);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+DatabaseContext::CacheStats
+DatabaseContext::getCacheStats(CacheType type) const {
+    auto objectCache = d->getObjectCache(type);
+    const auto stats =
+        objectCache ? objectCache->getStats()
+                    : type == CacheType::GRID_INFO
+                          ? d->cacheGridInfo_.getStats()
+                          : d->cacheCRSToCrsCoordOp_.getStats();
+    CacheStats res;
+    res.maxSize = stats.maxSize;
+    res.size = stats.size;
+    res.hits = stats.hits;
+    res.misses = stats.misses;
+    res.evictions = stats.evictions;
+    return res;
+}
+
 //! @endcond
 
 // ---------------------------------------------------------------------------
@@ -1223,8 +2433,12 @@ struct AuthorityFactory::Private {
         return AuthorityFactory::create(context_, auth_name);
     }
 
-    bool rejectOpDueToMissingGrid(const operation::CoordinateOperationNNPtr &op,
-                                  bool discardIfMissingGrid);
+    // If gridsChecked is not null, the grids looked at to take the decision
+    // are added to it, with their availability.
+    bool rejectOpDueToMissingGrid(
+        const operation::CoordinateOperationNNPtr &op,
+        bool discardIfMissingGrid,
+        std::set<std::pair<std::string, bool>> *gridsChecked = nullptr);
 
     UnitOfMeasure createUnitOfMeasure(const std::string &auth_name,
                                       const std::string &code);
@@ -1246,6 +2460,44 @@ struct AuthorityFactory::Private {
 
     SQLResultSet runWithCodeParam(const char *sql, const std::string &code);
 
+    using SQLCursor = DatabaseContext::Private::SQLCursor;
+
+    SQLCursor cursor(const std::string &sql,
+                     const ListOfParams &parameters = ListOfParams());
+
+    SQLCursor cursorWithCodeParam(const std::string &sql,
+                                  const std::string &code);
+
+    // Calls onRow for each row of sqlPrefix + "(?, ...)" + sqlSuffix, whose
+    // parameters are params followed by codes. The codes are queried by
+    // chunks, to stay below the SQLite limit on the number of parameters.
+    void forEachRowWithCodes(const std::string &sqlPrefix,
+                             const ListOfParams &params,
+                             const std::vector<std::string> &codes,
+                             const std::string &sqlSuffix,
+                             const std::function<void(SQLCursor &)> &onRow);
+
+    // Build an object from the current row of a query selecting the
+    // columns of the matching SQL_SELECT_XXX statement.
+    metadata::ExtentNNPtr createExtent(const SQLCursor &cursor,
+                                       const std::string &code);
+    operation::ConversionNNPtr createConversion(const SQLCursor &cursor,
+                                                const std::string &code);
+    crs::GeodeticCRSNNPtr createGeodeticCRS(const SQLCursor &cursor,
+                                            const std::string &code);
+    crs::VerticalCRSNNPtr createVerticalCRS(const SQLCursor &cursor,
+                                            const std::string &code);
+    crs::ProjectedCRSNNPtr createProjectedCRS(const SQLCursor &cursor,
+                                              const std::string &code);
+    crs::CompoundCRSNNPtr createCompoundCRS(const SQLCursor &cursor,
+                                            const std::string &code);
+
+    // Objects built by AuthorityFactory::createCoordinateReferenceSystems()
+    // from set-based queries, used instead of querying them one by one.
+    std::map<std::string, metadata::ExtentNNPtr> bulkExtents_{};
+    std::map<std::string, operation::ConversionNNPtr> bulkConversions_{};
+    std::map<std::string, crs::CRSNNPtr> bulkCRS_{};
+
     bool hasAuthorityRestriction() const {
         return !authority_.empty() && authority_ != "any";
     }
@@ -1281,6 +2533,47 @@ AuthorityFactory::Private::runWithCodeParam(const char *sql,
 
 // ---------------------------------------------------------------------------
 
+AuthorityFactory::Private::SQLCursor
+AuthorityFactory::Private::cursor(const std::string &sql,
+                                  const ListOfParams &parameters) {
+    return SQLCursor(context()->getPrivate(), sql, parameters);
+}
+
+// ---------------------------------------------------------------------------
+
+AuthorityFactory::Private::SQLCursor
+AuthorityFactory::Private::cursorWithCodeParam(const std::string &sql,
+                                               const std::string &code) {
+    return cursor(sql, {authority(), code});
+}
+
+// ---------------------------------------------------------------------------
+
+void AuthorityFactory::Private::forEachRowWithCodes(
+    const std::string &sqlPrefix, const ListOfParams &params,
+    const std::vector<std::string> &codes, const std::string &sqlSuffix,
+    const std::function<void(SQLCursor &)> &onRow) {
+    constexpr size_t CHUNK_SIZE = 500;
+    for (size_t i = 0; i < codes.size(); i += CHUNK_SIZE) {
+        const size_t count = std::min(CHUNK_SIZE, codes.size() - i);
+        std::string sql(sqlPrefix);
+        sql += '(';
+        auto chunkParams(params);
+        for (size_t j = 0; j < count; ++j) {
+            sql += j == 0 ? "?" : ",?";
+            chunkParams.emplace_back(codes[i + j]);
+        }
+        sql += ')';
+        sql += sqlSuffix;
+        auto chunkCursor = cursor(sql, chunkParams);
+        while (chunkCursor.next()) {
+            onRow(chunkCursor);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 UnitOfMeasure
 AuthorityFactory::Private::createUnitOfMeasure(const std::string &auth_name,
                                                const std::string &code) {
@@ -1324,9 +2617,14 @@ util::PropertyMap AuthorityFactory::Private::createProperties(
 // ---------------------------------------------------------------------------
 
 bool AuthorityFactory::Private::rejectOpDueToMissingGrid(
-    const operation::CoordinateOperationNNPtr &op, bool discardIfMissingGrid) {
+    const operation::CoordinateOperationNNPtr &op, bool discardIfMissingGrid,
+    std::set<std::pair<std::string, bool>> *gridsChecked) {
     if (discardIfMissingGrid) {
         for (const auto &gridDesc : op->gridsNeeded(context())) {
+            if (gridsChecked) {
+                gridsChecked->insert(
+                    std::make_pair(gridDesc.shortName, gridDesc.available));
+            }
             if (!gridDesc.available) {
                 return true;
             }
@@ -1490,6 +2788,40 @@ static FactoryException buildFactoryException(const char *type,
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_AREA =
+    "SELECT name, south_lat, north_lat, west_lon, east_lon, deprecated, code "
+    "FROM area WHERE auth_name = ? AND code ";
+
+metadata::ExtentNNPtr
+AuthorityFactory::Private::createExtent(const SQLCursor &cursor,
+                                        const std::string &code) {
+    try {
+        const auto name = cursor.str(0);
+        double south_lat = cursor.getDouble(1);
+        double north_lat = cursor.getDouble(2);
+        double west_lon = cursor.getDouble(3);
+        double east_lon = cursor.getDouble(4);
+        auto bbox = metadata::GeographicBoundingBox::create(
+            west_lon, south_lat, east_lon, north_lat);
+
+        auto extent = metadata::Extent::create(
+            util::optional<std::string>(name),
+            std::vector<metadata::GeographicExtentNNPtr>{bbox},
+            std::vector<metadata::VerticalExtentNNPtr>(),
+            std::vector<metadata::TemporalExtentNNPtr>());
+        context()->getPrivate()->cache(authority() + code, extent);
+        return extent;
+
+    } catch (const std::exception &ex) {
+        throw buildFactoryException("area", code, ex);
+    }
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 /** \brief Returns a metadata::Extent from the specified code.
  *
  * @param code Object code allocated by authority.
@@ -1507,34 +2839,19 @@ AuthorityFactory::createExtent(const std::string &code) const {
             return NN_NO_CHECK(extent);
         }
     }
-    auto sql = "SELECT name, south_lat, north_lat, west_lon, east_lon, "
-               "deprecated FROM area WHERE auth_name = ? AND code = ?";
-    auto res = d->runWithCodeParam(sql, code);
-    if (res.empty()) {
+    if (!d->bulkExtents_.empty()) {
+        const auto iter = d->bulkExtents_.find(code);
+        if (iter != d->bulkExtents_.end()) {
+            return iter->second;
+        }
+    }
+    auto cursor =
+        d->cursorWithCodeParam(std::string(SQL_SELECT_AREA) + "= ?", code);
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("area not found", d->authority(),
                                            code);
     }
-    try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        double south_lat = c_locale_stod(row[1]);
-        double north_lat = c_locale_stod(row[2]);
-        double west_lon = c_locale_stod(row[3]);
-        double east_lon = c_locale_stod(row[4]);
-        auto bbox = metadata::GeographicBoundingBox::create(
-            west_lon, south_lat, east_lon, north_lat);
-
-        auto extent = metadata::Extent::create(
-            util::optional<std::string>(name),
-            std::vector<metadata::GeographicExtentNNPtr>{bbox},
-            std::vector<metadata::VerticalExtentNNPtr>(),
-            std::vector<metadata::TemporalExtentNNPtr>());
-        d->context()->d->cache(code, extent);
-        return extent;
-
-    } catch (const std::exception &ex) {
-        throw buildFactoryException("area", code, ex);
-    }
+    return d->createExtent(cursor, code);
 }
 
 // ---------------------------------------------------------------------------
@@ -1556,23 +2873,22 @@ AuthorityFactory::createUnitOfMeasure(const std::string &code) const {
             return NN_NO_CHECK(uom);
         }
     }
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT name, conv_factor, type, deprecated FROM unit_of_measure WHERE "
         "auth_name = ? AND code = ?",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("unit of measure not found",
                                            d->authority(), code);
     }
     try {
-        const auto &row = res.front();
-        const auto &name =
-            (row[0] == "degree (supplier to define representation)")
+        const auto name =
+            cursor.equals(0, "degree (supplier to define representation)")
                 ? UnitOfMeasure::DEGREE.name()
-                : row[0];
+                : cursor.str(0);
         double conv_factor = (code == "9107" || code == "9108")
                                  ? UnitOfMeasure::DEGREE.conversionToSI()
-                                 : c_locale_stod(row[1]);
+                                 : cursor.getDouble(1);
         constexpr double EPS = 1e-10;
         if (std::fabs(conv_factor - UnitOfMeasure::DEGREE.conversionToSI()) <
             EPS * UnitOfMeasure::DEGREE.conversionToSI()) {
@@ -1583,15 +2899,14 @@ AuthorityFactory::createUnitOfMeasure(const std::string &code) const {
             EPS * UnitOfMeasure::ARC_SECOND.conversionToSI()) {
             conv_factor = UnitOfMeasure::ARC_SECOND.conversionToSI();
         }
-        const auto &type_str = row[2];
         UnitOfMeasure::Type unitType = UnitOfMeasure::Type::UNKNOWN;
-        if (type_str == "length")
+        if (cursor.equals(2, "length"))
             unitType = UnitOfMeasure::Type::LINEAR;
-        else if (type_str == "angle")
+        else if (cursor.equals(2, "angle"))
             unitType = UnitOfMeasure::Type::ANGULAR;
-        else if (type_str == "scale")
+        else if (cursor.equals(2, "scale"))
             unitType = UnitOfMeasure::Type::SCALE;
-        else if (type_str == "time")
+        else if (cursor.equals(2, "time"))
             unitType = UnitOfMeasure::Type::TIME;
         auto uom = util::nn_make_shared<UnitOfMeasure>(
             name, conv_factor, unitType, d->authority(), code);
@@ -1605,12 +2920,11 @@ AuthorityFactory::createUnitOfMeasure(const std::string &code) const {
 // ---------------------------------------------------------------------------
 
 //! @cond Doxygen_Suppress
-static double normalizeMeasure(const std::string &uom_code,
-                               const std::string &value,
+static double normalizeMeasure(const std::string &uom_code, double value,
                                std::string &normalized_uom_code) {
     if (uom_code == "9110") // DDD.MMSSsss.....
     {
-        double normalized_value = c_locale_stod(value);
+        double normalized_value = value;
         std::ostringstream buffer;
         buffer.imbue(std::locale::classic());
         constexpr size_t precision = 12;
@@ -1631,9 +2945,16 @@ static double normalizeMeasure(const std::string &uom_code,
         return normalized_value;
     } else {
         normalized_uom_code = uom_code;
-        return c_locale_stod(value);
+        return value;
     }
 }
+
+static double normalizeMeasure(const std::string &uom_code,
+                               const std::string &value,
+                               std::string &normalized_uom_code) {
+    return normalizeMeasure(uom_code, c_locale_stod(value),
+                            normalized_uom_code);
+}
 //! @endcond
 
 // ---------------------------------------------------------------------------
@@ -1655,22 +2976,21 @@ AuthorityFactory::createPrimeMeridian(const std::string &code) const {
             return NN_NO_CHECK(pm);
         }
     }
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT name, longitude, uom_auth_name, uom_code, deprecated FROM "
         "prime_meridian WHERE "
         "auth_name = ? AND code = ?",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("prime meridian not found",
                                            d->authority(), code);
     }
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &longitude = row[1];
-        const auto &uom_auth_name = row[2];
-        const auto &uom_code = row[3];
-        const bool deprecated = row[4] == "1";
+        const auto name = cursor.str(0);
+        const double longitude = cursor.getDouble(1);
+        const auto uom_auth_name = cursor.str(2);
+        const auto uom_code = cursor.str(3);
+        const bool deprecated = cursor.getBool(4);
 
         std::string normalized_uom_code(uom_code);
         const double normalized_value =
@@ -1725,7 +3045,7 @@ AuthorityFactory::identifyBodyFromSemiMajorAxis(double semi_major_axis,
 
 datum::EllipsoidNNPtr
 AuthorityFactory::createEllipsoid(const std::string &code) const {
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT ellipsoid.name, ellipsoid.semi_major_axis, "
         "ellipsoid.uom_auth_name, ellipsoid.uom_code, "
         "ellipsoid.inv_flattening, ellipsoid.semi_minor_axis, "
@@ -1735,34 +3055,32 @@ AuthorityFactory::createEllipsoid(const std::string &code) const {
         "ellipsoid.celestial_body_code = celestial_body.code WHERE "
         "ellipsoid.auth_name = ? AND ellipsoid.code = ?",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("ellipsoid not found",
                                            d->authority(), code);
     }
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &semi_major_axis_str = row[1];
-        double semi_major_axis = c_locale_stod(semi_major_axis_str);
-        const auto &uom_auth_name = row[2];
-        const auto &uom_code = row[3];
-        const auto &inv_flattening_str = row[4];
-        const auto &semi_minor_axis_str = row[5];
-        const auto &body = row[6];
-        const bool deprecated = row[7] == "1";
+        const auto name = cursor.str(0);
+        double semi_major_axis = cursor.getDouble(1);
+        const auto uom_auth_name = cursor.str(2);
+        const auto uom_code = cursor.str(3);
+        const auto body = cursor.str(6);
+        const bool deprecated = cursor.getBool(7);
         auto uom = d->createUnitOfMeasure(uom_auth_name, uom_code);
         auto props = d->createProperties(code, name, deprecated, nullptr);
-        if (!inv_flattening_str.empty()) {
+        if (!cursor.isNull(4)) {
             return datum::Ellipsoid::createFlattenedSphere(
                 props, common::Length(semi_major_axis, uom),
-                common::Scale(c_locale_stod(inv_flattening_str)), body);
-        } else if (semi_major_axis_str == semi_minor_axis_str) {
+                common::Scale(cursor.getDouble(4)), body);
+        }
+        double semi_minor_axis = cursor.getDouble(5);
+        if (semi_major_axis == semi_minor_axis) {
             return datum::Ellipsoid::createSphere(
                 props, common::Length(semi_major_axis, uom), body);
         } else {
             return datum::Ellipsoid::createTwoAxis(
                 props, common::Length(semi_major_axis, uom),
-                common::Length(c_locale_stod(semi_minor_axis_str), uom), body);
+                common::Length(semi_minor_axis, uom), body);
         }
     } catch (const std::exception &ex) {
         throw buildFactoryException("elllipsoid", code, ex);
@@ -1788,26 +3106,25 @@ AuthorityFactory::createGeodeticDatum(const std::string &code) const {
             return NN_NO_CHECK(datum);
         }
     }
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT name, ellipsoid_auth_name, ellipsoid_code, "
         "prime_meridian_auth_name, prime_meridian_code, area_of_use_auth_name, "
         "area_of_use_code, deprecated FROM geodetic_datum WHERE "
         "auth_name = ? AND code = ?",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("geodetic datum not found",
                                            d->authority(), code);
     }
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &ellipsoid_auth_name = row[1];
-        const auto &ellipsoid_code = row[2];
-        const auto &prime_meridian_auth_name = row[3];
-        const auto &prime_meridian_code = row[4];
-        const auto &area_of_use_auth_name = row[5];
-        const auto &area_of_use_code = row[6];
-        const bool deprecated = row[7] == "1";
+        const auto name = cursor.str(0);
+        const auto ellipsoid_auth_name = cursor.str(1);
+        const auto ellipsoid_code = cursor.str(2);
+        const auto prime_meridian_auth_name = cursor.str(3);
+        const auto prime_meridian_code = cursor.str(4);
+        const auto area_of_use_auth_name = cursor.str(5);
+        const auto area_of_use_code = cursor.str(6);
+        const bool deprecated = cursor.getBool(7);
         auto ellipsoid = d->createFactory(ellipsoid_auth_name)
                              ->createEllipsoid(ellipsoid_code);
         auto pm = d->createFactory(prime_meridian_auth_name)
@@ -1836,20 +3153,19 @@ AuthorityFactory::createGeodeticDatum(const std::string &code) const {
 
 datum::VerticalReferenceFrameNNPtr
 AuthorityFactory::createVerticalDatum(const std::string &code) const {
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT name, area_of_use_auth_name, area_of_use_code, deprecated FROM "
         "vertical_datum WHERE auth_name = ? AND code = ?",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("vertical datum not found",
                                            d->authority(), code);
     }
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &area_of_use_auth_name = row[1];
-        const auto &area_of_use_code = row[2];
-        const bool deprecated = row[3] == "1";
+        const auto name = cursor.str(0);
+        const auto area_of_use_auth_name = cursor.str(1);
+        const auto area_of_use_code = cursor.str(2);
+        const bool deprecated = cursor.getBool(3);
         auto props = d->createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
         auto anchor = util::optional<std::string>();
@@ -1870,17 +3186,21 @@ AuthorityFactory::createVerticalDatum(const std::string &code) const {
  */
 
 datum::DatumNNPtr AuthorityFactory::createDatum(const std::string &code) const {
-    auto res =
-        d->run("SELECT 'geodetic_datum' FROM geodetic_datum WHERE "
-               "auth_name = ? AND code = ? "
-               "UNION ALL SELECT 'vertical_datum' FROM vertical_datum WHERE "
-               "auth_name = ? AND code = ?",
-               {d->authority(), code, d->authority(), code});
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("datum not found", d->authority(),
-                                           code);
+    bool geodetic;
+    {
+        auto cursor =
+            d->cursor("SELECT 'geodetic_datum' FROM geodetic_datum WHERE "
+                      "auth_name = ? AND code = ? "
+                      "UNION ALL SELECT 'vertical_datum' FROM vertical_datum "
+                      "WHERE auth_name = ? AND code = ?",
+                      {d->authority(), code, d->authority(), code});
+        if (!cursor.next()) {
+            throw NoSuchAuthorityCodeException("datum not found",
+                                               d->authority(), code);
+        }
+        geodetic = cursor.equals(0, "geodetic_datum");
     }
-    if (res.front()[0] == "geodetic_datum") {
+    if (geodetic) {
         return createGeodeticDatum(code);
     }
     return createVerticalDatum(code);
@@ -1926,7 +3246,7 @@ AuthorityFactory::createCoordinateSystem(const std::string &code) const {
             return NN_NO_CHECK(cs);
         }
     }
-    auto res = d->runWithCodeParam(
+    auto cursor = d->cursorWithCodeParam(
         "SELECT axis.name, abbrev, orientation, uom_auth_name, uom_code, "
         "cs.type FROM "
         "axis LEFT JOIN coordinate_system cs ON "
@@ -1935,19 +3255,19 @@ AuthorityFactory::createCoordinateSystem(const std::string &code) const {
         "coordinate_system_auth_name = ? AND coordinate_system_code = ? ORDER "
         "BY coordinate_system_order",
         code);
-    if (res.empty()) {
+    if (!cursor.next()) {
         throw NoSuchAuthorityCodeException("coordinate system not found",
                                            d->authority(), code);
     }
 
-    const auto &csType = res.front()[5];
+    const auto csType = cursor.str(5);
     std::vector<cs::CoordinateSystemAxisNNPtr> axisList;
-    for (const auto &row : res) {
-        const auto &name = row[0];
-        const auto &abbrev = row[1];
-        const auto &orientation = row[2];
-        const auto &uom_auth_name = row[3];
-        const auto &uom_code = row[4];
+    do {
+        const auto name = cursor.str(0);
+        const auto abbrev = cursor.str(1);
+        const auto orientation = cursor.str(2);
+        const auto uom_auth_name = cursor.str(3);
+        const auto uom_code = cursor.str(4);
         auto uom = d->createUnitOfMeasure(uom_auth_name, uom_code);
         auto props =
             util::PropertyMap().set(common::IdentifiedObject::NAME_KEY, name);
@@ -1980,7 +3300,7 @@ AuthorityFactory::createCoordinateSystem(const std::string &code) const {
         }
         axisList.emplace_back(cs::CoordinateSystemAxis::create(
             props, abbrev, *direction, uom, meridian));
-    }
+    } while (cursor.next());
 
     const auto cacheAndRet = [this,
                               &cacheKey](const cs::CoordinateSystemNNPtr &cs) {
@@ -2078,47 +3398,36 @@ cloneWithProps(const crs::GeodeticCRSNNPtr &geodCRS,
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_GEODETIC_CRS =
+    "SELECT name, type, coordinate_system_auth_name, "
+    "coordinate_system_code, datum_auth_name, datum_code, "
+    "area_of_use_auth_name, area_of_use_code, text_definition, "
+    "deprecated, code FROM geodetic_crs WHERE auth_name = ? AND code ";
+
 crs::GeodeticCRSNNPtr
-AuthorityFactory::createGeodeticCRS(const std::string &code,
-                                    bool geographicOnly) const {
-    const auto cacheKey(d->authority() + code);
-    auto crs = std::dynamic_pointer_cast<crs::GeodeticCRS>(
-        d->context()->d->getCRSFromCache(cacheKey));
-    if (crs) {
-        return NN_NO_CHECK(crs);
-    }
-    std::string sql("SELECT name, type, coordinate_system_auth_name, "
-                    "coordinate_system_code, datum_auth_name, datum_code, "
-                    "area_of_use_auth_name, area_of_use_code, text_definition, "
-                    "deprecated FROM "
-                    "geodetic_crs WHERE auth_name = ? AND code = ?");
-    if (geographicOnly) {
-        sql += " AND type in (" GEOG_2D "," GEOG_3D ")";
-    }
-    auto res = d->runWithCodeParam(sql, code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("geodeticCRS not found",
-                                           d->authority(), code);
-    }
+AuthorityFactory::Private::createGeodeticCRS(const SQLCursor &cursor,
+                                             const std::string &code) {
+    const auto cacheKey(authority() + code);
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &type = row[1];
-        const auto &cs_auth_name = row[2];
-        const auto &cs_code = row[3];
-        const auto &datum_auth_name = row[4];
-        const auto &datum_code = row[5];
-        const auto &area_of_use_auth_name = row[6];
-        const auto &area_of_use_code = row[7];
-        const auto &text_definition = row[8];
-        const bool deprecated = row[9] == "1";
-
-        auto props = d->createProperties(
+        const auto name = cursor.str(0);
+        const auto type = cursor.str(1);
+        const auto cs_auth_name = cursor.str(2);
+        const auto cs_code = cursor.str(3);
+        const auto datum_auth_name = cursor.str(4);
+        const auto datum_code = cursor.str(5);
+        const auto area_of_use_auth_name = cursor.str(6);
+        const auto area_of_use_code = cursor.str(7);
+        const char *text_definition = cursor.cstr(8);
+        const bool deprecated = cursor.getBool(9);
+
+        auto props = createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
 
-        if (!text_definition.empty()) {
-            DatabaseContext::Private::RecursionDetector detector(d->context());
-            auto obj = createFromUserInput(text_definition, d->context());
+        if (text_definition[0] != '\0') {
+            DatabaseContext::Private::RecursionDetector detector(context());
+            auto obj = createFromUserInput(text_definition, context());
             auto geodCRS = util::nn_dynamic_pointer_cast<crs::GeodeticCRS>(obj);
             if (geodCRS) {
                 return cloneWithProps(NN_NO_CHECK(geodCRS), props);
@@ -2143,9 +3452,9 @@ AuthorityFactory::createGeodeticCRS(const std::string &code,
         }
 
         auto cs =
-            d->createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
+            createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
         auto datum =
-            d->createFactory(datum_auth_name)->createGeodeticDatum(datum_code);
+            createFactory(datum_auth_name)->createGeodeticDatum(datum_code);
 
         auto ellipsoidalCS =
             util::nn_dynamic_pointer_cast<cs::EllipsoidalCS>(cs);
@@ -2153,14 +3462,14 @@ AuthorityFactory::createGeodeticCRS(const std::string &code,
             ellipsoidalCS) {
             auto crsRet = crs::GeographicCRS::create(
                 props, datum, NN_NO_CHECK(ellipsoidalCS));
-            d->context()->d->cache(cacheKey, crsRet);
+            context()->getPrivate()->cache(cacheKey, crsRet);
             return crsRet;
         }
         auto geocentricCS = util::nn_dynamic_pointer_cast<cs::CartesianCS>(cs);
         if (type == "geocentric" && geocentricCS) {
             auto crsRet = crs::GeodeticCRS::create(props, datum,
                                                    NN_NO_CHECK(geocentricCS));
-            d->context()->d->cache(cacheKey, crsRet);
+            context()->getPrivate()->cache(cacheKey, crsRet);
             return crsRet;
         }
         throw FactoryException("unsupported (type, CS type) for geodeticCRS: " +
@@ -2169,45 +3478,72 @@ AuthorityFactory::createGeodeticCRS(const std::string &code,
         throw buildFactoryException("geodeticCRS", code, ex);
     }
 }
+//! @endcond
 
-// ---------------------------------------------------------------------------
 
-/** \brief Returns a crs::VerticalCRS from the specified code.
- *
- * @param code Object code allocated by authority.
- * @return object.
- * @throw NoSuchAuthorityCodeException
- * @throw FactoryException
- */
+// ---------------------------------------------------------------------------
 
-crs::VerticalCRSNNPtr
-AuthorityFactory::createVerticalCRS(const std::string &code) const {
-    auto res = d->runWithCodeParam(
-        "SELECT name, coordinate_system_auth_name, "
-        "coordinate_system_code, datum_auth_name, datum_code, "
-        "area_of_use_auth_name, area_of_use_code, deprecated FROM "
-        "vertical_crs WHERE auth_name = ? AND code = ?",
-        code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("verticalCRS not found",
+crs::GeodeticCRSNNPtr
+AuthorityFactory::createGeodeticCRS(const std::string &code,
+                                    bool geographicOnly) const {
+    const auto cacheKey(d->authority() + code);
+    auto crs = std::dynamic_pointer_cast<crs::GeodeticCRS>(
+        d->context()->d->getCRSFromCache(cacheKey));
+    if (crs) {
+        return NN_NO_CHECK(crs);
+    }
+    if (!d->bulkCRS_.empty()) {
+        const auto iter = d->bulkCRS_.find(code);
+        if (iter != d->bulkCRS_.end()) {
+            crs = util::nn_dynamic_pointer_cast<crs::GeodeticCRS>(
+                iter->second);
+            if (crs && (!geographicOnly ||
+                        dynamic_cast<crs::GeographicCRS *>(crs.get()))) {
+                return NN_NO_CHECK(crs);
+            }
+        }
+    }
+    std::string sql(SQL_SELECT_GEODETIC_CRS);
+    sql += "= ?";
+    if (geographicOnly) {
+        sql += " AND type in (" GEOG_2D "," GEOG_3D ")";
+    }
+    auto cursor = d->cursorWithCodeParam(sql, code);
+    if (!cursor.next()) {
+        throw NoSuchAuthorityCodeException("geodeticCRS not found",
                                            d->authority(), code);
     }
+    return d->createGeodeticCRS(cursor, code);
+}
+
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_VERTICAL_CRS =
+    "SELECT name, coordinate_system_auth_name, "
+    "coordinate_system_code, datum_auth_name, datum_code, "
+    "area_of_use_auth_name, area_of_use_code, deprecated, code FROM "
+    "vertical_crs WHERE auth_name = ? AND code ";
+
+crs::VerticalCRSNNPtr
+AuthorityFactory::Private::createVerticalCRS(const SQLCursor &cursor,
+                                             const std::string &code) {
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &cs_auth_name = row[1];
-        const auto &cs_code = row[2];
-        const auto &datum_auth_name = row[3];
-        const auto &datum_code = row[4];
-        const auto &area_of_use_auth_name = row[5];
-        const auto &area_of_use_code = row[6];
-        const bool deprecated = row[7] == "1";
+        const auto name = cursor.str(0);
+        const auto cs_auth_name = cursor.str(1);
+        const auto cs_code = cursor.str(2);
+        const auto datum_auth_name = cursor.str(3);
+        const auto datum_code = cursor.str(4);
+        const auto area_of_use_auth_name = cursor.str(5);
+        const auto area_of_use_code = cursor.str(6);
+        const bool deprecated = cursor.getBool(7);
         auto cs =
-            d->createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
+            createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
         auto datum =
-            d->createFactory(datum_auth_name)->createVerticalDatum(datum_code);
+            createFactory(datum_auth_name)->createVerticalDatum(datum_code);
 
-        auto props = d->createProperties(
+        auto props = createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
 
         auto verticalCS = util::nn_dynamic_pointer_cast<cs::VerticalCS>(cs);
@@ -2222,9 +3558,11 @@ AuthorityFactory::createVerticalCRS(const std::string &code) const {
     }
 }
 
+//! @endcond
+
 // ---------------------------------------------------------------------------
 
-/** \brief Returns a operation::Conversion from the specified code.
+/** \brief Returns a crs::VerticalCRS from the specified code.
  *
  * @param code Object code allocated by authority.
  * @return object.
@@ -2232,64 +3570,86 @@ AuthorityFactory::createVerticalCRS(const std::string &code) const {
  * @throw FactoryException
  */
 
-operation::ConversionNNPtr
-AuthorityFactory::createConversion(const std::string &code) const {
+crs::VerticalCRSNNPtr
+AuthorityFactory::createVerticalCRS(const std::string &code) const {
+    if (!d->bulkCRS_.empty()) {
+        const auto iter = d->bulkCRS_.find(code);
+        if (iter != d->bulkCRS_.end()) {
+            auto crs =
+                util::nn_dynamic_pointer_cast<crs::VerticalCRS>(iter->second);
+            if (crs) {
+                return NN_NO_CHECK(crs);
+            }
+        }
+    }
+    auto cursor = d->cursorWithCodeParam(
+        std::string(SQL_SELECT_VERTICAL_CRS) + "= ?", code);
+    if (!cursor.next()) {
+        throw NoSuchAuthorityCodeException("verticalCRS not found",
+                                           d->authority(), code);
+    }
+    return d->createVerticalCRS(cursor, code);
+}
 
-    static const char *sql =
-        "SELECT name, area_of_use_auth_name, area_of_use_code, "
-        "method_auth_name, method_code, method_name, "
+// ---------------------------------------------------------------------------
 
-        "param1_auth_name, param1_code, param1_name, param1_value, "
-        "param1_uom_auth_name, param1_uom_code, "
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_CONVERSION =
+    "SELECT name, area_of_use_auth_name, area_of_use_code, "
+    "method_auth_name, method_code, method_name, "
 
-        "param2_auth_name, param2_code, param2_name, param2_value, "
-        "param2_uom_auth_name, param2_uom_code, "
+    "param1_auth_name, param1_code, param1_name, param1_value, "
+    "param1_uom_auth_name, param1_uom_code, "
 
-        "param3_auth_name, param3_code, param3_name, param3_value, "
-        "param3_uom_auth_name, param3_uom_code, "
+    "param2_auth_name, param2_code, param2_name, param2_value, "
+    "param2_uom_auth_name, param2_uom_code, "
 
-        "param4_auth_name, param4_code, param4_name, param4_value, "
-        "param4_uom_auth_name, param4_uom_code, "
+    "param3_auth_name, param3_code, param3_name, param3_value, "
+    "param3_uom_auth_name, param3_uom_code, "
 
-        "param5_auth_name, param5_code, param5_name, param5_value, "
-        "param5_uom_auth_name, param5_uom_code, "
+    "param4_auth_name, param4_code, param4_name, param4_value, "
+    "param4_uom_auth_name, param4_uom_code, "
 
-        "param6_auth_name, param6_code, param6_name, param6_value, "
-        "param6_uom_auth_name, param6_uom_code, "
+    "param5_auth_name, param5_code, param5_name, param5_value, "
+    "param5_uom_auth_name, param5_uom_code, "
 
-        "param7_auth_name, param7_code, param7_name, param7_value, "
-        "param7_uom_auth_name, param7_uom_code, "
+    "param6_auth_name, param6_code, param6_name, param6_value, "
+    "param6_uom_auth_name, param6_uom_code, "
 
-        "deprecated FROM conversion WHERE auth_name = ? AND code = ?";
+    "param7_auth_name, param7_code, param7_name, param7_value, "
+    "param7_uom_auth_name, param7_uom_code, "
 
-    auto res = d->runWithCodeParam(sql, code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("conversion not found",
-                                           d->authority(), code);
-    }
+    "deprecated, code FROM conversion WHERE auth_name = ? AND code ";
+
+operation::ConversionNNPtr
+AuthorityFactory::Private::createConversion(const SQLCursor &cursor,
+                                            const std::string &code) {
     try {
-        const auto &row = res.front();
-        size_t idx = 0;
-        const auto &name = row[idx++];
-        const auto &area_of_use_auth_name = row[idx++];
-        const auto &area_of_use_code = row[idx++];
-        const auto &method_auth_name = row[idx++];
-        const auto &method_code = row[idx++];
-        const auto &method_name = row[idx++];
-        const size_t base_param_idx = idx;
+        int idx = 0;
+        const auto name = cursor.str(idx++);
+        const auto area_of_use_auth_name = cursor.str(idx++);
+        const auto area_of_use_code = cursor.str(idx++);
+        const auto method_auth_name = cursor.str(idx++);
+        const auto method_code = cursor.str(idx++);
+        const auto method_name = cursor.str(idx++);
+        const int base_param_idx = idx;
         std::vector<operation::OperationParameterNNPtr> parameters;
         std::vector<operation::ParameterValueNNPtr> values;
         constexpr int N_MAX_PARAMS = 7;
         for (int i = 0; i < N_MAX_PARAMS; ++i) {
-            const auto &param_auth_name = row[base_param_idx + i * 6 + 0];
+            const auto param_auth_name =
+                cursor.str(base_param_idx + i * 6 + 0);
             if (param_auth_name.empty()) {
                 break;
             }
-            const auto &param_code = row[base_param_idx + i * 6 + 1];
-            const auto &param_name = row[base_param_idx + i * 6 + 2];
-            const auto &param_value = row[base_param_idx + i * 6 + 3];
-            const auto &param_uom_auth_name = row[base_param_idx + i * 6 + 4];
-            const auto &param_uom_code = row[base_param_idx + i * 6 + 5];
+            const auto param_code = cursor.str(base_param_idx + i * 6 + 1);
+            const auto param_name = cursor.str(base_param_idx + i * 6 + 2);
+            const double param_value =
+                cursor.getDouble(base_param_idx + i * 6 + 3);
+            const auto param_uom_auth_name =
+                cursor.str(base_param_idx + i * 6 + 4);
+            const auto param_uom_code = cursor.str(base_param_idx + i * 6 + 5);
             parameters.emplace_back(operation::OperationParameter::create(
                 util::PropertyMap()
                     .set(metadata::Identifier::CODESPACE_KEY, param_auth_name)
@@ -2298,14 +3658,15 @@ AuthorityFactory::createConversion(const std::string &code) const {
             std::string normalized_uom_code(param_uom_code);
             const double normalized_value = normalizeMeasure(
                 param_uom_code, param_value, normalized_uom_code);
-            auto uom = d->createUnitOfMeasure(param_uom_auth_name,
+            auto uom = createUnitOfMeasure(param_uom_auth_name,
                                               normalized_uom_code);
             values.emplace_back(operation::ParameterValue::create(
                 common::Measure(normalized_value, uom)));
         }
-        const bool deprecated = row[base_param_idx + N_MAX_PARAMS * 6] == "1";
+        const bool deprecated =
+            cursor.getBool(base_param_idx + N_MAX_PARAMS * 6);
 
-        auto propConversion = d->createProperties(
+        auto propConversion = createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
 
         auto propMethod = util::PropertyMap().set(
@@ -2323,9 +3684,11 @@ AuthorityFactory::createConversion(const std::string &code) const {
     }
 }
 
+//! @endcond
+
 // ---------------------------------------------------------------------------
 
-/** \brief Returns a crs::ProjectedCRS from the specified code.
+/** \brief Returns a operation::Conversion from the specified code.
  *
  * @param code Object code allocated by authority.
  * @return object.
@@ -2333,39 +3696,57 @@ AuthorityFactory::createConversion(const std::string &code) const {
  * @throw FactoryException
  */
 
-crs::ProjectedCRSNNPtr
-AuthorityFactory::createProjectedCRS(const std::string &code) const {
-    auto res = d->runWithCodeParam(
-        "SELECT name, coordinate_system_auth_name, "
-        "coordinate_system_code, geodetic_crs_auth_name, geodetic_crs_code, "
-        "conversion_auth_name, conversion_code, "
-        "area_of_use_auth_name, area_of_use_code, text_definition, "
-        "deprecated FROM projected_crs WHERE auth_name = ? AND code = ?",
-        code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("projectedCRS not found",
+operation::ConversionNNPtr
+AuthorityFactory::createConversion(const std::string &code) const {
+    if (!d->bulkConversions_.empty()) {
+        const auto iter = d->bulkConversions_.find(code);
+        if (iter != d->bulkConversions_.end()) {
+            return iter->second;
+        }
+    }
+    auto cursor = d->cursorWithCodeParam(
+        std::string(SQL_SELECT_CONVERSION) + "= ?", code);
+    if (!cursor.next()) {
+        throw NoSuchAuthorityCodeException("conversion not found",
                                            d->authority(), code);
     }
-    try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &cs_auth_name = row[1];
-        const auto &cs_code = row[2];
-        const auto &geodetic_crs_auth_name = row[3];
-        const auto &geodetic_crs_code = row[4];
-        const auto &conversion_auth_name = row[5];
-        const auto &conversion_code = row[6];
-        const auto &area_of_use_auth_name = row[7];
-        const auto &area_of_use_code = row[8];
-        const auto &text_definition = row[9];
-        const bool deprecated = row[10] == "1";
+    return d->createConversion(cursor, code);
+}
 
-        auto props = d->createProperties(
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_PROJECTED_CRS =
+    "SELECT name, coordinate_system_auth_name, "
+    "coordinate_system_code, geodetic_crs_auth_name, geodetic_crs_code, "
+    "conversion_auth_name, conversion_code, "
+    "area_of_use_auth_name, area_of_use_code, text_definition, "
+    "deprecated, code FROM projected_crs WHERE auth_name = ? AND code ";
+
+crs::ProjectedCRSNNPtr
+AuthorityFactory::Private::createProjectedCRS(const SQLCursor &cursor,
+                                              const std::string &code) {
+    const auto cacheKey(authority() + code);
+    try {
+        const auto name = cursor.str(0);
+        const auto cs_auth_name = cursor.str(1);
+        const auto cs_code = cursor.str(2);
+        const auto geodetic_crs_auth_name = cursor.str(3);
+        const auto geodetic_crs_code = cursor.str(4);
+        const auto conversion_auth_name = cursor.str(5);
+        const auto conversion_code = cursor.str(6);
+        const auto area_of_use_auth_name = cursor.str(7);
+        const auto area_of_use_code = cursor.str(8);
+        const char *text_definition = cursor.cstr(9);
+        const bool deprecated = cursor.getBool(10);
+
+        auto props = createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
 
-        if (!text_definition.empty()) {
-            DatabaseContext::Private::RecursionDetector detector(d->context());
-            auto obj = createFromUserInput(text_definition, d->context());
+        if (text_definition[0] != '\0') {
+            DatabaseContext::Private::RecursionDetector detector(context());
+            auto obj = createFromUserInput(text_definition, context());
             auto projCRS = dynamic_cast<const crs::ProjectedCRS *>(obj.get());
             if (projCRS) {
                 const auto &conv = projCRS->derivingConversionRef();
@@ -2376,9 +3757,11 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
                                   common::IdentifiedObject::NAME_KEY, name),
                               conv->method(), conv->parameterValues())
                         : conv;
-                return crs::ProjectedCRS::create(props, projCRS->baseCRS(),
-                                                 newConv,
-                                                 projCRS->coordinateSystem());
+                auto crsRet = crs::ProjectedCRS::create(
+                    props, projCRS->baseCRS(), newConv,
+                    projCRS->coordinateSystem());
+                context()->getPrivate()->cache(cacheKey, crsRet);
+                return crsRet;
             }
 
             auto boundCRS = dynamic_cast<const crs::BoundCRS *>(obj.get());
@@ -2392,9 +3775,11 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
                             projCRS->derivingConversionRef(),
                             projCRS->coordinateSystem()),
                         boundCRS->hubCRS(), boundCRS->transformation());
-                    return NN_NO_CHECK(
+                    auto crsRet = NN_NO_CHECK(
                         util::nn_dynamic_pointer_cast<crs::ProjectedCRS>(
                             newBoundCRS->baseCRSWithCanonicalBoundCRS()));
+                    context()->getPrivate()->cache(cacheKey, crsRet);
+                    return crsRet;
                 }
             }
 
@@ -2403,18 +3788,20 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
         }
 
         auto cs =
-            d->createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
+            createFactory(cs_auth_name)->createCoordinateSystem(cs_code);
 
-        auto baseCRS = d->createFactory(geodetic_crs_auth_name)
+        auto baseCRS = createFactory(geodetic_crs_auth_name)
                            ->createGeodeticCRS(geodetic_crs_code);
 
-        auto conv = d->createFactory(conversion_auth_name)
+        auto conv = createFactory(conversion_auth_name)
                         ->createConversion(conversion_code);
 
         auto cartesianCS = util::nn_dynamic_pointer_cast<cs::CartesianCS>(cs);
         if (cartesianCS) {
-            return crs::ProjectedCRS::create(props, baseCRS, conv,
-                                             NN_NO_CHECK(cartesianCS));
+            auto crsRet = crs::ProjectedCRS::create(props, baseCRS, conv,
+                                                    NN_NO_CHECK(cartesianCS));
+            context()->getPrivate()->cache(cacheKey, crsRet);
+            return crsRet;
         }
         throw FactoryException("unsupported CS type for projectedCRS: " +
                                cs->getWKT2Type(true));
@@ -2423,9 +3810,11 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
     }
 }
 
+//! @endcond
+
 // ---------------------------------------------------------------------------
 
-/** \brief Returns a crs::CompoundCRS from the specified code.
+/** \brief Returns a crs::ProjectedCRS from the specified code.
  *
  * @param code Object code allocated by authority.
  * @return object.
@@ -2433,36 +3822,63 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
  * @throw FactoryException
  */
 
-crs::CompoundCRSNNPtr
-AuthorityFactory::createCompoundCRS(const std::string &code) const {
-    auto res = d->runWithCodeParam(
-        "SELECT name, horiz_crs_auth_name, horiz_crs_code, "
-        "vertical_crs_auth_name, vertical_crs_code, "
-        "area_of_use_auth_name, area_of_use_code, deprecated FROM "
-        "compound_crs WHERE auth_name = ? AND code = ?",
-        code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("compoundCRS not found",
+crs::ProjectedCRSNNPtr
+AuthorityFactory::createProjectedCRS(const std::string &code) const {
+    const auto cacheKey(d->authority() + code);
+    auto crs = std::dynamic_pointer_cast<crs::ProjectedCRS>(
+        d->context()->d->getCRSFromCache(cacheKey));
+    if (crs) {
+        return NN_NO_CHECK(crs);
+    }
+    if (!d->bulkCRS_.empty()) {
+        const auto iter = d->bulkCRS_.find(code);
+        if (iter != d->bulkCRS_.end()) {
+            crs = util::nn_dynamic_pointer_cast<crs::ProjectedCRS>(
+                iter->second);
+            if (crs) {
+                return NN_NO_CHECK(crs);
+            }
+        }
+    }
+    auto cursor = d->cursorWithCodeParam(
+        std::string(SQL_SELECT_PROJECTED_CRS) + "= ?", code);
+    if (!cursor.next()) {
+        throw NoSuchAuthorityCodeException("projectedCRS not found",
                                            d->authority(), code);
     }
+    return d->createProjectedCRS(cursor, code);
+}
+
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// Followed by "= ?" or "IN (...)"
+static const char *const SQL_SELECT_COMPOUND_CRS =
+    "SELECT name, horiz_crs_auth_name, horiz_crs_code, "
+    "vertical_crs_auth_name, vertical_crs_code, "
+    "area_of_use_auth_name, area_of_use_code, deprecated, code FROM "
+    "compound_crs WHERE auth_name = ? AND code ";
+
+crs::CompoundCRSNNPtr
+AuthorityFactory::Private::createCompoundCRS(const SQLCursor &cursor,
+                                             const std::string &code) {
     try {
-        const auto &row = res.front();
-        const auto &name = row[0];
-        const auto &horiz_crs_auth_name = row[1];
-        const auto &horiz_crs_code = row[2];
-        const auto &vertical_crs_auth_name = row[3];
-        const auto &vertical_crs_code = row[4];
-        const auto &area_of_use_auth_name = row[5];
-        const auto &area_of_use_code = row[6];
-        const bool deprecated = row[7] == "1";
+        const auto name = cursor.str(0);
+        const auto horiz_crs_auth_name = cursor.str(1);
+        const auto horiz_crs_code = cursor.str(2);
+        const auto vertical_crs_auth_name = cursor.str(3);
+        const auto vertical_crs_code = cursor.str(4);
+        const auto area_of_use_auth_name = cursor.str(5);
+        const auto area_of_use_code = cursor.str(6);
+        const bool deprecated = cursor.getBool(7);
 
         auto horizCRS =
-            d->createFactory(horiz_crs_auth_name)
+            createFactory(horiz_crs_auth_name)
                 ->createCoordinateReferenceSystem(horiz_crs_code, false);
-        auto vertCRS = d->createFactory(vertical_crs_auth_name)
+        auto vertCRS = createFactory(vertical_crs_auth_name)
                            ->createVerticalCRS(vertical_crs_code);
 
-        auto props = d->createProperties(
+        auto props = createProperties(
             code, name, deprecated, area_of_use_auth_name, area_of_use_code);
         return crs::CompoundCRS::create(
             props, std::vector<crs::CRSNNPtr>{horizCRS, vertCRS});
@@ -2471,6 +3887,39 @@ AuthorityFactory::createCompoundCRS(const std::string &code) const {
     }
 }
 
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+/** \brief Returns a crs::CompoundCRS from the specified code.
+ *
+ * @param code Object code allocated by authority.
+ * @return object.
+ * @throw NoSuchAuthorityCodeException
+ * @throw FactoryException
+ */
+
+crs::CompoundCRSNNPtr
+AuthorityFactory::createCompoundCRS(const std::string &code) const {
+    if (!d->bulkCRS_.empty()) {
+        const auto iter = d->bulkCRS_.find(code);
+        if (iter != d->bulkCRS_.end()) {
+            auto crs =
+                util::nn_dynamic_pointer_cast<crs::CompoundCRS>(iter->second);
+            if (crs) {
+                return NN_NO_CHECK(crs);
+            }
+        }
+    }
+    auto cursor = d->cursorWithCodeParam(
+        std::string(SQL_SELECT_COMPOUND_CRS) + "= ?", code);
+    if (!cursor.next()) {
+        throw NoSuchAuthorityCodeException("compoundCRS not found",
+                                           d->authority(), code);
+    }
+    return d->createCompoundCRS(cursor, code);
+}
+
 // ---------------------------------------------------------------------------
 
 /** \brief Returns a crs::CRS from the specified code.
@@ -2494,13 +3943,25 @@ AuthorityFactory::createCoordinateReferenceSystem(const std::string &code,
     if (crs) {
         return NN_NO_CHECK(crs);
     }
-    auto res = d->runWithCodeParam(
-        "SELECT type FROM crs_view WHERE auth_name = ? AND code = ?", code);
-    if (res.empty()) {
-        throw NoSuchAuthorityCodeException("crs not found", d->authority(),
-                                           code);
+    if (!d->bulkCRS_.empty()) {
+        const auto iter = d->bulkCRS_.find(code);
+        if (iter != d->bulkCRS_.end() &&
+            (allowCompound ||
+             !dynamic_cast<const crs::CompoundCRS *>(iter->second.get()))) {
+            return iter->second;
+        }
+    }
+    std::string type;
+    {
+        auto cursor = d->cursorWithCodeParam(
+            "SELECT type FROM crs_view WHERE auth_name = ? AND code = ?",
+            code);
+        if (!cursor.next()) {
+            throw NoSuchAuthorityCodeException("crs not found",
+                                               d->authority(), code);
+        }
+        type = cursor.str(0);
     }
-    const auto &type = res.front()[0];
     if (type == "geographic 2D" || type == "geographic 3D" ||
         type == "geocentric") {
         return createGeodeticCRS(code);
@@ -2516,6 +3977,139 @@ AuthorityFactory::createCoordinateReferenceSystem(const std::string &code,
     }
     throw FactoryException("unhandled CRS type: " + type);
 }
+
+// ---------------------------------------------------------------------------
+
+/** \brief Returns the crs::CRS of several codes.
+ *
+ * This gives the same result as calling createCoordinateReferenceSystem()
+ * on each code, but the CRS, their areas of use and conversions are read
+ * with a few set-based queries rather than with several queries per CRS,
+ * which is faster when instantiating many objects.
+ *
+ * @param codes Object codes allocated by authority.
+ * @return objects, in the order of codes.
+ * @throw NoSuchAuthorityCodeException
+ * @throw FactoryException
+ */
+
+std::vector<crs::CRSNNPtr> AuthorityFactory::createCoordinateReferenceSystems(
+    const std::vector<std::string> &codes) const {
+
+    // Forget the objects built in advance when leaving
+    struct BulkObjectsCleaner {
+        Private *d;
+        ~BulkObjectsCleaner() {
+            d->bulkExtents_.clear();
+            d->bulkConversions_.clear();
+            d->bulkCRS_.clear();
+        }
+    } cleaner{d.get()};
+
+    std::set<std::string> setCodesToQuery;
+    for (const auto &code : codes) {
+        if (!d->context()->d->getCRSFromCache(d->authority() + code)) {
+            setCodesToQuery.insert(code);
+        }
+    }
+    const std::vector<std::string> codesToQuery(setCodesToQuery.begin(),
+                                                setCodesToQuery.end());
+
+    // Tables of the CRS, and codes of their areas of use
+    std::map<std::string, std::vector<std::string>> mapTableToCodes;
+    std::set<std::string> setAreaCodes;
+    d->forEachRowWithCodes(
+        "SELECT code, table_name, area_of_use_auth_name, area_of_use_code "
+        "FROM crs_view WHERE auth_name = ? AND code IN ",
+        {d->authority()}, codesToQuery, std::string(),
+        [this, &mapTableToCodes, &setAreaCodes](Private::SQLCursor &cursor) {
+            mapTableToCodes[cursor.str(1)].push_back(cursor.str(0));
+            if (cursor.equals(2, d->authority().c_str())) {
+                setAreaCodes.insert(cursor.str(3));
+            }
+        });
+    size_t countFound = 0;
+    for (const auto &pair : mapTableToCodes) {
+        countFound += pair.second.size();
+    }
+    if (countFound != codesToQuery.size()) {
+        std::set<std::string> setCodesFound;
+        for (const auto &pair : mapTableToCodes) {
+            setCodesFound.insert(pair.second.begin(), pair.second.end());
+        }
+        for (const auto &code : codes) {
+            if (setCodesToQuery.find(code) != setCodesToQuery.end() &&
+                setCodesFound.find(code) == setCodesFound.end()) {
+                throw NoSuchAuthorityCodeException("crs not found",
+                                                   d->authority(), code);
+            }
+        }
+    }
+
+    d->forEachRowWithCodes(
+        std::string(SQL_SELECT_AREA) + "IN ", {d->authority()},
+        std::vector<std::string>(setAreaCodes.begin(), setAreaCodes.end()),
+        std::string(), [this](Private::SQLCursor &cursor) {
+            // Errors are reported when building the objects using them
+            const auto code = cursor.str(cursor.columnCount() - 1);
+            try {
+                d->bulkExtents_.emplace(code, d->createExtent(cursor, code));
+            } catch (const FactoryException &) {
+            }
+        });
+
+    const auto createCRS = [this](const std::string &table,
+                                  const char *sqlSelect,
+                                  const std::vector<std::string> &tableCodes) {
+        d->forEachRowWithCodes(
+            std::string(sqlSelect) + "IN ", {d->authority()}, tableCodes,
+            std::string(), [this, &table](Private::SQLCursor &cursor) {
+                const auto code = cursor.str(cursor.columnCount() - 1);
+                crs::CRSPtr crs;
+                if (table == "geodetic_crs") {
+                    crs = d->createGeodeticCRS(cursor, code).as_nullable();
+                } else if (table == "vertical_crs") {
+                    crs = d->createVerticalCRS(cursor, code).as_nullable();
+                } else if (table == "projected_crs") {
+                    crs = d->createProjectedCRS(cursor, code).as_nullable();
+                } else {
+                    crs = d->createCompoundCRS(cursor, code).as_nullable();
+                }
+                d->bulkCRS_.emplace(code, NN_NO_CHECK(crs));
+            });
+    };
+
+    // Dependencies first: geodetic CRS may be the base of projected CRS,
+    // and compound CRS are made of the other ones.
+    createCRS("geodetic_crs", SQL_SELECT_GEODETIC_CRS,
+              mapTableToCodes["geodetic_crs"]);
+    createCRS("vertical_crs", SQL_SELECT_VERTICAL_CRS,
+              mapTableToCodes["vertical_crs"]);
+    const auto &projectedCodes = mapTableToCodes["projected_crs"];
+    d->forEachRowWithCodes(
+        std::string(SQL_SELECT_CONVERSION) +
+            "IN (SELECT conversion_code FROM projected_crs "
+            "WHERE conversion_auth_name = ? AND auth_name = ? AND code IN ",
+        {d->authority(), d->authority(), d->authority()}, projectedCodes, ")",
+        [this](Private::SQLCursor &cursor) {
+            const auto code = cursor.str(cursor.columnCount() - 1);
+            try {
+                d->bulkConversions_.emplace(
+                    code, d->createConversion(cursor, code));
+            } catch (const FactoryException &) {
+            }
+        });
+    createCRS("projected_crs", SQL_SELECT_PROJECTED_CRS, projectedCodes);
+    createCRS("compound_crs", SQL_SELECT_COMPOUND_CRS,
+              mapTableToCodes["compound_crs"]);
+
+    std::vector<crs::CRSNNPtr> res;
+    res.reserve(codes.size());
+    for (const auto &code : codes) {
+        res.emplace_back(createCoordinateReferenceSystem(code));
+    }
+    return res;
+}
 // ---------------------------------------------------------------------------
 
 //! @cond Doxygen_Suppress
@@ -3361,6 +4955,12 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
         return list;
     }
 
+    if (d->context()->d->getCRSToCRSCoordOpFromPersistentCache(cacheKey,
+                                                               list)) {
+        d->context()->d->cache(cacheKey, list);
+        return list;
+    }
+
     // Look-up first for conversion which is the most precise.
     std::string sql("SELECT conversion_auth_name, "
                     "geodetic_crs_auth_name, geodetic_crs_code FROM "
@@ -3416,6 +5016,7 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
            "(CASE WHEN accuracy is NULL THEN 1 ELSE 0 END), accuracy";
     res = d->run(sql, params);
     std::set<std::pair<std::string, std::string>> setTransf;
+    std::set<std::pair<std::string, bool>> gridsChecked;
     if (discardSuperseded) {
         for (const auto &row : res) {
             const auto &auth_name = row[0];
@@ -3443,39 +5044,20 @@ AuthorityFactory::createFromCoordinateReferenceSystemCodes(
         const auto &table_name = row[2];
         auto op = d->createFactory(auth_name)->createCoordinateOperation(
             code, true, usePROJAlternativeGridNames, table_name);
-        if (!d->rejectOpDueToMissingGrid(op, discardIfMissingGrid)) {
+        if (!d->rejectOpDueToMissingGrid(op, discardIfMissingGrid,
+                                         &gridsChecked)) {
             list.emplace_back(op);
         }
     }
     d->context()->d->cache(cacheKey, list);
-    return list;
-}
-
-// ---------------------------------------------------------------------------
 
-//! @cond Doxygen_Suppress
-static std::string
-buildIntermediateWhere(const std::vector<std::pair<std::string, std::string>>
-                           &intermediateCRSAuthCodes,
-                       const std::string &first_field,
-                       const std::string &second_field) {
-    if (intermediateCRSAuthCodes.empty()) {
-        return std::string();
-    }
-    std::string sql(" AND (");
-    for (size_t i = 0; i < intermediateCRSAuthCodes.size(); ++i) {
-        if (i > 0) {
-            sql += " OR";
-        }
-        sql += "(v1." + first_field + "_crs_auth_name = ? AND ";
-        sql += "v1." + first_field + "_crs_code = ? AND ";
-        sql += "v2." + second_field + "_crs_auth_name = ? AND ";
-        sql += "v2." + second_field + "_crs_code = ?) ";
+    SQLResultSet gridRows;
+    for (const auto &grid : gridsChecked) {
+        gridRows.emplace_back(SQLRow{grid.first, grid.second ? "1" : "0"});
     }
-    sql += ")";
-    return sql;
+    d->context()->d->cacheInPersistentCache(cacheKey, list, gridRows);
+    return list;
 }
-//! @endcond
 
 // ---------------------------------------------------------------------------
 
@@ -3553,6 +5135,29 @@ AuthorityFactory::createFromCRSCodesWithIntermediates(
     bool discardSuperseded,
     const std::vector<std::pair<std::string, std::string>>
         &intermediateCRSAuthCodes) const {
+    return createFromCRSCodesWithIntermediates(
+        sourceCRSAuthName, sourceCRSCode, targetCRSAuthName, targetCRSCode,
+        usePROJAlternativeGridNames, discardIfMissingGrid, discardSuperseded,
+        intermediateCRSAuthCodes, nullptr);
+}
+
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+
+// Same as above, but if areaOfInterest is not null, only the operations whose
+// area of use may intersect it are returned. The test is made on the R*Tree
+// of the areas when proj.db has it, and is conservative: operations that
+// do not intersect it may still be returned.
+std::vector<operation::CoordinateOperationNNPtr>
+AuthorityFactory::createFromCRSCodesWithIntermediates(
+    const std::string &sourceCRSAuthName, const std::string &sourceCRSCode,
+    const std::string &targetCRSAuthName, const std::string &targetCRSCode,
+    bool usePROJAlternativeGridNames, bool discardIfMissingGrid,
+    bool discardSuperseded,
+    const std::vector<std::pair<std::string, std::string>>
+        &intermediateCRSAuthCodes,
+    const metadata::ExtentPtr &areaOfInterest) const {
 
     std::vector<operation::CoordinateOperationNNPtr> listTmp;
 
@@ -3561,297 +5166,177 @@ AuthorityFactory::createFromCRSCodesWithIntermediates(
         return listTmp;
     }
 
-    const std::string sqlProlog(
-        discardSuperseded
-            ?
-
-            "SELECT v1.table_name as table1, "
-            "v1.auth_name AS auth_name1, v1.code AS code1, "
-            "v1.accuracy AS accuracy1, "
-            "v2.table_name as table2, "
-            "v2.auth_name AS auth_name2, v2.code AS code2, "
-            "v2.accuracy as accuracy2, "
-            "a1.south_lat AS south_lat1, "
-            "a1.west_lon AS west_lon1, "
-            "a1.north_lat AS north_lat1, "
-            "a1.east_lon AS east_lon1, "
-            "a2.south_lat AS south_lat2, "
-            "a2.west_lon AS west_lon2, "
-            "a2.north_lat AS north_lat2, "
-            "a2.east_lon AS east_lon2, "
-            "ss1.replacement_auth_name AS replacement_auth_name1, "
-            "ss1.replacement_code AS replacement_code1, "
-            "ss2.replacement_auth_name AS replacement_auth_name2, "
-            "ss2.replacement_code AS replacement_code2 "
-            "FROM coordinate_operation_view v1 "
-            "JOIN coordinate_operation_view v2 "
-            :
-
-            "SELECT v1.table_name as table1, "
-            "v1.auth_name AS auth_name1, v1.code AS code1, "
-            "v1.accuracy AS accuracy1, "
-            "v2.table_name as table2, "
-            "v2.auth_name AS auth_name2, v2.code AS code2, "
-            "v2.accuracy as accuracy2, "
-            "a1.south_lat AS south_lat1, "
-            "a1.west_lon AS west_lon1, "
-            "a1.north_lat AS north_lat1, "
-            "a1.east_lon AS east_lon1, "
-            "a2.south_lat AS south_lat2, "
-            "a2.west_lon AS west_lon2, "
-            "a2.north_lat AS north_lat2, "
-            "a2.east_lon AS east_lon2 "
-            "FROM coordinate_operation_view v1 "
-            "JOIN coordinate_operation_view v2 ");
-
-    const std::string joinSupersession(
-        "LEFT JOIN supersession ss1 ON "
-        "ss1.superseded_table_name = v1.table_name AND "
-        "ss1.superseded_auth_name = v1.auth_name AND "
-        "ss1.superseded_code = v1.code AND "
-        "ss1.superseded_table_name = ss1.replacement_table_name "
-        "LEFT JOIN supersession ss2 ON "
-        "ss2.superseded_table_name = v2.table_name AND "
-        "ss2.superseded_auth_name = v2.auth_name AND "
-        "ss2.superseded_code = v2.code AND "
-        "ss2.superseded_table_name = ss2.replacement_table_name ");
-    const std::string joinArea(
-        (discardSuperseded ? joinSupersession : std::string()) +
-        "JOIN area a1 ON v1.area_of_use_auth_name = a1.auth_name "
-        "AND v1.area_of_use_code = a1.code "
-        "JOIN area a2 ON v2.area_of_use_auth_name = a2.auth_name "
-        "AND v2.area_of_use_code = a2.code ");
-    const std::string orderBy(
-        "ORDER BY (CASE WHEN accuracy1 is NULL THEN 1 ELSE 0 END) + "
-        "(CASE WHEN accuracy2 is NULL THEN 1 ELSE 0 END), "
-        "accuracy1 + accuracy2");
-
-    // Case (source->intermediate) and (intermediate->target)
-    std::string sql(
-        sqlProlog + "ON v1.target_crs_auth_name = v2.source_crs_auth_name "
-                    "AND v1.target_crs_code = v2.source_crs_code " +
-        joinArea +
-        "WHERE v1.source_crs_auth_name = ? AND v1.source_crs_code = ? "
-        "AND v2.target_crs_auth_name = ? AND v2.target_crs_code = ? ");
-    auto params = ListOfParams{sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode};
-
-    std::string additionalWhere(
-        "AND v1.deprecated = 0 AND v2.deprecated = 0 "
-        "AND intersects_bbox(south_lat1, west_lon1, north_lat1, east_lon1, "
-        "south_lat2, west_lon2, north_lat2, east_lon2) == 1 ");
-    if (d->hasAuthorityRestriction()) {
-        additionalWhere += "AND v1.auth_name = ? AND v2.auth_name = ? ";
-        params.emplace_back(d->authority());
-        params.emplace_back(d->authority());
+    using OperationGraph = DatabaseContext::Private::OperationGraph;
+    const auto graph = d->context()->d->getOperationGraph();
+    const int sourceCRS =
+        OperationGraph::getId(graph->crsIds, sourceCRSAuthName, sourceCRSCode);
+    const int targetCRS =
+        OperationGraph::getId(graph->crsIds, targetCRSAuthName, targetCRSCode);
+    if (sourceCRS < 0 || targetCRS < 0) {
+        return listTmp;
     }
-    std::string intermediateWhere =
-        buildIntermediateWhere(intermediateCRSAuthCodes, "target", "source");
+
+    std::set<int> allowedIntermediateCRS;
     for (const auto &pair : intermediateCRSAuthCodes) {
-        params.emplace_back(pair.first);
-        params.emplace_back(pair.second);
-        params.emplace_back(pair.first);
-        params.emplace_back(pair.second);
+        const int crs =
+            OperationGraph::getId(graph->crsIds, pair.first, pair.second);
+        if (crs >= 0) {
+            allowedIntermediateCRS.insert(crs);
+        }
     }
-    auto res =
-        d->run(sql + additionalWhere + intermediateWhere + orderBy, params);
-
-    const auto filterOutSuperseded = [](SQLResultSet &&resultSet) {
-        std::set<std::pair<std::string, std::string>> setTransf1;
-        std::set<std::pair<std::string, std::string>> setTransf2;
-        for (const auto &row : resultSet) {
-            // table1
-            const auto &auth_name1 = row[1];
-            const auto &code1 = row[2];
-            // accuracy1
-            // table2
-            const auto &auth_name2 = row[5];
-            const auto &code2 = row[6];
-            setTransf1.insert(
-                std::pair<std::string, std::string>(auth_name1, code1));
-            setTransf2.insert(
-                std::pair<std::string, std::string>(auth_name2, code2));
-        }
-        SQLResultSet filteredResultSet;
-        for (const auto &row : resultSet) {
-            const auto &replacement_auth_name1 = row[16];
-            const auto &replacement_code1 = row[17];
-            const auto &replacement_auth_name2 = row[18];
-            const auto &replacement_code2 = row[19];
-            if (!replacement_auth_name1.empty() &&
-                setTransf1.find(std::pair<std::string, std::string>(
-                    replacement_auth_name1, replacement_code1)) !=
-                    setTransf1.end()) {
-                // Skip transformations that are superseded by others that got
-                // returned in the result set.
-                continue;
-            }
-            if (!replacement_auth_name2.empty() &&
-                setTransf2.find(std::pair<std::string, std::string>(
-                    replacement_auth_name2, replacement_code2)) !=
-                    setTransf2.end()) {
-                // Skip transformations that are superseded by others that got
-                // returned in the result set.
-                continue;
+    if (!intermediateCRSAuthCodes.empty() && allowedIntermediateCRS.empty()) {
+        return listTmp;
+    }
+
+    // Restrict both steps to the areas that may intersect the area of
+    // interest, through the R*Tree of area_index.sql
+    bool filterOnArea = false;
+    std::set<int> areasOfInterest;
+    if (areaOfInterest && d->context()->d->hasAreaIndex()) {
+        ListOfParams params;
+        const auto filter =
+            d->context()->d->getAreaIndexFilter(*areaOfInterest, "id", params);
+        if (!filter.empty()) {
+            filterOnArea = true;
+            const auto res = d->run(
+                "SELECT auth_name, code FROM area_index WHERE " + filter,
+                params);
+            for (const auto &row : res) {
+                const int area =
+                    OperationGraph::getId(graph->areaIds, row[0], row[1]);
+                if (area >= 0) {
+                    areasOfInterest.insert(area);
+                }
             }
-            filteredResultSet.emplace_back(row);
         }
-        return filteredResultSet;
-    };
-
-    if (discardSuperseded) {
-        res = filterOutSuperseded(std::move(res));
     }
-    for (const auto &row : res) {
-        const auto &table1 = row[0];
-        const auto &auth_name1 = row[1];
-        const auto &code1 = row[2];
-        // const auto &accuracy1 = row[3];
-        const auto &table2 = row[4];
-        const auto &auth_name2 = row[5];
-        const auto &code2 = row[6];
-        // const auto &accuracy2 = row[7];
-        auto op1 = d->createFactory(auth_name1)
-                       ->createCoordinateOperation(
-                           code1, true, usePROJAlternativeGridNames, table1);
-        if (useIrrelevantPivot(op1, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
-        }
-        auto op2 = d->createFactory(auth_name2)
-                       ->createCoordinateOperation(
-                           code2, true, usePROJAlternativeGridNames, table2);
-        if (useIrrelevantPivot(op2, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
-        }
 
-        listTmp.emplace_back(
-            operation::ConcatenatedOperation::createComputeMetadata({op1, op2},
-                                                                    false));
-    }
+    const auto isCandidate = [this, &graph, filterOnArea,
+                              &areasOfInterest](int index) {
+        const auto &op = graph->operations[index];
+        return (!d->hasAuthorityRestriction() ||
+                op.authName == d->authority()) &&
+               (!filterOnArea ||
+                areasOfInterest.find(op.area) != areasOfInterest.end());
+    };
 
-    // Case (source->intermediate) and (target->intermediate)
-    sql = sqlProlog + "ON v1.target_crs_auth_name = v2.target_crs_auth_name "
-                      "AND v1.target_crs_code = v2.target_crs_code " +
-          joinArea +
-          "WHERE v1.source_crs_auth_name = ? AND v1.source_crs_code = ? "
-          "AND v2.source_crs_auth_name = ? AND v2.source_crs_code = ? ";
-    intermediateWhere =
-        buildIntermediateWhere(intermediateCRSAuthCodes, "target", "target");
-    res = d->run(sql + additionalWhere + intermediateWhere + orderBy, params);
-    if (discardSuperseded) {
-        res = filterOutSuperseded(std::move(res));
-    }
-    for (const auto &row : res) {
-        const auto &table1 = row[0];
-        const auto &auth_name1 = row[1];
-        const auto &code1 = row[2];
-        // const auto &accuracy1 = row[3];
-        const auto &table2 = row[4];
-        const auto &auth_name2 = row[5];
-        const auto &code2 = row[6];
-        // const auto &accuracy2 = row[7];
-        auto op1 = d->createFactory(auth_name1)
-                       ->createCoordinateOperation(
-                           code1, true, usePROJAlternativeGridNames, table1);
-        if (useIrrelevantPivot(op1, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
+    // Pairs of operations (source, intermediate) and (intermediate, target),
+    // each of them possibly used in its reverse direction, ordered by
+    // accuracy.
+    const auto findPairs = [this, &graph, &allowedIntermediateCRS,
+                            &isCandidate, sourceCRS, targetCRS,
+                            discardSuperseded](bool reverse1, bool reverse2) {
+        std::map<int, std::vector<int>> mapIntermediateToOps2;
+        for (const int index2 : reverse2 ? graph->opsFromCRS[targetCRS]
+                                         : graph->opsToCRS[targetCRS]) {
+            const auto &op2 = graph->operations[index2];
+            const int intermediate = reverse2 ? op2.targetCRS : op2.sourceCRS;
+            if ((allowedIntermediateCRS.empty() ||
+                 allowedIntermediateCRS.find(intermediate) !=
+                     allowedIntermediateCRS.end()) &&
+                isCandidate(index2)) {
+                mapIntermediateToOps2[intermediate].push_back(index2);
+            }
         }
-        auto op2 = d->createFactory(auth_name2)
-                       ->createCoordinateOperation(
-                           code2, true, usePROJAlternativeGridNames, table2);
-        if (useIrrelevantPivot(op2, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
+
+        std::vector<std::pair<int, int>> pairs;
+        for (const int index1 : reverse1 ? graph->opsToCRS[sourceCRS]
+                                         : graph->opsFromCRS[sourceCRS]) {
+            const auto &op1 = graph->operations[index1];
+            const auto iter = mapIntermediateToOps2.find(
+                reverse1 ? op1.sourceCRS : op1.targetCRS);
+            if (iter == mapIntermediateToOps2.end() || !isCandidate(index1)) {
+                continue;
+            }
+            for (const int index2 : iter->second) {
+                if (op1.bbox->intersects(
+                        NN_NO_CHECK(graph->operations[index2].bbox))) {
+                    pairs.emplace_back(index1, index2);
+                }
+            }
         }
 
-        listTmp.emplace_back(
-            operation::ConcatenatedOperation::createComputeMetadata(
-                {op1, op2->inverse()}, false));
-    }
+        // Operations with unknown accuracy last
+        const auto sortKey = [&graph](const std::pair<int, int> &pair) {
+            const double accuracy1 = graph->operations[pair.first].accuracy;
+            const double accuracy2 = graph->operations[pair.second].accuracy;
+            const int countUnknown = (accuracy1 < 0 ? 1 : 0) +
+                                     (accuracy2 < 0 ? 1 : 0);
+            return std::make_pair(
+                countUnknown, countUnknown == 0 ? accuracy1 + accuracy2 : 0.0);
+        };
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [&sortKey](const std::pair<int, int> &a,
+                                    const std::pair<int, int> &b) {
+                             return sortKey(a) < sortKey(b);
+                         });
 
-    // Case (intermediate->source) and (intermediate->target)
-    sql = sqlProlog + "ON v1.source_crs_auth_name = v2.source_crs_auth_name "
-                      "AND v1.source_crs_code = v2.source_crs_code " +
-          joinArea +
-          "WHERE v1.target_crs_auth_name = ? AND v1.target_crs_code = ? "
-          "AND v2.target_crs_auth_name = ? AND v2.target_crs_code = ? ";
-    intermediateWhere =
-        buildIntermediateWhere(intermediateCRSAuthCodes, "source", "source");
-    res = d->run(sql + additionalWhere + intermediateWhere + orderBy, params);
-    if (discardSuperseded) {
-        res = filterOutSuperseded(std::move(res));
-    }
-    for (const auto &row : res) {
-        const auto &table1 = row[0];
-        const auto &auth_name1 = row[1];
-        const auto &code1 = row[2];
-        // const auto &accuracy1 = row[3];
-        const auto &table2 = row[4];
-        const auto &auth_name2 = row[5];
-        const auto &code2 = row[6];
-        // const auto &accuracy2 = row[7];
-        auto op1 = d->createFactory(auth_name1)
-                       ->createCoordinateOperation(
-                           code1, true, usePROJAlternativeGridNames, table1);
-        if (useIrrelevantPivot(op1, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
-        }
-        auto op2 = d->createFactory(auth_name2)
-                       ->createCoordinateOperation(
-                           code2, true, usePROJAlternativeGridNames, table2);
-        if (useIrrelevantPivot(op2, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
+        if (discardSuperseded) {
+            // Skip operations that are superseded by others that got
+            // returned in the result set.
+            std::set<int> setOps1;
+            std::set<int> setOps2;
+            for (const auto &pair : pairs) {
+                setOps1.insert(pair.first);
+                setOps2.insert(pair.second);
+            }
+            const auto isSuperseded = [&graph](int index,
+                                               const std::set<int> &setOps) {
+                for (const int replacement :
+                     graph->operations[index].replacements) {
+                    if (setOps.find(replacement) != setOps.end()) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            std::vector<std::pair<int, int>> filteredPairs;
+            for (const auto &pair : pairs) {
+                if (!isSuperseded(pair.first, setOps1) &&
+                    !isSuperseded(pair.second, setOps2)) {
+                    filteredPairs.emplace_back(pair);
+                }
+            }
+            pairs = std::move(filteredPairs);
         }
+        return pairs;
+    };
 
-        listTmp.emplace_back(
-            operation::ConcatenatedOperation::createComputeMetadata(
-                {op1->inverse(), op2}, false));
-    }
+    // Case (source->intermediate) and (intermediate->target), then
+    // (source->intermediate) and (target->intermediate),
+    // (intermediate->source) and (intermediate->target), and
+    // (intermediate->source) and (target->intermediate)
+    for (const bool reverse1 : {false, true}) {
+        for (const bool reverse2 : {false, true}) {
+            for (const auto &pair : findPairs(reverse1, reverse2)) {
+                const auto &opDesc1 = graph->operations[pair.first];
+                const auto &opDesc2 = graph->operations[pair.second];
+                auto op1 = d->createFactory(opDesc1.authName)
+                               ->createCoordinateOperation(
+                                   opDesc1.code, true,
+                                   usePROJAlternativeGridNames,
+                                   opDesc1.tableName);
+                if (useIrrelevantPivot(op1, sourceCRSAuthName, sourceCRSCode,
+                                       targetCRSAuthName, targetCRSCode)) {
+                    continue;
+                }
+                auto op2 = d->createFactory(opDesc2.authName)
+                               ->createCoordinateOperation(
+                                   opDesc2.code, true,
+                                   usePROJAlternativeGridNames,
+                                   opDesc2.tableName);
+                if (useIrrelevantPivot(op2, sourceCRSAuthName, sourceCRSCode,
+                                       targetCRSAuthName, targetCRSCode)) {
+                    continue;
+                }
 
-    // Case (intermediate->source) and (target->intermediate)
-    sql = sqlProlog + "ON v1.source_crs_auth_name = v2.target_crs_auth_name "
-                      "AND v1.source_crs_code = v2.target_crs_code " +
-          joinArea +
-          "WHERE v1.target_crs_auth_name = ? AND v1.target_crs_code = ? "
-          "AND v2.source_crs_auth_name = ? AND v2.source_crs_code = ? ";
-    intermediateWhere =
-        buildIntermediateWhere(intermediateCRSAuthCodes, "source", "target");
-    res = d->run(sql + additionalWhere + intermediateWhere + orderBy, params);
-    if (discardSuperseded) {
-        res = filterOutSuperseded(std::move(res));
-    }
-    for (const auto &row : res) {
-        const auto &table1 = row[0];
-        const auto &auth_name1 = row[1];
-        const auto &code1 = row[2];
-        // const auto &accuracy1 = row[3];
-        const auto &table2 = row[4];
-        const auto &auth_name2 = row[5];
-        const auto &code2 = row[6];
-        // const auto &accuracy2 = row[7];
-        auto op1 = d->createFactory(auth_name1)
-                       ->createCoordinateOperation(
-                           code1, true, usePROJAlternativeGridNames, table1);
-        if (useIrrelevantPivot(op1, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
-        }
-        auto op2 = d->createFactory(auth_name2)
-                       ->createCoordinateOperation(
-                           code2, true, usePROJAlternativeGridNames, table2);
-        if (useIrrelevantPivot(op2, sourceCRSAuthName, sourceCRSCode,
-                               targetCRSAuthName, targetCRSCode)) {
-            continue;
+                listTmp.emplace_back(
+                    operation::ConcatenatedOperation::createComputeMetadata(
+                        {reverse1 ? op1->inverse() : op1,
+                         reverse2 ? op2->inverse() : op2},
+                        false));
+            }
         }
-
-        listTmp.emplace_back(
-            operation::ConcatenatedOperation::createComputeMetadata(
-                {op1->inverse(), op2->inverse()}, false));
     }
 
     std::vector<operation::CoordinateOperationNNPtr> list;
@@ -3864,6 +5349,8 @@ AuthorityFactory::createFromCRSCodesWithIntermediates(
     return list;
 }
 
+//! @endcond
+
 // ---------------------------------------------------------------------------
 
 /** \brief Returns the authority name associated to this factory.
@@ -4134,6 +5621,13 @@ AuthorityFactory::createObjectsFromName(
         return {};
     }
 
+    // Querying geodetic datum is a super hot path when importing from WKT1
+    // so cache results.
+    const bool useGRFNameCache =
+        allowedObjectTypes.size() == 1 &&
+        allowedObjectTypes[0] == ObjectType::GEODETIC_REFERENCE_FRAME &&
+        approximateMatch && d->authority().empty();
+
     std::string sql(
         "SELECT table_name, auth_name, code, name FROM object_view WHERE "
         "deprecated = ? AND ");
@@ -4246,26 +5740,22 @@ AuthorityFactory::createObjectsFromName(
             sql += ')';
         }
     }
-    sql += " ORDER BY length(name), name";
+    std::string sqlSuffix(" ORDER BY length(name), name");
     if (limitResultCount > 0 &&
         limitResultCount <
             static_cast<size_t>(std::numeric_limits<int>::max()) &&
         !approximateMatch) {
-        sql += " LIMIT ";
-        sql += toString(static_cast<int>(limitResultCount));
+        sqlSuffix += " LIMIT ";
+        sqlSuffix += toString(static_cast<int>(limitResultCount));
     }
 
     std::list<common::IdentifiedObjectNNPtr> res;
 
-    // Querying geodetic datum is a super hot path when importing from WKT1
-    // so cache results.
-    if (allowedObjectTypes.size() == 1 &&
-        allowedObjectTypes[0] == ObjectType::GEODETIC_REFERENCE_FRAME &&
-        approximateMatch && d->authority().empty()) {
+    if (useGRFNameCache) {
         auto &mapCanonicalizeGRFName =
             d->context()->getPrivate()->getMapCanonicalizeGRFName();
         if (mapCanonicalizeGRFName.empty()) {
-            auto sqlRes = d->run(sql, params);
+            auto sqlRes = d->run(sql + sqlSuffix, params);
             for (const auto &row : sqlRes) {
                 const auto &name = row[3];
                 const auto canonicalizedName(
@@ -4320,57 +5810,91 @@ AuthorityFactory::createObjectsFromName(
             }
         }
     } else {
-        auto sqlRes = d->run(sql, params);
-        for (const auto &row : sqlRes) {
-            const auto &name = row[3];
-            if (approximateMatch) {
-                bool match = ci_find(name, searchedNameWithoutDeprecated) !=
-                             std::string::npos;
-                if (!match) {
-                    const auto canonicalizedName(
-                        metadata::Identifier::canonicalizeName(name));
-                    match =
-                        ci_find(canonicalizedName, canonicalizedSearchedName) !=
-                        std::string::npos;
+        // Returns whether limitResultCount has been reached
+        const auto addObjects = [this, &res,
+                                 limitResultCount](const SQLResultSet &rows) {
+            for (const auto &row : rows) {
+                const auto &table_name = row[0];
+                const auto &auth_name = row[1];
+                const auto &code = row[2];
+                auto factory = d->createFactory(auth_name);
+                if (table_name == "prime_meridian") {
+                    res.emplace_back(factory->createPrimeMeridian(code));
+                } else if (table_name == "ellipsoid") {
+                    res.emplace_back(factory->createEllipsoid(code));
+                } else if (table_name == "geodetic_datum") {
+                    res.emplace_back(factory->createGeodeticDatum(code));
+                } else if (table_name == "vertical_datum") {
+                    res.emplace_back(factory->createVerticalDatum(code));
+                } else if (table_name == "geodetic_crs") {
+                    res.emplace_back(factory->createGeodeticCRS(code));
+                } else if (table_name == "projected_crs") {
+                    res.emplace_back(factory->createProjectedCRS(code));
+                } else if (table_name == "vertical_crs") {
+                    res.emplace_back(factory->createVerticalCRS(code));
+                } else if (table_name == "compound_crs") {
+                    res.emplace_back(factory->createCompoundCRS(code));
+                } else if (table_name == "conversion") {
+                    res.emplace_back(factory->createConversion(code));
+                } else if (table_name == "grid_transformation" ||
+                           table_name == "helmert_transformation" ||
+                           table_name == "other_transformation" ||
+                           table_name == "concatenated_operation") {
+                    res.emplace_back(
+                        factory->createCoordinateOperation(code, true));
+                } else {
+                    assert(false);
                 }
-                if (!match) {
-                    continue;
+                if (limitResultCount > 0 && res.size() == limitResultCount) {
+                    return true;
                 }
             }
-            const auto &table_name = row[0];
-            const auto &auth_name = row[1];
-            const auto &code = row[2];
-            auto factory = d->createFactory(auth_name);
-            if (table_name == "prime_meridian") {
-                res.emplace_back(factory->createPrimeMeridian(code));
-            } else if (table_name == "ellipsoid") {
-                res.emplace_back(factory->createEllipsoid(code));
-            } else if (table_name == "geodetic_datum") {
-                res.emplace_back(factory->createGeodeticDatum(code));
-            } else if (table_name == "vertical_datum") {
-                res.emplace_back(factory->createVerticalDatum(code));
-            } else if (table_name == "geodetic_crs") {
-                res.emplace_back(factory->createGeodeticCRS(code));
-            } else if (table_name == "projected_crs") {
-                res.emplace_back(factory->createProjectedCRS(code));
-            } else if (table_name == "vertical_crs") {
-                res.emplace_back(factory->createVerticalCRS(code));
-            } else if (table_name == "compound_crs") {
-                res.emplace_back(factory->createCompoundCRS(code));
-            } else if (table_name == "conversion") {
-                res.emplace_back(factory->createConversion(code));
-            } else if (table_name == "grid_transformation" ||
-                       table_name == "helmert_transformation" ||
-                       table_name == "other_transformation" ||
-                       table_name == "concatenated_operation") {
-                res.emplace_back(
-                    factory->createCoordinateOperation(code, true));
-            } else {
-                assert(false);
+            return false;
+        };
+
+        // Beyond that many matching names, reading all the rows is cheaper
+        // than looking them up by name, e.g. for names shorter than the
+        // trigrams of the index, which all names are candidates for.
+        constexpr size_t CHUNK_SIZE = 100;
+        constexpr size_t MAX_CHUNKS = 10;
+        std::vector<std::string> names;
+        if (approximateMatch) {
+            names = d->context()->getPrivate()->getNameIndex()->find(
+                searchedNameWithoutDeprecated, canonicalizedSearchedName);
+        }
+        if (approximateMatch && names.size() <= CHUNK_SIZE * MAX_CHUNKS) {
+            // Only read the rows of the matching names, by chunks. The names
+            // are sorted as by sqlSuffix, so the concatenated chunks are.
+            // Chunks are padded with the last name, which does not change
+            // the result, so that a single statement is prepared.
+            std::string chunkSql(sql);
+            chunkSql += " AND name IN (?";
+            for (size_t j = 1; j < CHUNK_SIZE; ++j) {
+                chunkSql += ",?";
             }
-            if (limitResultCount > 0 && res.size() == limitResultCount) {
-                break;
+            chunkSql += ')';
+            chunkSql += sqlSuffix;
+            for (size_t i = 0; i < names.size(); i += CHUNK_SIZE) {
+                auto chunkParams(params);
+                for (size_t j = 0; j < CHUNK_SIZE; ++j) {
+                    chunkParams.emplace_back(
+                        names[std::min(i + j, names.size() - 1)]);
+                }
+                if (addObjects(d->run(chunkSql, chunkParams))) {
+                    break;
+                }
+            }
+        } else if (approximateMatch) {
+            const std::set<std::string> nameSet(names.begin(), names.end());
+            SQLResultSet sqlRes;
+            for (auto &row : d->run(sql + sqlSuffix, params)) {
+                if (nameSet.find(row[3]) != nameSet.end()) {
+                    sqlRes.emplace_back(std::move(row));
+                }
             }
+            addObjects(sqlRes);
+        } else {
+            addObjects(d->run(sql + sqlSuffix, params));
         }
     }
 
@@ -4552,6 +6076,259 @@ AuthorityFactory::createGeodeticCRSFromEllipsoid(
 
 // ---------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+std::string DatabaseContext::Private::CRSFingerprintIndex::
+    getProjectedCRSFingerprint(double semiMajorAxis, double invFlattening,
+                               double pmLongitude, int methodCode,
+                               std::vector<Parameter> &params) {
+    // Values are rounded to quanta well above the tolerance of
+    // Measure::_isEquivalentTo(), so that equivalent values almost always
+    // get the same fingerprint.
+    const auto round = [](double value, common::UnitOfMeasure::Type type) {
+        const double quantum =
+            type == common::UnitOfMeasure::Type::LINEAR ? 1e-2 : 1e-8;
+        return static_cast<long long>(std::llround(value / quantum));
+    };
+
+    std::sort(params.begin(), params.end(),
+              [](const Parameter &a, const Parameter &b) {
+                  return a.code < b.code;
+              });
+    if (methodCode == EPSG_CODE_METHOD_LAMBERT_CONIC_CONFORMAL_2SP) {
+        // The standard parallels can be switched
+        Parameter *lat1 = nullptr;
+        Parameter *lat2 = nullptr;
+        for (auto &param : params) {
+            if (param.code == EPSG_CODE_PARAMETER_LATITUDE_1ST_STD_PARALLEL) {
+                lat1 = &param;
+            } else if (param.code ==
+                       EPSG_CODE_PARAMETER_LATITUDE_2ND_STD_PARALLEL) {
+                lat2 = &param;
+            }
+        }
+        if (lat1 && lat2 && lat1->siValue > lat2->siValue) {
+            std::swap(lat1->siValue, lat2->siValue);
+        }
+    }
+
+    std::ostringstream buffer;
+    buffer.imbue(std::locale::classic());
+    buffer << round(semiMajorAxis, common::UnitOfMeasure::Type::LINEAR) << ','
+           << std::llround(invFlattening * 1e6) << ','
+           << round(pmLongitude, common::UnitOfMeasure::Type::ANGULAR) << ';'
+           << methodCode;
+    for (const auto &param : params) {
+        buffer << ';' << param.code << '=' << round(param.siValue, param.type);
+    }
+    return buffer.str();
+}
+
+// ---------------------------------------------------------------------------
+
+std::string DatabaseContext::Private::CRSFingerprintIndex::
+    getProjectedCRSFingerprint(const crs::ProjectedCRS &crs) {
+    const auto &conv = crs.derivingConversionRef();
+    const auto methodEPSGCode = conv->method()->getEPSGCode();
+    if (methodEPSGCode == 0) {
+        return std::string();
+    }
+    std::vector<Parameter> params;
+    for (const auto &genOpParamvalue : conv->parameterValues()) {
+        auto opParamvalue =
+            dynamic_cast<const operation::OperationParameterValue *>(
+                genOpParamvalue.get());
+        if (!opParamvalue) {
+            return std::string();
+        }
+        const auto paramEPSGCode = opParamvalue->parameter()->getEPSGCode();
+        const auto &parameterValue = opParamvalue->parameterValue();
+        if (!(paramEPSGCode > 0 &&
+              parameterValue->type() ==
+                  operation::ParameterValue::Type::MEASURE)) {
+            return std::string();
+        }
+        const auto &measure = parameterValue->value();
+        params.push_back(Parameter{paramEPSGCode, measure.getSIValue(),
+                                   measure.unit().type()});
+    }
+
+    const auto &baseCRS(crs.baseCRS());
+    const auto &ellipsoid(baseCRS->ellipsoid());
+    return getProjectedCRSFingerprint(
+        ellipsoid->semiMajorAxis().getSIValue(),
+        ellipsoid->computedInverseFlattening(),
+        baseCRS->primeMeridian()->longitude().getSIValue(), methodEPSGCode,
+        params);
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::CRSFingerprintIndex>
+DatabaseContext::Private::CRSFingerprintIndex::build(Private *db) {
+    auto index = std::make_shared<CRSFingerprintIndex>();
+
+    struct Unit {
+        double convFactor;
+        common::UnitOfMeasure::Type type;
+    };
+    std::map<AuthCode, Unit> units;
+    {
+        SQLCursor cursor(db, "SELECT auth_name, code, conv_factor, type FROM "
+                             "unit_of_measure WHERE conv_factor IS NOT NULL");
+        while (cursor.next()) {
+            auto type = common::UnitOfMeasure::Type::UNKNOWN;
+            if (cursor.equals(3, "length"))
+                type = common::UnitOfMeasure::Type::LINEAR;
+            else if (cursor.equals(3, "angle"))
+                type = common::UnitOfMeasure::Type::ANGULAR;
+            else if (cursor.equals(3, "scale"))
+                type = common::UnitOfMeasure::Type::SCALE;
+            else if (cursor.equals(3, "time"))
+                type = common::UnitOfMeasure::Type::TIME;
+            units[AuthCode(cursor.str(0), cursor.str(1))] =
+                Unit{cursor.getDouble(2), type};
+        }
+    }
+    // Value in SI unit of the measure in columns idx to idx + 2 (value,
+    // uom_auth_name, uom_code). Returns false for unknown units.
+    const auto getSIValue = [&units](const SQLCursor &cursor, int idx,
+                                     double &value,
+                                     common::UnitOfMeasure::Type &type) {
+        std::string normalized_uom_code;
+        const double normalized_value = normalizeMeasure(
+            cursor.str(idx + 2), cursor.getDouble(idx), normalized_uom_code);
+        const auto iter =
+            units.find(AuthCode(cursor.str(idx + 1), normalized_uom_code));
+        if (iter == units.end()) {
+            return false;
+        }
+        value = normalized_value * iter->second.convFactor;
+        type = iter->second.type;
+        return true;
+    };
+
+    constexpr int N_MAX_PARAMS = 7;
+    std::string sql("SELECT p.auth_name, p.code, "
+                    "p.geodetic_crs_auth_name, p.geodetic_crs_code, "
+                    "e.semi_major_axis, e.uom_auth_name, e.uom_code, "
+                    "e.inv_flattening, e.semi_minor_axis, "
+                    "pm.longitude, pm.uom_auth_name, pm.uom_code, "
+                    "c.method_code");
+    for (int i = 1; i <= N_MAX_PARAMS; ++i) {
+        const auto iAsStr(toString(i));
+        for (const char *field : {"_auth_name", "_code", "_value",
+                                  "_uom_auth_name", "_uom_code"}) {
+            sql += ", c.param";
+            sql += iAsStr;
+            sql += field;
+        }
+    }
+    sql += " FROM projected_crs p "
+           "JOIN conversion c ON p.conversion_auth_name = c.auth_name "
+           "AND p.conversion_code = c.code "
+           "JOIN geodetic_crs g ON p.geodetic_crs_auth_name = g.auth_name "
+           "AND p.geodetic_crs_code = g.code "
+           "JOIN geodetic_datum d ON g.datum_auth_name = d.auth_name "
+           "AND g.datum_code = d.code "
+           "JOIN ellipsoid e ON d.ellipsoid_auth_name = e.auth_name "
+           "AND d.ellipsoid_code = e.code "
+           "JOIN prime_meridian pm ON "
+           "d.prime_meridian_auth_name = pm.auth_name "
+           "AND d.prime_meridian_code = pm.code "
+           "WHERE p.deprecated = 0 AND c.method_auth_name = 'EPSG'";
+
+    SQLCursor cursor(db, sql);
+    std::vector<Parameter> params;
+    while (cursor.next()) {
+        double semiMajorAxis = 0;
+        double pmLongitude = 0;
+        auto type = common::UnitOfMeasure::Type::UNKNOWN;
+        if (!getSIValue(cursor, 4, semiMajorAxis, type) ||
+            !getSIValue(cursor, 9, pmLongitude, type)) {
+            continue;
+        }
+        double invFlattening = 0;
+        if (!cursor.isNull(7)) {
+            invFlattening = cursor.getDouble(7);
+        } else {
+            const double semiMinorAxis =
+                semiMajorAxis / cursor.getDouble(4) * cursor.getDouble(8);
+            if (semiMinorAxis != semiMajorAxis) {
+                invFlattening = semiMajorAxis / (semiMajorAxis - semiMinorAxis);
+            }
+        }
+
+        params.clear();
+        bool ok = true;
+        for (int i = 0; i < N_MAX_PARAMS && ok; ++i) {
+            const int idx = 13 + i * 5;
+            if (cursor.isNull(idx)) {
+                break;
+            }
+            Parameter param;
+            ok = cursor.equals(idx, "EPSG") &&
+                 getSIValue(cursor, idx + 2, param.siValue, param.type);
+            param.code = atoi(cursor.cstr(idx + 1));
+            params.push_back(param);
+        }
+        if (!ok) {
+            continue;
+        }
+        index
+            ->projectedCRS[getProjectedCRSFingerprint(
+                semiMajorAxis, invFlattening, pmLongitude,
+                atoi(cursor.cstr(12)), params)]
+            .emplace_back(
+                ProjectedCRS{AuthCode(cursor.str(0), cursor.str(1)),
+                             AuthCode(cursor.str(2), cursor.str(3))});
+    }
+
+    // The CRS defined by a text_definition are parsed without database
+    // context, which is much faster and enough for their fingerprint.
+    SQLCursor cursorText(
+        db, "SELECT auth_name, code, geodetic_crs_auth_name, "
+            "geodetic_crs_code, text_definition FROM projected_crs "
+            "WHERE deprecated = 0 AND text_definition IS NOT NULL");
+    while (cursorText.next()) {
+        try {
+            auto obj = createFromUserInput(cursorText.str(4), nullptr);
+            auto crs = dynamic_cast<const crs::ProjectedCRS *>(obj.get());
+            if (!crs) {
+                continue;
+            }
+            const auto fingerprint = getProjectedCRSFingerprint(*crs);
+            if (!fingerprint.empty()) {
+                index->projectedCRS[fingerprint].emplace_back(ProjectedCRS{
+                    AuthCode(cursorText.str(0), cursorText.str(1)),
+                    AuthCode(cursorText.str(2), cursorText.str(3))});
+            }
+        } catch (const std::exception &) {
+        }
+    }
+    return index;
+}
+
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const DatabaseContext::Private::CRSFingerprintIndex>
+DatabaseContext::Private::getCRSFingerprintIndex() {
+    if (!crsFingerprintIndex_) {
+        if (shared_) {
+            std::lock_guard<std::mutex> lock(shared_->crsFingerprintIndexMutex);
+            if (!shared_->crsFingerprintIndex) {
+                shared_->crsFingerprintIndex = CRSFingerprintIndex::build(this);
+            }
+            crsFingerprintIndex_ = shared_->crsFingerprintIndex;
+        } else {
+            crsFingerprintIndex_ = CRSFingerprintIndex::build(this);
+        }
+    }
+    return crsFingerprintIndex_;
+}
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
 //! @cond Doxygen_Suppress
 static std::string buildSqlLookForAuthNameCode(
     const std::list<std::pair<crs::CRSNNPtr, int>> &list, ListOfParams &params,
@@ -4851,6 +6628,47 @@ AuthorityFactory::createProjectedCRSFromExisting(
 
 // ---------------------------------------------------------------------------
 
+std::list<crs::ProjectedCRSNNPtr>
+AuthorityFactory::createProjectedCRSFromFingerprint(
+    const crs::ProjectedCRSNNPtr &crs,
+    const std::list<std::pair<crs::GeodeticCRSNNPtr, int>> &candidatesBaseCRS)
+    const {
+    std::list<crs::ProjectedCRSNNPtr> res;
+    const auto fingerprint = DatabaseContext::Private::CRSFingerprintIndex::
+        getProjectedCRSFingerprint(*crs);
+    if (fingerprint.empty()) {
+        return res;
+    }
+
+    const auto index = d->context()->d->getCRSFingerprintIndex();
+    const auto iter = index->projectedCRS.find(fingerprint);
+    if (iter == index->projectedCRS.end()) {
+        return res;
+    }
+    std::set<std::pair<std::string, std::string>> baseCRSAuthCodes;
+    for (const auto &pair : candidatesBaseCRS) {
+        const auto &ids = pair.first->identifiers();
+        if (!ids.empty()) {
+            baseCRSAuthCodes.emplace(*(ids[0]->codeSpace()), ids[0]->code());
+        }
+    }
+    for (const auto &entry : iter->second) {
+        if (d->hasAuthorityRestriction() &&
+            entry.crs.first != d->authority()) {
+            continue;
+        }
+        if (!baseCRSAuthCodes.empty() &&
+            baseCRSAuthCodes.find(entry.baseCRS) == baseCRSAuthCodes.end()) {
+            continue;
+        }
+        res.emplace_back(d->createFactory(entry.crs.first)
+                             ->createProjectedCRS(entry.crs.second));
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
 std::list<crs::CompoundCRSNNPtr>
 AuthorityFactory::createCompoundCRSFromExisting(
     const crs::CompoundCRSNNPtr &crs) const {
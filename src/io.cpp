@@ -119,6 +119,7 @@ struct WKTFormatter::Private {
         bool strict_ = true;
         int indentWidth_ = 4;
         bool idOnTopLevelOnly_ = false;
+        bool idOnAllNodes_ = false;
         bool outputAxisOrder_ = false;
         bool primeMeridianOmittedIfGreenwich_ = false;
         bool ellipsoidUnitOmittedIfMetre_ = false;
@@ -338,6 +339,11 @@ WKTFormatter &WKTFormatter::setOutputId(bool outputIdIn) {
     return *this;
 }
 
+WKTFormatter &WKTFormatter::setOutputIdOnAllNodes(bool outputIdOnAllNodes) {
+    d->params_.idOnAllNodes_ = outputIdOnAllNodes;
+    return *this;
+}
+
 // ---------------------------------------------------------------------------
 
 void WKTFormatter::Private::addNewLine() { result_ += '\n'; }
@@ -402,7 +408,9 @@ void WKTFormatter::startNode(const std::string &keyword, bool hasId) {
     // set.
     // For WKT2, all other intermediate nodes shouldn't have ID ("not
     // recommended")
-    if (!d->params_.idOnTopLevelOnly_ && d->indentLevel_ >= 2 &&
+    if (d->params_.idOnAllNodes_) {
+        pushOutputId(d->outputIdStack_[0]);
+    } else if (!d->params_.idOnTopLevelOnly_ && d->indentLevel_ >= 2 &&
         d->params_.version_ == WKTFormatter::Version::WKT2 &&
         (keyword == WKTConstants::METHOD ||
          keyword == WKTConstants::PARAMETER)) {
@@ -979,55 +987,97 @@ static const std::string startPrintedQuote("\xE2\x80\x9C");
 static const std::string endPrintedQuote("\xE2\x80\x9D");
 //! @endcond
 
-WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
-                                 int recLevel, size_t &indexEnd) {
-    if (recLevel == 16) {
-        throw ParsingException("too many nesting levels");
-    }
-    std::string value;
-    size_t i = skipSpace(wkt, indexStart);
-    if (i == wkt.size()) {
-        throw ParsingException("whitespace only string");
-    }
-    std::string closingStringMarker;
-    bool inString = false;
+//! @cond Doxygen_Suppress
+
+// Scan the value of a WKT node starting at index i, up to the first
+// delimiter found outside of a quoted string, and return the index of its end.
+// needsTranslation is set if the value differs from the scanned characters,
+// that is if it contains doubled or printed quotes. If value is not null, the
+// translated value is appended to it.
+static size_t scanWKTValue(const std::string &wkt, size_t i, std::string *value,
+                           bool &needsTranslation) {
+    enum class Quote { NONE, ASCII, PRINTED };
+    Quote quote = Quote::NONE;
+    needsTranslation = false;
 
     for (; i < wkt.size() &&
-           (inString || (wkt[i] != '[' && wkt[i] != '(' && wkt[i] != ',' &&
-                         wkt[i] != ']' && wkt[i] != ')' && !::isspace(wkt[i])));
+           (quote != Quote::NONE ||
+            (wkt[i] != '[' && wkt[i] != '(' && wkt[i] != ',' &&
+             wkt[i] != ']' && wkt[i] != ')' && !::isspace(wkt[i])));
          ++i) {
-        if (wkt[i] == '"') {
-            if (!inString) {
-                inString = true;
-                closingStringMarker = "\"";
-            } else if (closingStringMarker == "\"") {
+        const char ch = wkt[i];
+        if (ch == '"') {
+            if (quote == Quote::NONE) {
+                quote = Quote::ASCII;
+            } else if (quote == Quote::ASCII) {
                 if (i + 1 < wkt.size() && wkt[i + 1] == '"') {
+                    needsTranslation = true;
                     i++;
                 } else {
-                    inString = false;
-                    closingStringMarker.clear();
+                    quote = Quote::NONE;
                 }
             }
-        } else if (i + 3 <= wkt.size() &&
-                   wkt.substr(i, 3) == startPrintedQuote) {
-            if (!inString) {
-                inString = true;
-                closingStringMarker = endPrintedQuote;
-                value += '"';
+        } else if (ch == startPrintedQuote[0] && i + 3 <= wkt.size() &&
+                   wkt.compare(i, 3, startPrintedQuote) == 0) {
+            if (quote == Quote::NONE) {
+                quote = Quote::PRINTED;
+                needsTranslation = true;
+                if (value) {
+                    *value += '"';
+                }
                 i += 2;
                 continue;
             }
-        } else if (i + 3 <= wkt.size() &&
-                   closingStringMarker == endPrintedQuote &&
-                   wkt.substr(i, 3) == endPrintedQuote) {
-            inString = false;
-            closingStringMarker.clear();
-            value += '"';
+        } else if (ch == endPrintedQuote[0] && quote == Quote::PRINTED &&
+                   i + 3 <= wkt.size() &&
+                   wkt.compare(i, 3, endPrintedQuote) == 0) {
+            quote = Quote::NONE;
+            if (value) {
+                *value += '"';
+            }
             i += 2;
             continue;
         }
-        value += wkt[i];
+        if (value) {
+            *value += ch;
+        }
     }
+    return i;
+}
+
+// ---------------------------------------------------------------------------
+
+// Node of a WKT string, as found by tokenizeWKT(). The value is not copied,
+// but refers to a range of the WKT string.
+struct WKTToken {
+    size_t valueStart;
+    size_t valueLength;
+    bool needsTranslation;
+    size_t childrenCount;
+};
+
+// ---------------------------------------------------------------------------
+
+// Append the node starting at indexStart, and then its descendants in
+// depth-first order, to tokens.
+static void tokenizeWKT(const std::string &wkt, size_t indexStart, int recLevel,
+                        size_t &indexEnd, std::vector<WKTToken> &tokens) {
+    if (recLevel == 16) {
+        throw ParsingException("too many nesting levels");
+    }
+    size_t i = skipSpace(wkt, indexStart);
+    if (i == wkt.size()) {
+        throw ParsingException("whitespace only string");
+    }
+
+    const size_t tokenIdx = tokens.size();
+    WKTToken token;
+    token.valueStart = i;
+    i = scanWKTValue(wkt, i, nullptr, token.needsTranslation);
+    token.valueLength = i - token.valueStart;
+    token.childrenCount = 0;
+    tokens.push_back(token);
+
     i = skipSpace(wkt, i);
     if (i == wkt.size()) {
         if (indexStart == 0) {
@@ -1037,16 +1087,14 @@ WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
         }
     }
 
-    auto node = NN_NO_CHECK(internal::make_unique<WKTNode>(value));
-
     if (indexStart > 0) {
         if (wkt[i] == ',') {
             indexEnd = i + 1;
-            return node;
+            return;
         }
         if (wkt[i] == ']' || wkt[i] == ')') {
             indexEnd = i;
-            return node;
+            return;
         }
     }
     if (wkt[i] != '[' && wkt[i] != '(') {
@@ -1056,7 +1104,8 @@ WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
     i = skipSpace(wkt, i);
     while (i < wkt.size() && wkt[i] != ']' && wkt[i] != ')') {
         size_t indexEndChild;
-        node->addChild(createFrom(wkt, i, recLevel + 1, indexEndChild));
+        tokenizeWKT(wkt, i, recLevel + 1, indexEndChild, tokens);
+        tokens[tokenIdx].childrenCount++;
         assert(indexEndChild > i);
         i = indexEndChild;
         i = skipSpace(wkt, i);
@@ -1069,7 +1118,55 @@ WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
         throw ParsingException("missing ]");
     }
     indexEnd = i + 1;
-    return node;
+}
+
+//! @endcond
+
+// ---------------------------------------------------------------------------
+
+WKTNodeNNPtr WKTNode::createFrom(const std::string &wkt, size_t indexStart,
+                                 int recLevel, size_t &indexEnd) {
+    // First tokenize the whole string into a flat array, so that the tree
+    // can be built with a single allocation per value and per children array.
+    std::vector<WKTToken> tokens;
+    tokens.reserve(wkt.size() / 16);
+    tokenizeWKT(wkt, indexStart, recLevel, indexEnd, tokens);
+
+    const auto createNode = [&wkt](const WKTToken &token) {
+        auto node = NN_NO_CHECK(internal::make_unique<WKTNode>(std::string()));
+        auto &value = node->d->value_;
+        if (token.needsTranslation) {
+            bool needsTranslation;
+            value.reserve(token.valueLength);
+            scanWKTValue(wkt, token.valueStart, &value, needsTranslation);
+        } else {
+            value.assign(wkt, token.valueStart, token.valueLength);
+        }
+        node->d->children_.reserve(token.childrenCount);
+        return node;
+    };
+
+    auto root = createNode(tokens[0]);
+
+    // Nodes whose children are not all created yet, with the count of
+    // missing children.
+    std::vector<std::pair<WKTNode *, size_t>> stack;
+    if (tokens[0].childrenCount > 0) {
+        stack.emplace_back(root.get(), tokens[0].childrenCount);
+    }
+    for (size_t k = 1; k < tokens.size(); ++k) {
+        assert(!stack.empty());
+        auto parent = stack.back().first;
+        parent->d->children_.emplace_back(createNode(tokens[k]));
+        if (--stack.back().second == 0) {
+            stack.pop_back();
+        }
+        if (tokens[k].childrenCount > 0) {
+            stack.emplace_back(parent->d->children_.back().get(),
+                               tokens[k].childrenCount);
+        }
+    }
+    return root;
 }
 // ---------------------------------------------------------------------------
 
@@ -5756,13 +5853,7 @@ static bool isProjectedStep(const std::string &name) {
         name == "vgridshit") {
         return false;
     }
-    const auto *operations = proj_list_operations();
-    for (int i = 0; operations[i].id != nullptr; ++i) {
-        if (name == operations[i].id) {
-            return true;
-        }
-    }
-    return false;
+    return pj_find_operation(name.c_str()) != nullptr;
 }
 
 // ---------------------------------------------------------------------------
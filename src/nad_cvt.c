@@ -1,5 +1,6 @@
 #define PJ_LIB__
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -9,36 +10,30 @@
 #define MAX_ITERATIONS 10
 #define TOL 1e-12
 
-LP nad_cvt(LP in, int inverse, struct CTABLE *ct) {
-    LP t, tb,del, dif;
-    int i = MAX_ITERATIONS;
+/* Inverse grid shift of tb, relative to the lower left corner of the  */
+/* grid: find t such that shifting t forward gives tb.  This is solved */
+/* by Newton iterations, with the analytic Jacobian of the bilinear    */
+/* interpolation, and the current cell is kept until the iterations    */
+/* leave it, so that there is usually a single cell lookup.            */
+LP nad_inverse(projCtx ctx, LP tb, PJ_GRIDINFO *gi) {
+    struct CTABLE *ct = gi->ct;
+    PJ_GRID_CELL cell;
+    ILP indx;
+    LP t, del, frct, dif, step;
+    double dlam_dlam, dlam_dphi, dphi_dlam, dphi_dphi, det;
+    int i = MAX_ITERATIONS, edge = 0;
     const double toltol = TOL*TOL;
 
-    if (in.lam == HUGE_VAL)
-        return in;
-
-    /* normalize input to ll origin */
-    tb = in;
-    tb.lam -= ct->ll.lam;
-    tb.phi -= ct->ll.phi;
-    tb.lam = adjlon (tb.lam - M_PI) + M_PI;
-
-    t = nad_intr (tb, ct);
-    if (t.lam == HUGE_VAL)
+    t.lam = t.phi = HUGE_VAL;
+    if (!nad_cell_index(ct, tb, &indx, &frct) || !nad_cell(ctx, gi, indx, &cell))
         return t;
+    del = nad_cell_value(&cell, frct);
 
-    if (!inverse) {
-        in.lam -= t.lam;
-        in.phi += t.phi;
-        return in;
-    }
-
-    t.lam = tb.lam + t.lam;
-    t.phi = tb.phi - t.phi;
+    /* first approximation */
+    t.lam = tb.lam + del.lam;
+    t.phi = tb.phi - del.phi;
 
     do {
-        del = nad_intr(t, ct);
-
         /* This case used to return failure, but I have
            changed it to return the first order approximation
            of the inverse shift.  This avoids cases where the
@@ -48,27 +43,100 @@ LP nad_cvt(LP in, int inverse, struct CTABLE *ct) {
            no result.  NFW
            To demonstrate use -112.5839956 49.4914451 against
            the NTv2 grid shift file from Canada. */
-        if (del.lam == HUGE_VAL)
+        if (!nad_cell_index(ct, t, &indx, &frct)
+            || ((indx.lam != cell.indx.lam || indx.phi != cell.indx.phi)
+                && !nad_cell(ctx, gi, indx, &cell))) {
+            edge = 1;
             break;
+        }
+        del = nad_cell_value(&cell, frct);
 
+        /* residual of the forward shift of t */
         dif.lam = t.lam - del.lam - tb.lam;
-           dif.phi = t.phi + del.phi - tb.phi;
-        t.lam -= dif.lam;
-        t.phi -= dif.phi;
-
-    } while (--i && (dif.lam*dif.lam + dif.phi*dif.phi > toltol)); /* prob. slightly faster than hypot() */
+        dif.phi = t.phi + del.phi - tb.phi;
+
+        /* derivatives of the shifts over the cell */
+        dlam_dlam = ((1. - frct.phi) * (cell.f10.lam - cell.f00.lam)
+                     + frct.phi * (cell.f11.lam - cell.f01.lam)) / ct->del.lam;
+        dlam_dphi = ((1. - frct.lam) * (cell.f01.lam - cell.f00.lam)
+                     + frct.lam * (cell.f11.lam - cell.f10.lam)) / ct->del.phi;
+        dphi_dlam = ((1. - frct.phi) * (cell.f10.phi - cell.f00.phi)
+                     + frct.phi * (cell.f11.phi - cell.f01.phi)) / ct->del.lam;
+        dphi_dphi = ((1. - frct.lam) * (cell.f01.phi - cell.f00.phi)
+                     + frct.lam * (cell.f11.phi - cell.f10.phi)) / ct->del.phi;
+
+        /* Newton step, or plain fixed point step if the grid folds */
+        det = (1. - dlam_dlam) * (1. + dphi_dphi) + dlam_dphi * dphi_dlam;
+        if (fabs(det) < 0.5)
+            step = dif;
+        else {
+            step.lam = ((1. + dphi_dphi) * dif.lam + dlam_dphi * dif.phi) / det;
+            step.phi = ((1. - dlam_dlam) * dif.phi - dphi_dlam * dif.lam) / det;
+        }
+        t.lam -= step.lam;
+        t.phi -= step.phi;
+
+    } while (--i && (step.lam*step.lam + step.phi*step.phi > toltol)); /* prob. slightly faster than hypot() */
 
     if (i==0) {
-        /* If we had access to a context, this should go through pj_log, and we should set ctx->errno */
-        if (getenv ("PROJ_DEBUG"))
-            fprintf( stderr, "Inverse grid shift iterator failed to converge.\n" );
+        pj_log (ctx, PJ_LOG_DEBUG_MAJOR, "Inverse grid shift iterator failed to converge.");
         t.lam = t.phi = HUGE_VAL;
         return t;
     }
 
-    /* and again: pj_log and ctx->errno */
-    if (del.lam==HUGE_VAL && getenv ("PROJ_DEBUG"))
-        fprintf (stderr, "Inverse grid shift iteration failed, presumably at grid edge.\nUsing first approximation.\n");
+    if (edge)
+        pj_log (ctx, PJ_LOG_DEBUG_MAJOR, "Inverse grid shift iteration failed, presumably at grid edge. Using first approximation.");
+
+    return t;
+}
+
+LP nad_cvt(projCtx ctx, LP in, int inverse, PJ_GRIDINFO *gi) {
+    struct CTABLE *ct = gi->ct;
+    LP t, tb;
+    FLP *shifts;
+
+    if (in.lam == HUGE_VAL)
+        return in;
+
+    /* normalize input to ll origin */
+    tb = in;
+    tb.lam -= ct->ll.lam;
+    tb.phi -= ct->ll.phi;
+    tb.lam = adjlon (tb.lam - M_PI) + M_PI;
+
+    /* precomputed inverse shifts are applied as forward ones */
+    if (inverse && ctx->use_inverse_grids
+        && (shifts = pj_gridinfo_inverse (ctx, gi)) != NULL) {
+        PJ_GRID_CELL cell;
+        LP frct;
+        FLP *row;
+
+        t.lam = t.phi = HUGE_VAL;
+        if (!nad_cell_index (ct, tb, &cell.indx, &frct))
+            return t;
+        row = shifts + (size_t) cell.indx.phi * ct->lim.lam + cell.indx.lam;
+        cell.f00 = row[0];
+        cell.f10 = row[1];
+        cell.f01 = row[ct->lim.lam];
+        cell.f11 = row[ct->lim.lam + 1];
+        t = nad_cell_value (&cell, frct);
+        in.lam = adjlon (in.lam - t.lam);
+        in.phi += t.phi;
+        return in;
+    }
+
+    if (!inverse) {
+        t = nad_intr (ctx, tb, gi);
+        if (t.lam == HUGE_VAL)
+            return t;
+        in.lam -= t.lam;
+        in.phi += t.phi;
+        return in;
+    }
+
+    t = nad_inverse (ctx, tb, gi);
+    if (t.lam == HUGE_VAL)
+        return t;
 
     in.lam = adjlon (t.lam + ct->ll.lam);
     in.phi = t.phi + ct->ll.phi;
@@ -4,55 +4,73 @@
 #include "proj_math.h"
 #include "projects.h"
 
-	LP
-nad_intr(LP t, struct CTABLE *ct) {
-	LP val, frct;
-	ILP indx;
-	double m00, m10, m01, m11;
-	FLP *f00, *f10, *f01, *f11;
-	long index;
+/* Find the cell of the table holding t, relative to the lower left */
+/* corner of the table, and the position of t within it.  Points    */
+/* a hair off the table edges are moved onto them.                  */
+	int
+nad_cell_index(const struct CTABLE *ct, LP t, ILP *indx, LP *frct) {
 	int in;
 
 	t.lam /= ct->del.lam;
-	indx.lam = isnan(t.lam) ? 0 : (pj_int32)lround(floor(t.lam));
+	indx->lam = isnan(t.lam) ? 0 : (pj_int32)lround(floor(t.lam));
 	t.phi /= ct->del.phi;
-	indx.phi = isnan(t.phi) ? 0 : (pj_int32)lround(floor(t.phi));
+	indx->phi = isnan(t.phi) ? 0 : (pj_int32)lround(floor(t.phi));
 
-	frct.lam = t.lam - indx.lam;
-	frct.phi = t.phi - indx.phi;
-	val.lam = val.phi = HUGE_VAL;
-	if (indx.lam < 0) {
-		if (indx.lam == -1 && frct.lam > 0.99999999999) {
-			++indx.lam;
-			frct.lam = 0.;
+	frct->lam = t.lam - indx->lam;
+	frct->phi = t.phi - indx->phi;
+	if (indx->lam < 0) {
+		if (indx->lam == -1 && frct->lam > 0.99999999999) {
+			++indx->lam;
+			frct->lam = 0.;
 		} else
-			return val;
-	} else if ((in = indx.lam + 1) >= ct->lim.lam) {
-		if (in == ct->lim.lam && frct.lam < 1e-11) {
-			--indx.lam;
-			frct.lam = 1.;
+			return 0;
+	} else if ((in = indx->lam + 1) >= ct->lim.lam) {
+		if (in == ct->lim.lam && frct->lam < 1e-11) {
+			--indx->lam;
+			frct->lam = 1.;
 		} else
-			return val;
+			return 0;
 	}
-	if (indx.phi < 0) {
-		if (indx.phi == -1 && frct.phi > 0.99999999999) {
-			++indx.phi;
-			frct.phi = 0.;
+	if (indx->phi < 0) {
+		if (indx->phi == -1 && frct->phi > 0.99999999999) {
+			++indx->phi;
+			frct->phi = 0.;
 		} else
-			return val;
-	} else if ((in = indx.phi + 1) >= ct->lim.phi) {
-		if (in == ct->lim.phi && frct.phi < 1e-11) {
-			--indx.phi;
-			frct.phi = 1.;
+			return 0;
+	} else if ((in = indx->phi + 1) >= ct->lim.phi) {
+		if (in == ct->lim.phi && frct->phi < 1e-11) {
+			--indx->phi;
+			frct->phi = 1.;
 		} else
-			return val;
+			return 0;
 	}
-	index = indx.phi * ct->lim.lam + indx.lam;
-	f00 = ct->cvs + index++;
-	f10 = ct->cvs + index;
-	index += ct->lim.lam;
-	f11 = ct->cvs + index--;
-	f01 = ct->cvs + index;
+	return 1;
+}
+
+/* Fetch the corner values of the cell of indx, from the two rows */
+/* of the cell, see pj_gridinfo_row().                            */
+	int
+nad_cell(projCtx ctx, PJ_GRIDINFO *gi, ILP indx, PJ_GRID_CELL *cell) {
+	FLP *row0, *row1;
+
+	row0 = (FLP *) pj_gridinfo_row(ctx, gi, indx.phi);
+	row1 = row0 ? (FLP *) pj_gridinfo_row(ctx, gi, indx.phi + 1) : NULL;
+	if (row1 == NULL)
+		return 0;
+	cell->indx = indx;
+	cell->f00 = row0[indx.lam];
+	cell->f10 = row0[indx.lam + 1];
+	cell->f01 = row1[indx.lam];
+	cell->f11 = row1[indx.lam + 1];
+	return 1;
+}
+
+/* Bilinear interpolation within a cell */
+	LP
+nad_cell_value(const PJ_GRID_CELL *cell, LP frct) {
+	LP val;
+	double m00, m10, m01, m11;
+
 	m11 = m10 = frct.lam;
 	m00 = m01 = 1. - frct.lam;
 	m11 *= frct.phi;
@@ -60,9 +78,22 @@ nad_intr(LP t, struct CTABLE *ct) {
 	frct.phi = 1. - frct.phi;
 	m00 *= frct.phi;
 	m10 *= frct.phi;
-	val.lam = m00 * f00->lam + m10 * f10->lam +
-			  m01 * f01->lam + m11 * f11->lam;
-	val.phi = m00 * f00->phi + m10 * f10->phi +
-			  m01 * f01->phi + m11 * f11->phi;
+	val.lam = m00 * cell->f00.lam + m10 * cell->f10.lam +
+			  m01 * cell->f01.lam + m11 * cell->f11.lam;
+	val.phi = m00 * cell->f00.phi + m10 * cell->f10.phi +
+			  m01 * cell->f01.phi + m11 * cell->f11.phi;
 	return val;
 }
+
+	LP
+nad_intr(projCtx ctx, LP t, PJ_GRIDINFO *gi) {
+	PJ_GRID_CELL cell;
+	ILP indx;
+	LP val, frct;
+
+	val.lam = val.phi = HUGE_VAL;
+	if (!nad_cell_index(gi->ct, t, &indx, &frct)
+		|| !nad_cell(ctx, gi, indx, &cell))
+		return val;
+	return nad_cell_value(&cell, frct);
+}
@@ -233,7 +233,10 @@ char *opt_filename (OPTARGS *opt) {
         return 0;
     if (0==opt->fargc)
         return opt->flaglevel;
-    return opt->fargv[opt->input_index];
+    /* input_index has already moved on to the next file */
+    if (0==opt->input_index)
+        return opt->fargv[0];
+    return opt->fargv[opt->input_index - 1];
 }
 
 static int opt_eof (OPTARGS *opt) {
@@ -52,6 +52,7 @@ int pj_apply_gridshift( projCtx ctx, const char *nadgrids, int inverse,
 
 {
     PJ_GRIDINFO **gridlist;
+    PJ_GRID_INDEX *index = NULL;
     int           grid_count;
     int           ret;
 
@@ -60,14 +61,15 @@ int pj_apply_gridshift( projCtx ctx, const char *nadgrids, int inverse,
     if( gridlist == NULL || grid_count == 0 )
         return ctx->last_errno;
 
-    ret = pj_apply_gridshift_3( ctx, gridlist, grid_count, inverse,
+    ret = pj_apply_gridshift_3( ctx, gridlist, grid_count, &index, inverse,
                                 point_count, point_offset, x, y, z );
 
     /*
     ** Note this frees the array of grid list pointers, but not the grids
-    ** which is as intended.  The grids themselves live on.
+    ** which is as intended.  The grids themselves live on in the registry.
     */
-    pj_dalloc( gridlist );
+    pj_gridlist_free( gridlist, grid_count );
+    pj_gridlist_index_free( index );
 
     return ret;
 }
@@ -102,72 +104,34 @@ int pj_apply_gridshift_2( PJ *defn, int inverse,
     }
 
     return pj_apply_gridshift_3( pj_get_ctx( defn ),
-                                 defn->gridlist, defn->gridlist_count, inverse,
+                                 defn->gridlist, defn->gridlist_count,
+                                 &(defn->gridlist_index), inverse,
                                  point_count, point_offset, x, y, z );
 }
 
 /************************************************************************/
-/*                             find_ctable()                            */
+/*                              find_grid()                             */
 /*                                                                      */
 /*    Determine which grid is the correct given an input coordinate.    */
 /************************************************************************/
 
-static struct CTABLE* find_ctable(projCtx ctx, LP input, int grid_count, PJ_GRIDINFO **tables) {
-    int itable;
+static PJ_GRIDINFO* find_grid(projCtx ctx, LP input, PJ_GRID_INDEX **index_p,
+                              int grid_count, PJ_GRIDINFO **tables) {
+    PJ_GRIDINFO *gi;
 
-    /* keep trying till we find a table that works */
-    for( itable = 0; itable < grid_count; itable++ )
-    {
-
-        PJ_GRIDINFO *gi = tables[itable];
-        struct CTABLE *ct = gi->ct;
-        double epsilon = (fabs(ct->del.phi)+fabs(ct->del.lam))/10000.0;
-        /* skip tables that don't match our point at all.  */
-        if ( ct->ll.phi - epsilon > input.phi
-                || ct->ll.lam - epsilon > input.lam
-                || (ct->ll.phi + (ct->lim.phi-1) * ct->del.phi + epsilon < input.phi)
-                || (ct->ll.lam + (ct->lim.lam-1) * ct->del.lam + epsilon < input.lam) ) {
-            continue;
-        }
-
-        /* If we have child nodes, check to see if any of them apply. */
-        while( gi->child )
-        {
-            PJ_GRIDINFO *child;
-
-            for( child = gi->child; child != NULL; child = child->next )
-            {
-                struct CTABLE *ct1 = child->ct;
-                epsilon = (fabs(ct1->del.phi)+fabs(ct1->del.lam))/10000.0;
-
-                if( ct1->ll.phi - epsilon > input.phi
-                    || ct1->ll.lam - epsilon > input.lam
-                    || (ct1->ll.phi+(ct1->lim.phi-1)*ct1->del.phi + epsilon < input.phi)
-                    || (ct1->ll.lam+(ct1->lim.lam-1)*ct1->del.lam + epsilon < input.lam) ) {
-                    continue;
-                }
-                break;
-            }
+    /* find the first table, or child of it, that matches our point */
+    gi = pj_gridlist_find( index_p, tables, grid_count, input,
+                           PJ_GRID_FIND_TOLERANT );
+    if( gi == NULL )
+        return NULL;
 
-            /* If we didn't find a child then nothing more to do */
-            if( child == NULL ) break;
-
-            /* Otherwise use the child, first checking it's children */
-            gi = child;
-            ct = child->ct;
-        }
-        /* load the grid shift info if we don't have it. */
-        if( ct->cvs == NULL) {
-            if (!pj_gridinfo_load( ctx, gi ) ) {
-                pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-                return NULL;
-            }
-        }
-        /* if we get this far we have found a suitable grid */
-        return ct;
+    /* load the grid shift info if we don't have it. */
+    if (!pj_gridinfo_prepare( ctx, gi ) ) {
+        pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+        return NULL;
     }
-
-    return NULL;
+    /* if we get this far we have found a suitable grid */
+    return gi;
 }
 
 /************************************************************************/
@@ -177,12 +141,13 @@ static struct CTABLE* find_ctable(projCtx ctx, LP input, int grid_count, PJ_GRID
 /************************************************************************/
 
 int pj_apply_gridshift_3( projCtx ctx, PJ_GRIDINFO **gridlist, int gridlist_count,
+                          PJ_GRID_INDEX **index_p,
                           int inverse, long point_count, int point_offset,
                           double *x, double *y, double *z )
 {
     int  i;
-    struct CTABLE *ct;
-    static int debug_count = 0;
+    PJ_GRIDINFO *gi;
+    int  debug_count = 0;   /* per call: a static would be shared by all threads */
     (void) z;
 
     if( gridlist== NULL || gridlist_count == 0 )
@@ -204,13 +169,13 @@ int pj_apply_gridshift_3( projCtx ctx, PJ_GRIDINFO **gridlist, int gridlist_coun
         output.phi = HUGE_VAL;
         output.lam = HUGE_VAL;
 
-        ct = find_ctable(ctx, input, gridlist_count, gridlist);
-        if( ct != NULL )
+        gi = find_grid(ctx, input, index_p, gridlist_count, gridlist);
+        if( gi != NULL )
         {
-            output = nad_cvt( input, inverse, ct );
+            output = nad_cvt( ctx, input, inverse, gi );
 
             if ( output.lam != HUGE_VAL && debug_count++ < 20 )
-                pj_log( ctx, PJ_LOG_DEBUG_MINOR, "pj_apply_gridshift(): used %s", ct->id );
+                pj_log( ctx, PJ_LOG_DEBUG_MINOR, "pj_apply_gridshift(): used %s", gi->ct->id );
         }
 
         if ( output.lam == HUGE_VAL )
@@ -224,7 +189,7 @@ int pj_apply_gridshift_3( projCtx ctx, PJ_GRIDINFO **gridlist, int gridlist_coun
                     y[io] * RAD_TO_DEG );
                 for( itable = 0; itable < gridlist_count; itable++ )
                 {
-                    PJ_GRIDINFO *gi = gridlist[itable];
+                    gi = gridlist[itable];
                     if( itable == 0 )
                         pj_log( ctx, PJ_LOG_DEBUG_MAJOR, "   tried: %s", gi->gridname );
                     else
@@ -307,22 +272,23 @@ int proj_hgrid_init(PJ* P, const char *grids) {
 /*    Return coordinate offset in grid      */
 /********************************************/
 LP proj_hgrid_value(PJ *P, LP lp) {
-    struct CTABLE *ct;
+    PJ_GRIDINFO *gi;
     LP out = proj_coord_error().lp;
 
-    ct = find_ctable(P->ctx, lp, P->gridlist_count, P->gridlist);
-    if (ct == 0) {
+    gi = find_grid(P->ctx, lp, &(P->gridlist_index),
+                   P->gridlist_count, P->gridlist);
+    if (gi == 0) {
         pj_ctx_set_errno( P->ctx, PJD_ERR_GRID_AREA);
         return out;
     }
 
     /* normalize input to ll origin */
-    lp.lam -= ct->ll.lam;
-    lp.phi -= ct->ll.phi;
+    lp.lam -= gi->ct->ll.lam;
+    lp.phi -= gi->ct->ll.phi;
 
     lp.lam = adjlon(lp.lam - M_PI) + M_PI;
 
-    out = nad_intr(lp, ct);
+    out = nad_intr(P->ctx, lp, gi);
 
     if (out.lam == HUGE_VAL || out.phi == HUGE_VAL) {
         pj_ctx_set_errno(P->ctx, PJD_ERR_GRID_AREA);
@@ -332,21 +298,22 @@ LP proj_hgrid_value(PJ *P, LP lp) {
 }
 
 LP proj_hgrid_apply(PJ *P, LP lp, PJ_DIRECTION direction) {
-    struct CTABLE *ct;
+    PJ_GRIDINFO *gi;
     int inverse;
     LP out;
 
     out.lam = HUGE_VAL; out.phi = HUGE_VAL;
 
-    ct = find_ctable(P->ctx, lp, P->gridlist_count, P->gridlist);
+    gi = find_grid(P->ctx, lp, &(P->gridlist_index),
+                   P->gridlist_count, P->gridlist);
 
-    if (ct == NULL || ct->cvs == NULL) {
+    if (gi == NULL) {
         pj_ctx_set_errno( P->ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
         return out;
     }
 
     inverse = direction == PJ_FWD ? 0 : 1;
-    out = nad_cvt(lp, inverse, ct);
+    out = nad_cvt(P->ctx, lp, inverse, gi);
 
     if (out.lam == HUGE_VAL || out.phi == HUGE_VAL)
         pj_ctx_set_errno(P->ctx, PJD_ERR_GRID_AREA);
@@ -44,67 +44,38 @@ static int is_nodata(float value)
     return value > 1000 || value < -1000 || value == -88.88880f;
 }
 
-static double read_vgrid_value( PJ *defn, LP input, int *gridlist_count_p, PJ_GRIDINFO **tables, struct CTABLE *ct) {
-    int  itable = 0;
+static double read_vgrid_value( PJ *defn, LP input,
+                                PJ_GRID_INDEX **index_p, int gridlist_count,
+                                PJ_GRIDINFO **tables, PJ_GRIDINFO **used ) {
     double value = HUGE_VAL;
     double grid_x, grid_y;
     long   grid_ix, grid_iy;
     long   grid_ix2, grid_iy2;
-    float  *cvs;
+    float  *row, *row2;
+    PJ_GRIDINFO *gi;
+    struct CTABLE *ct;
+
     /* do not deal with NaN coordinates */
     /* cppcheck-suppress duplicateExpression */
     if( isnan(input.phi) || isnan(input.lam) )
-        itable = *gridlist_count_p;
+        return value;
 
-    /* keep trying till we find a table that works */
-    for ( ; itable < *gridlist_count_p; itable++ )
+    /* the last table of the list that covers the point wins */
+    gi = pj_gridlist_find( index_p, tables, gridlist_count, input,
+                           PJ_GRID_FIND_LAST );
+    if( gi != NULL )
     {
-        PJ_GRIDINFO *gi = tables[itable];
-
         ct = gi->ct;
-
-        /* skip tables that don't match our point at all.  */
-        if( ct->ll.phi > input.phi || ct->ll.lam > input.lam
-            || ct->ll.phi + (ct->lim.phi-1) * ct->del.phi < input.phi
-            || ct->ll.lam + (ct->lim.lam-1) * ct->del.lam < input.lam )
-            continue;
-
-        /* If we have child nodes, check to see if any of them apply. */
-        while( gi->child != NULL )
-        {
-            PJ_GRIDINFO *child;
-
-            for( child = gi->child; child != NULL; child = child->next )
-            {
-                struct CTABLE *ct1 = child->ct;
-
-                if( ct1->ll.phi > input.phi || ct1->ll.lam > input.lam
-                  || ct1->ll.phi+(ct1->lim.phi-1)*ct1->del.phi < input.phi
-                  || ct1->ll.lam+(ct1->lim.lam-1)*ct1->del.lam < input.lam)
-                    continue;
-
-                break;
-            }
-
-            /* we didn't find a more refined child node to use, so go with current grid */
-            if( child == NULL )
-            {
-                break;
-            }
-
-            /* Otherwise let's try for childrens children .. */
-            gi = child;
-            ct = child->ct;
-        }
+        if( used != NULL )
+            *used = gi;
 
         /* load the grid shift info if we don't have it. */
-        if( ct->cvs == NULL && !pj_gridinfo_load( pj_get_ctx(defn), gi ) )
+        if( !pj_gridinfo_prepare( pj_get_ctx(defn), gi ) )
         {
             pj_ctx_set_errno( defn->ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
             return PJD_ERR_FAILED_TO_LOAD_GRID;
         }
 
-
         /* Interpolation a location within the grid */
         grid_x = (input.lam - ct->ll.lam) / ct->del.lam;
         grid_y = (input.phi - ct->ll.phi) / ct->del.phi;
@@ -120,12 +91,18 @@ static double read_vgrid_value( PJ *defn, LP input, int *gridlist_count_p, PJ_GR
         if( grid_iy2 >= ct->lim.phi )
             grid_iy2 = ct->lim.phi - 1;
 
-        cvs = (float *) ct->cvs;
+        row = (float *) pj_gridinfo_row( pj_get_ctx(defn), gi, (int) grid_iy );
+        row2 = row ? (float *) pj_gridinfo_row( pj_get_ctx(defn), gi, (int) grid_iy2 ) : NULL;
+        if( row2 == NULL )
         {
-            float value_a = cvs[grid_ix + grid_iy * ct->lim.lam];
-            float value_b = cvs[grid_ix2 + grid_iy * ct->lim.lam];
-            float value_c = cvs[grid_ix + grid_iy2 * ct->lim.lam];
-            float value_d = cvs[grid_ix2 + grid_iy2 * ct->lim.lam];
+            pj_ctx_set_errno( defn->ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+            return PJD_ERR_FAILED_TO_LOAD_GRID;
+        }
+        {
+            float value_a = row[grid_ix];
+            float value_b = row[grid_ix2];
+            float value_c = row2[grid_ix];
+            float value_d = row2[grid_ix2];
             double total_weight = 0.0;
             int n_weights = 0;
             value = 0.0f;
@@ -179,15 +156,16 @@ static double read_vgrid_value( PJ *defn, LP input, int *gridlist_count_p, PJ_GR
 int pj_apply_vgridshift( PJ *defn, const char *listname,
                          PJ_GRIDINFO ***gridlist_p,
                          int *gridlist_count_p,
+                         PJ_GRID_INDEX **index_p,
                          int inverse,
                          long point_count, int point_offset,
                          double *x, double *y, double *z )
 
 {
     int  i;
-    static int debug_count = 0;
+    int  debug_count = 0;
     PJ_GRIDINFO **tables;
-    struct CTABLE ct;
+    PJ_GRIDINFO *used = NULL;
 
     if( *gridlist_p == NULL )
     {
@@ -218,7 +196,8 @@ int pj_apply_vgridshift( PJ *defn, const char *listname,
         input.phi = y[io];
         input.lam = x[io];
 
-        value = read_vgrid_value(defn, input, gridlist_count_p, tables, &ct);
+        value = read_vgrid_value(defn, input, index_p, *gridlist_count_p,
+                                 tables, &used);
 
         if( inverse )
             z[io] -= value;
@@ -226,10 +205,8 @@ int pj_apply_vgridshift( PJ *defn, const char *listname,
             z[io] += value;
         if( value != HUGE_VAL )
         {
-            if( debug_count++ < 20 ) {
-                proj_log_trace(defn, "pj_apply_gridshift(): used %s", ct.id);
-                break;
-            }
+            if( debug_count++ < 20 )
+                proj_log_trace(defn, "pj_apply_vgridshift(): used %s", used->ct->id);
         }
 
         if( value == HUGE_VAL )
@@ -320,11 +297,10 @@ double proj_vgrid_value(PJ *P, LP lp){
 
 ************************************************/
 
-    struct CTABLE used_grid;
     double value;
-    memset(&used_grid, 0, sizeof(struct CTABLE));
 
-    value = read_vgrid_value(P, lp, &(P->vgridlist_geoid_count), P->vgridlist_geoid, &used_grid);
+    value = read_vgrid_value(P, lp, &(P->vgridlist_geoid_index),
+                             P->vgridlist_geoid_count, P->vgridlist_geoid, NULL);
     proj_log_trace(P, "proj_vgrid_value: (%f, %f) = %f", lp.lam*RAD_TO_DEG, lp.phi*RAD_TO_DEG, value);
 
     return value;
@@ -87,6 +87,19 @@ projCtx pj_get_default_ctx()
         default_context.cpp_context = NULL;
         default_context.use_proj4_init_rules = -1;
         default_context.epsg_file_exists = -1;
+        default_context.thread_count = 1;
+        default_context.grid_tiling = -1;
+        default_context.grid_tiles = NULL;
+        default_context.grid_tile_count = 0;
+        default_context.grid_tile_generation = 0;
+        default_context.grid_cache_hits = 0;
+        default_context.grid_cache_misses = 0;
+        default_context.grid_cache_evictions = 0;
+        default_context.use_inverse_grids = 0;
+        default_context.operation_cache = NULL;
+        default_context.operation_cache_count = 0;
+        default_context.operation_cache_max = 0;
+        default_context.per_point_operations = 0;
 
         if( getenv("PROJ_DEBUG") != NULL )
         {
@@ -104,19 +117,50 @@ projCtx pj_get_default_ctx()
 }
 
 /************************************************************************/
-/*                            pj_ctx_alloc()                            */
+/*                             pj_ctx_copy()                            */
+/*                                                                      */
+/*      Allocate a context with the settings of src. What src owns,     */
+/*      that is its C++ context, grid tiles and operation cache, is     */
+/*      not shared: the copy starts without them, and without error.    */
+/*      Fields added to projCtx_t that point to memory owned by the     */
+/*      context must be reset here, so that pj_ctx_free() does not      */
+/*      free them twice.                                                */
 /************************************************************************/
 
-projCtx pj_ctx_alloc()
+projCtx pj_ctx_copy( projCtx src )
 
 {
     projCtx ctx = (projCtx_t *) malloc(sizeof(projCtx_t));
     if (0==ctx)
         return 0;
-    memcpy( ctx, pj_get_default_ctx(), sizeof(projCtx_t) );
+    memcpy( ctx, src, sizeof(projCtx_t) );
     ctx->last_errno = 0;
     ctx->cpp_context = NULL;
+    ctx->grid_tiles = NULL;
+    ctx->grid_tile_count = 0;
+    ctx->grid_cache_hits = 0;
+    ctx->grid_cache_misses = 0;
+    ctx->grid_cache_evictions = 0;
+    ctx->operation_cache = NULL;
+    ctx->operation_cache_count = 0;
+    ctx->operation_cache_max = 0;
+
+    return ctx;
+}
+
+/************************************************************************/
+/*                            pj_ctx_alloc()                            */
+/************************************************************************/
+
+projCtx pj_ctx_alloc()
+
+{
+    projCtx ctx = pj_ctx_copy( pj_get_default_ctx() );
+    if (0==ctx)
+        return 0;
     ctx->use_proj4_init_rules = -1;
+    ctx->thread_count = 1;
+    ctx->per_point_operations = 0;
 
     return ctx;
 }
@@ -129,6 +173,8 @@ void pj_ctx_free( projCtx ctx )
 
 {
     proj_context_delete_cpp_context( ctx->cpp_context );
+    pj_gridinfo_free_tiles( ctx );
+    pj_free_operation_cache( ctx );
     pj_dealloc( ctx );
 }
 
@@ -218,6 +264,9 @@ void pj_ctx_set_fileapi( projCtx ctx, projFileAPI *fileapi )
     if (0==ctx)
         return;
     ctx->fileapi = fileapi;
+
+    /* Cached results of proj_create_crs_to_crs() depend on the grids found */
+    pj_free_operation_cache( ctx );
 }
 
 /************************************************************************/
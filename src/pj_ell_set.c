@@ -401,10 +401,7 @@ static int ellps_spherification (PJ *P) {
 
 /* locate parameter in list */
 static paralist *pj_get_param (paralist *list, char *key) {
-    size_t l = strlen(key);
-	while (list && !(0==strncmp(list->param, key, l) && (0==list->param[l] || list->param[l] == '=') ) )
-		list = list->next;
-	return list;
+    return pj_param_lookup (list, key, strlen (key));
 }
 
 
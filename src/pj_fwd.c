@@ -30,6 +30,7 @@
 
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 
 #include "proj_internal.h"
 #include "proj_math.h"
@@ -259,3 +260,72 @@ PJ_COORD pj_fwd4d (PJ_COORD coo, PJ *P) {
 
     return error_or_coord(P, coo, last_errno);
 }
+
+
+
+void pj_fwd4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+/******************************************************************************
+    Batch version of pj_fwd4d. Coordinates are transformed in place.
+
+    If P has a batch kernel, the prepare step is run on a full block, then
+    the kernel, then the finalize step, so the function pointer dispatch and
+    errno bookkeeping are paid once per block rather than once per point.
+    Otherwise we fall back to pj_fwd4d, point by point.
+
+    A coordinate with HUGE_VAL in any component after the kernel has failed.
+    Operations may also report failures through errno only, which cannot be
+    traced back to a given point of the block: a block in which errno gets
+    set is thus redone point by point with pj_fwd4d, from its input values,
+    so that failures are detected exactly as in the scalar path.
+
+    Failed coordinates are set to proj_coord_error (). Contrary to pj_fwd4d,
+    the error state of the context is not reset between points, so on
+    return proj_errno reflects any error in the array.
+******************************************************************************/
+    PJ_COORD in[PJ_TRANS_BLOCK_SIZE];
+    size_t i, b, m;
+    int err = 0;
+    int last_errno = proj_errno_reset (P);
+
+    for (b = 0;  b < n;  b += m) {
+        PJ_COORD *c = coo + b;
+        m = n - b < PJ_TRANS_BLOCK_SIZE ? n - b : PJ_TRANS_BLOCK_SIZE;
+
+        if (P->fwd4d_array) {
+            memcpy (in, c, m * sizeof (PJ_COORD));
+
+            if (!P->skip_fwd_prepare)
+                for (i = 0;  i < m;  i++)
+                    c[i] = fwd_prepare (P, c[i]);
+
+            P->fwd4d_array (c, m, P);
+
+            for (i = 0;  i < m;  i++) {
+                if (HUGE_VAL==c[i].v[0] || HUGE_VAL==c[i].v[1] ||
+                    HUGE_VAL==c[i].v[2] || HUGE_VAL==c[i].v[3]) {
+                    c[i] = proj_coord_error ();
+                    continue;
+                }
+                if (!P->skip_fwd_finalize)
+                    c[i] = fwd_finalize (P, c[i]);
+            }
+            if (0==proj_errno (P))
+                continue;
+
+            /* Something failed in the block: start it over, point by point */
+            proj_errno_reset (P);
+            memcpy (c, in, m * sizeof (PJ_COORD));
+        }
+
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_fwd4d (c[i], P);
+            if (proj_errno (P))
+                err = proj_errno (P);
+        }
+    }
+
+    if (err)
+        proj_errno_set (P, err);
+    else
+        proj_errno_restore (P, last_errno);
+}
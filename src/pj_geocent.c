@@ -50,6 +50,7 @@ static LP inverse(XY xy, PJ *P) {
 
 PJ *CONVERSION (geocent, 0) {
     P->is_geocent = 1;
+    P->copier = pj_default_copier;
     P->x0 = 0.0;
     P->y0 = 0.0;
     P->inv = inverse;
@@ -39,8 +39,8 @@ static PJ_GridCatalog *grid_catalog_list = NULL;
 /************************************************************************/
 /*                          pj_gc_unloadall()                           */
 /*                                                                      */
-/*      Deallocate all the grid catalogs (but not the referenced        */
-/*      grids).                                                         */
+/*      Deallocate all the grid catalogs, releasing the grids they      */
+/*      reference.                                                      */
 /************************************************************************/
 
 void pj_gc_unloadall( projCtx ctx )
@@ -55,7 +55,7 @@ void pj_gc_unloadall( projCtx ctx )
 
         for( i = 0; i < catalog->entry_count; i++ )
         {
-            /* we don't own gridinfo - do not free here */
+            pj_gridinfo_release( catalog->entries[i].gridinfo );
             free( catalog->entries[i].definition );
         }
         free( catalog->entries );
@@ -150,13 +150,13 @@ int pj_gc_apply_gridshift( PJ *defn, int inverse,
         assert( gi->child == NULL );
 
         /* load the grid shift info if we don't have it. */
-        if( gi->ct->cvs == NULL && !pj_gridinfo_load( defn->ctx, gi ) )
+        if( !pj_gridinfo_prepare( defn->ctx, gi ) )
         {
             pj_ctx_set_errno( defn->ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
             return PJD_ERR_FAILED_TO_LOAD_GRID;
         }
             
-        output_after = nad_cvt( input, inverse, gi->ct );
+        output_after = nad_cvt( defn->ctx, input, inverse, gi );
         if( output_after.lam == HUGE_VAL )
         {
             if( defn->ctx->debug_level >= PJ_LOG_DEBUG_MAJOR )
@@ -199,13 +199,13 @@ int pj_gc_apply_gridshift( PJ *defn, int inverse,
         assert( gi->child == NULL );
 
         /* load the grid shift info if we don't have it. */
-        if( gi->ct->cvs == NULL && !pj_gridinfo_load( defn->ctx, gi ) )
+        if( !pj_gridinfo_prepare( defn->ctx, gi ) )
         {
             pj_ctx_set_errno( defn->ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
             return PJD_ERR_FAILED_TO_LOAD_GRID;
         }
             
-        output_before = nad_cvt( input, inverse, gi->ct );
+        output_before = nad_cvt( defn->ctx, input, inverse, gi );
         if( output_before.lam == HUGE_VAL )
         {
             if( defn->ctx->debug_level >= PJ_LOG_DEBUG_MAJOR )
@@ -287,7 +287,13 @@ PJ_GRIDINFO *pj_gc_findgrid( projCtx ctx, PJ_GridCatalog *catalog, int after,
         gridlist = pj_gridlist_from_nadgrids( ctx, entry->definition, 
                                               &grid_count);
         if( grid_count == 1 )
+        {
+            /* the entry keeps the reference of the list */
             entry->gridinfo = gridlist[0];
+            pj_dalloc( gridlist );
+        }
+        else
+            pj_gridlist_free( gridlist, grid_count );
     }
     
     return entry->gridinfo;
@@ -38,6 +38,38 @@
 #include "proj_internal.h"
 #include "projects.h"
 
+/* Grids holding more data than this are read in tiles on demand, */
+/* rather than being loaded completely. */
+#define GRID_TILING_MIN_SIZE    (8*1024*1024)
+
+/* Approximate size of a tile, which is made of complete grid rows */
+#define GRID_TILE_SIZE          (64*1024)
+
+/* Maximum number of tiles kept by each context */
+#define GRID_TILE_MAX           64
+
+struct pj_grid_tile {
+    PJ_GRIDINFO *gi;
+    int          first_row;
+    unsigned char *data;
+    struct pj_grid_tile *next;
+};
+
+/* Bumped whenever a grid is freed, so that contexts drop their tiles */
+static int grid_generation = 0;
+
+/* Bytes of grid data loaded by pj_gridinfo_load(), and the limit set */
+/* with pj_gridinfo_set_cache_size() (0 for none), under the lock */
+static size_t grid_memory_used = 0;
+static size_t grid_cache_max = 0;
+
+/* Bumped when the limit changes, so that grids which did not fit retry */
+static int grid_cache_generation = 1;
+
+/* ct->cvs is set once, by pj_gridinfo_load(), and read without lock */
+#define GRID_DATA(gi) \
+    ((FLP *) pj_atomic_get_ptr( (void * volatile *) &(gi)->ct->cvs ))
+
 /************************************************************************/
 /*                             swap_words()                             */
 /*                                                                      */
@@ -82,6 +114,178 @@ static double to_double( unsigned char* data )
     return d;
 }
 
+/************************************************************************/
+/*                         gridinfo_cell_size()                         */
+/*                                                                      */
+/*      Size of a grid node in memory: a float for GTX grids, and a     */
+/*      FLP shift pair for all the others.                              */
+/************************************************************************/
+
+static size_t gridinfo_cell_size( const PJ_GRIDINFO *gi )
+{
+    return strcmp(gi->format,"gtx") == 0 ? sizeof(float) : sizeof(FLP);
+}
+
+/************************************************************************/
+/*                         gridinfo_read_rows()                         */
+/*                                                                      */
+/*      Read row_count rows of grid data, starting at first_row, into   */
+/*      data, using the layout of ct->cvs.  Note that the array         */
+/*      storage direction (e-w) is different in the NTv1 and NTv2      */
+/*      files and what the CTABLE is supposed to have.  The phi/lam     */
+/*      are also reversed, and we have to be aware of byte swapping.    */
+/************************************************************************/
+
+static int gridinfo_read_rows( projCtx ctx, PJ_GRIDINFO *gi, PAFile fid,
+                               int first_row, int row_count, void *data )
+
+{
+    struct CTABLE *ct = gi->ct;
+    size_t cells = (size_t) ct->lim.lam * row_count;
+    int    row;
+
+    if( strcmp(gi->format,"ctable") == 0
+        || strcmp(gi->format,"ctable2") == 0 )
+    {
+        long header_size = strcmp(gi->format,"ctable") == 0
+            ? (long) sizeof(struct CTABLE) : 160;
+
+        pj_ctx_fseek( ctx, fid, header_size
+                      + (long) first_row * ct->lim.lam * (long) sizeof(FLP),
+                      SEEK_SET );
+        if( pj_ctx_fread( ctx, data, sizeof(FLP), cells, fid ) != cells )
+        {
+            pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+            return 0;
+        }
+
+        if( !IS_LSB && strcmp(gi->format,"ctable2") == 0 )
+            swap_words( (unsigned char *) data, 4, (int) cells * 2 );
+
+        return 1;
+    }
+
+    else if( strcmp(gi->format,"ntv1") == 0 )
+    {
+        double *row_buf;
+
+        row_buf = (double *) pj_malloc(ct->lim.lam * sizeof(double) * 2);
+        if( row_buf == NULL )
+        {
+            pj_ctx_set_errno( ctx, ENOMEM );
+            return 0;
+        }
+
+        pj_ctx_fseek( ctx, fid, gi->grid_offset
+                      + (long) first_row * ct->lim.lam * 2 * (long) sizeof(double),
+                      SEEK_SET );
+
+        for( row = 0; row < row_count; row++ )
+        {
+            int	    i;
+            FLP     *cvs;
+            double  *diff_seconds;
+
+            if( pj_ctx_fread( ctx, row_buf,
+                              sizeof(double), ct->lim.lam * 2, fid )
+                != (size_t)( 2 * ct->lim.lam ) )
+            {
+                pj_dalloc( row_buf );
+                pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+                return 0;
+            }
+
+            if( IS_LSB )
+                swap_words( (unsigned char *) row_buf, 8, ct->lim.lam*2 );
+
+            /* convert seconds to radians */
+            diff_seconds = row_buf;
+
+            for( i = 0; i < ct->lim.lam; i++ )
+            {
+                cvs = (FLP *) data + (size_t) row * ct->lim.lam
+                    + (ct->lim.lam - i - 1);
+
+                cvs->phi = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
+                cvs->lam = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
+            }
+        }
+
+        pj_dalloc( row_buf );
+        return 1;
+    }
+
+    else if( strcmp(gi->format,"ntv2") == 0 )
+    {
+        float *row_buf;
+
+        row_buf = (float *) pj_malloc(ct->lim.lam * sizeof(float) * 4);
+        if( row_buf == NULL )
+        {
+            pj_ctx_set_errno( ctx, ENOMEM );
+            return 0;
+        }
+
+        pj_ctx_fseek( ctx, fid, gi->grid_offset
+                      + (long) first_row * ct->lim.lam * 4 * (long) sizeof(float),
+                      SEEK_SET );
+
+        for( row = 0; row < row_count; row++ )
+        {
+            int	    i;
+            FLP     *cvs;
+            float   *diff_seconds;
+
+            if( pj_ctx_fread( ctx, row_buf, sizeof(float),
+                              ct->lim.lam*4, fid )
+                != (size_t)( 4 * ct->lim.lam ) )
+            {
+                pj_dalloc( row_buf );
+                pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+                return 0;
+            }
+
+            if( gi->must_swap )
+                swap_words( (unsigned char *) row_buf, 4, ct->lim.lam*4 );
+
+            /* convert seconds to radians */
+            diff_seconds = row_buf;
+
+            for( i = 0; i < ct->lim.lam; i++ )
+            {
+                cvs = (FLP *) data + (size_t) row * ct->lim.lam
+                    + (ct->lim.lam - i - 1);
+
+                cvs->phi = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
+                cvs->lam = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
+                diff_seconds += 2; /* skip accuracy values */
+            }
+        }
+
+        pj_dalloc( row_buf );
+        return 1;
+    }
+
+    else if( strcmp(gi->format,"gtx") == 0 )
+    {
+        pj_ctx_fseek( ctx, fid, gi->grid_offset
+                      + (long) first_row * ct->lim.lam * (long) sizeof(float),
+                      SEEK_SET );
+        if( pj_ctx_fread( ctx, data, sizeof(float), cells, fid ) != cells )
+        {
+            pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+            return 0;
+        }
+
+        if( IS_LSB )
+            swap_words( (unsigned char *) data, 4, (int) cells );
+
+        return 1;
+    }
+
+    return 0;
+}
+
 /************************************************************************/
 /*                          pj_gridinfo_free()                          */
 /************************************************************************/
@@ -92,6 +296,9 @@ void pj_gridinfo_free( projCtx ctx, PJ_GRIDINFO *gi )
     if( gi == NULL )
         return;
 
+    /* tiles of this grid may still be cached by some contexts */
+    pj_atomic_add( &grid_generation, 1 );
+
     if( gi->child != NULL )
     {
         PJ_GRIDINFO *child, *next;
@@ -103,8 +310,18 @@ void pj_gridinfo_free( projCtx ctx, PJ_GRIDINFO *gi )
         }
     }
 
+    pj_gridlist_index_free( gi->child_index );
+
+    if( gi->data_size != 0 )
+    {
+        pj_acquire_lock();
+        grid_memory_used -= gi->data_size;
+        pj_release_lock();
+    }
+
     if( gi->ct != NULL )
         nad_free( gi->ct );
+    pj_dalloc( gi->inverse );
 
     free( gi->gridname );
     if( gi->filename != NULL )
@@ -114,30 +331,15 @@ void pj_gridinfo_free( projCtx ctx, PJ_GRIDINFO *gi )
 }
 
 /************************************************************************/
-/*                          pj_gridinfo_load()                          */
+/*                         gridinfo_load_data()                         */
 /*                                                                      */
-/*      This function is intended to implement delayed loading of       */
-/*      the data contents of a grid file.  The header and related       */
-/*      stuff are loaded by pj_gridinfo_init().                         */
+/*      Read all the data of a grid into ct_tmp->cvs.                   */
 /************************************************************************/
 
-int pj_gridinfo_load( projCtx ctx, PJ_GRIDINFO *gi )
+static int gridinfo_load_data( projCtx ctx, PJ_GRIDINFO *gi,
+                               struct CTABLE *ct_tmp )
 
 {
-    struct CTABLE ct_tmp;
-
-    if( gi == NULL || gi->ct == NULL )
-        return 0;
-
-    pj_acquire_lock();
-    if( gi->ct->cvs != NULL )
-    {
-        pj_release_lock();
-        return 1;
-    }
-
-    memcpy(&ct_tmp, gi->ct, sizeof(struct CTABLE));
-
 /* -------------------------------------------------------------------- */
 /*      Original platform specific CTable format.                       */
 /* -------------------------------------------------------------------- */
@@ -151,17 +353,13 @@ int pj_gridinfo_load( projCtx ctx, PJ_GRIDINFO *gi )
         if( fid == NULL )
         {
             pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
             return 0;
         }
 
-        result = nad_ctable_load( ctx, &ct_tmp, fid );
+        result = nad_ctable_load( ctx, ct_tmp, fid );
 
         pj_ctx_fclose( ctx, fid );
 
-        gi->ct->cvs = ct_tmp.cvs;
-        pj_release_lock();
-
         return result;
     }
 
@@ -178,231 +376,524 @@ int pj_gridinfo_load( projCtx ctx, PJ_GRIDINFO *gi )
         if( fid == NULL )
         {
             pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
             return 0;
         }
 
-        result = nad_ctable2_load( ctx, &ct_tmp, fid );
+        result = nad_ctable2_load( ctx, ct_tmp, fid );
 
         pj_ctx_fclose( ctx, fid );
 
-        gi->ct->cvs = ct_tmp.cvs;
-
-        pj_release_lock();
         return result;
     }
 
 /* -------------------------------------------------------------------- */
-/*      NTv1 format.                                                    */
-/*      We process one line at a time.  Note that the array storage     */
-/*      direction (e-w) is different in the NTv1 file and what          */
-/*      the CTABLE is supposed to have.  The phi/lam are also           */
-/*      reversed, and we have to be aware of byte swapping.             */
+/*      NTv1, NTv2 and GTX formats.  The rows are converted by          */
+/*      gridinfo_read_rows(), which is shared with the loading of       */
+/*      tiles on demand.                                                */
 /* -------------------------------------------------------------------- */
-    else if( strcmp(gi->format,"ntv1") == 0 )
+    else if( strcmp(gi->format,"ntv1") == 0
+             || strcmp(gi->format,"ntv2") == 0
+             || strcmp(gi->format,"gtx") == 0 )
     {
-        double	*row_buf;
-        int	row;
         PAFile fid;
 
+        if( strcmp(gi->format,"ntv2") == 0 )
+            pj_log( ctx, PJ_LOG_DEBUG_MINOR,
+                    "NTv2 - loading grid %s", gi->ct->id );
+
         fid = pj_open_lib( ctx, gi->filename, "rb" );
 
         if( fid == NULL )
         {
             pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
             return 0;
         }
 
-        pj_ctx_fseek( ctx, fid, gi->grid_offset, SEEK_SET );
-
-        row_buf = (double *) pj_malloc(gi->ct->lim.lam * sizeof(double) * 2);
-        ct_tmp.cvs = (FLP *) pj_malloc(gi->ct->lim.lam*gi->ct->lim.phi*sizeof(FLP));
-        if( row_buf == NULL || ct_tmp.cvs == NULL )
+        ct_tmp->cvs = (FLP *) pj_malloc( (size_t) gi->ct->lim.lam
+                                        * gi->ct->lim.phi
+                                        * gridinfo_cell_size( gi ) );
+        if( ct_tmp->cvs == NULL )
         {
-            pj_dalloc( row_buf );
-            pj_dalloc( ct_tmp.cvs );
+            pj_ctx_fclose( ctx, fid );
             pj_ctx_set_errno( ctx, ENOMEM );
-            pj_release_lock();
             return 0;
         }
 
-        for( row = 0; row < gi->ct->lim.phi; row++ )
+        if( !gridinfo_read_rows( ctx, gi, fid, 0, gi->ct->lim.phi,
+                                 ct_tmp->cvs ) )
         {
-            int	    i;
-            FLP     *cvs;
-            double  *diff_seconds;
+            pj_ctx_fclose( ctx, fid );
+            return 0;
+        }
 
-            if( pj_ctx_fread( ctx, row_buf,
-                              sizeof(double), gi->ct->lim.lam * 2, fid )
-                != (size_t)( 2 * gi->ct->lim.lam ) )
-            {
-                pj_dalloc( row_buf );
-                pj_dalloc( ct_tmp.cvs );
-                pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-                pj_release_lock();
-                return 0;
-            }
+        pj_ctx_fclose( ctx, fid );
 
-            if( IS_LSB )
-                swap_words( (unsigned char *) row_buf, 8, gi->ct->lim.lam*2 );
+        return 1;
+    }
 
-            /* convert seconds to radians */
-            diff_seconds = row_buf;
+    else
+    {
+        return 0;
+    }
+}
 
-            for( i = 0; i < gi->ct->lim.lam; i++ )
-            {
-                cvs = ct_tmp.cvs + (row) * gi->ct->lim.lam
-                    + (gi->ct->lim.lam - i - 1);
+/************************************************************************/
+/*                           gridinfo_unload()                          */
+/*                                                                      */
+/*      Free the data of a grid and of its children, which no grid      */
+/*      list uses.  Called with the lock held.                          */
+/************************************************************************/
 
-                cvs->phi = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
-                cvs->lam = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
-            }
-        }
+static void gridinfo_unload( PJ_GRIDINFO *gi )
 
-        pj_dalloc( row_buf );
+{
+    PJ_GRIDINFO *child;
+    FLP *cvs = gi->ct->cvs;
+    FLP *inverse = gi->inverse;
 
-        pj_ctx_fclose( ctx, fid );
+    if( cvs != NULL )
+    {
+        pj_atomic_set_ptr( (void * volatile *) &gi->ct->cvs, NULL );
+        pj_dalloc( cvs );
+    }
+    if( inverse != NULL )
+    {
+        pj_atomic_set_ptr( (void * volatile *) &gi->inverse, NULL );
+        pj_dalloc( inverse );
+    }
+    grid_memory_used -= gi->data_size;
+    gi->data_size = 0;
 
-        gi->ct->cvs = ct_tmp.cvs;
-        pj_release_lock();
+    for( child = gi->child; child != NULL; child = child->next )
+        gridinfo_unload( child );
+}
+
+/************************************************************************/
+/*                           gridinfo_evict()                           */
+/*                                                                      */
+/*      Evict the data of the grids no grid list has used for the       */
+/*      longest time, till there is room for size more bytes in the     */
+/*      cache, or nothing more to evict.  Called with the lock held.    */
+/*      Grids still used by some grid list are never evicted, even if   */
+/*      that leaves the cache over its limit, as their data is read     */
+/*      without the lock.                                               */
+/************************************************************************/
+
+static void gridinfo_evict( projCtx ctx, size_t size )
+
+{
+    PJ_GRIDINFO *gi;
+
+    while( grid_memory_used + size > grid_cache_max
+           && (gi = pj_gridlist_evictable()) != NULL )
+    {
+        pj_log( ctx, PJ_LOG_DEBUG_MINOR,
+                "gridinfo_evict(): unloading %s", gi->gridname );
+        gridinfo_unload( gi );
+        ctx->grid_cache_evictions++;
+    }
+}
+
+/************************************************************************/
+/*                          pj_gridinfo_load()                          */
+/*                                                                      */
+/*      This function is intended to implement delayed loading of       */
+/*      the data contents of a grid file.  The header and related       */
+/*      stuff are loaded by pj_gridinfo_init().                         */
+/************************************************************************/
+
+int pj_gridinfo_load( projCtx ctx, PJ_GRIDINFO *gi )
+
+{
+    struct CTABLE ct_tmp;
+    size_t size;
+    int result;
 
+    if( gi == NULL || gi->ct == NULL )
+        return 0;
+
+    if( GRID_DATA(gi) != NULL )
+        return 1;
+
+    pj_acquire_lock();
+    if( gi->ct->cvs != NULL )
+    {
+        pj_release_lock();
         return 1;
     }
 
 /* -------------------------------------------------------------------- */
-/*      NTv2 format.                                                    */
-/*      We process one line at a time.  Note that the array storage     */
-/*      direction (e-w) is different in the NTv2 file and what          */
-/*      the CTABLE is supposed to have.  The phi/lam are also           */
-/*      reversed, and we have to be aware of byte swapping.             */
+/*      Make room for the data, evicting the grids unused for the       */
+/*      longest time.  If that is not enough, the grid is read in       */
+/*      tiles instead.                                                  */
 /* -------------------------------------------------------------------- */
-    else if( strcmp(gi->format,"ntv2") == 0 )
+    size = (size_t) gi->ct->lim.lam * gi->ct->lim.phi * gridinfo_cell_size( gi );
+    if( grid_cache_max != 0 && grid_memory_used + size > grid_cache_max )
     {
-        float	*row_buf;
-        int	row;
-        PAFile fid;
-
-        pj_log( ctx, PJ_LOG_DEBUG_MINOR,
-                "NTv2 - loading grid %s", gi->ct->id );
-
-        fid = pj_open_lib( ctx, gi->filename, "rb" );
-
-        if( fid == NULL )
+        gridinfo_evict( ctx, size );
+        if( grid_memory_used + size > grid_cache_max )
         {
-            pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+            pj_log( ctx, PJ_LOG_DEBUG_MINOR,
+                    "pj_gridinfo_load(): %s does not fit in the grid cache, "
+                    "reading it in tiles", gi->gridname );
+            gi->over_budget = grid_cache_generation;
             pj_release_lock();
-            return 0;
+            return 1;
         }
+    }
 
-        pj_ctx_fseek( ctx, fid, gi->grid_offset, SEEK_SET );
+    memcpy(&ct_tmp, gi->ct, sizeof(struct CTABLE));
+    ct_tmp.cvs = NULL;
+    result = gridinfo_load_data( ctx, gi, &ct_tmp );
+    ctx->grid_cache_misses++;
+
+/* -------------------------------------------------------------------- */
+/*      Publish the data for the readers that do not take the lock.     */
+/* -------------------------------------------------------------------- */
+    if( result && ct_tmp.cvs != NULL )
+    {
+        gi->data_size = size;
+        grid_memory_used += gi->data_size;
+        pj_atomic_set_ptr( (void * volatile *) &gi->ct->cvs, ct_tmp.cvs );
+    }
+    else
+        pj_dalloc( ct_tmp.cvs );
+
+    pj_release_lock();
+    return result;
+}
+
+/************************************************************************/
+/*                         pj_gridinfo_inverse()                        */
+/*                                                                      */
+/*      Return the inverse shifts at the nodes of a grid, computed on   */
+/*      first use, so that inverse shifts can be interpolated like      */
+/*      forward ones.  NULL if the grid is not loaded completely, or    */
+/*      if they do not fit in the grid cache.                           */
+/*                                                                      */
+/*      The shifts are computed without the lock, after reserving room  */
+/*      for them in the cache, and published under it, unless another   */
+/*      thread was faster.                                              */
+/************************************************************************/
 
-        row_buf = (float *) pj_malloc(gi->ct->lim.lam * sizeof(float) * 4);
-        ct_tmp.cvs = (FLP *) pj_malloc(gi->ct->lim.lam*gi->ct->lim.phi*sizeof(FLP));
-        if( row_buf == NULL || ct_tmp.cvs == NULL )
+FLP *pj_gridinfo_inverse( projCtx ctx, PJ_GRIDINFO *gi )
+
+{
+    struct CTABLE *ct = gi->ct;
+    FLP *inverse, *cvs;
+    size_t size;
+    int i, j;
+
+    inverse = (FLP *) pj_atomic_get_ptr( (void * volatile *) &gi->inverse );
+    if( inverse != NULL || ct == NULL || GRID_DATA(gi) == NULL )
+        return inverse;
+
+    pj_acquire_lock();
+    if( gi->inverse != NULL || ct->cvs == NULL )
+    {
+        inverse = gi->inverse;
+        pj_release_lock();
+        return inverse;
+    }
+
+    size = (size_t) ct->lim.lam * ct->lim.phi * sizeof(FLP);
+    if( grid_cache_max != 0 && grid_memory_used + size > grid_cache_max )
+    {
+        gridinfo_evict( ctx, size );
+        if( grid_memory_used + size > grid_cache_max )
         {
-            pj_dalloc( row_buf );
-            pj_dalloc( ct_tmp.cvs );
-            pj_ctx_set_errno( ctx, ENOMEM );
             pj_release_lock();
-            return 0;
+            return NULL;
         }
+    }
+    grid_memory_used += size;
+    cvs = ct->cvs;
+    pj_release_lock();
 
-        for( row = 0; row < gi->ct->lim.phi; row++ )
-        {
-            int	    i;
-            FLP     *cvs;
-            float   *diff_seconds;
+    inverse = (FLP *) pj_malloc( size );
+    if( inverse == NULL )
+    {
+        pj_acquire_lock();
+        grid_memory_used -= size;
+        pj_release_lock();
+        return NULL;
+    }
 
-            if( pj_ctx_fread( ctx, row_buf, sizeof(float),
-                              gi->ct->lim.lam*4, fid )
-                != (size_t)( 4 * gi->ct->lim.lam ) )
+    for( j = 0; j < ct->lim.phi; j++ )
+    {
+        for( i = 0; i < ct->lim.lam; i++ )
+        {
+            FLP *node = cvs + (size_t) j * ct->lim.lam + i;
+            FLP *shift = inverse + (size_t) j * ct->lim.lam + i;
+            LP tb, t;
+
+            tb.lam = i * ct->del.lam;
+            tb.phi = j * ct->del.phi;
+            t = nad_inverse( ctx, tb, gi );
+            if( t.lam == HUGE_VAL )
             {
-                pj_dalloc( row_buf );
-                pj_dalloc( ct_tmp.cvs );
-                pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-                pj_release_lock();
-                return 0;
+                /* first order approximation */
+                shift->lam = -node->lam;
+                shift->phi = -node->phi;
             }
+            else
+            {
+                shift->lam = (float) (tb.lam - t.lam);
+                shift->phi = (float) (t.phi - tb.phi);
+            }
+        }
+    }
 
-            if( gi->must_swap )
-                swap_words( (unsigned char *) row_buf, 4,
-                            gi->ct->lim.lam*4 );
+    pj_acquire_lock();
+    if( gi->inverse != NULL )
+    {
+        grid_memory_used -= size;
+        pj_dalloc( inverse );
+        inverse = gi->inverse;
+    }
+    else
+    {
+        gi->data_size += size;
+        pj_atomic_set_ptr( (void * volatile *) &gi->inverse, inverse );
+    }
+    pj_release_lock();
+    return inverse;
+}
 
-            /* convert seconds to radians */
-            diff_seconds = row_buf;
+/************************************************************************/
+/*                        pj_gridinfo_memory_used()                     */
+/*                                                                      */
+/*      Bytes of grid data currently loaded, for all contexts.          */
+/************************************************************************/
 
-            for( i = 0; i < gi->ct->lim.lam; i++ )
-            {
-                cvs = ct_tmp.cvs + (row) * gi->ct->lim.lam
-                    + (gi->ct->lim.lam - i - 1);
+size_t pj_gridinfo_memory_used( void )
 
-                cvs->phi = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
-                cvs->lam = (float) (*(diff_seconds++) * ((M_PI/180.0) / 3600.0));
-                diff_seconds += 2; /* skip accuracy values */
-            }
-        }
+{
+    size_t used;
 
-        pj_dalloc( row_buf );
+    pj_acquire_lock();
+    used = grid_memory_used;
+    pj_release_lock();
+    return used;
+}
 
-        pj_ctx_fclose( ctx, fid );
+/************************************************************************/
+/*                      pj_gridinfo_set_cache_size()                    */
+/*                                                                      */
+/*      Limit the bytes of grid data loaded for all contexts, 0 for no  */
+/*      limit.  Grids that do not fit are read in tiles.                */
+/************************************************************************/
 
-        gi->ct->cvs = ct_tmp.cvs;
+void pj_gridinfo_set_cache_size( projCtx ctx, size_t max_size )
 
-        pj_release_lock();
+{
+    pj_acquire_lock();
+    grid_cache_max = max_size;
+    pj_atomic_add( &grid_cache_generation, 1 );
+    if( grid_cache_max != 0 )
+        gridinfo_evict( ctx, 0 );
+    pj_release_lock();
+}
+
+/************************************************************************/
+/*                      pj_gridinfo_get_cache_size()                    */
+/************************************************************************/
+
+size_t pj_gridinfo_get_cache_size( void )
+
+{
+    size_t max_size;
+
+    pj_acquire_lock();
+    max_size = grid_cache_max;
+    pj_release_lock();
+    return max_size;
+}
+
+/************************************************************************/
+/*                           gridinfo_tiled()                           */
+/*                                                                      */
+/*      Whether the data of a grid are read in tiles on demand in       */
+/*      this context, rather than loaded completely.                    */
+/************************************************************************/
+
+static int gridinfo_tiled( projCtx ctx, PJ_GRIDINFO *gi )
+{
+    /* did not fit in the grid cache */
+    if( pj_atomic_get( &gi->over_budget )
+        == pj_atomic_get( &grid_cache_generation ) )
         return 1;
+
+    if( ctx->grid_tiling >= 0 )
+        return ctx->grid_tiling;
+
+    return (double) gi->ct->lim.lam * gi->ct->lim.phi
+        * gridinfo_cell_size( gi ) > GRID_TILING_MIN_SIZE;
+}
+
+/************************************************************************/
+/*                        pj_gridinfo_prepare()                         */
+/*                                                                      */
+/*      Make the data of a grid available to pj_gridinfo_row().         */
+/*      Grids read in tiles need nothing more, the others are loaded    */
+/*      completely with pj_gridinfo_load().                             */
+/************************************************************************/
+
+int pj_gridinfo_prepare( projCtx ctx, PJ_GRIDINFO *gi )
+
+{
+    if( gi == NULL || gi->ct == NULL )
+        return 0;
+
+    if( GRID_DATA(gi) != NULL || gridinfo_tiled( ctx, gi ) )
+        return 1;
+
+    return pj_gridinfo_load( ctx, gi );
+}
+
+/************************************************************************/
+/*                          pj_gridinfo_row()                           */
+/*                                                                      */
+/*      Return the given row of grid data, using the layout of          */
+/*      ct->cvs.  The row comes from the loaded grid if there is one,   */
+/*      otherwise from the tiles cached by the context, reading the     */
+/*      missing tile from the file.  The two most recently returned     */
+/*      rows always remain valid, so bilinear interpolation can hold    */
+/*      on to both rows of a cell.                                      */
+/************************************************************************/
+
+void *pj_gridinfo_row( projCtx ctx, PJ_GRIDINFO *gi, int row )
+
+{
+    struct CTABLE *ct = gi->ct;
+    size_t row_size = (size_t) ct->lim.lam * gridinfo_cell_size( gi );
+    struct pj_grid_tile *tile, *prev = NULL;
+    int    rows_per_tile, first_row, row_count, generation;
+    FLP    *cvs = GRID_DATA(gi);
+    PAFile fid;
+
+    if( cvs == NULL && !gridinfo_tiled( ctx, gi ) )
+    {
+        if( !pj_gridinfo_load( ctx, gi ) )
+            return NULL;
+        cvs = GRID_DATA(gi);
+    }
+
+    if( cvs != NULL )
+    {
+        ctx->grid_cache_hits++;
+        return (unsigned char *) cvs + row * row_size;
+    }
+
+    generation = pj_atomic_get( &grid_generation );
+    if( ctx->grid_tile_generation != generation )
+    {
+        pj_gridinfo_free_tiles( ctx );
+        ctx->grid_tile_generation = generation;
     }
 
+    rows_per_tile = row_size >= GRID_TILE_SIZE ? 1
+        : (int) (GRID_TILE_SIZE / row_size);
+    first_row = row - row % rows_per_tile;
+
 /* -------------------------------------------------------------------- */
-/*      GTX format.                                                     */
+/*      Look for the tile, moving it to the front of the list.          */
 /* -------------------------------------------------------------------- */
-    else if( strcmp(gi->format,"gtx") == 0 )
+    for( tile = ctx->grid_tiles; tile != NULL; prev = tile, tile = tile->next )
     {
-        int   words = gi->ct->lim.lam * gi->ct->lim.phi;
-        PAFile fid;
+        if( tile->gi != gi || tile->first_row != first_row )
+            continue;
 
-        fid = pj_open_lib( ctx, gi->filename, "rb" );
-
-        if( fid == NULL )
+        if( prev != NULL )
         {
-            pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
-            return 0;
+            prev->next = tile->next;
+            tile->next = ctx->grid_tiles;
+            ctx->grid_tiles = tile;
         }
+        ctx->grid_cache_hits++;
+        return tile->data + (row - first_row) * row_size;
+    }
 
-        pj_ctx_fseek( ctx, fid, gi->grid_offset, SEEK_SET );
+/* -------------------------------------------------------------------- */
+/*      Read it from the file.                                          */
+/* -------------------------------------------------------------------- */
+    row_count = ct->lim.phi - first_row;
+    if( row_count > rows_per_tile )
+        row_count = rows_per_tile;
 
-        ct_tmp.cvs = (FLP *) pj_malloc(words*sizeof(float));
-        if( ct_tmp.cvs == NULL )
-        {
-            pj_ctx_set_errno( ctx, ENOMEM );
-            pj_release_lock();
-            return 0;
-        }
+    pj_log( ctx, PJ_LOG_DEBUG_MINOR,
+            "pj_gridinfo_row(): reading rows %d to %d of %s",
+            first_row, first_row + row_count - 1, gi->gridname );
 
-        if( pj_ctx_fread( ctx, ct_tmp.cvs, sizeof(float), words, fid )
-            != (size_t)words )
-        {
-            pj_dalloc( ct_tmp.cvs );
-            pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
-            return 0;
-        }
+    tile = (struct pj_grid_tile *) pj_calloc(1, sizeof(struct pj_grid_tile));
+    if( tile != NULL )
+        tile->data = (unsigned char *) pj_malloc(row_count * row_size);
+    if( tile == NULL || tile->data == NULL )
+    {
+        pj_dalloc( tile );
+        pj_ctx_set_errno( ctx, ENOMEM );
+        return NULL;
+    }
 
-        if( IS_LSB )
-            swap_words( (unsigned char *) ct_tmp.cvs, 4, words );
+    fid = pj_open_lib( ctx, gi->filename, "rb" );
+    if( fid == NULL
+        || !gridinfo_read_rows( ctx, gi, fid, first_row, row_count,
+                                tile->data ) )
+    {
+        if( fid != NULL )
+            pj_ctx_fclose( ctx, fid );
+        pj_dalloc( tile->data );
+        pj_dalloc( tile );
+        pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
+        return NULL;
+    }
+    pj_ctx_fclose( ctx, fid );
+    ctx->grid_cache_misses++;
 
-        pj_ctx_fclose( ctx, fid );
-        gi->ct->cvs = ct_tmp.cvs;
-        pj_release_lock();
-        return 1;
+    tile->gi = gi;
+    tile->first_row = first_row;
+    tile->next = ctx->grid_tiles;
+    ctx->grid_tiles = tile;
+    ctx->grid_tile_count++;
+
+/* -------------------------------------------------------------------- */
+/*      Drop the least recently used tile if we have too many.          */
+/* -------------------------------------------------------------------- */
+    if( ctx->grid_tile_count > GRID_TILE_MAX )
+    {
+        struct pj_grid_tile *last;
+
+        for( prev = ctx->grid_tiles; prev->next->next != NULL;
+             prev = prev->next ) {}
+        last = prev->next;
+        prev->next = NULL;
+        pj_dalloc( last->data );
+        pj_dalloc( last );
+        ctx->grid_tile_count--;
+        ctx->grid_cache_evictions++;
     }
 
-    else
+    return tile->data + (row - first_row) * row_size;
+}
+
+/************************************************************************/
+/*                       pj_gridinfo_free_tiles()                       */
+/*                                                                      */
+/*      Free the grid tiles cached by a context.                        */
+/************************************************************************/
+
+void pj_gridinfo_free_tiles( projCtx ctx )
+
+{
+    while( ctx->grid_tiles != NULL )
     {
-        pj_release_lock();
-        return 0;
+        struct pj_grid_tile *tile = ctx->grid_tiles;
+
+        ctx->grid_tiles = tile->next;
+        pj_dalloc( tile->data );
+        pj_dalloc( tile );
     }
+    ctx->grid_tile_count = 0;
 }
 
 /************************************************************************/
@@ -839,6 +1330,43 @@ static int pj_gridinfo_init_gtx( projCtx ctx, PAFile fid, PJ_GRIDINFO *gi )
     return 1;
 }
 
+/************************************************************************/
+/*                       gridinfo_index_children()                      */
+/*                                                                      */
+/*      Build the spatial index of the children of each grid of the    */
+/*      list, at all levels, for pj_gridlist_find().  A grid left       */
+/*      without index just has its children scanned.                    */
+/************************************************************************/
+
+static void gridinfo_index_children( PJ_GRIDINFO *gilist )
+{
+    PJ_GRIDINFO *gi, *child, **children;
+    int count;
+
+    for( gi = gilist; gi != NULL; gi = gi->next )
+    {
+        if( gi->child == NULL )
+            continue;
+
+        gridinfo_index_children( gi->child );
+
+        count = 0;
+        for( child = gi->child; child != NULL; child = child->next )
+            count++;
+
+        children = (PJ_GRIDINFO **) pj_malloc( count * sizeof(PJ_GRIDINFO *) );
+        if( children == NULL )
+            continue;
+
+        count = 0;
+        for( child = gi->child; child != NULL; child = child->next )
+            children[count++] = child;
+
+        gi->child_index = pj_gridlist_index( children, count );
+        pj_dealloc( children );
+    }
+}
+
 /************************************************************************/
 /*                          pj_gridinfo_init()                          */
 /*                                                                      */
@@ -883,10 +1411,11 @@ PJ_GRIDINFO *pj_gridinfo_init( projCtx ctx, const char *gridname )
     gilist->next = NULL;
 
 /* -------------------------------------------------------------------- */
-/*      Open the file using the usual search rules.                     */
+/*      Open the file using the usual search rules.  The grid keeps     */
+/*      the name of the file found, so reading its data later on, tile  */
+/*      by tile for large grids, does not go through them again.        */
 /* -------------------------------------------------------------------- */
-    strcpy(fname, gridname);
-    if (!(fp = pj_open_lib(ctx, fname, "rb"))) {
+    if (!(fp = pj_open_lib_ex(ctx, gridname, "rb", fname, sizeof(fname)))) {
         ctx->last_errno = 0; /* don't treat as a persistent error */
         return gilist;
     }
@@ -987,5 +1516,7 @@ PJ_GRIDINFO *pj_gridinfo_init( projCtx ctx, const char *gridname )
 
     pj_ctx_fclose(ctx, fp);
 
+    gridinfo_index_children( gilist );
+
     return gilist;
 }
@@ -29,56 +29,168 @@
 #define PJ_LIB__
 
 #include <errno.h>
+#include <math.h>
 #include <stddef.h>
 #include <string.h>
 
+#include "proj_internal.h"
+#include "proj_math.h"
 #include "projects.h"
 
+/*
+** The registry of the grid files opened so far, shared by all contexts.
+** Grids are only ever added at its head, under the lock, and published
+** with pj_atomic_set_ptr(), so it can be searched without taking the lock.
+** The registry holds one reference on each of its grids, and each grid
+** list another one on each of the grids it lists.
+*/
 static PJ_GRIDINFO *grid_list = NULL;
 #define PJ_MAX_PATH_LENGTH 1024
 
+/* Counts the releases of grids by grid lists, under the lock */
+static int grid_clock = 0;
+
+/************************************************************************/
+/*                          gridinfo_add_ref()                          */
+/*                                                                      */
+/*      Take a reference on a grid of the registry.  The data of the    */
+/*      grids held by the registry alone may be evicted, under the      */
+/*      lock, so taking the first reference of a grid list also needs   */
+/*      it.                                                             */
+/************************************************************************/
+
+static void gridinfo_add_ref( PJ_GRIDINFO *gi )
+
+{
+    int count = pj_atomic_get( &gi->ref_count );
+
+    while( count >= 2 )
+    {
+        if( pj_atomic_cas( &gi->ref_count, count, count + 1 ) )
+            return;
+        count = pj_atomic_get( &gi->ref_count );
+    }
+
+    pj_acquire_lock();
+    pj_atomic_add( &gi->ref_count, 1 );
+    pj_release_lock();
+}
+
+/************************************************************************/
+/*                        pj_gridinfo_release()                         */
+/*                                                                      */
+/*      Drop a reference on a grid, freeing it with the last one.       */
+/************************************************************************/
+
+void pj_gridinfo_release( PJ_GRIDINFO *gi )
+
+{
+    int count;
+
+    if( gi == NULL )
+        return;
+
+    count = pj_atomic_add( &gi->ref_count, -1 );
+    if( count == 0 )
+        pj_gridinfo_free( pj_get_default_ctx(), gi );
+    else if( count == 1 )
+    {
+        /* no more used by grid lists: remember when, for eviction */
+        pj_acquire_lock();
+        gi->last_used = ++grid_clock;
+        pj_release_lock();
+    }
+}
+
+/************************************************************************/
+/*                          gridinfo_has_data()                         */
+/************************************************************************/
+
+static int gridinfo_has_data( const PJ_GRIDINFO *gi )
+
+{
+    const PJ_GRIDINFO *child;
+
+    if( gi->data_size != 0 )
+        return 1;
+    for( child = gi->child; child != NULL; child = child->next )
+        if( gridinfo_has_data( child ) )
+            return 1;
+    return 0;
+}
+
+/************************************************************************/
+/*                        pj_gridlist_evictable()                       */
+/*                                                                      */
+/*      Return the grid of the registry, with some data loaded, that    */
+/*      has not been used by any grid list for the longest time, or     */
+/*      NULL if there is none.  To be called with the lock held.        */
+/************************************************************************/
+
+PJ_GRIDINFO *pj_gridlist_evictable( void )
+
+{
+    PJ_GRIDINFO *gi, *best = NULL;
+
+    for( gi = grid_list; gi != NULL; gi = gi->next )
+    {
+        if( pj_atomic_get( &gi->ref_count ) != 1 || !gridinfo_has_data( gi ) )
+            continue;
+        if( best == NULL || gi->last_used < best->last_used )
+            best = gi;
+    }
+
+    return best;
+}
+
 /************************************************************************/
 /*                        pj_deallocate_grids()                         */
 /*                                                                      */
-/*      Deallocate all loaded grids.                                    */
+/*      Deallocate all loaded grids.  Grids still used by grid lists    */
+/*      are only freed with the last of these lists.  This must not     */
+/*      run while other threads set up grid lists.                      */
 /************************************************************************/
 
 void pj_deallocate_grids()
 
 {
-    while( grid_list != NULL )
+    PJ_GRIDINFO *item;
+
+    pj_acquire_lock();
+    item = (PJ_GRIDINFO *) pj_atomic_get_ptr( (void * volatile *) &grid_list );
+    pj_atomic_set_ptr( (void * volatile *) &grid_list, NULL );
+    pj_release_lock();
+
+    while( item != NULL )
     {
-        PJ_GRIDINFO *item = grid_list;
-        grid_list = grid_list->next;
+        PJ_GRIDINFO *next = item->next;
         item->next = NULL;
 
-        pj_gridinfo_free( pj_get_default_ctx(), item );
+        pj_gridinfo_release( item );
+        item = next;
     }
 }
 
 /************************************************************************/
-/*                       pj_gridlist_merge_grid()                       */
+/*                         gridlist_add_grids()                         */
 /*                                                                      */
-/*      Find/load the named gridfile and merge it into the              */
-/*      last_nadgrids_list.                                             */
+/*      Add the grids of the registry, starting at head, that come      */
+/*      from the named grid file to the list.  As with NTv2 we can      */
+/*      get many grids from one file (one shared gridname), all the     */
+/*      matching grids are added.  Returns -1 if there is none.         */
 /************************************************************************/
 
-static int pj_gridlist_merge_gridfile( projCtx ctx, 
-                                       const char *gridname,
-                                       PJ_GRIDINFO ***p_gridlist,
-                                       int *p_gridcount, 
-                                       int *p_gridmax )
+static int gridlist_add_grids( projCtx ctx, PJ_GRIDINFO *head,
+                               const char *gridname,
+                               PJ_GRIDINFO ***p_gridlist,
+                               int *p_gridcount,
+                               int *p_gridmax )
 
 {
     int got_match=0;
-    PJ_GRIDINFO *this_grid, *tail = NULL;
+    PJ_GRIDINFO *this_grid;
 
-/* -------------------------------------------------------------------- */
-/*      Try to find in the existing list of loaded grids.  Add all      */
-/*      matching grids as with NTv2 we can get many grids from one      */
-/*      file (one shared gridname).                                     */
-/* -------------------------------------------------------------------- */
-    for( this_grid = grid_list; this_grid != NULL; this_grid = this_grid->next)
+    for( this_grid = head; this_grid != NULL; this_grid = this_grid->next)
     {
         if( strcmp(this_grid->gridname,gridname) == 0 )
         {
@@ -111,36 +223,78 @@ static int pj_gridlist_merge_gridfile( projCtx ctx,
             }
 
             /* add to the list */
+            gridinfo_add_ref( this_grid );
             (*p_gridlist)[(*p_gridcount)++] = this_grid;
             (*p_gridlist)[*p_gridcount] = NULL;
         }
-
-        tail = this_grid;
     }
 
-    if( got_match )
-        return 1;
+    return got_match ? 1 : -1;
+}
+
+/************************************************************************/
+/*                       pj_gridlist_merge_grid()                       */
+/*                                                                      */
+/*      Find/load the named gridfile and merge it into the              */
+/*      last_nadgrids_list.                                             */
+/************************************************************************/
+
+static int pj_gridlist_merge_gridfile( projCtx ctx,
+                                       const char *gridname,
+                                       PJ_GRIDINFO ***p_gridlist,
+                                       int *p_gridcount,
+                                       int *p_gridmax )
+
+{
+    int result;
+    PJ_GRIDINFO *head, *this_grid, *tail;
+
+/* -------------------------------------------------------------------- */
+/*      Try to find in the existing list of loaded grids.               */
+/* -------------------------------------------------------------------- */
+    head = (PJ_GRIDINFO *) pj_atomic_get_ptr( (void * volatile *) &grid_list );
+    result = gridlist_add_grids( ctx, head, gridname,
+                                 p_gridlist, p_gridcount, p_gridmax );
+    if( result >= 0 )
+        return result;
 
 /* -------------------------------------------------------------------- */
-/*      Try to load the named grid.                                     */
+/*      Try to load the named grid, under the lock so that it is        */
+/*      opened only once, checking first that another thread did not   */
+/*      just do it.                                                     */
 /* -------------------------------------------------------------------- */
-    this_grid = pj_gridinfo_init( ctx, gridname );
+    pj_acquire_lock();
 
-    if( this_grid == NULL )
+    head = (PJ_GRIDINFO *) pj_atomic_get_ptr( (void * volatile *) &grid_list );
+    result = gridlist_add_grids( ctx, head, gridname,
+                                 p_gridlist, p_gridcount, p_gridmax );
+    if( result < 0 )
     {
-        return 0;
+        this_grid = pj_gridinfo_init( ctx, gridname );
+
+        if( this_grid == NULL )
+        {
+            pj_release_lock();
+            return 0;
+        }
+
+        /* the registry holds a reference on each of the new grids */
+        for( tail = this_grid; ; tail = tail->next )
+        {
+            tail->ref_count = 1;
+            if( tail->next == NULL )
+                break;
+        }
+        tail->next = head;
+        pj_atomic_set_ptr( (void * volatile *) &grid_list, this_grid );
+
+        result = gridlist_add_grids( ctx, this_grid, gridname,
+                                     p_gridlist, p_gridcount, p_gridmax );
     }
-    
-    if( tail != NULL )
-        tail->next = this_grid;
-    else
-        grid_list = this_grid;
 
-/* -------------------------------------------------------------------- */
-/*      Recurse to add the grid now that it is loaded.                  */
-/* -------------------------------------------------------------------- */
-    return pj_gridlist_merge_gridfile( ctx, gridname, p_gridlist, 
-                                       p_gridcount, p_gridmax );
+    pj_release_lock();
+
+    return result > 0;
 }
 
 /************************************************************************/
@@ -164,8 +318,6 @@ PJ_GRIDINFO **pj_gridlist_from_nadgrids( projCtx ctx, const char *nadgrids,
     pj_errno = 0;
     *grid_count = 0;
 
-    pj_acquire_lock();
-
 /* -------------------------------------------------------------------- */
 /*      Loop processing names out of nadgrids one at a time.            */
 /* -------------------------------------------------------------------- */
@@ -187,9 +339,8 @@ PJ_GRIDINFO **pj_gridlist_from_nadgrids( projCtx ctx, const char *nadgrids,
 
         if( end_char >= sizeof(name) )
         {
-            pj_dalloc( gridlist );
+            pj_gridlist_free( gridlist, *grid_count );
             pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
             return NULL;
         }
         
@@ -204,16 +355,473 @@ PJ_GRIDINFO **pj_gridlist_from_nadgrids( projCtx ctx, const char *nadgrids,
                                          &grid_max) 
             && required )
         {
-            pj_dalloc( gridlist );
+            pj_gridlist_free( gridlist, *grid_count );
             pj_ctx_set_errno( ctx, PJD_ERR_FAILED_TO_LOAD_GRID );
-            pj_release_lock();
             return NULL;
         }
         else
             pj_errno = 0;
     }
 
-    pj_release_lock();
-
     return gridlist;
 }
+
+/************************************************************************/
+/*                          pj_gridlist_free()                          */
+/*                                                                      */
+/*      Free a list of grids from pj_gridlist_from_nadgrids(),          */
+/*      dropping its references on the grids.                           */
+/************************************************************************/
+
+void pj_gridlist_free( PJ_GRIDINFO **gridlist, int grid_count )
+
+{
+    int i;
+
+    if( gridlist == NULL )
+        return;
+
+    for( i = 0; i < grid_count; i++ )
+        pj_gridinfo_release( gridlist[i] );
+    pj_dalloc( gridlist );
+}
+
+/************************************************************************/
+/*                          pj_gridlist_copy()                          */
+/*                                                                      */
+/*      Copy a list of grids from pj_gridlist_from_nadgrids(), taking   */
+/*      a reference on each of its grids, so that both lists share      */
+/*      them.  The copy is freed with pj_gridlist_free().               */
+/************************************************************************/
+
+PJ_GRIDINFO **pj_gridlist_copy( projCtx ctx, PJ_GRIDINFO **gridlist,
+                                int grid_count )
+
+{
+    PJ_GRIDINFO **new_list;
+    int i;
+
+    if( gridlist == NULL )
+        return NULL;
+
+    new_list = (PJ_GRIDINFO **) pj_calloc( grid_count + 1, sizeof(void *) );
+    if( new_list == NULL )
+    {
+        pj_ctx_set_errno( ctx, ENOMEM );
+        return NULL;
+    }
+
+    for( i = 0; i < grid_count; i++ )
+    {
+        gridinfo_add_ref( gridlist[i] );
+        new_list[i] = gridlist[i];
+    }
+
+    return new_list;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*      Spatial index over a list of grids.  The extent of the list    */
+/*      is cut in buckets, each holding the grids that touch it, in    */
+/*      list order, so that looking a point up only checks a few       */
+/*      grids, with the same result as a scan of the whole list.       */
+/* ==================================================================== */
+/************************************************************************/
+
+/* Number of buckets per grid of the list, and upper limit */
+#define GRID_INDEX_BUCKETS_PER_GRID   4
+#define GRID_INDEX_MAX_BUCKETS        4096
+
+/* bucket flags telling that the bucket lies within its first/last grid */
+#define GRID_INDEX_FIRST_COVERS       1
+#define GRID_INDEX_LAST_COVERS        2
+
+struct _pj_grid_index {
+    int           grid_count;
+    PJ_GRIDINFO **grids;        /* in list order */
+
+    LP            ll, ur;       /* extent of the grids, with tolerance */
+    LP            size;         /* size of a bucket */
+    int           cols, rows;
+    int          *first;        /* per bucket, offset of its entries */
+    int          *entries;      /* positions of the grids in each bucket */
+    unsigned char *covers;      /* per bucket, GRID_INDEX_xxx_COVERS flags */
+
+    /* Last hit of pj_gridlist_find(): any point of last_ll/last_ur */
+    /* gives last_grid when looked up with last_flags. */
+    PJ_GRIDINFO  *last_grid;
+    int           last_flags;
+    LP            last_ll, last_ur;
+};
+
+/************************************************************************/
+/*                            grid_contains()                           */
+/************************************************************************/
+
+static int grid_contains( const PJ_GRIDINFO *gi, LP input, int flags )
+{
+    const struct CTABLE *ct = gi->ct;
+    double epsilon = 0.0;
+
+    if( flags & PJ_GRID_FIND_TOLERANT )
+        epsilon = (fabs(ct->del.phi)+fabs(ct->del.lam))/10000.0;
+
+    return !( ct->ll.phi - epsilon > input.phi
+              || ct->ll.lam - epsilon > input.lam
+              || ct->ll.phi + (ct->lim.phi-1) * ct->del.phi + epsilon < input.phi
+              || ct->ll.lam + (ct->lim.lam-1) * ct->del.lam + epsilon < input.lam );
+}
+
+/************************************************************************/
+/*                          grid_index_bucket()                         */
+/*                                                                      */
+/*      Bucket column (or row) of a coordinate, clamped to the index.   */
+/************************************************************************/
+
+static int grid_index_bucket( double value, double origin, double size, int n )
+{
+    double i = floor( (value - origin) / size );
+
+    if( i < 0 )
+        return 0;
+    if( i >= n )
+        return n - 1;
+    return (int) i;
+}
+
+/************************************************************************/
+/*                          pj_gridlist_index()                         */
+/*                                                                      */
+/*      Build the spatial index of a list of grids.  The list itself    */
+/*      is copied, the grids are not.                                   */
+/************************************************************************/
+
+PJ_GRID_INDEX *pj_gridlist_index( PJ_GRIDINFO **grids, int grid_count )
+
+{
+    PJ_GRID_INDEX *idx;
+    int    i, b, col, row, buckets;
+    int    *fill;
+    double width, height;
+
+    idx = (PJ_GRID_INDEX *) pj_calloc( 1, sizeof(PJ_GRID_INDEX) );
+    if( idx == NULL )
+        return NULL;
+
+    idx->grid_count = grid_count;
+    idx->grids = (PJ_GRIDINFO **)
+        pj_malloc( (grid_count + 1) * sizeof(PJ_GRIDINFO *) );
+    if( idx->grids == NULL )
+    {
+        pj_gridlist_index_free( idx );
+        return NULL;
+    }
+    if( grid_count > 0 )
+        memcpy( idx->grids, grids, grid_count * sizeof(PJ_GRIDINFO *) );
+
+/* -------------------------------------------------------------------- */
+/*      Extent of the list, including the tolerance of the grids.       */
+/* -------------------------------------------------------------------- */
+    idx->ll.lam = idx->ll.phi = HUGE_VAL;
+    idx->ur.lam = idx->ur.phi = -HUGE_VAL;
+    for( i = 0; i < grid_count; i++ )
+    {
+        struct CTABLE *ct = grids[i]->ct;
+        double epsilon = (fabs(ct->del.phi)+fabs(ct->del.lam))/10000.0;
+
+        idx->ll.lam = MIN( idx->ll.lam, ct->ll.lam - epsilon );
+        idx->ll.phi = MIN( idx->ll.phi, ct->ll.phi - epsilon );
+        idx->ur.lam = MAX( idx->ur.lam,
+                           ct->ll.lam + (ct->lim.lam-1) * ct->del.lam + epsilon );
+        idx->ur.phi = MAX( idx->ur.phi,
+                           ct->ll.phi + (ct->lim.phi-1) * ct->del.phi + epsilon );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Choose buckets about square, a few per grid.                    */
+/* -------------------------------------------------------------------- */
+    buckets = MIN( grid_count * GRID_INDEX_BUCKETS_PER_GRID,
+                   GRID_INDEX_MAX_BUCKETS );
+    width = idx->ur.lam - idx->ll.lam;
+    height = idx->ur.phi - idx->ll.phi;
+    if( grid_count == 0 || !(width > 0) || !(height > 0) )
+    {
+        idx->cols = idx->rows = 1;
+        width = height = 1;
+    }
+    else
+    {
+        idx->cols = (int) ceil( sqrt( buckets * width / height ) );
+        idx->cols = MAX( 1, MIN( buckets, idx->cols ) );
+        idx->rows = MAX( 1, buckets / idx->cols );
+    }
+    idx->size.lam = width / idx->cols;
+    idx->size.phi = height / idx->rows;
+    buckets = idx->cols * idx->rows;
+
+    idx->first = (int *) pj_calloc( buckets + 1, sizeof(int) );
+    fill = (int *) pj_calloc( buckets, sizeof(int) );
+    idx->covers = (unsigned char *) pj_calloc( buckets, 1 );
+    if( idx->first == NULL || fill == NULL || idx->covers == NULL )
+    {
+        pj_dealloc( fill );
+        pj_gridlist_index_free( idx );
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Count the grids of each bucket, then fill them in list order.   */
+/* -------------------------------------------------------------------- */
+    for( i = 0; i < 2 * grid_count; i++ )
+    {
+        struct CTABLE *ct = grids[i % grid_count]->ct;
+        double epsilon = (fabs(ct->del.phi)+fabs(ct->del.lam))/10000.0;
+        int    col0, col1, row0, row1;
+
+        if( i == grid_count )
+        {
+            /* counting done */
+            for( b = 0; b < buckets; b++ )
+                idx->first[b+1] = idx->first[b] + fill[b];
+            idx->entries = (int *) pj_malloc( (idx->first[buckets] + 1)
+                                              * sizeof(int) );
+            if( idx->entries == NULL )
+            {
+                pj_dealloc( fill );
+                pj_gridlist_index_free( idx );
+                return NULL;
+            }
+            memset( fill, 0, buckets * sizeof(int) );
+        }
+
+        col0 = grid_index_bucket( ct->ll.lam - epsilon, idx->ll.lam,
+                                  idx->size.lam, idx->cols );
+        col1 = grid_index_bucket( ct->ll.lam + (ct->lim.lam-1) * ct->del.lam
+                                  + epsilon, idx->ll.lam,
+                                  idx->size.lam, idx->cols );
+        row0 = grid_index_bucket( ct->ll.phi - epsilon, idx->ll.phi,
+                                  idx->size.phi, idx->rows );
+        row1 = grid_index_bucket( ct->ll.phi + (ct->lim.phi-1) * ct->del.phi
+                                  + epsilon, idx->ll.phi,
+                                  idx->size.phi, idx->rows );
+
+        for( row = row0; row <= row1; row++ )
+        {
+            for( col = col0; col <= col1; col++ )
+            {
+                b = row * idx->cols + col;
+                if( i >= grid_count )
+                    idx->entries[idx->first[b] + fill[b]] = i - grid_count;
+                fill[b]++;
+            }
+        }
+    }
+    pj_dealloc( fill );
+
+/* -------------------------------------------------------------------- */
+/*      Flag the buckets lying within their first or last grid, so      */
+/*      that no check at all is needed for their points.                */
+/* -------------------------------------------------------------------- */
+    for( b = 0; b < buckets && grid_count > 0; b++ )
+    {
+        LP corner[2];
+        int k;
+
+        if( idx->first[b] == idx->first[b+1] )
+            continue;
+
+        /* a bit larger than the bucket, to allow for rounding */
+        col = b % idx->cols;
+        row = b / idx->cols;
+        corner[0].lam = idx->ll.lam + (col - 0.01) * idx->size.lam;
+        corner[0].phi = idx->ll.phi + (row - 0.01) * idx->size.phi;
+        corner[1].lam = idx->ll.lam + (col + 1.01) * idx->size.lam;
+        corner[1].phi = idx->ll.phi + (row + 1.01) * idx->size.phi;
+
+        for( k = 0; k < 2; k++ )
+        {
+            PJ_GRIDINFO *gi = idx->grids[idx->entries[k == 0
+                                                      ? idx->first[b]
+                                                      : idx->first[b+1] - 1]];
+
+            if( grid_contains( gi, corner[0], 0 )
+                && grid_contains( gi, corner[1], 0 ) )
+                idx->covers[b] |= k == 0 ? GRID_INDEX_FIRST_COVERS
+                                         : GRID_INDEX_LAST_COVERS;
+        }
+    }
+
+    return idx;
+}
+
+/************************************************************************/
+/*                        pj_gridlist_index_free()                      */
+/************************************************************************/
+
+void pj_gridlist_index_free( PJ_GRID_INDEX *idx )
+
+{
+    if( idx == NULL )
+        return;
+
+    pj_dealloc( idx->grids );
+    pj_dealloc( idx->first );
+    pj_dealloc( idx->entries );
+    pj_dealloc( idx->covers );
+    pj_dealloc( idx );
+}
+
+/************************************************************************/
+/*                          grid_index_lookup()                         */
+/*                                                                      */
+/*      Find the first (or last) grid of the index that contains the    */
+/*      point.  ll/ur are shrunk to an area giving the same answer,     */
+/*      and *cacheable is cleared if there is no such simple area.      */
+/************************************************************************/
+
+static PJ_GRIDINFO *grid_index_lookup( const PJ_GRID_INDEX *idx, LP input,
+                                       int flags, LP *ll, LP *ur,
+                                       int *cacheable )
+{
+    int col, row, b, k, last = (flags & PJ_GRID_FIND_LAST) != 0;
+
+    if( input.lam < idx->ll.lam || input.lam > idx->ur.lam
+        || input.phi < idx->ll.phi || input.phi > idx->ur.phi )
+    {
+        *cacheable = 0;
+        return NULL;
+    }
+
+    col = grid_index_bucket( input.lam, idx->ll.lam, idx->size.lam, idx->cols );
+    row = grid_index_bucket( input.phi, idx->ll.phi, idx->size.phi, idx->rows );
+    b = row * idx->cols + col;
+
+    if( idx->first[b] == idx->first[b+1]
+        || (idx->covers[b] & (last ? GRID_INDEX_LAST_COVERS
+                                   : GRID_INDEX_FIRST_COVERS)) )
+    {
+        /* a bit smaller than the bucket, to allow for rounding */
+        ll->lam = MAX( ll->lam, idx->ll.lam + (col + 0.01) * idx->size.lam );
+        ll->phi = MAX( ll->phi, idx->ll.phi + (row + 0.01) * idx->size.phi );
+        ur->lam = MIN( ur->lam, idx->ll.lam + (col + 0.99) * idx->size.lam );
+        ur->phi = MIN( ur->phi, idx->ll.phi + (row + 0.99) * idx->size.phi );
+
+        if( idx->first[b] == idx->first[b+1] )
+            return NULL;
+        return idx->grids[idx->entries[last ? idx->first[b+1] - 1
+                                            : idx->first[b]]];
+    }
+
+    *cacheable = 0;
+    if( last )
+    {
+        for( k = idx->first[b+1] - 1; k >= idx->first[b]; k-- )
+            if( grid_contains( idx->grids[idx->entries[k]], input, flags ) )
+                return idx->grids[idx->entries[k]];
+    }
+    else
+    {
+        for( k = idx->first[b]; k < idx->first[b+1]; k++ )
+            if( grid_contains( idx->grids[idx->entries[k]], input, flags ) )
+                return idx->grids[idx->entries[k]];
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                          pj_gridlist_find()                          */
+/*                                                                      */
+/*      Find the grid to use for a point: the first grid of the list    */
+/*      that contains it (or the last one, with PJ_GRID_FIND_LAST),     */
+/*      refined into the first of its children containing it, and so    */
+/*      on.  The index of the list is built in *index_p on first use.   */
+/*      It also remembers an area around the last point looked up,      */
+/*      within which the answer is known to be the same, so coherent    */
+/*      streams of points mostly skip the lookup altogether.            */
+/************************************************************************/
+
+PJ_GRIDINFO *pj_gridlist_find( PJ_GRID_INDEX **index_p,
+                               PJ_GRIDINFO **grids, int grid_count,
+                               LP input, int flags )
+
+{
+    PJ_GRID_INDEX *idx;
+    PJ_GRIDINFO *gi = NULL;
+    LP     ll, ur;
+    int    cacheable = 1, i;
+    int    is_nan;
+
+    if( *index_p == NULL )
+        *index_p = pj_gridlist_index( grids, grid_count );
+    idx = *index_p;
+
+    /* NaN coordinates fail all the bounds checks: give them the answer */
+    /* of a plain scan of the list, as they always got. */
+    /* cppcheck-suppress duplicateExpression */
+    is_nan = isnan(input.phi) || isnan(input.lam);
+    if( is_nan )
+        idx = NULL;
+
+    if( idx != NULL && idx->last_grid != NULL && idx->last_flags == flags
+        && input.lam >= idx->last_ll.lam && input.lam <= idx->last_ur.lam
+        && input.phi >= idx->last_ll.phi && input.phi <= idx->last_ur.phi )
+        return idx->last_grid;
+
+    ll.lam = ll.phi = -HUGE_VAL;
+    ur.lam = ur.phi = HUGE_VAL;
+
+    if( idx != NULL )
+        gi = grid_index_lookup( idx, input, flags, &ll, &ur, &cacheable );
+    else
+    {
+        /* no index to use, scan the list */
+        cacheable = 0;
+        for( i = 0; i < grid_count; i++ )
+        {
+            int k = (flags & PJ_GRID_FIND_LAST) ? grid_count - 1 - i : i;
+            if( grid_contains( grids[k], input, flags ) )
+            {
+                gi = grids[k];
+                break;
+            }
+        }
+    }
+
+    if( gi == NULL )
+        return NULL;
+
+    /* If we have child nodes, check to see if any of them apply. */
+    while( gi->child != NULL )
+    {
+        PJ_GRIDINFO *child;
+
+        if( gi->child_index != NULL && !is_nan )
+            child = grid_index_lookup( gi->child_index, input,
+                                       flags & ~PJ_GRID_FIND_LAST,
+                                       &ll, &ur, &cacheable );
+        else
+        {
+            cacheable = 0;
+            for( child = gi->child; child != NULL; child = child->next )
+                if( grid_contains( child, input, flags ) )
+                    break;
+        }
+
+        /* If we didn't find a child then nothing more to do */
+        if( child == NULL )
+            break;
+
+        gi = child;
+    }
+
+    if( idx != NULL )
+    {
+        idx->last_grid = cacheable ? gi : NULL;
+        idx->last_flags = flags;
+        idx->last_ll = ll;
+        idx->last_ur = ur;
+    }
+
+    return gi;
+}
@@ -85,17 +85,16 @@ static char *get_init_string (PJ_CONTEXT *ctx, const char *name) {
     Read a section of an init file. Return its contents as a plain character string.
     It is the duty of the caller to free the memory allocated for the string.
 ***************************************************************************************/
-#define MAX_LINE_LENGTH 1000
-    size_t current_buffer_size = 5 * (MAX_LINE_LENGTH + 1);
+    size_t current_buffer_size = 5 * (PJ_INIT_LINE_LENGTH + 1);
     char *fname, *section;
-    const char *key;
+    const char *key, *contents;
+    struct INIT_FILE *file;
     char *buffer = 0;
     char *line = 0;
-    PAFile fid;
-    size_t n;
+    size_t n, contents_size, offset = 0;
 
 
-    line = pj_malloc (MAX_LINE_LENGTH + 1);
+    line = pj_malloc (PJ_INIT_LINE_LENGTH + 1);
     if (0==line)
         return 0;
 
@@ -133,50 +132,29 @@ static char *get_init_string (PJ_CONTEXT *ctx, const char *name) {
             "get_init_string: searching for section [%s] in init file [%s]",
             section, fname);
 
-    fid = pj_open_lib (ctx, fname, "rt");
-    if (0==fid) {
+    /* Look the section up in the index of the init file. The reference */
+    /* to the file keeps its contents alive while we copy the section   */
+    contents = pj_find_init_section (ctx, fname, section, &contents_size, &file);
+    if (0==contents) {
         pj_dealloc (fname);
         pj_dealloc (line);
         proj_context_errno_set (ctx, PJD_ERR_NO_OPTION_IN_INIT_FILE);
         return 0;
     }
 
-    /* Search for section in init file */
-    for (;;) {
-
-        /* End of file? */
-        if (0==pj_ctx_fgets (ctx, line, MAX_LINE_LENGTH, fid)) {
-            pj_dealloc (buffer);
-            pj_dealloc (fname);
-            pj_dealloc (line);
-            pj_ctx_fclose (ctx, fid);
-            proj_context_errno_set (ctx, PJD_ERR_NO_OPTION_IN_INIT_FILE);
-            return 0;
-        }
-
-        /* At start of right section? */
-        pj_chomp (line);
-        if ('<'!=line[0])
-            continue;
-        if (strlen (line) < n + 2)
-            continue;
-        if (line[n + 1] != '>')
-            continue;
-        if (0==strncmp (line + 1, section, n))
-            break;
-    }
-
     /* We're at the first line of the right section - copy line to buffer */
+    pj_init_file_gets (line, PJ_INIT_LINE_LENGTH, contents, contents_size, &offset);
+    pj_chomp (line);
     buffer = pj_malloc (current_buffer_size);
     if (0==buffer) {
+        pj_release_init_file (file);
         pj_dealloc (fname);
         pj_dealloc (line);
-        pj_ctx_fclose (ctx, fid);
         return 0;
     }
 
     /* Skip the "<section>" indicator, and copy the rest of the line over */
-    strcpy (buffer, line + strlen (section) + 2);
+    strcpy (buffer, line + n + 2);
 
     /* Copy the remaining lines of the section to buffer */
     for (;;) {
@@ -191,7 +169,7 @@ static char *get_init_string (PJ_CONTEXT *ctx, const char *name) {
         }
 
         /* End of file? - done! */
-        if (0==pj_ctx_fgets (ctx, line, MAX_LINE_LENGTH, fid))
+        if (0==pj_init_file_gets (line, PJ_INIT_LINE_LENGTH, contents, contents_size, &offset))
             break;
 
         /* Otherwise, handle the line. It MAY be the start of the next section, */
@@ -215,7 +193,7 @@ static char *get_init_string (PJ_CONTEXT *ctx, const char *name) {
         strcpy (buffer + buffer_length + 1, line);
     }
 
-    pj_ctx_fclose (ctx, fid);
+    pj_release_init_file (file);
     pj_dealloc (fname);
     pj_dealloc (line);
     if (0==buffer)
@@ -545,14 +523,10 @@ pj_init(int argc, char **argv) {
 
 
 static PJ_CONSTRUCTOR locate_constructor (const char *name) {
-    int i;
-    const char *s;
-    const PJ_OPERATIONS *operations;
-    operations = proj_list_operations();
-    for (i = 0; (s = operations[i].id) && strcmp(name, s) ; ++i) ;
-    if (0==s)
+    const PJ_OPERATIONS *operation = pj_find_operation (name);
+    if (0==operation)
         return 0;
-    return (PJ_CONSTRUCTOR) operations[i].proj;
+    return (PJ_CONSTRUCTOR) operation->proj;
 }
 
 
@@ -621,6 +595,11 @@ pj_init_ctx_with_allow_init_epsg(projCtx ctx, int argc, char **argv, int allow_i
         curr = curr->next;
     }
 
+    /* The generic setup below looks up many parameters: do it by hashing.    */
+    /* Elements appended to the list by the expansions of +init, defaults and */
+    /* +datum get indexed on the fly.                                         */
+    pj_param_index_create (start);
+
 
     /* Only expand '+init's in non-pipeline operations. '+init's in pipelines are */
     /* expanded in the individual pipeline steps during pipeline initialization.  */
@@ -670,9 +649,11 @@ pj_init_ctx_with_allow_init_epsg(projCtx ctx, int argc, char **argv, int allow_i
 
     PIN->gridlist = NULL;
     PIN->gridlist_count = 0;
+    PIN->gridlist_index = NULL;
 
     PIN->vgridlist_geoid = NULL;
     PIN->vgridlist_geoid_count = 0;
+    PIN->vgridlist_geoid_index = NULL;
 
     /* Set datum parameters. Similarly to +init parameters we want to expand    */
     /* +datum parameters as late as possible when dealing with pipelines.       */
@@ -858,7 +839,10 @@ pj_init_ctx_with_allow_init_epsg(projCtx ctx, int argc, char **argv, int allow_i
         return pj_default_destructor (PIN, ENOMEM);
     geod_init(PIN->geod, PIN->a,  (1 - sqrt (1 - PIN->es)));
 
-    /* Projection specific initialization */
+    /* Projection specific initialization. Some of these rearrange the list */
+    /* of parameters (see set_ellipsoid() in PJ_pipeline.c), so they do     */
+    /* without its lookup table.                                            */
+    pj_param_index_free (start);
     err = proj_errno_reset (PIN);
     PIN = proj(PIN);
     if (proj_errno (PIN)) {
@@ -25,8 +25,10 @@
  * DEALINGS IN THE SOFTWARE.
  *****************************************************************************/
 
+#include <ctype.h>
 #include <string.h>
 
+#include "proj_internal.h"
 #include "projects.h"
 
 static int cache_count = 0;
@@ -34,6 +36,27 @@ static int cache_alloc = 0;
 static char **cache_key = NULL;
 static paralist **cache_paralist = NULL;
 
+/* Section of an init file, located by the "<name>" tag starting it */
+typedef struct {
+    const char *name;       /* points into the contents of the file */
+    size_t name_length;
+    size_t offset;          /* offset of the line of the tag */
+} INIT_SECTION;
+
+/* An init file, read once, with its sections in a hash table */
+typedef struct INIT_FILE {
+    char *filename;         /* full file name, as found by pj_find_file() */
+    char *contents;         /* the whole file, NUL terminated */
+    size_t size;
+    INIT_SECTION *sections; /* open addressing hash table */
+    size_t section_alloc;   /* size of the hash table, a power of two */
+    size_t section_count;
+    int ref_count;          /* one for init_files, one per user of contents */
+    struct INIT_FILE *next;
+} INIT_FILE;
+
+static INIT_FILE *init_files = NULL;
+
 /************************************************************************/
 /*                            pj_clone_paralist()                       */
 /*                                                                      */
@@ -49,6 +72,7 @@ paralist *pj_clone_paralist( const paralist *list)
       paralist *newitem = (paralist *)
 	pj_malloc(sizeof(paralist) + strlen(list->param));
 
+      newitem->index = NULL;
       newitem->used = 0;
       newitem->next = 0;
       strcpy( newitem->param, list->param );
@@ -72,6 +96,24 @@ paralist *pj_clone_paralist( const paralist *list)
 
 void pj_clear_initcache()
 {
+    if( init_files != NULL )
+    {
+        INIT_FILE *file;
+
+        /* Files still in use are freed by their last pj_release_init_file() */
+        pj_acquire_lock();
+        file = init_files;
+        init_files = NULL;
+        pj_release_lock();
+
+        while( file != NULL )
+        {
+            INIT_FILE *next = file->next;
+            pj_release_init_file( file );
+            file = next;
+        }
+    }
+
     if( cache_alloc > 0 )
     {
         int i;
@@ -182,3 +224,329 @@ void pj_insert_initcache( const char *filekey, const paralist *list )
     pj_release_lock();
 }
 
+
+/************************************************************************/
+/*                          pj_init_file_gets()                         */
+/*                                                                      */
+/*      Equivalent of pj_ctx_fgets() reading from the size bytes of     */
+/*      contents, starting at *offset, which is advanced to the start   */
+/*      of the next line. Returns NULL at the end of contents.          */
+/************************************************************************/
+
+char *pj_init_file_gets( char *line, int size, const char *contents,
+                         size_t contents_size, size_t *offset )
+{
+    size_t bytes_read, max_size, i;
+
+    if( *offset >= contents_size || size < 2 )
+        return NULL;
+
+    bytes_read = MIN( contents_size - *offset, (size_t) size - 1 );
+    memcpy( line, contents + *offset, bytes_read );
+    line[bytes_read] = '\0';
+
+    max_size = MIN( bytes_read, (size_t) size - 2 );
+    for( i = 0; i < max_size; i++ )
+    {
+        if( line[i] == '\n' )
+        {
+            line[i+1] = '\0';
+            *offset += i + 1;
+            return line;
+        }
+    }
+
+    *offset += bytes_read;
+    return line;
+}
+
+/************************************************************************/
+/*                         hash_section_name()                          */
+/*                                                                      */
+/*      FNV-1a hash of a section name.                                  */
+/************************************************************************/
+
+static size_t hash_section_name( const char *name, size_t name_length )
+{
+    unsigned long hash = 2166136261UL;
+    size_t i;
+
+    for( i = 0; i < name_length; i++ )
+    {
+        hash ^= (unsigned char) name[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return (size_t) hash;
+}
+
+/************************************************************************/
+/*                         find_init_section()                          */
+/*                                                                      */
+/*      Return the hash table slot of a section, or the empty slot      */
+/*      where it belongs.                                               */
+/************************************************************************/
+
+static INIT_SECTION *find_init_section( const INIT_FILE *file,
+                                        const char *name, size_t name_length )
+{
+    size_t mask = file->section_alloc - 1;
+    size_t i = hash_section_name( name, name_length ) & mask;
+
+    for( ;; i = (i + 1) & mask )
+    {
+        INIT_SECTION *slot = file->sections + i;
+        if( slot->name == NULL )
+            return slot;
+        if( slot->name_length == name_length
+            && memcmp( slot->name, name, name_length ) == 0 )
+            return slot;
+    }
+}
+
+/************************************************************************/
+/*                         index_init_section()                         */
+/*                                                                      */
+/*      Add a section to the hash table of file, unless a section of    */
+/*      the same name comes before it in the file.                      */
+/************************************************************************/
+
+static int index_init_section( INIT_FILE *file, const char *name,
+                               size_t name_length, size_t offset )
+{
+    INIT_SECTION *slot;
+
+    /* Keep the table at most half full */
+    if( 2 * (file->section_count + 1) > file->section_alloc )
+    {
+        INIT_SECTION *old_sections = file->sections;
+        size_t old_alloc = file->section_alloc, i;
+
+        file->section_alloc = old_alloc ? 2 * old_alloc : 256;
+        file->sections = (INIT_SECTION *)
+            pj_calloc( file->section_alloc, sizeof(INIT_SECTION) );
+        if( file->sections == NULL )
+        {
+            file->sections = old_sections;
+            file->section_alloc = old_alloc;
+            return 0;
+        }
+
+        for( i = 0; i < old_alloc; i++ )
+        {
+            if( old_sections[i].name != NULL )
+                *find_init_section( file, old_sections[i].name,
+                                    old_sections[i].name_length )
+                    = old_sections[i];
+        }
+        pj_dalloc( old_sections );
+    }
+
+    slot = find_init_section( file, name, name_length );
+    if( slot->name == NULL )
+    {
+        slot->name = name;
+        slot->name_length = name_length;
+        slot->offset = offset;
+        file->section_count++;
+    }
+    return 1;
+}
+
+/************************************************************************/
+/*                           free_init_file()                           */
+/************************************************************************/
+
+static void free_init_file( INIT_FILE *file )
+{
+    pj_dalloc( file->sections );
+    pj_dalloc( file->contents );
+    pj_dalloc( file->filename );
+    pj_dalloc( file );
+}
+
+/************************************************************************/
+/*                           read_init_file()                           */
+/*                                                                      */
+/*      Read an init file in memory, and index its sections. A section  */
+/*      starts with a line beginning with "<name>", as searched for by  */
+/*      get_init_string() in pj_init.c                                  */
+/************************************************************************/
+
+static INIT_FILE *read_init_file( projCtx ctx, const char *name,
+                                  const char *full_filename )
+{
+    INIT_FILE *file;
+    PAFile fid;
+    size_t alloc = 65536, offset, next;
+    char line[PJ_INIT_LINE_LENGTH + 1];
+
+    fid = pj_open_lib( ctx, name, "rt" );
+    if( fid == NULL )
+        return NULL;
+
+    file = (INIT_FILE *) pj_calloc( 1, sizeof(INIT_FILE) );
+    if( file == NULL )
+    {
+        pj_ctx_fclose( ctx, fid );
+        return NULL;
+    }
+
+    /* Read the whole file */
+    file->contents = (char *) pj_malloc( alloc );
+    while( file->contents != NULL )
+    {
+        size_t bytes_read = pj_ctx_fread( ctx, file->contents + file->size, 1,
+                                          alloc - 1 - file->size, fid );
+        file->size += bytes_read;
+        if( file->size < alloc - 1 )
+            break;
+
+        {
+            char *contents = (char *) pj_malloc( 2 * alloc );
+            if( contents != NULL )
+                memcpy( contents, file->contents, file->size );
+            pj_dalloc( file->contents );
+            file->contents = contents;
+            alloc *= 2;
+        }
+    }
+    pj_ctx_fclose( ctx, fid );
+
+    file->filename = (char *) pj_malloc( strlen(full_filename) + 1 );
+    if( file->contents == NULL || file->filename == NULL )
+    {
+        pj_dalloc( file->contents );
+        pj_dalloc( file->filename );
+        pj_dalloc( file );
+        return NULL;
+    }
+    file->contents[file->size] = '\0';
+    strcpy( file->filename, full_filename );
+
+    /* Index the sections, line by line */
+    for( offset = 0, next = 0;
+         pj_init_file_gets( line, PJ_INIT_LINE_LENGTH, file->contents,
+                            file->size, &next ) != NULL;
+         offset = next )
+    {
+        const char *tag, *end;
+
+        pj_chomp( line );
+        if( line[0] != '<' || (end = strchr( line, '>' )) == NULL )
+            continue;
+
+        /* pj_chomp() only stripped leading ';' and white space */
+        for( tag = file->contents + offset;
+             *tag == ';' || isspace( (unsigned char) *tag ); tag++ ) {}
+
+        if( !index_init_section( file, tag + 1, (size_t) (end - line - 1),
+                                 offset ) )
+        {
+            free_init_file( file );
+            return NULL;
+        }
+    }
+
+    pj_log( ctx, PJ_LOG_DEBUG_MAJOR, "read_init_file(%s): %d sections",
+            full_filename, (int) file->section_count );
+    return file;
+}
+
+/************************************************************************/
+/*                        pj_find_init_section()                        */
+/*                                                                      */
+/*      Locate a section of an init file, reading and indexing the      */
+/*      file on first access. Returns the start of the line of the      */
+/*      "<section>" tag, with *size set to the count of bytes from      */
+/*      there to the end of the file, or NULL if not found.             */
+/*                                                                      */
+/*      On success, *file holds a reference to the file, which keeps    */
+/*      the result valid, even through pj_clear_initcache(), until it   */
+/*      is given back with pj_release_init_file().                      */
+/************************************************************************/
+
+const char *pj_find_init_section( projCtx ctx, const char *name,
+                                  const char *section, size_t *size,
+                                  struct INIT_FILE **file )
+{
+    char full_filename[MAX_PATH_FILENAME + 1];
+    INIT_FILE *f, *read_file = NULL;
+    const INIT_SECTION *slot;
+
+    *file = NULL;
+
+    /* Resolve the file name, so as to honour the search paths of ctx */
+    if( !pj_find_file( ctx, name, full_filename, sizeof(full_filename) ) )
+        return NULL;
+
+    for( ;; )
+    {
+        pj_acquire_lock();
+
+        for( f = init_files; f != NULL; f = f->next )
+        {
+            if( strcmp( f->filename, full_filename ) == 0 )
+                break;
+        }
+
+        /* Publish the file we have read, unless another thread beat us */
+        if( f == NULL && read_file != NULL )
+        {
+            f = read_file;
+            f->next = init_files;
+            init_files = f;
+            read_file = NULL;
+        }
+
+        if( f != NULL )
+        {
+            f->ref_count++;
+            pj_release_lock();
+            break;
+        }
+
+        pj_release_lock();
+
+        /* Read and index the file without holding the lock */
+        read_file = read_init_file( ctx, name, full_filename );
+        if( read_file == NULL )
+            return NULL;
+        read_file->ref_count = 1;
+    }
+
+    if( read_file != NULL )
+        free_init_file( read_file );
+
+    slot = f->section_count == 0 ? NULL
+        : find_init_section( f, section, strlen(section) );
+    if( slot == NULL || slot->name == NULL )
+    {
+        pj_release_init_file( f );
+        return NULL;
+    }
+
+    *file = f;
+    *size = f->size - slot->offset;
+    return f->contents + slot->offset;
+}
+
+/************************************************************************/
+/*                        pj_release_init_file()                        */
+/*                                                                      */
+/*      Give back a reference obtained from pj_find_init_section().     */
+/************************************************************************/
+
+void pj_release_init_file( struct INIT_FILE *file )
+{
+    int ref_count;
+
+    if( file == NULL )
+        return;
+
+    pj_acquire_lock();
+    ref_count = --file->ref_count;
+    pj_release_lock();
+
+    if( ref_count == 0 )
+        free_init_file( file );
+}
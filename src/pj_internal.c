@@ -77,6 +77,10 @@ chained calls starting out with a call to its 2D interface.
         return coo;
     if (P->inverted)
         direction = -direction;
+    if (P->candidate_count > 0 && (PJ_FWD==direction || PJ_INV==direction)) {
+        pj_trans_candidates (P, direction, 2, 1, &coo);
+        return coo;
+    }
     switch (direction) {
         case PJ_FWD:
             coo.xy = pj_fwd (coo.lp, P);
@@ -107,6 +111,10 @@ chained calls starting out with a call to its 3D interface.
         return coo;
     if (P->inverted)
         direction = -direction;
+    if (P->candidate_count > 0 && (PJ_FWD==direction || PJ_INV==direction)) {
+        pj_trans_candidates (P, direction, 3, 1, &coo);
+        return coo;
+    }
     switch (direction) {
         case PJ_FWD:
             coo.xyz = pj_fwd3d (coo.lpz, P);
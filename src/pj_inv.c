@@ -29,6 +29,7 @@
  *****************************************************************************/
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 
 #include "proj_internal.h"
 #include "proj_math.h"
@@ -236,3 +237,57 @@ PJ_COORD pj_inv4d (PJ_COORD coo, PJ *P) {
 
     return error_or_coord(P, coo, last_errno);
 }
+
+
+
+void pj_inv4d_array (PJ_COORD *coo, size_t n, PJ *P) {
+/******************************************************************************
+    Batch version of pj_inv4d. See pj_fwd4d_array for the details.
+******************************************************************************/
+    PJ_COORD in[PJ_TRANS_BLOCK_SIZE];
+    size_t i, b, m;
+    int err = 0;
+    int last_errno = proj_errno_reset (P);
+
+    for (b = 0;  b < n;  b += m) {
+        PJ_COORD *c = coo + b;
+        m = n - b < PJ_TRANS_BLOCK_SIZE ? n - b : PJ_TRANS_BLOCK_SIZE;
+
+        if (P->inv4d_array) {
+            memcpy (in, c, m * sizeof (PJ_COORD));
+
+            if (!P->skip_inv_prepare)
+                for (i = 0;  i < m;  i++)
+                    c[i] = inv_prepare (P, c[i]);
+
+            P->inv4d_array (c, m, P);
+
+            for (i = 0;  i < m;  i++) {
+                if (HUGE_VAL==c[i].v[0] || HUGE_VAL==c[i].v[1] ||
+                    HUGE_VAL==c[i].v[2] || HUGE_VAL==c[i].v[3]) {
+                    c[i] = proj_coord_error ();
+                    continue;
+                }
+                if (!P->skip_inv_finalize)
+                    c[i] = inv_finalize (P, c[i]);
+            }
+            if (0==proj_errno (P))
+                continue;
+
+            /* Something failed in the block: start it over, point by point */
+            proj_errno_reset (P);
+            memcpy (c, in, m * sizeof (PJ_COORD));
+        }
+
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_inv4d (c[i], P);
+            if (proj_errno (P))
+                err = proj_errno (P);
+        }
+    }
+
+    if (err)
+        proj_errno_set (P, err);
+    else
+        proj_errno_restore (P, last_errno);
+}
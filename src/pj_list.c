@@ -2,6 +2,8 @@
 ** Use local definition of PJ_LIST_H for subset.
 */
 
+#include <string.h>
+
 #include "proj.h"
 
 #define USE_PJ_LIST_H 1
@@ -30,3 +32,66 @@ const struct PJ_LIST pj_list[] = {
 const PJ_OPERATIONS *proj_list_operations(void) {
     return pj_list;
 }
+
+
+/* Count the operations, to size the hash table of their names */
+#define PROJ_HEAD(id, name) + 1
+enum { pj_list_count = 0
+#include "pj_list.h"
+};
+#undef PROJ_HEAD
+
+/* Open addressing hash table of the operation names, holding index + 1 */
+/* into pj_list, or 0 for an empty slot. Filled once, on first use.     */
+#define PJ_LIST_HASH_SIZE (2 * pj_list_count + 1)
+static int pj_list_hash[PJ_LIST_HASH_SIZE];
+static int pj_list_hash_initialized = 0;
+
+static size_t hash_operation_id(const char *id) {
+    /* FNV-1a */
+    unsigned long hash = 2166136261UL;
+    for (; *id; id++) {
+        hash ^= (unsigned char) *id;
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return (size_t) (hash % PJ_LIST_HASH_SIZE);
+}
+
+/*****************************************************************************/
+const PJ_OPERATIONS *pj_find_operation(const char *id) {
+/******************************************************************************
+    Return the entry of pj_list for the operation named id, or 0 if there is
+    none. Equivalent to a linear search of proj_list_operations(), but looks
+    the name up in a hash table.
+******************************************************************************/
+    size_t i;
+
+    if (0==id)
+        return 0;
+
+    /* If already initialized, don't bother locking */
+    if (!pj_list_hash_initialized) {
+        pj_acquire_lock();
+
+        /* Ask again, since it may have been initialized in another thread */
+        if (!pj_list_hash_initialized) {
+            int k;
+            for (k = 0;  pj_list[k].id;  k++) {
+                /* Keep the first of duplicate names, as a linear search would */
+                for (i = hash_operation_id(pj_list[k].id);  pj_list_hash[i];  i = (i + 1) % PJ_LIST_HASH_SIZE)
+                    if (0==strcmp(pj_list[pj_list_hash[i] - 1].id, pj_list[k].id))
+                        break;
+                if (0==pj_list_hash[i])
+                    pj_list_hash[i] = k + 1;
+            }
+            pj_list_hash_initialized = 1;
+        }
+
+        pj_release_lock();
+    }
+
+    for (i = hash_operation_id(id);  pj_list_hash[i];  i = (i + 1) % PJ_LIST_HASH_SIZE)
+        if (0==strcmp(pj_list[pj_list_hash[i] - 1].id, id))
+            return pj_list + pj_list_hash[i] - 1;
+    return 0;
+}
@@ -45,6 +45,7 @@
 #include <string.h>
 
 #include "proj.h"
+#include "proj_internal.h"
 #include "projects.h"
 
 /**********************************************************************/
@@ -156,6 +157,7 @@ void *pj_dealloc_params (PJ_CONTEXT *ctx, paralist *start, int errlev) {
     proper is allocated.
 ******************************************************************************/
     paralist *t, *n;
+    pj_param_index_free (start);
     for (t = start; t; t = n) {
         n = t->next;
         pj_dealloc(t);
@@ -209,8 +211,10 @@ void *pj_default_destructor (PJ *P, int errlev) {   /* Destructor */
         return 0;
 
     /* free grid lists */
-    pj_dealloc( P->gridlist );
-    pj_dealloc( P->vgridlist_geoid );
+    pj_gridlist_free( P->gridlist, P->gridlist_count );
+    pj_gridlist_free( P->vgridlist_geoid, P->vgridlist_geoid_count );
+    pj_gridlist_index_free( P->gridlist_index );
+    pj_gridlist_index_free( P->vgridlist_geoid_index );
     pj_dealloc( P->catalog_name );
 
     /* We used to call pj_dalloc( P->catalog ), but this will leak */
@@ -234,6 +238,44 @@ void *pj_default_destructor (PJ *P, int errlev) {   /* Destructor */
     pj_free (P->hgridshift);
     pj_free (P->vgridshift);
 
+    /* free the private copies used by the multi-threaded batch APIs */
+    pj_free_workers (P);
+
+    /* free the alternative operations set up by proj_create_crs_to_crs */
+    pj_free_candidates (P);
+
     pj_dealloc (P->opaque);
     return pj_dealloc(P);
 }
+
+
+
+
+/*****************************************************************************/
+PJ *pj_default_copier (PJ *Q, const PJ *P) {   /* Copy hook */
+/*****************************************************************************
+    Copy hook of the PJ objects that have no opaque object at all: Q, as
+    made by pj_copy(), is already a complete copy of P.
+******************************************************************************/
+    (void) P;
+    return Q;
+}
+
+
+
+
+/*****************************************************************************/
+PJ *pj_copy_opaque (PJ *Q, const PJ *P, size_t size) {
+/*****************************************************************************
+    Companion to pj_default_copier, for "plain" PJ objects whose opaque
+    object, of the given size, holds no pointers. Copy hooks of such
+    objects just call it with the size of their opaque object.
+******************************************************************************/
+    if (0==P->opaque)
+        return Q;
+    Q->opaque = pj_malloc (size);
+    if (0==Q->opaque)
+        return pj_default_destructor (Q, ENOMEM);
+    memcpy (Q->opaque, P->opaque, size);
+    return Q;
+}
@@ -38,6 +38,7 @@
 
 #ifndef _WIN32
 #include "proj_config.h"
+#include "proj_internal.h"
 #include "projects.h"
 #else
 #ifndef ACCEPT_USE_OF_DEPRECATED_PROJ_API_H
@@ -46,6 +47,8 @@
 #include "proj_api.h"
 #endif
 
+#include <stdlib.h>
+
 /* on win32 we always use win32 mutexes, even if pthreads are available */
 #if defined(_WIN32) && !defined(MUTEX_stub)
 #ifndef MUTEX_win32
@@ -93,6 +96,22 @@ void pj_cleanup_lock()
 {
 }
 
+/************************************************************************/
+/*                          pj_run_in_threads()                         */
+/*                                                                      */
+/*      Without thread support, the work items are simply run one       */
+/*      after the other in the calling thread.                          */
+/************************************************************************/
+
+int pj_run_in_threads( int n, void (*func)(void *), void *args,
+                       size_t arg_size )
+{
+    int i;
+    for( i = 0; i < n; i++ )
+        func( (char *) args + i * arg_size );
+    return n;
+}
+
 #endif /* def MUTEX_stub */
 
 /************************************************************************/
@@ -170,6 +189,80 @@ void pj_cleanup_lock()
 {
 }
 
+/************************************************************************/
+/*                          pj_run_in_threads()                         */
+/*                                                                      */
+/*      Run func() on each of the n work items in args, each item       */
+/*      being arg_size bytes long. Item 0 is run in the calling         */
+/*      thread, the others in threads of their own. Items for which     */
+/*      no thread could be created are run in the calling thread, so    */
+/*      all items are always processed. Returns the number of threads   */
+/*      used (including the calling thread).                            */
+/************************************************************************/
+
+struct pj_thread_item {
+    void (*func)(void *);
+    void *arg;
+};
+
+static void *pj_thread_trampoline( void *arg )
+{
+    struct pj_thread_item *item = (struct pj_thread_item *) arg;
+    item->func( item->arg );
+    return NULL;
+}
+
+int pj_run_in_threads( int n, void (*func)(void *), void *args,
+                       size_t arg_size )
+{
+    pthread_t *threads;
+    struct pj_thread_item *items;
+    char *started;
+    int i, used = 1;
+
+    if( n <= 0 )
+        return 0;
+
+    threads = (pthread_t *) calloc( n, sizeof(pthread_t) );
+    items = (struct pj_thread_item *) calloc( n, sizeof(struct pj_thread_item) );
+    started = (char *) calloc( n, 1 );
+    if( threads == NULL || items == NULL || started == NULL )
+    {
+        free( threads );
+        free( items );
+        free( started );
+        for( i = 0; i < n; i++ )
+            func( (char *) args + i * arg_size );
+        return 1;
+    }
+
+    for( i = 1; i < n; i++ )
+    {
+        items[i].func = func;
+        items[i].arg = (char *) args + i * arg_size;
+        if( pthread_create( &threads[i], NULL, pj_thread_trampoline,
+                            &items[i] ) == 0 )
+        {
+            started[i] = 1;
+            used++;
+        }
+    }
+
+    func( args );
+    for( i = 1; i < n; i++ )
+    {
+        if( started[i] )
+            pthread_join( threads[i], NULL );
+        else
+            func( (char *) args + i * arg_size );
+    }
+
+    free( threads );
+    free( items );
+    free( started );
+    return used;
+}
+
 #endif /* def MUTEX_pthread */
 
 /************************************************************************/
@@ -258,4 +351,193 @@ void pj_cleanup_lock()
     }
 }
 
+/************************************************************************/
+/*                          pj_run_in_threads()                         */
+/*                                                                      */
+/*      Win32 version of the pthread implementation above.              */
+/************************************************************************/
+
+struct pj_thread_item {
+    void (*func)(void *);
+    void *arg;
+};
+
+static DWORD WINAPI pj_thread_trampoline( LPVOID arg )
+{
+    struct pj_thread_item *item = (struct pj_thread_item *) arg;
+    item->func( item->arg );
+    return 0;
+}
+
+int pj_run_in_threads( int n, void (*func)(void *), void *args,
+                       size_t arg_size )
+{
+    HANDLE *threads;
+    struct pj_thread_item *items;
+    int i, used = 1;
+
+    if( n <= 0 )
+        return 0;
+
+    threads = (HANDLE *) calloc( n, sizeof(HANDLE) );
+    items = (struct pj_thread_item *) calloc( n, sizeof(struct pj_thread_item) );
+    if( threads == NULL || items == NULL )
+    {
+        free( threads );
+        free( items );
+        for( i = 0; i < n; i++ )
+            func( (char *) args + i * arg_size );
+        return 1;
+    }
+
+    for( i = 1; i < n; i++ )
+    {
+        items[i].func = func;
+        items[i].arg = (char *) args + i * arg_size;
+        threads[i] = CreateThread( NULL, 0, pj_thread_trampoline,
+                                   &items[i], 0, NULL );
+        if( threads[i] != NULL )
+            used++;
+    }
+
+    func( args );
+    for( i = 1; i < n; i++ )
+    {
+        if( threads[i] != NULL )
+        {
+            WaitForSingleObject( threads[i], INFINITE );
+            CloseHandle( threads[i] );
+        }
+        else
+            func( (char *) args + i * arg_size );
+    }
+
+    free( threads );
+    free( items );
+    return used;
+}
+
 #endif /* def MUTEX_win32 */
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          atomic operations                           */
+/*                                                                      */
+/*      Used for the data shared between threads without taking the     */
+/*      lock, such as the grid registry.  Pointers set with             */
+/*      pj_atomic_set_ptr() are published with everything written       */
+/*      before, and pj_atomic_get_ptr() sees all of it.                 */
+/* ==================================================================== */
+/************************************************************************/
+
+#if defined(MUTEX_win32)
+
+int pj_atomic_add( volatile int *value, int delta )
+{
+    return (int) InterlockedExchangeAdd( (LONG volatile *) value, delta )
+        + delta;
+}
+
+int pj_atomic_get( volatile int *value )
+{
+    return (int) InterlockedCompareExchange( (LONG volatile *) value, 0, 0 );
+}
+
+int pj_atomic_cas( volatile int *value, int expected, int desired )
+{
+    return InterlockedCompareExchange( (LONG volatile *) value,
+                                       desired, expected ) == expected;
+}
+
+void *pj_atomic_get_ptr( void * volatile *ptr )
+{
+    return InterlockedCompareExchangePointer( ptr, NULL, NULL );
+}
+
+void pj_atomic_set_ptr( void * volatile *ptr, void *value )
+{
+    InterlockedExchangePointer( ptr, value );
+}
+
+#elif defined(__GNUC__)
+
+int pj_atomic_add( volatile int *value, int delta )
+{
+    return __atomic_add_fetch( value, delta, __ATOMIC_ACQ_REL );
+}
+
+int pj_atomic_get( volatile int *value )
+{
+    return __atomic_load_n( value, __ATOMIC_ACQUIRE );
+}
+
+int pj_atomic_cas( volatile int *value, int expected, int desired )
+{
+    return __atomic_compare_exchange_n( value, &expected, desired, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+}
+
+void *pj_atomic_get_ptr( void * volatile *ptr )
+{
+    return __atomic_load_n( ptr, __ATOMIC_ACQUIRE );
+}
+
+void pj_atomic_set_ptr( void * volatile *ptr, void *value )
+{
+    __atomic_store_n( ptr, value, __ATOMIC_RELEASE );
+}
+
+#else
+
+/* No atomic operations known for this compiler: fall back to the lock */
+
+int pj_atomic_add( volatile int *value, int delta )
+{
+    int result;
+
+    pj_acquire_lock();
+    result = (*value += delta);
+    pj_release_lock();
+    return result;
+}
+
+int pj_atomic_get( volatile int *value )
+{
+    int result;
+
+    pj_acquire_lock();
+    result = *value;
+    pj_release_lock();
+    return result;
+}
+
+int pj_atomic_cas( volatile int *value, int expected, int desired )
+{
+    int result;
+
+    pj_acquire_lock();
+    result = *value == expected;
+    if( result )
+        *value = desired;
+    pj_release_lock();
+    return result;
+}
+
+void *pj_atomic_get_ptr( void * volatile *ptr )
+{
+    void *result;
+
+    pj_acquire_lock();
+    result = *ptr;
+    pj_release_lock();
+    return result;
+}
+
+void pj_atomic_set_ptr( void * volatile *ptr, void *value )
+{
+    pj_acquire_lock();
+    *ptr = value;
+    pj_release_lock();
+}
+
+#endif
@@ -42,6 +42,8 @@
 static const char *(*pj_finder)(const char *) = NULL;
 static int path_count = 0;
 static char **search_path = NULL;
+/* bumped whenever the finder or the search path change */
+static int search_generation = 0;
 static const char * proj_lib_name =
 #ifdef PROJ_LIB
 PROJ_LIB;
@@ -57,6 +59,7 @@ void pj_set_finder( const char *(*new_finder)(const char *) )
 
 {
     pj_finder = new_finder;
+    search_generation++;
 }
 
 /************************************************************************/
@@ -93,6 +96,7 @@ void pj_set_searchpath ( int count, const char **path )
     }
 
     path_count = count;
+    search_generation++;
 }
 
 /* just a couple of helper functions that lets other functions
@@ -104,11 +108,19 @@ const char * const *proj_get_searchpath(void) {
 int proj_get_path_count(void) {
     return path_count;
 }
+
+/* changes whenever files may be found elsewhere than before */
+int proj_get_search_generation(void) {
+    return search_generation;
+}
 /************************************************************************/
 /*                          pj_open_lib_ex()                            */
+/*                                                                      */
+/*      Like pj_open_lib(), also returning the name of the file         */
+/*      actually opened in out_full_filename, if not NULL.              */
 /************************************************************************/
 
-static PAFile
+PAFile
 pj_open_lib_ex(projCtx ctx, const char *name, const char *mode,
                char* out_full_filename, size_t out_full_filename_size) {
     char fname[MAX_PATH_FILENAME+1];
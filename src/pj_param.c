@@ -13,6 +13,7 @@ paralist *pj_mkparam(const char *str) {
     paralist *newitem;
 
     if((newitem = (paralist *)pj_malloc(sizeof(paralist) + strlen(str))) != NULL) {
+        newitem->index = 0;
         newitem->used = 0;
         newitem->next = 0;
         if (*str == '+')
@@ -53,6 +54,158 @@ paralist *pj_mkparam_ws (const char *str) {
     return newitem;
 }
 
+/* Lookup table of the elements of a paralist, by parameter name */
+struct PJ_PARAM_INDEX {
+    paralist *last;     /* last element of the list indexed so far */
+    paralist **slots;   /* open addressing hash table */
+    size_t alloc;       /* size of slots, a power of two */
+    size_t count;
+};
+
+static size_t hash_param_name (const char *name, size_t length) {
+    /* FNV-1a */
+    unsigned long hash = 2166136261UL;
+    size_t i;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char) name[i];
+        hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return (size_t) hash;
+}
+
+static int param_has_name (const paralist *item, const char *name, size_t length) {
+    return 0==strncmp (name, item->param, length) && (item->param[length]=='=' || item->param[length]==0);
+}
+
+/* Return the slot of the element named name, or the empty slot where it belongs */
+static paralist **param_index_slot (const struct PJ_PARAM_INDEX *index, const char *name, size_t length) {
+    size_t mask = index->alloc - 1;
+    size_t i = hash_param_name (name, length) & mask;
+    for (;;  i = (i + 1) & mask) {
+        if (0==index->slots[i] || param_has_name (index->slots[i], name, length))
+            return index->slots + i;
+    }
+}
+
+/* Index an element, unless an element of the same name precedes it in the list */
+static int param_index_add (struct PJ_PARAM_INDEX *index, paralist *item) {
+    size_t length = strcspn (item->param, "=");
+    paralist **slot;
+
+    /* Keep the table at most half full */
+    if (2 * (index->count + 1) > index->alloc) {
+        paralist **old_slots = index->slots;
+        size_t old_alloc = index->alloc, i;
+
+        index->slots = pj_calloc (2 * old_alloc, sizeof (paralist *));
+        if (0==index->slots) {
+            index->slots = old_slots;
+            return 0;
+        }
+        index->alloc = 2 * old_alloc;
+        for (i = 0;  i < old_alloc;  i++) {
+            if (old_slots[i])
+                *param_index_slot (index, old_slots[i]->param, strcspn (old_slots[i]->param, "=")) = old_slots[i];
+        }
+        pj_dealloc (old_slots);
+    }
+
+    slot = param_index_slot (index, item->param, length);
+    if (0==*slot) {
+        *slot = item;
+        index->count++;
+    }
+    return 1;
+}
+
+
+/**************************************************************************************/
+int pj_param_index_create (paralist *list) {
+/***************************************************************************************
+    Attach a lookup table to a paralist, so that pj_param_lookup(), and hence
+    pj_param() and pj_param_exists(), find its elements by hashing rather than
+    by walking the list. Returns 0 if out of memory, in which case lookups
+    keep on walking the list.
+
+    The table follows elements appended to the end of the list, but any other
+    change to the list (removing elements, or cutting it short) must only be
+    done after a call to pj_param_index_free().
+***************************************************************************************/
+    struct PJ_PARAM_INDEX *index;
+
+    if (0==list)
+        return 0;
+    if (list->index)
+        return 1;
+
+    index = pj_calloc (1, sizeof (struct PJ_PARAM_INDEX));
+    if (0==index)
+        return 0;
+    index->alloc = 32;
+    index->slots = pj_calloc (index->alloc, sizeof (paralist *));
+    if (0==index->slots) {
+        pj_dealloc (index);
+        return 0;
+    }
+
+    index->last = list;
+    if (!param_index_add (index, list)) {
+        pj_dealloc (index->slots);
+        pj_dealloc (index);
+        return 0;
+    }
+    list->index = index;
+    return 1;
+}
+
+
+/**************************************************************************************/
+void pj_param_index_free (paralist *list) {
+/***************************************************************************************
+    Detach the lookup table of a paralist, if any.
+***************************************************************************************/
+    if (0==list || 0==list->index)
+        return;
+    pj_dealloc (list->index->slots);
+    pj_dealloc (list->index);
+    list->index = 0;
+}
+
+
+/**************************************************************************************/
+paralist *pj_param_lookup (paralist *list, const char *name, size_t length) {
+/***************************************************************************************
+    Return the first element of a paralist with the given name, i.e. whose
+    first length characters match name, followed by either '=' or the end of
+    the string. Returns 0 if there is none. Unlike pj_param_exists(), the
+    element is not marked as used.
+***************************************************************************************/
+    struct PJ_PARAM_INDEX *index;
+
+    if (0==list)
+        return 0;
+
+    index = list->index;
+    if (0==index) {
+        for (;  list;  list = list->next)
+            if (param_has_name (list, name, length))
+                return list;
+        return 0;
+    }
+
+    /* Index the elements appended since last time */
+    while (index->last->next) {
+        if (!param_index_add (index, index->last->next)) {
+            pj_param_index_free (list);
+            return pj_param_lookup (list, name, length);
+        }
+        index->last = index->last->next;
+    }
+
+    return *param_index_slot (index, name, length);
+}
+
+
 /**************************************************************************************/
 paralist *pj_param_exists (paralist *list, const char *parameter) {
 /***************************************************************************************
@@ -69,7 +222,7 @@ paralist *pj_param_exists (paralist *list, const char *parameter) {
     writing the code allocating memory for a new copy of parameter name, and prepending
     the t (for compile time known names, this is obviously not an issue).
 ***************************************************************************************/
-    paralist *next = list;
+    paralist *next;
     char *c = strchr (parameter, '=');
     size_t len = strlen (parameter);
     if (c)
@@ -77,16 +230,15 @@ paralist *pj_param_exists (paralist *list, const char *parameter) {
     if (list==0)
         return 0;
 
-    for (next = list; next; next = next->next) {
-        if (0==strncmp (parameter, next->param, len) && (next->param[len]=='=' || next->param[len]==0)) {
-            next->used = 1;
-            return next;
-        }
-        if (0==strcmp (parameter, "step"))
-            return 0;
-    }
+    /* A "step" is only looked for at the head of the list */
+    if (0==strcmp (parameter, "step"))
+        next = param_has_name (list, parameter, len)? list: 0;
+    else
+        next = pj_param_lookup (list, parameter, len);
 
-    return 0;
+    if (next)
+        next->used = 1;
+    return next;
 }
 
 
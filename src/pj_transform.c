@@ -456,6 +456,7 @@ static int geometric_to_orthometric (PJ *P, PJ_DIRECTION dir, long n, int dist,
     err = pj_apply_vgridshift (P, "sgeoidgrids",
               &(P->vgridlist_geoid),
               &(P->vgridlist_geoid_count),
+              &(P->vgridlist_geoid_index),
               dir==PJ_FWD ? 1 : 0, n, dist, x, y, z );
     if (err)
         return pj_ctx_get_errno(P->ctx);
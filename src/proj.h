@@ -203,6 +203,9 @@ typedef struct PJ_GRID_INFO PJ_GRID_INFO;
 struct PJ_INIT_INFO;
 typedef struct PJ_INIT_INFO PJ_INIT_INFO;
 
+struct PJ_GRID_CACHE_INFO;
+typedef struct PJ_GRID_CACHE_INFO PJ_GRID_CACHE_INFO;
+
 /* Data types for list of operations, ellipsoids, datums and units used in PROJ.4 */
 struct PJ_LIST {
     const char  *id;                /* projection keyword */
@@ -302,6 +305,14 @@ struct PJ_GRID_INFO {
     double      cs_lon, cs_lat;     /* Cell size of grid                    */
 };
 
+struct PJ_GRID_CACHE_INFO {
+    size_t        size;             /* Bytes of grid data loaded, all contexts */
+    size_t        max_size;         /* Limit on size, 0 if none                */
+    unsigned long hits;             /* Grid rows found in memory               */
+    unsigned long misses;           /* Grid data read from file                */
+    unsigned long evictions;        /* Grid data dropped to make room          */
+};
+
 struct PJ_INIT_INFO {
     char        name[32];           /* name of init file                        */
     char        filename[260];      /* full path to the init file.              */
@@ -337,11 +348,20 @@ PJ_CONTEXT PROJ_DLL *proj_context_destroy (PJ_CONTEXT *ctx);
 
 void PROJ_DLL proj_context_use_proj4_init_rules(PJ_CONTEXT *ctx, int enable);
 int PROJ_DLL proj_context_get_use_proj4_init_rules(PJ_CONTEXT *ctx, int from_legacy_code_path);
+void PROJ_DLL proj_context_set_thread_count(PJ_CONTEXT *ctx, int count);
+int PROJ_DLL proj_context_get_thread_count(PJ_CONTEXT *ctx);
+void PROJ_DLL proj_context_set_grid_tiling(PJ_CONTEXT *ctx, int tiling);
+void PROJ_DLL proj_context_set_grid_cache_size(PJ_CONTEXT *ctx, size_t max_size);
+PJ_GRID_CACHE_INFO PROJ_DLL proj_context_get_grid_cache_info(PJ_CONTEXT *ctx);
+void PROJ_DLL proj_context_use_inverse_grids(PJ_CONTEXT *ctx, int enable);
+void PROJ_DLL proj_context_set_crs_to_crs_cache_size(PJ_CONTEXT *ctx, int size);
+void PROJ_DLL proj_context_use_per_point_operations(PJ_CONTEXT *ctx, int enable);
 
 /* Manage the transformation definition object PJ */
 PJ PROJ_DLL *proj_create (PJ_CONTEXT *ctx, const char *definition);
 PJ PROJ_DLL *proj_create_argv (PJ_CONTEXT *ctx, int argc, char **argv);
 PJ PROJ_DLL *proj_create_crs_to_crs(PJ_CONTEXT *ctx, const char *source_crs, const char *target_crs, PJ_AREA *area);
+PJ PROJ_DLL *proj_clone (PJ_CONTEXT *ctx, const PJ *P);
 PJ PROJ_DLL *proj_destroy (PJ *P);
 
 
@@ -466,6 +486,62 @@ const char PROJ_DLL *proj_context_get_database_path(PJ_CONTEXT *ctx);
 const char PROJ_DLL *proj_context_get_database_metadata(PJ_CONTEXT* ctx,
                                                         const char* key);
 
+/** \brief Cache of objects built from the database. */
+typedef enum
+{
+    /** Units of measure */
+    PJ_DATABASE_CACHE_UNIT_OF_MEASURE,
+
+    /** CRS */
+    PJ_DATABASE_CACHE_CRS,
+
+    /** Geodetic datums */
+    PJ_DATABASE_CACHE_GEODETIC_DATUM,
+
+    /** Prime meridians */
+    PJ_DATABASE_CACHE_PRIME_MERIDIAN,
+
+    /** Coordinate systems */
+    PJ_DATABASE_CACHE_COORDINATE_SYSTEM,
+
+    /** Areas of use */
+    PJ_DATABASE_CACHE_EXTENT,
+
+    /** Information on grids */
+    PJ_DATABASE_CACHE_GRID_INFO,
+
+    /** Operations between two CRS codes */
+    PJ_DATABASE_CACHE_CRS_TO_CRS_OPERATIONS
+} PJ_DATABASE_CACHE;
+
+/** \brief Size and counters of a cache of objects built from the database. */
+typedef struct
+{
+    /** Maximum number of entries, 0 if none */
+    size_t        max_size;
+
+    /** Number of entries */
+    size_t        size;
+
+    /** Number of lookups that found their entry */
+    unsigned long hits;
+
+    /** Number of lookups that did not find their entry */
+    unsigned long misses;
+
+    /** Number of entries dropped to make room */
+    unsigned long evictions;
+} PJ_DATABASE_CACHE_INFO;
+
+int PROJ_DLL proj_context_set_database_cache_size(PJ_CONTEXT *ctx,
+                                                  PJ_DATABASE_CACHE cache,
+                                                  size_t max_size);
+
+PJ_DATABASE_CACHE_INFO PROJ_DLL proj_context_get_database_cache_info(
+                                                    PJ_CONTEXT *ctx,
+                                                    PJ_DATABASE_CACHE cache);
+
+
 
 /** \brief Guessed WKT "dialect". */
 typedef enum
@@ -516,6 +592,18 @@ PJ_OBJ PROJ_DLL *proj_obj_create_from_database(PJ_CONTEXT *ctx,
                                                int usePROJAlternativeGridNames,
                                                const char* const *options);
 
+PJ_OBJ_LIST PROJ_DLL *proj_obj_create_crs_list_from_database(
+                                               PJ_CONTEXT *ctx,
+                                               const char *auth_name,
+                                               const char* const *codes,
+                                               const char* const *options);
+
+int PROJ_DLL proj_context_warm_database_cache(PJ_CONTEXT *ctx,
+                                              const char *auth_name,
+                                              const char* const *codes,
+                                              PJ_OBJ_CATEGORY category,
+                                              const char* const *options);
+
 void PROJ_DLL proj_obj_unref(PJ_OBJ *obj);
 
 PJ_OBJ PROJ_DLL *proj_obj_clone(PJ_CONTEXT *ctx, const PJ_OBJ *obj);
@@ -156,6 +156,120 @@ double proj_roundtrip (PJ *P, PJ_DIRECTION direction, int n, PJ_COORD *coord) {
 
 
 
+/*****************************************************************************/
+static int candidate_contains (const PJ_CANDIDATE *c, PJ_DIRECTION direction, PJ_COORD coo) {
+/******************************************************************************
+    Does the area of use of the candidate operation c contain coo?
+******************************************************************************/
+    const double *bbox = PJ_FWD==direction? c->src_bbox: c->dst_bbox;
+    return coo.v[0] >= bbox[0] && coo.v[0] <= bbox[2] &&
+           coo.v[1] >= bbox[1] && coo.v[1] <= bbox[3];
+}
+
+
+/*****************************************************************************/
+static void trans_candidate (PJ *op, PJ_DIRECTION direction, int dims, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    Apply the candidate operation op to the n coordinates in coord, through
+    its 2D, 3D or 4D interfaces, as the caller of pj_trans_candidates asks.
+******************************************************************************/
+    size_t i;
+
+    switch (dims) {
+        case 2:
+            for (i = 0;  i < n;  i++) {
+                if (PJ_FWD==direction)
+                    coord[i].xy = pj_fwd (coord[i].lp, op);
+                else
+                    coord[i].lp = pj_inv (coord[i].xy, op);
+            }
+            return;
+        case 3:
+            for (i = 0;  i < n;  i++) {
+                if (PJ_FWD==direction)
+                    coord[i].xyz = pj_fwd3d (coord[i].lpz, op);
+                else
+                    coord[i].lpz = pj_inv3d (coord[i].xyz, op);
+            }
+            return;
+        default:
+            if (PJ_FWD==direction)
+                pj_fwd4d_array (coord, n, op);
+            else
+                pj_inv4d_array (coord, n, op);
+    }
+}
+
+
+/*****************************************************************************/
+void pj_trans_candidates (PJ *P, PJ_DIRECTION direction, int dims, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    Apply the candidate operations of P to the n coordinates in coord, with
+    their 2D, 3D or 4D (dims 2, 3 or 4) interfaces, for pj_approx_2D_trans,
+    pj_approx_3D_trans and the 4D API respectively. The direction must
+    already be adjusted for P->inverted.
+
+    Each coordinate is handed to the first candidate whose area of use
+    contains it. If that fails, the next containing candidate is tried, and
+    so on. Coordinates not contained in any area of use, or failing with all
+    candidates containing them, are handled by P itself, i.e. by the overall
+    best operation, which also gets to report any error.
+******************************************************************************/
+    PJ_COORD in[PJ_TRANS_BLOCK_SIZE], buf[PJ_TRANS_BLOCK_SIZE];
+    size_t idx[PJ_TRANS_BLOCK_SIZE];
+    char done[PJ_TRANS_BLOCK_SIZE];
+    size_t i, j, m, b, nb;
+    int k, last_errno;
+
+    for (b = 0;  b < n;  b += nb) {
+        nb = n - b < PJ_TRANS_BLOCK_SIZE ? n - b : PJ_TRANS_BLOCK_SIZE;
+        memcpy (in, coord + b, nb * sizeof (PJ_COORD));
+        for (i = 0;  i < nb;  i++)
+            done[i] = HUGE_VAL==in[i].v[0];
+
+        last_errno = proj_errno_reset (P);
+        for (k = 0;  k < P->candidate_count;  k++) {
+            PJ_CANDIDATE *c = P->candidates + k;
+            for (i = m = 0;  i < nb;  i++) {
+                if (done[i] || !candidate_contains (c, direction, in[i]))
+                    continue;
+                idx[m] = i;
+                buf[m++] = in[i];
+            }
+            if (0==m)
+                continue;
+
+            trans_candidate (c->op, direction, dims, m, buf);
+
+            for (j = 0;  j < m;  j++) {
+                if (HUGE_VAL==buf[j].v[0])
+                    continue;
+                coord[b + idx[j]] = buf[j];
+                done[idx[j]] = 1;
+            }
+        }
+
+        /* Failures above may be made up for by other candidates, so we only */
+        /* report errors from the fallback below                             */
+        proj_errno_reset (P);
+        for (i = m = 0;  i < nb;  i++) {
+            if (done[i])
+                continue;
+            idx[m] = i;
+            buf[m++] = in[i];
+        }
+        if (m > 0) {
+            trans_candidate (P, direction, dims, m, buf);
+            for (j = 0;  j < m;  j++)
+                coord[b + idx[j]] = buf[j];
+        }
+        if (0==proj_errno (P))
+            proj_errno_restore (P, last_errno);
+    }
+}
+
+
+
 /**************************************************************************************/
 PJ_COORD proj_trans (PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
 /***************************************************************************************
@@ -170,6 +284,11 @@ similarly, but prefers the 2D resp. 3D interfaces if available.
     if (P->inverted)
         direction = -direction;
 
+    if (P->candidate_count > 0 && (PJ_FWD==direction || PJ_INV==direction)) {
+        pj_trans_candidates (P, direction, 4, 1, &coord);
+        return coord;
+    }
+
     switch (direction) {
         case PJ_FWD:
             return pj_fwd4d (coord, P);
@@ -187,18 +306,186 @@ similarly, but prefers the 2D resp. 3D interfaces if available.
 
 
 
+/*****************************************************************************/
+void pj_trans_block (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    Batch equivalent of proj_trans: Apply P to the n coordinates in coord,
+    in place, using the batch kernels of P where available.
+******************************************************************************/
+    if (0==P)
+        return;
+    if (P->inverted)
+        direction = -direction;
+
+    if (P->candidate_count > 0 && (PJ_FWD==direction || PJ_INV==direction)) {
+        pj_trans_candidates (P, direction, 4, n, coord);
+        return;
+    }
+
+    switch (direction) {
+        case PJ_FWD:
+            pj_fwd4d_array (coord, n, P);
+            return;
+        case PJ_INV:
+            pj_inv4d_array (coord, n, P);
+            return;
+        case PJ_IDENT:
+            return;
+        default:
+            break;
+    }
+
+    proj_errno_set (P, EINVAL);
+}
+
+
+
+/* A contiguous part of the coordinates handed to one of the batch APIs, */
+/* transformed by its own copy of the PJ when running multi-threaded     */
+struct trans_range {
+    PJ *P;
+    PJ_DIRECTION direction;
+    size_t start, n;
+
+    /* proj_trans_array */
+    PJ_COORD *coord;
+
+    /* proj_trans_generic */
+    double *x, *y, *z, *t;
+    size_t sx, sy, sz, st;
+    size_t nx, ny, nz, nt;
+    PJ_COORD last;
+
+    int err;
+};
+
+static int trans_workers (PJ *P, int n);
+
+
+/*****************************************************************************/
+static int trans_thread_count (PJ *P, size_t n) {
+/******************************************************************************
+    Number of threads to use for transforming n coordinates with P: Limited
+    by the thread count of the context, by PJ_TRANS_THREAD_MIN_POINTS, and
+    by the number of worker copies of P we manage to set up.
+******************************************************************************/
+    size_t max_threads = n / PJ_TRANS_THREAD_MIN_POINTS;
+    int nthreads;
+
+    if (0==P)
+        return 1;
+    nthreads = pj_get_ctx (P)->thread_count;
+    if (nthreads < 2 || max_threads < 2)
+        return 1;
+    if ((size_t) nthreads > max_threads)
+        nthreads = (int) max_threads;
+
+    return trans_workers (P, nthreads - 1) + 1;
+}
+
+
+/*****************************************************************************/
+static struct trans_range *trans_ranges (PJ *P, PJ_DIRECTION direction, size_t n, int nthreads) {
+/******************************************************************************
+    Split n coordinates into nthreads ranges of (almost) equal size. The
+    first range is handled by P itself, the others by its worker copies.
+******************************************************************************/
+    struct trans_range *ranges;
+    int k;
+
+    ranges = pj_calloc (nthreads, sizeof (struct trans_range));
+    if (0==ranges)
+        return 0;
+
+    for (k = 0;  k < nthreads;  k++) {
+        ranges[k].P = k==0? P: P->workers[k - 1];
+        ranges[k].direction = direction;
+        ranges[k].start = n * k / nthreads;
+        ranges[k].n = n * (k + 1) / nthreads - ranges[k].start;
+        if (k > 0)
+            proj_errno_reset (ranges[k].P);
+    }
+    return ranges;
+}
+
+
+/*****************************************************************************/
+static int trans_ranges_errno (PJ *P, const struct trans_range *ranges, int nthreads) {
+/******************************************************************************
+    Return the first error encountered across the ranges, and make sure it
+    is also reflected in the error state of P. The grid cache counters of
+    the worker contexts are also folded into the context of P.
+******************************************************************************/
+    PJ_CONTEXT *ctx = pj_get_ctx (P);
+    int k;
+    for (k = 1;  k < nthreads;  k++) {
+        PJ_CONTEXT *wctx = ranges[k].P->ctx;
+        ctx->grid_cache_hits += wctx->grid_cache_hits;
+        ctx->grid_cache_misses += wctx->grid_cache_misses;
+        ctx->grid_cache_evictions += wctx->grid_cache_evictions;
+        wctx->grid_cache_hits = wctx->grid_cache_misses = wctx->grid_cache_evictions = 0;
+    }
+    for (k = 0;  k < nthreads;  k++) {
+        if (0==ranges[k].err)
+            continue;
+        if (0==proj_errno (P))
+            proj_errno_set (P, ranges[k].err);
+        return ranges[k].err;
+    }
+    return 0;
+}
+
+
+/*****************************************************************************/
+static void trans_array_range (void *arg) {
+/******************************************************************************
+    Thread body for proj_trans_array
+******************************************************************************/
+    struct trans_range *r = arg;
+    size_t i, m;
+
+    for (i = 0;  i < r->n;  i += m) {
+        m = r->n - i < PJ_TRANS_BLOCK_SIZE ? r->n - i : PJ_TRANS_BLOCK_SIZE;
+        pj_trans_block (r->P, r->direction, m, r->coord + i);
+        if (proj_errno (r->P))
+            break;
+    }
+    r->err = proj_errno (r->P);
+}
+
+
 /*****************************************************************************/
 int proj_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
 /******************************************************************************
     Batch transform an array of PJ_COORD.
 
+    The array is handled in blocks of PJ_TRANS_BLOCK_SIZE coordinates, and
+    processing stops after the first block containing a failed coordinate.
+
+    If the context of P allows for more than one thread, large arrays are
+    split in contiguous ranges, transformed in parallel. Each range then
+    stops after its own first failing block.
+
     Returns 0 if all coordinates are transformed without error, otherwise
     returns error number.
 ******************************************************************************/
-    size_t i;
+    struct trans_range *ranges;
+    size_t i, m;
+    int k, err, nthreads;
+
+    nthreads = trans_thread_count (P, n);
+    if (nthreads > 1 && 0 != (ranges = trans_ranges (P, direction, n, nthreads))) {
+        for (k = 0;  k < nthreads;  k++)
+            ranges[k].coord = coord + ranges[k].start;
+        pj_run_in_threads (nthreads, trans_array_range, ranges, sizeof (struct trans_range));
+        err = trans_ranges_errno (P, ranges, nthreads);
+        pj_dealloc (ranges);
+        return err;
+    }
 
-    for (i = 0;  i < n;  i++) {
-        coord[i] = proj_trans (P, direction, coord[i]);
+    for (i = 0;  i < n;  i += m) {
+        m = n - i < PJ_TRANS_BLOCK_SIZE ? n - i : PJ_TRANS_BLOCK_SIZE;
+        pj_trans_block (P, direction, m, coord + i);
         if (proj_errno(P))
             return proj_errno (P);
     }
@@ -208,6 +495,74 @@ int proj_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord)
 
 
 
+/*****************************************************************************/
+static void trans_generic_range (void *arg) {
+/******************************************************************************
+    Thread body for proj_trans_generic, also used for the single threaded
+    case.
+
+    Arrays of length==0 are broadcast as the constant 0
+    Arrays of length==1 are broadcast as their single value
+    Arrays of length >1 are iterated over (for the first r->n values)
+    The slightly convolved incremental indexing is used due
+    to the stride, which may be any size supported by the platform
+    The coordinates are gathered in blocks of PJ_TRANS_BLOCK_SIZE,
+    transformed in one go, and scattered back to the input arrays
+******************************************************************************/
+    struct trans_range *r = arg;
+    PJ_COORD coord[PJ_TRANS_BLOCK_SIZE];
+    double *x = r->x, *y = r->y, *z = r->z, *t = r->t;
+    size_t i, j, m = 0;
+
+    for (i = 0;  i < r->n;  i += m) {
+        double *xj = x, *yj = y, *zj = z, *tj = t;
+        m = r->n - i < PJ_TRANS_BLOCK_SIZE ? r->n - i : PJ_TRANS_BLOCK_SIZE;
+
+        for (j = 0;  j < m;  j++) {
+            coord[j].xyzt.x = *xj;
+            coord[j].xyzt.y = *yj;
+            coord[j].xyzt.z = *zj;
+            coord[j].xyzt.t = *tj;
+            /* The casts are somewhat funky, but they compile down to no-ops and  */
+            /* they tell compilers and static analyzers that we know what we do   */
+            if (r->nx > 1)  xj = (double *) ((void *) ( ((char *) xj) + r->sx));
+            if (r->ny > 1)  yj = (double *) ((void *) ( ((char *) yj) + r->sy));
+            if (r->nz > 1)  zj = (double *) ((void *) ( ((char *) zj) + r->sz));
+            if (r->nt > 1)  tj = (double *) ((void *) ( ((char *) tj) + r->st));
+        }
+
+        pj_trans_block (r->P, r->direction, m, coord);
+
+        /* in all full length cases, we overwrite the input with the output,  */
+        /* and step on to the next element.                                   */
+        for (j = 0;  j < m;  j++) {
+            if (r->nx > 1)  {
+               *x = coord[j].xyzt.x;
+                x = (double *) ((void *) ( ((char *) x) + r->sx));
+            }
+            if (r->ny > 1)  {
+               *y = coord[j].xyzt.y;
+                y = (double *) ((void *) ( ((char *) y) + r->sy));
+            }
+            if (r->nz > 1)  {
+               *z = coord[j].xyzt.z;
+                z = (double *) ((void *) ( ((char *) z) + r->sz));
+            }
+            if (r->nt > 1)  {
+               *t = coord[j].xyzt.t;
+                t = (double *) ((void *) ( ((char *) t) + r->st));
+            }
+        }
+    }
+
+    /* The length 1 cases are updated by the caller, from the last coordinate */
+    if (m > 0)
+        r->last = coord[m-1];
+    r->err = proj_errno (r->P);
+}
+
+
+
 /*************************************************************************************/
 size_t proj_trans_generic (
     PJ *P,
@@ -263,19 +618,20 @@ size_t proj_trans_generic (
     supposedly constants (i.e. length 1 arrays) will return from the call in altered
     state. Hence, remember to reinitialize between repeated calls.
 
+    If the context of P allows for more than one thread, large arrays are split
+    in contiguous ranges, transformed in parallel.
+
     Return value: Number of transformations completed.
 
 **************************************************************************************/
-    PJ_COORD coord = {{0,0,0,0}};
-    size_t i, nmin;
+    struct trans_range single, *ranges;
+    size_t nmin;
     double null_broadcast = 0;
+    int k, nthreads;
 
     if (0==P)
         return 0;
 
-    if (P->inverted)
-        direction = -direction;
-
     /* ignore lengths of null arrays */
     if (0==x) nx = 0;
     if (0==y) ny = 0;
@@ -313,55 +669,49 @@ size_t proj_trans_generic (
             return 0;
     }
 
-    /* Arrays of length==0 are broadcast as the constant 0               */
-    /* Arrays of length==1 are broadcast as their single value           */
-    /* Arrays of length >1 are iterated over (for the first nmin values) */
-    /* The slightly convolved incremental indexing is used due           */
-    /* to the stride, which may be any size supported by the platform    */
-    for (i = 0;  i < nmin;  i++) {
-        coord.xyzt.x = *x;
-        coord.xyzt.y = *y;
-        coord.xyzt.z = *z;
-        coord.xyzt.t = *t;
+    nthreads = trans_thread_count (P, nmin);
+    ranges = 0;
+    if (nthreads > 1)
+        ranges = trans_ranges (P, direction, nmin, nthreads);
+    if (0==ranges) {
+        memset (&single, 0, sizeof (single));
+        single.P = P;
+        single.direction = direction;
+        single.n = nmin;
+        ranges = &single;
+        nthreads = 1;
+    }
 
-        if (PJ_FWD==direction)
-            coord = pj_fwd4d (coord, P);
-        else
-            coord = pj_inv4d (coord, P);
+    for (k = 0;  k < nthreads;  k++) {
+        struct trans_range *r = ranges + k;
+        r->x = nx > 1 ? (double *) ((void *) ( ((char *) x) + r->start * sx)) : x;
+        r->y = ny > 1 ? (double *) ((void *) ( ((char *) y) + r->start * sy)) : y;
+        r->z = nz > 1 ? (double *) ((void *) ( ((char *) z) + r->start * sz)) : z;
+        r->t = nt > 1 ? (double *) ((void *) ( ((char *) t) + r->start * st)) : t;
+        r->sx = sx;  r->sy = sy;  r->sz = sz;  r->st = st;
+        r->nx = nx;  r->ny = ny;  r->nz = nz;  r->nt = nt;
+    }
 
-        /* in all full length cases, we overwrite the input with the output,  */
-        /* and step on to the next element.                                   */
-        /* The casts are somewhat funky, but they compile down to no-ops and  */
-        /* they tell compilers and static analyzers that we know what we do   */
-        if (nx > 1)  {
-           *x = coord.xyzt.x;
-            x = (double *) ((void *) ( ((char *) x) + sx));
-        }
-        if (ny > 1)  {
-           *y = coord.xyzt.y;
-            y = (double *) ((void *) ( ((char *) y) + sy));
-        }
-        if (nz > 1)  {
-           *z = coord.xyzt.z;
-            z = (double *) ((void *) ( ((char *) z) + sz));
-        }
-        if (nt > 1)  {
-           *t = coord.xyzt.t;
-            t = (double *) ((void *) ( ((char *) t) + st));
-        }
+    if (1==nthreads)
+        trans_generic_range (ranges);
+    else {
+        pj_run_in_threads (nthreads, trans_generic_range, ranges, sizeof (struct trans_range));
+        trans_ranges_errno (P, ranges, nthreads);
     }
 
-    /* Last time around, we update the length 1 cases with their transformed alter egos */
+    /* Finally, we update the length 1 cases with their transformed alter egos */
     if (nx==1)
-        *x = coord.xyzt.x;
+        *x = ranges[nthreads-1].last.xyzt.x;
     if (ny==1)
-        *y = coord.xyzt.y;
+        *y = ranges[nthreads-1].last.xyzt.y;
     if (nz==1)
-        *z = coord.xyzt.z;
+        *z = ranges[nthreads-1].last.xyzt.z;
     if (nt==1)
-        *t = coord.xyzt.t;
+        *t = ranges[nthreads-1].last.xyzt.t;
 
-    return i;
+    if (ranges != &single)
+        pj_dealloc (ranges);
+    return nmin;
 }
 
 
@@ -640,6 +990,297 @@ indicator, as in {"+proj=utm", "+zone=32"}, or leave it out, as in {"proj=utm",
     return P;
 }
 
+/*************************************************************************************/
+static PJ *clone_from_params (PJ *P, PJ_CONTEXT *ctx) {
+/**************************************************************************************
+Set up a new PJ in ctx, from the parameter list of P.
+**************************************************************************************/
+    PJ *Q;
+    paralist *par;
+    char **argv;
+    int argc = 0, n = 0;
+
+    for (par = P->params;  par;  par = par->next)
+        n++;
+    argv = pj_calloc (n, sizeof (char *));
+    if (0==argv)
+        return 0;
+
+    /* Outside of pipelines, init files are already expanded into the list */
+    for (par = P->params;  par;  par = par->next) {
+        if (!P->is_pipeline && 0==strncmp (par->param, "init=", 5))
+            continue;
+        argv[argc++] = par->param;
+    }
+
+    Q = pj_init_ctx_with_allow_init_epsg (ctx, argc, argv, TRUE);
+    pj_dealloc (argv);
+
+    /* Only add the cs2cs emulation steps if P has them */
+    if (Q && (P->axisswap || P->cart || P->helmert || P->hgridshift || P->vgridshift)) {
+        if (0==cs2cs_emulation_setup (Q))
+            return proj_destroy (Q);
+    }
+    if (Q)
+        Q->inverted = P->inverted;
+    return Q;
+}
+
+
+
+/*************************************************************************************/
+static paralist *clone_params (PJ_CONTEXT *ctx, const paralist *params) {
+/**************************************************************************************
+Copy a parameter list, along with the used flags of its elements and, if it has one,
+its lookup table.
+**************************************************************************************/
+    paralist *first = 0, *last = 0, *item;
+    const paralist *par;
+
+    for (par = params;  par;  par = par->next) {
+        item = pj_malloc (sizeof (paralist) + strlen (par->param));
+        if (0==item)
+            return pj_dealloc_params (ctx, first, ENOMEM);
+        item->next = 0;
+        item->index = 0;
+        item->used = par->used;
+        strcpy (item->param, par->param);
+        if (last)
+            last->next = item;
+        else
+            first = item;
+        last = item;
+    }
+
+    if (params && params->index)
+        pj_param_index_create (first);
+    return first;
+}
+
+
+
+/*************************************************************************************/
+static char *param_of_clone (const paralist *params, paralist *copy, const char *param) {
+/**************************************************************************************
+The element of copy, a copy of params, matching the element param of params, if any.
+**************************************************************************************/
+    for (;  params && copy;  params = params->next, copy = copy->next)
+        if (params->param==param)
+            return copy->param;
+    return 0;
+}
+
+
+
+/*************************************************************************************/
+static PJ *clone_by_copy (PJ *P, PJ_CONTEXT *ctx) {
+/**************************************************************************************
+Copy P into ctx, for an operation with a copy hook: the parts of P common to all
+operations are copied here, then the hook copies the opaque object. Nothing is set
+up again: the grids are shared with P, each copy holding a reference on them, and
+the geodesic data are copied as they are.
+**************************************************************************************/
+    PJ *Q;
+    PJ **steps[6];
+    PJ *const *from[6];
+    int i;
+
+    Q = pj_calloc (1, sizeof (PJ));
+    if (0==Q) {
+        proj_context_errno_set (ctx, ENOMEM);
+        return 0;
+    }
+    *Q = *P;
+    Q->ctx = ctx;
+
+    /* Drop what P owns, so that Q may be freed at any point below */
+    Q->params = 0;
+    Q->def_full = Q->def_size = Q->def_shape = Q->def_spherification = Q->def_ellps = 0;
+    Q->geod = 0;
+    Q->opaque = 0;
+    Q->axisswap = Q->cart = Q->cart_wgs84 = Q->helmert = Q->hgridshift = Q->vgridshift = 0;
+    Q->workers = 0;
+    Q->worker_count = 0;
+    Q->candidates = 0;
+    Q->candidate_count = 0;
+    Q->gridlist = Q->vgridlist_geoid = 0;
+    Q->gridlist_count = Q->vgridlist_geoid_count = 0;
+    Q->gridlist_index = Q->vgridlist_geoid_index = 0;
+    Q->catalog_name = 0;
+
+    Q->params = clone_params (ctx, P->params);
+    if (P->params && 0==Q->params)
+        return pj_default_destructor (Q, ENOMEM);
+    Q->def_size = param_of_clone (P->params, Q->params, P->def_size);
+    Q->def_shape = param_of_clone (P->params, Q->params, P->def_shape);
+    Q->def_spherification = param_of_clone (P->params, Q->params, P->def_spherification);
+    Q->def_ellps = param_of_clone (P->params, Q->params, P->def_ellps);
+    if (P->def_full && 0==(Q->def_full = pj_strdup (P->def_full)))
+        return pj_default_destructor (Q, ENOMEM);
+    if (P->catalog_name && 0==(Q->catalog_name = pj_strdup (P->catalog_name)))
+        return pj_default_destructor (Q, ENOMEM);
+
+    if (P->geod) {
+        Q->geod = pj_malloc (sizeof (struct geod_geodesic));
+        if (0==Q->geod)
+            return pj_default_destructor (Q, ENOMEM);
+        memcpy (Q->geod, P->geod, sizeof (struct geod_geodesic));
+    }
+
+    /* The spatial indexes of the grid lists are built again on first use */
+    Q->gridlist = pj_gridlist_copy (ctx, P->gridlist, P->gridlist_count);
+    if (P->gridlist && 0==Q->gridlist)
+        return pj_default_destructor (Q, ENOMEM);
+    Q->gridlist_count = P->gridlist_count;
+    Q->vgridlist_geoid = pj_gridlist_copy (ctx, P->vgridlist_geoid, P->vgridlist_geoid_count);
+    if (P->vgridlist_geoid && 0==Q->vgridlist_geoid)
+        return pj_default_destructor (Q, ENOMEM);
+    Q->vgridlist_geoid_count = P->vgridlist_geoid_count;
+
+    /* The cs2cs emulation steps, each copied as any operation */
+    steps[0] = &Q->axisswap;    from[0] = &P->axisswap;
+    steps[1] = &Q->cart;        from[1] = &P->cart;
+    steps[2] = &Q->cart_wgs84;  from[2] = &P->cart_wgs84;
+    steps[3] = &Q->helmert;     from[3] = &P->helmert;
+    steps[4] = &Q->hgridshift;  from[4] = &P->hgridshift;
+    steps[5] = &Q->vgridshift;  from[5] = &P->vgridshift;
+    for (i = 0;  i < 6;  i++) {
+        if (0==*from[i])
+            continue;
+        *steps[i] = pj_copy (ctx, *from[i]);
+        if (0==*steps[i])
+            return pj_default_destructor (Q, proj_context_errno (ctx));
+    }
+
+    return P->copier (Q, P);
+}
+
+
+
+/*************************************************************************************/
+PJ *pj_copy (PJ_CONTEXT *ctx, const PJ *P) {
+/**************************************************************************************
+Copy P into ctx. Operations with a copy hook are copied as they are, the others are
+set up again from the parameter list of P.
+**************************************************************************************/
+    if (P->copier)
+        return clone_by_copy ((PJ *) P, ctx);
+    return clone_from_params ((PJ *) P, ctx);
+}
+
+
+
+/*************************************************************************************/
+static PJ *clone_with_candidates (PJ *P, PJ_CONTEXT *ctx) {
+/**************************************************************************************
+Copy P into ctx, along with the candidate operations set up by
+proj_create_crs_to_crs, if any.
+**************************************************************************************/
+    PJ *Q;
+    int k;
+
+    Q = pj_copy (ctx, P);
+    if (0==Q)
+        return 0;
+    if (0==P->candidate_count)
+        return Q;
+
+    Q->candidates = pj_calloc (P->candidate_count, sizeof (PJ_CANDIDATE));
+    if (0==Q->candidates)
+        return proj_destroy (Q);
+    for (k = 0;  k < P->candidate_count;  k++) {
+        Q->candidates[k] = P->candidates[k];
+        if (P->candidates[k].op==P)
+            Q->candidates[k].op = Q;
+        else
+            Q->candidates[k].op = pj_copy (ctx, P->candidates[k].op);
+        if (0==Q->candidates[k].op)
+            return proj_destroy (Q);
+        Q->candidate_count++;
+    }
+    return Q;
+}
+
+
+
+/*************************************************************************************/
+static PJ *trans_worker_create (PJ *P) {
+/**************************************************************************************
+Create a private copy of P, for use by a worker thread of the batch APIs. The copy
+gets a context of its own, so its error state, and any state held by the operation
+itself, is never shared between threads.
+**************************************************************************************/
+    PJ_CONTEXT *ctx;
+    PJ *W;
+
+    /* The worker keeps the init rules of P's context, so that it is set */
+    /* up as P was, but does not start threads of its own                */
+    ctx = pj_ctx_copy (pj_get_ctx (P));
+    if (0==ctx)
+        return 0;
+    ctx->thread_count = 1;
+
+    /* The candidate operations go along, in the same context */
+    W = clone_with_candidates (P, ctx);
+    if (0==W) {
+        pj_ctx_free (ctx);
+        return 0;
+    }
+    return W;
+}
+
+
+
+/*************************************************************************************/
+static int trans_workers (PJ *P, int n) {
+/**************************************************************************************
+Make sure P has (up to) n worker copies, for the multi-threaded batch APIs. The copies
+are kept until P is destroyed. Returns the number of copies available.
+**************************************************************************************/
+    PJ **workers;
+
+    if (P->worker_count >= n)
+        return n;
+
+    workers = pj_calloc (n, sizeof (PJ *));
+    if (0==workers)
+        return P->worker_count;
+    if (P->workers)
+        memcpy (workers, P->workers, P->worker_count * sizeof (PJ *));
+    pj_dealloc (P->workers);
+    P->workers = workers;
+
+    while (P->worker_count < n) {
+        PJ *W = trans_worker_create (P);
+        if (0==W)
+            break;
+        P->workers[P->worker_count++] = W;
+    }
+    return P->worker_count;
+}
+
+
+
+/*************************************************************************************/
+void pj_free_workers (PJ *P) {
+/**************************************************************************************
+Free the worker copies of P, including their private contexts
+**************************************************************************************/
+    int i;
+    if (0==P || 0==P->workers)
+        return;
+    for (i = 0;  i < P->worker_count;  i++) {
+        PJ_CONTEXT *ctx = P->workers[i]->ctx;
+        proj_destroy (P->workers[i]);
+        pj_ctx_free (ctx);
+    }
+    pj_dealloc (P->workers);
+    P->workers = 0;
+    P->worker_count = 0;
+}
+
+
+
 /** Create an area of use */
 PJ_AREA * proj_area_create(void) {
     return pj_calloc(1, sizeof(PJ_AREA));
@@ -675,29 +1316,101 @@ void proj_context_use_proj4_init_rules(PJ_CONTEXT *ctx, int enable) {
 }
 
 /************************************************************************/
-/*                              EQUAL()                                 */
+/*                    proj_context_set_thread_count()                   */
 /************************************************************************/
 
-static int EQUAL(const char* a, const char* b) {
-#ifdef _MSC_VER
-    return _stricmp(a, b) == 0;
-#else
-    return strcasecmp(a, b) == 0;
-#endif
+void proj_context_set_thread_count(PJ_CONTEXT *ctx, int count) {
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->thread_count = count < 1 ? 1 : count;
 }
 
 /************************************************************************/
-/*                  proj_context_get_use_proj4_init_rules()             */
+/*                    proj_context_get_thread_count()                   */
 /************************************************************************/
 
-int proj_context_get_use_proj4_init_rules(PJ_CONTEXT *ctx, int from_legacy_code_path) {
-    const char* val = getenv("PROJ_USE_PROJ4_INIT_RULES");
-
+int proj_context_get_thread_count(PJ_CONTEXT *ctx) {
     if( ctx == NULL ) {
         ctx = pj_get_default_ctx();
     }
+    return ctx->thread_count;
+}
 
-    if( val ) {
+/************************************************************************/
+/*                    proj_context_set_grid_tiling()                    */
+/************************************************************************/
+
+void proj_context_set_grid_tiling(PJ_CONTEXT *ctx, int tiling) {
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->grid_tiling = tiling < 0 ? -1 : tiling > 0;
+}
+
+/************************************************************************/
+/*                  proj_context_set_grid_cache_size()                  */
+/************************************************************************/
+
+void proj_context_set_grid_cache_size(PJ_CONTEXT *ctx, size_t max_size) {
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+    pj_gridinfo_set_cache_size(ctx, max_size);
+}
+
+/************************************************************************/
+/*                  proj_context_get_grid_cache_info()                  */
+/************************************************************************/
+
+PJ_GRID_CACHE_INFO proj_context_get_grid_cache_info(PJ_CONTEXT *ctx) {
+    PJ_GRID_CACHE_INFO info;
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+    info.size = pj_gridinfo_memory_used();
+    info.max_size = pj_gridinfo_get_cache_size();
+    info.hits = ctx->grid_cache_hits;
+    info.misses = ctx->grid_cache_misses;
+    info.evictions = ctx->grid_cache_evictions;
+    return info;
+}
+
+/************************************************************************/
+/*                   proj_context_use_inverse_grids()                   */
+/************************************************************************/
+
+void proj_context_use_inverse_grids(PJ_CONTEXT *ctx, int enable) {
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->use_inverse_grids = enable ? 1 : 0;
+}
+
+/************************************************************************/
+/*                              EQUAL()                                 */
+/************************************************************************/
+
+static int EQUAL(const char* a, const char* b) {
+#ifdef _MSC_VER
+    return _stricmp(a, b) == 0;
+#else
+    return strcasecmp(a, b) == 0;
+#endif
+}
+
+/************************************************************************/
+/*                  proj_context_get_use_proj4_init_rules()             */
+/************************************************************************/
+
+int proj_context_get_use_proj4_init_rules(PJ_CONTEXT *ctx, int from_legacy_code_path) {
+    const char* val = getenv("PROJ_USE_PROJ4_INIT_RULES");
+
+    if( ctx == NULL ) {
+        ctx = pj_get_default_ctx();
+    }
+
+    if( val ) {
         if( EQUAL(val, "yes") || EQUAL(val, "on") || EQUAL(val, "true") ) {
             return TRUE;
         }
@@ -715,38 +1428,291 @@ int proj_context_get_use_proj4_init_rules(PJ_CONTEXT *ctx, int from_legacy_code_
 
 
 /*****************************************************************************/
-PJ  *proj_create_crs_to_crs (PJ_CONTEXT *ctx, const char *source_crs, const char *target_crs, PJ_AREA *area) {
+static const char *op_definition (PJ_CONTEXT *ctx, const PJ_OBJ *op) {
 /******************************************************************************
-    Create a transformation pipeline between two known coordinate reference
-    systems.
+    The PROJ string instantiating the coordinate operation op.
+******************************************************************************/
+    const char* proj_string;
 
-    source_crs and target_crs can be :
-    - a "AUTHORITY:CODE", like EPSG:25832. When using that syntax for a source
-      CRS, the created pipeline will expect that the values passed to proj_trans()
-      respect the axis order and axis unit of the official definition (
-      so for example, for EPSG:4326, with latitude first and longitude next,
-      in degrees). Similarly, when using that syntax for a target CRS, output
-      values will be emitted according to the official definition of this CRS.
-    - a PROJ string, like "+proj=longlat +datum=WGS84".
-      When using that syntax, the axis order and unit for geographic CRS will
-      be longitude, latitude, and the unit degrees.
-    - more generally any string accepted by proj_obj_create_from_user_input()
+    proj_string = proj_obj_as_proj_string(ctx, op, PJ_PROJ_5, NULL);
+    if( proj_string && proj_string[0] == '\0' ) {
+        /* Null transform ? */
+        return "proj=affine";
+    }
+    return proj_string;
+}
 
-    An "area of use" can be specified in area. When it is supplied, the more
-    accurate transformation between two given systems can be chosen.
 
-    Example call:
+/*****************************************************************************/
+static PJ *op_to_pj (PJ_CONTEXT *ctx, const PJ_OBJ *op) {
+/******************************************************************************
+    Instantiate the coordinate operation op as a PJ.
+******************************************************************************/
+    const char* proj_string = op_definition(ctx, op);
+    if( !proj_string) {
+        return NULL;
+    }
+    return proj_create(ctx, proj_string);
+}
 
-        PJ *P = proj_create_crs_to_crs(0, "EPSG:25832", "EPSG:25833", NULL);
 
+/*****************************************************************************/
+static PJ *geodetic_to_crs (PJ_CONTEXT *ctx, const PJ_OBJ *crs,
+                            int *lat_first, double *deg_to_unit) {
+/******************************************************************************
+    Create a PJ converting from the geodetic CRS underlying crs, to crs.
+    On success, *lat_first tells the axis order of the geodetic CRS, and
+    *deg_to_unit the factor converting from degrees to its angular unit.
+******************************************************************************/
+    PJ *P = NULL;
+    PJ_OBJ* geod;
+    PJ_OBJ* cs;
+    PJ_OBJ* op;
+    PJ_OBJ_LIST* op_list;
+    PJ_OPERATION_FACTORY_CONTEXT* operation_ctx;
+    const char* direction = NULL;
+    double to_si = 0;
+
+    geod = proj_obj_crs_get_geodetic_crs(ctx, crs);
+    if( !geod ) {
+        return NULL;
+    }
+
+    cs = proj_obj_crs_get_coordinate_system(ctx, geod);
+    if( !cs || !proj_obj_cs_get_axis_info(ctx, cs, 0, NULL, NULL,
+                                          &direction, &to_si, NULL) ||
+        to_si <= 0 ) {
+        proj_obj_unref(cs);
+        proj_obj_unref(geod);
+        return NULL;
+    }
+    *lat_first = EQUAL(direction, "north") || EQUAL(direction, "south");
+    *deg_to_unit = PJ_TORAD(1.0) / to_si;
+    proj_obj_unref(cs);
+
+    operation_ctx = proj_create_operation_factory_context(ctx, NULL);
+    if( !operation_ctx ) {
+        proj_obj_unref(geod);
+        return NULL;
+    }
+    op_list = proj_obj_create_operations(ctx, geod, crs, operation_ctx);
+    proj_operation_factory_context_unref(operation_ctx);
+    proj_obj_unref(geod);
+    if( !op_list ) {
+        return NULL;
+    }
+
+    if( proj_obj_list_get_count(op_list) > 0 ) {
+        op = proj_obj_list_get(ctx, op_list, 0);
+        if( op ) {
+            P = op_to_pj(ctx, op);
+            proj_obj_unref(op);
+        }
+    }
+    proj_obj_list_unref(op_list);
+    return P;
+}
+
+
+/*****************************************************************************/
+static int area_to_bbox (PJ *T, int lat_first, double deg_to_unit,
+                         double west, double south, double east, double north,
+                         double *bbox) {
+/******************************************************************************
+    Compute the bounding box, in the CRS targeted by T (see geodetic_to_crs),
+    of a geographic area given in degrees, by sampling its boundary.
+    Returns 0 if no boundary point could be transformed.
+******************************************************************************/
+    const int N = 20;
+    int i, side, ok = 0;
+    proj_errno_reset(T);
+
+    if( east < west ) {
+        east += 360;
+    }
+
+    bbox[0] = bbox[1] = HUGE_VAL;
+    bbox[2] = bbox[3] = -HUGE_VAL;
+    for( side = 0; side < 4; side++ ) {
+        for( i = 0; i <= N; i++ ) {
+            double lon, lat;
+            PJ_COORD c;
+            switch( side ) {
+                case 0:  lon = west + (east - west) * i / N;  lat = south;  break;
+                case 1:  lon = west + (east - west) * i / N;  lat = north;  break;
+                case 2:  lon = west;  lat = south + (north - south) * i / N;  break;
+                default: lon = east;  lat = south + (north - south) * i / N;  break;
+            }
+            if( lon > 180 ) {
+                lon -= 360;
+            }
+            lon *= deg_to_unit;
+            lat *= deg_to_unit;
+            c = lat_first ? proj_coord(lat, lon, 0, 0) : proj_coord(lon, lat, 0, 0);
+            c = proj_trans(T, PJ_FWD, c);
+            if( c.v[0] == HUGE_VAL || c.v[1] == HUGE_VAL ) {
+                continue;
+            }
+            ok = 1;
+            if( c.v[0] < bbox[0] ) bbox[0] = c.v[0];
+            if( c.v[1] < bbox[1] ) bbox[1] = c.v[1];
+            if( c.v[0] > bbox[2] ) bbox[2] = c.v[0];
+            if( c.v[1] > bbox[3] ) bbox[3] = c.v[1];
+        }
+    }
+    proj_errno_reset(T);
+    return ok;
+}
+
+
+/*****************************************************************************/
+static int candidate_before (const PJ_CANDIDATE *a, const PJ_CANDIDATE *b,
+                             const PJ *P) {
+/******************************************************************************
+    Should the candidate a of P be tried before b? P itself goes first,
+    unless its accuracy is unknown, and the others in order of accuracy,
+    with those of unknown accuracy last.
+******************************************************************************/
+    if( a->accuracy < 0 ) {
+        return 0;
+    }
+    return b->accuracy < 0 || (b->op != P && b->accuracy > a->accuracy);
+}
+
+
+/*****************************************************************************/
+static void add_candidates (PJ_CONTEXT *ctx, PJ *P, const char *definition,
+                            const PJ_OBJ_LIST *op_list,
+                            const PJ_OBJ *src, const PJ_OBJ *dst) {
+/******************************************************************************
+    Attach the operations of op_list to P, which instantiates definition, so
+    the 4D API can choose the most appropriate operation for each coordinate:
+    The first one whose area of use contains it, in the order given by
+    candidate_before(), or P itself if there is none.
+    Operations with no usable area of use, or that cannot be instantiated,
+    are skipped. If anything else fails, P is left as is, with just the one
+    operation.
+******************************************************************************/
+    PJ *Tsrc, *Tdst;
+    PJ_CANDIDATE *candidates;
+    int src_lat_first, dst_lat_first;
+    double src_to_unit, dst_to_unit;
+    int i, n = 0, others = 0, found_P = 0;
+    const int count = proj_obj_list_get_count(op_list);
+
+    Tsrc = geodetic_to_crs(ctx, src, &src_lat_first, &src_to_unit);
+    Tdst = geodetic_to_crs(ctx, dst, &dst_lat_first, &dst_to_unit);
+    candidates = pj_calloc(count, sizeof(PJ_CANDIDATE));
+    if( !Tsrc || !Tdst || !candidates ) {
+        proj_destroy(Tsrc);
+        proj_destroy(Tdst);
+        pj_dealloc(candidates);
+        return;
+    }
+    P->candidates = candidates;
+
+    for( i = 0; i < count; i++ ) {
+        PJ_OBJ* op = proj_obj_list_get(ctx, op_list, i);
+        PJ_CANDIDATE *c = candidates + n;
+        const char *op_def;
+        int is_P;
+        double west, south, east, north;
+        if( !op ) {
+            break;
+        }
+        op_def = op_definition(ctx, op);
+        is_P = !found_P && op_def && 0 == strcmp(op_def, definition);
+        if( !op_def ||
+            !proj_obj_get_area_of_use(ctx, op, &west, &south, &east, &north,
+                                      NULL) || west == -1000 ||
+            !area_to_bbox(Tsrc, src_lat_first, src_to_unit,
+                          west, south, east, north, c->src_bbox) ||
+            !area_to_bbox(Tdst, dst_lat_first, dst_to_unit,
+                          west, south, east, north, c->dst_bbox) ) {
+            proj_obj_unref(op);
+            /* Without bounds for P, there is no telling where the others */
+            /* should take over                                           */
+            if( is_P ) {
+                others = 0;
+                break;
+            }
+            continue;
+        }
+        if( is_P ) {
+            c->op = P;
+            found_P = 1;
+        } else {
+            c->op = proj_create(ctx, op_def);
+            others += c->op != NULL;
+        }
+        c->accuracy = proj_coordoperation_get_accuracy(ctx, op);
+        proj_obj_unref(op);
+        if( c->op ) {
+            P->candidate_count = ++n;
+        }
+    }
+    proj_destroy(Tsrc);
+    proj_destroy(Tdst);
+
+    /* Stable sort, keeping the original order for equally ranked ones */
+    for( i = 1; i < n; i++ ) {
+        PJ_CANDIDATE c = candidates[i];
+        int j = i;
+        if( c.op == P ) {
+            while( j > 0 && !candidate_before(candidates + j - 1, &c, P) ) {
+                candidates[j] = candidates[j-1];
+                j--;
+            }
+            candidates[j] = c;
+            continue;
+        }
+        while( j > 0 && candidate_before(&c, candidates + j - 1, P) ) {
+            candidates[j] = candidates[j-1];
+            j--;
+        }
+        candidates[j] = c;
+    }
+
+    /* Nothing to choose from, besides P */
+    if( others == 0 ) {
+        pj_free_candidates(P);
+    }
+}
+
+
+/*****************************************************************************/
+void pj_free_candidates (PJ *P) {
+/******************************************************************************
+    Free the candidate operations of P, except P itself
+******************************************************************************/
+    int i;
+    if( !P || !P->candidates ) {
+        return;
+    }
+    for( i = 0; i < P->candidate_count; i++ ) {
+        if( P->candidates[i].op != P ) {
+            proj_destroy(P->candidates[i].op);
+        }
+    }
+    pj_dealloc(P->candidates);
+    P->candidates = NULL;
+    P->candidate_count = 0;
+}
+
+
+/*****************************************************************************/
+static PJ *create_crs_to_crs (PJ_CONTEXT *ctx, const char *source_crs, const char *target_crs, PJ_AREA *area) {
+/******************************************************************************
+    The work of proj_create_crs_to_crs(), without the cache.
 ******************************************************************************/
     PJ *P;
     PJ_OBJ* src;
     PJ_OBJ* dst;
     PJ_OPERATION_FACTORY_CONTEXT* operation_ctx;
     PJ_OBJ_LIST* op_list;
+    PJ_OBJ_LIST* partial_list = NULL;
     PJ_OBJ* op;
-    const char* proj_string;
+    const char* definition;
     const char* const optionsProj4Mode[] = { "USE_PROJ4_INIT_RULES=YES", NULL };
     const char* const* optionsImportCRS =
         proj_context_get_use_proj4_init_rules(ctx, FALSE) ? optionsProj4Mode : NULL;
@@ -784,43 +1750,296 @@ PJ  *proj_create_crs_to_crs (PJ_CONTEXT *ctx, const char *source_crs, const char
 
     op_list = proj_obj_create_operations(ctx, src, dst, operation_ctx);
 
+    /* Without an area of interest, the operations above are valid over   */
+    /* the whole CRS extents. Those only valid in part of them are looked */
+    /* for separately, to be used within their own area of use, if asked  */
+    if( op_list && ctx->per_point_operations && !(area && area->bbox_set) ) {
+        proj_operation_factory_context_set_spatial_criterion(
+            ctx, operation_ctx, PROJ_SPATIAL_CRITERION_PARTIAL_INTERSECTION);
+        partial_list = proj_obj_create_operations(ctx, src, dst, operation_ctx);
+    }
+
     proj_operation_factory_context_unref(operation_ctx);
-    proj_obj_unref(src);
-    proj_obj_unref(dst);
 
-    if( !op_list ) {
+    if( !op_list || proj_obj_list_get_count(op_list) == 0 ) {
+        proj_obj_list_unref(op_list);
+        proj_obj_list_unref(partial_list);
+        proj_obj_unref(src);
+        proj_obj_unref(dst);
         return NULL;
     }
 
-    if( proj_obj_list_get_count(op_list) == 0 ) {
+    op = proj_obj_list_get(ctx, op_list, 0);
+    if( !op ) {
         proj_obj_list_unref(op_list);
+        proj_obj_list_unref(partial_list);
+        proj_obj_unref(src);
+        proj_obj_unref(dst);
         return NULL;
     }
 
-    op = proj_obj_list_get(ctx, op_list, 0);
+    definition = op_definition(ctx, op);
+    P = definition ? proj_create(ctx, definition) : NULL;
+
+    /* Keep the other operations around, for use where they apply, if  */
+    /* asked. The first one remains the one to use anywhere else       */
+    if( P && partial_list && proj_obj_list_get_count(partial_list) > 1 ) {
+        add_candidates(ctx, P, definition, partial_list, src, dst);
+    } else if( P && ctx->per_point_operations &&
+               proj_obj_list_get_count(op_list) > 1 ) {
+        add_candidates(ctx, P, definition, op_list, src, dst);
+    }
+    proj_obj_unref(op);
+
     proj_obj_list_unref(op_list);
-    if( !op ) {
+    proj_obj_list_unref(partial_list);
+    proj_obj_unref(src);
+    proj_obj_unref(dst);
+
+    return P;
+}
+
+/* An entry of the cache of PJs made by proj_create_crs_to_crs() */
+struct pj_operation_cache {
+    char *key;
+    PJ *P;
+    int search_generation;  /* see proj_get_search_generation() */
+    struct pj_operation_cache *next;
+};
+
+
+/*****************************************************************************/
+static char *operation_cache_key (PJ_CONTEXT *ctx, const char *source_crs,
+                                  const char *target_crs, const PJ_AREA *area) {
+/******************************************************************************
+    Everything the result of proj_create_crs_to_crs() depends on, besides
+    the database, as a string.
+******************************************************************************/
+    char area_str[128] = "";
+    char *key;
+
+    if( area && area->bbox_set ) {
+        sprintf(area_str, "%.17g,%.17g,%.17g,%.17g",
+                area->west_lon_degree, area->south_lat_degree,
+                area->east_lon_degree, area->north_lat_degree);
+    }
+    key = pj_malloc(strlen(source_crs) + strlen(target_crs) +
+                    strlen(area_str) + 10);
+    if( !key ) {
         return NULL;
     }
+    sprintf(key, "%s\n%s\n%s\n%d\n%d", source_crs, target_crs, area_str,
+            proj_context_get_use_proj4_init_rules(ctx, FALSE),
+            ctx->per_point_operations);
+    return key;
+}
 
-    proj_string = proj_obj_as_proj_string(ctx, op, PJ_PROJ_5, NULL);
-    if( !proj_string) {
-        proj_obj_unref(op);
-        return NULL;
+
+/*****************************************************************************/
+static void operation_cache_trim (PJ_CONTEXT *ctx, int max) {
+/******************************************************************************
+    Drop the least recently used entries of the cache of ctx beyond max.
+******************************************************************************/
+    struct pj_operation_cache **link = &ctx->operation_cache;
+    int i;
+
+    for( i = 0; *link && i < max; i++ ) {
+        link = &(*link)->next;
+    }
+    while( *link ) {
+        struct pj_operation_cache *entry = *link;
+        *link = entry->next;
+        proj_destroy(entry->P);
+        pj_dealloc(entry->key);
+        pj_dealloc(entry);
+        ctx->operation_cache_count--;
     }
+}
 
-    if( proj_string[0] == '\0' ) {
-        /* Null transform ? */
-        P = proj_create(ctx, "proj=affine");
-    } else {
-        P = proj_create(ctx, proj_string);
+
+/*****************************************************************************/
+static void operation_cache_drop_stale (PJ_CONTEXT *ctx) {
+/******************************************************************************
+    Drop the entries of the cache of ctx made before the last change of the
+    search path or file finder, as the grids they were made with may have
+    changed.
+******************************************************************************/
+    struct pj_operation_cache **link = &ctx->operation_cache;
+    const int generation = proj_get_search_generation();
+
+    while( *link ) {
+        struct pj_operation_cache *entry = *link;
+        if( entry->search_generation == generation ) {
+            link = &entry->next;
+            continue;
+        }
+        *link = entry->next;
+        proj_destroy(entry->P);
+        pj_dealloc(entry->key);
+        pj_dealloc(entry);
+        ctx->operation_cache_count--;
     }
+}
 
-    proj_obj_unref(op);
+
+/*****************************************************************************/
+void pj_free_operation_cache (PJ_CONTEXT *ctx) {
+/******************************************************************************
+    Free the cache of proj_create_crs_to_crs() results of ctx, e.g. when
+    the database or the file API changes. The cache size is kept.
+******************************************************************************/
+    operation_cache_trim(ctx, 0);
+}
+
+
+/*****************************************************************************/
+PJ  *proj_create_crs_to_crs (PJ_CONTEXT *ctx, const char *source_crs, const char *target_crs, PJ_AREA *area) {
+/******************************************************************************
+    Create a transformation pipeline between two known coordinate reference
+    systems.
+
+    source_crs and target_crs can be :
+    - a "AUTHORITY:CODE", like EPSG:25832. When using that syntax for a source
+      CRS, the created pipeline will expect that the values passed to proj_trans()
+      respect the axis order and axis unit of the official definition (
+      so for example, for EPSG:4326, with latitude first and longitude next,
+      in degrees). Similarly, when using that syntax for a target CRS, output
+      values will be emitted according to the official definition of this CRS.
+    - a PROJ string, like "+proj=longlat +datum=WGS84".
+      When using that syntax, the axis order and unit for geographic CRS will
+      be longitude, latitude, and the unit degrees.
+    - more generally any string accepted by proj_obj_create_from_user_input()
+
+    An "area of use" can be specified in area. When it is supplied, the more
+    accurate transformation between two given systems can be chosen.
+
+    When more than one operation is found, and the context asks for it (see
+    proj_context_use_per_point_operations()), they are all kept, so the 4D
+    API can choose among them per coordinate (see pj_trans_candidates()).
+
+    When the context has a cache (see proj_context_set_crs_to_crs_cache_size()),
+    the result for the same arguments is a copy of the one kept in the cache,
+    made with clone_with_candidates(), skipping the CRS parsing and the
+    operation search.
+
+    Example call:
+
+        PJ *P = proj_create_crs_to_crs(0, "EPSG:25832", "EPSG:25833", NULL);
+
+******************************************************************************/
+    PJ *P;
+    char *key;
+    int generation;
+    struct pj_operation_cache **link, *entry;
+
+    if( !ctx ) {
+        ctx = pj_get_default_ctx();
+    }
+    if( ctx->operation_cache_max <= 0 || !source_crs || !target_crs ) {
+        return create_crs_to_crs(ctx, source_crs, target_crs, area);
+    }
+
+    key = operation_cache_key(ctx, source_crs, target_crs, area);
+    if( !key ) {
+        return create_crs_to_crs(ctx, source_crs, target_crs, area);
+    }
+    operation_cache_drop_stale(ctx);
+    generation = proj_get_search_generation();
+
+    /* A hit is moved to the front, and copied for the caller */
+    for( link = &ctx->operation_cache; *link; link = &(*link)->next ) {
+        entry = *link;
+        if( strcmp(entry->key, key) != 0 ) {
+            continue;
+        }
+        *link = entry->next;
+        entry->next = ctx->operation_cache;
+        ctx->operation_cache = entry;
+        pj_dealloc(key);
+        P = clone_with_candidates(entry->P, ctx);
+        if( P ) {
+            return P;
+        }
+        return create_crs_to_crs(ctx, source_crs, target_crs, area);
+    }
+
+    P = create_crs_to_crs(ctx, source_crs, target_crs, area);
+    entry = P ? pj_calloc(1, sizeof(struct pj_operation_cache)) : NULL;
+    if( !entry ) {
+        pj_dealloc(key);
+        return P;
+    }
+
+    /* The cache keeps a copy of its own, so the caller may do as it */
+    /* pleases with P */
+    entry->P = clone_with_candidates(P, ctx);
+    if( !entry->P ) {
+        pj_dealloc(entry);
+        pj_dealloc(key);
+        return P;
+    }
+    entry->key = key;
+    entry->search_generation = generation;
+    entry->next = ctx->operation_cache;
+    ctx->operation_cache = entry;
+    ctx->operation_cache_count++;
+    operation_cache_trim(ctx, ctx->operation_cache_max);
 
     return P;
 }
 
+/*****************************************************************************/
+void proj_context_set_crs_to_crs_cache_size (PJ_CONTEXT *ctx, int size) {
+/******************************************************************************
+    Keep up to size results of proj_create_crs_to_crs() in ctx, 0 for none.
+******************************************************************************/
+    if( !ctx ) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->operation_cache_max = size < 0 ? 0 : size;
+    operation_cache_trim(ctx, ctx->operation_cache_max);
+}
+
+/*****************************************************************************/
+void proj_context_use_per_point_operations (PJ_CONTEXT *ctx, int enable) {
+/******************************************************************************
+    Have proj_create_crs_to_crs() in ctx keep all the operations it finds,
+    to choose among them per coordinate, or only the best one overall.
+******************************************************************************/
+    if( !ctx ) {
+        ctx = pj_get_default_ctx();
+    }
+    ctx->per_point_operations = enable != 0;
+}
+
+/*****************************************************************************/
+PJ *proj_clone (PJ_CONTEXT *ctx, const PJ *P) {
+/******************************************************************************
+    Create a copy of P in ctx, e.g. for use in another thread.
+
+    Operations with a copy hook (PJ::copier), and the pipelines made of
+    them, are copied as they are, private data included, without being set
+    up again. The grids they use are shared with P. Other operations are
+    set up again from the parameter list of P, already parsed and with init
+    files expanded, so neither the definition nor the CRS it came from are
+    parsed again. The candidate operations of P, if made by
+    proj_create_crs_to_crs(), are copied the same way.
+
+    The copy belongs to ctx alone: it can be used in any thread using ctx,
+    independently of P, and outlive P. Neither P nor its copy may be used
+    by two threads at the same time.
+******************************************************************************/
+    if( !ctx ) {
+        ctx = pj_get_default_ctx();
+    }
+    if( !P ) {
+        proj_context_errno_set(ctx, PJD_ERR_INVALID_ARG);
+        return NULL;
+    }
+
+    return clone_with_candidates((PJ *) P, ctx);
+}
+
 PJ *proj_destroy (PJ *P) {
     pj_free (P);
     return 0;
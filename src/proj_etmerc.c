@@ -216,6 +216,23 @@ static LP e_inverse (XY xy, PJ *P) {          /* Ellipsoidal, inverse */
 }
 
 
+/* Batch versions, for proj_trans_array and proj_trans_generic */
+static void e_forward_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].xy = e_forward (coo[i].lp, P);
+}
+
+
+static void e_inverse_array (PJ_COORD *coo, size_t n, PJ *P) {
+    size_t i;
+    for (i = 0;  i < n;  i++)
+        if (HUGE_VAL != coo[i].v[0])
+            coo[i].lp = e_inverse (coo[i].xy, P);
+}
+
+
 static PJ *setup(PJ *P) { /* general initialization */
     double f, n, np, Z;
     struct pj_opaque *Q = P->opaque;
@@ -300,16 +317,24 @@ static PJ *setup(PJ *P) { /* general initialization */
     Q->Zb  = - Q->Qn*(Z + clens(Q->gtu, PROJ_ETMERC_ORDER, 2*Z));
     P->inv = e_inverse;
     P->fwd = e_forward;
+    P->inv4d_array = e_inverse_array;
+    P->fwd4d_array = e_forward_array;
     return P;
 }
 
 
 
+static PJ *copy (PJ *Q, const PJ *P) {                          /* Copy hook */
+    return pj_copy_opaque (Q, P, sizeof (struct pj_opaque));
+}
+
+
 PJ *PROJECTION(etmerc) {
     struct pj_opaque *Q = pj_calloc (1, sizeof (struct pj_opaque));
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = Q;
+    P->copier = copy;
    return setup (P);
 }
 
@@ -324,6 +349,7 @@ PJ *PROJECTION(utm) {
     if (0==Q)
         return pj_default_destructor (P, ENOMEM);
     P->opaque = Q;
+    P->copier = copy;
 
     if (P->es == 0.0) {
         proj_errno_set(P, PJD_ERR_ELLIPSOID_USE_REQUIRED);
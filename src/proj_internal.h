@@ -86,6 +86,7 @@ enum pj_io_units pj_right (PJ *P);
 PJ_COORD PROJ_DLL proj_coord_error (void);
 
 void proj_context_errno_set (PJ_CONTEXT *ctx, int err);
+PJ_CONTEXT *pj_ctx_copy (PJ_CONTEXT *src);
 void PROJ_DLL proj_context_set (PJ *P, PJ_CONTEXT *ctx);
 void proj_context_inherit (PJ *parent, PJ *child);
 
@@ -96,6 +97,34 @@ void PROJ_DLL proj_context_delete_cpp_context(struct projCppContext* cppContext)
 PJ_COORD pj_fwd4d (PJ_COORD coo, PJ *P);
 PJ_COORD pj_inv4d (PJ_COORD coo, PJ *P);
 
+/* Batch versions of the above, and their direction dispatcher */
+void pj_fwd4d_array (PJ_COORD *coo, size_t n, PJ *P);
+void pj_inv4d_array (PJ_COORD *coo, size_t n, PJ *P);
+void pj_trans_block (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord);
+
+/* Number of coordinates handled per call to pj_trans_block by the batch APIs */
+#define PJ_TRANS_BLOCK_SIZE 256
+
+/* Minimum number of coordinates per thread before the batch APIs go parallel. */
+/* Each thread then has at least a few hundred microseconds of work, against   */
+/* about 10 microseconds to start and join it, so no thread pool is kept       */
+#define PJ_TRANS_THREAD_MIN_POINTS 4096
+
+/* Run func on n work items of arg_size bytes each, in up to n threads (pj_mutex.c) */
+int PROJ_DLL pj_run_in_threads (int n, void (*func)(void *), void *args, size_t arg_size);
+
+/* Atomic operations on data shared between threads without lock (pj_mutex.c) */
+int   pj_atomic_add (volatile int *value, int delta);
+int   pj_atomic_get (volatile int *value);
+int   pj_atomic_cas (volatile int *value, int expected, int desired);
+void *pj_atomic_get_ptr (void * volatile *ptr);
+void  pj_atomic_set_ptr (void * volatile *ptr, void *value);
+void pj_free_workers (PJ *P);
+void pj_free_candidates (PJ *P);
+void pj_trans_candidates (PJ *P, PJ_DIRECTION direction, int dims, size_t n, PJ_COORD *coord);
+PJ  *pj_copy (PJ_CONTEXT *ctx, const PJ *P);
+void pj_free_operation_cache (PJ_CONTEXT *ctx);
+
 PJ_COORD PROJ_DLL pj_approx_2D_trans (PJ *P, PJ_DIRECTION direction, PJ_COORD coo);
 PJ_COORD PROJ_DLL pj_approx_3D_trans (PJ *P, PJ_DIRECTION direction, PJ_COORD coo);
 
@@ -130,6 +159,7 @@ void proj_fileapi_set (PJ *P, void *fileapi);
 
 const char * const *proj_get_searchpath(void);
 int    proj_get_path_count(void);
+int    proj_get_search_generation(void);
 
 #ifdef __cplusplus
 }
@@ -104,17 +104,28 @@
 #define proj_area_create internal_proj_area_create
 #define proj_area_destroy internal_proj_area_destroy
 #define proj_area_set_bbox internal_proj_area_set_bbox
+#define proj_clone internal_proj_clone
 #define proj_context_create internal_proj_context_create
 #define proj_context_delete_cpp_context internal_proj_context_delete_cpp_context
 #define proj_context_destroy internal_proj_context_destroy
 #define proj_context_errno internal_proj_context_errno
+#define proj_context_get_database_cache_info internal_proj_context_get_database_cache_info
 #define proj_context_get_database_metadata internal_proj_context_get_database_metadata
 #define proj_context_get_database_path internal_proj_context_get_database_path
+#define proj_context_get_grid_cache_info internal_proj_context_get_grid_cache_info
+#define proj_context_get_thread_count internal_proj_context_get_thread_count
 #define proj_context_get_use_proj4_init_rules internal_proj_context_get_use_proj4_init_rules
 #define proj_context_guess_wkt_dialect internal_proj_context_guess_wkt_dialect
 #define proj_context_set internal_proj_context_set
+#define proj_context_set_crs_to_crs_cache_size internal_proj_context_set_crs_to_crs_cache_size
+#define proj_context_set_database_cache_size internal_proj_context_set_database_cache_size
 #define proj_context_set_database_path internal_proj_context_set_database_path
+#define proj_context_set_grid_cache_size internal_proj_context_set_grid_cache_size
+#define proj_context_set_thread_count internal_proj_context_set_thread_count
+#define proj_context_use_inverse_grids internal_proj_context_use_inverse_grids
+#define proj_context_use_per_point_operations internal_proj_context_use_per_point_operations
 #define proj_context_use_proj4_init_rules internal_proj_context_use_proj4_init_rules
+#define proj_context_warm_database_cache internal_proj_context_warm_database_cache
 #define proj_coord internal_proj_coord
 #define proj_coord_error internal_proj_coord_error
 #define proj_coordoperation_get_accuracy internal_proj_coordoperation_get_accuracy
@@ -157,6 +168,7 @@
 #define proj_obj_as_proj_string internal_proj_obj_as_proj_string
 #define proj_obj_as_wkt internal_proj_obj_as_wkt
 #define proj_obj_clone internal_proj_obj_clone
+#define proj_obj_create_crs_list_from_database internal_proj_obj_create_crs_list_from_database
 #define proj_obj_create_from_database internal_proj_obj_create_from_database
 #define proj_obj_create_from_name internal_proj_obj_create_from_name
 #define proj_obj_create_from_proj_string internal_proj_obj_create_from_proj_string
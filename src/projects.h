@@ -199,6 +199,7 @@ union  PJ_COORD;
 struct geod_geodesic;
 struct pj_opaque;
 struct ARG_list;
+struct PJ_PARAM_INDEX;
 struct PJ_REGION_S;
 typedef struct PJ_REGION_S  PJ_Region;
 typedef struct ARG_list paralist;   /* parameter list */
@@ -258,13 +259,34 @@ PJ_OPERATOR:
     A function taking a PJ_COORD and a pointer-to-PJ as args, applying the
     PJ to the PJ_COORD, and returning the resulting PJ_COORD.
 
+PJ_ARRAY_OPERATOR:
+
+    A function taking an array of PJ_COORD, its length and a pointer-to-PJ
+    as args, applying the PJ to each PJ_COORD in place. Coordinates entering
+    with HUGE_VAL in their first component are left alone. Coordinates that
+    cannot be transformed leave with HUGE_VAL in any component, or have the
+    error reported through proj_errno_set, in which case pj_fwd4d_array and
+    pj_inv4d_array redo the block point by point to find them.
+
 *****************************************************************************/
 typedef    PJ       *(* PJ_CONSTRUCTOR) (PJ *);
 typedef    void     *(* PJ_DESTRUCTOR)  (PJ *, int);
+typedef    PJ       *(* PJ_COPIER)      (PJ *, const PJ *);
 typedef    PJ_COORD  (* PJ_OPERATOR)    (PJ_COORD, PJ *);
+typedef    void      (* PJ_ARRAY_OPERATOR) (PJ_COORD *, size_t, PJ *);
 /****************************************************************************/
 
 
+/* One of the candidate operations of a PJ made by proj_create_crs_to_crs,  */
+/* with the bounding box of its area of use in source and target CRS units  */
+typedef struct {
+    PJ *op;                 /* the PJ itself for the overall best operation */
+    double accuracy;        /* in metres, -1 if unknown */
+    double src_bbox[4];     /* xmin, ymin, xmax, ymax */
+    double dst_bbox[4];
+} PJ_CANDIDATE;
+
+
 
 /* base projection data structure */
 struct PJconsts {
@@ -317,8 +339,20 @@ struct PJconsts {
     PJ_OPERATOR fwd4d;
     PJ_OPERATOR inv4d;
 
+    /* Optional batch versions of the above, used by proj_trans_array and    */
+    /* proj_trans_generic. They replace only the call to the operator proper:*/
+    /* prepare and finalize steps are still handled by pj_fwd4d_array and    */
+    /* pj_inv4d_array. Operations without them are run point by point.       */
+    PJ_ARRAY_OPERATOR fwd4d_array;
+    PJ_ARRAY_OPERATOR inv4d_array;
+
     PJ_DESTRUCTOR destructor;
 
+    /* Optional copy hook, used by proj_clone. It is handed a copy of P made  */
+    /* by pj_copy(), complete but for P->opaque, which it copies. Operations  */
+    /* without it are copied by setting them up again from their parameters */
+    PJ_COPIER copier;
+
 
     /*************************************************************************************
 
@@ -402,6 +436,16 @@ struct PJconsts {
     PJ *hgridshift;
     PJ *vgridshift;
 
+    /* Private copies of this PJ, used by the worker threads of the batch APIs */
+    PJ **workers;
+    int worker_count;
+
+    /* Operations to choose from, per coordinate, in the 4D API, the PJ     */
+    /* itself handling coordinates outside of all of them. Set up by        */
+    /* proj_create_crs_to_crs                                               */
+    PJ_CANDIDATE *candidates;
+    int candidate_count;
+
 
     /*************************************************************************************
 
@@ -439,10 +483,12 @@ struct PJconsts {
     double  datum_params[7];           /* Parameters for 3PARAM and 7PARAM */
     struct _pj_gi **gridlist;          /* TODO: Description needed */
     int     gridlist_count;
+    struct _pj_grid_index *gridlist_index; /* spatial index over gridlist */
 
     int     has_geoid_vgrids;          /* TODO: Description needed */
     struct _pj_gi **vgridlist_geoid;   /* TODO: Description needed */
     int     vgridlist_geoid_count;
+    struct _pj_grid_index *vgridlist_geoid_index; /* spatial index over vgridlist_geoid */
 
     double  from_greenwich;            /* prime meridian offset (in radians) */
     double  long_wrap_center;          /* 0.0 for -180 to 180, actually in radians*/
@@ -478,6 +524,7 @@ struct PJconsts {
 /* Parameter list (a copy of the +proj=... etc. parameters) */
 struct ARG_list {
     paralist *next;
+    struct PJ_PARAM_INDEX *index; /* lookup table, on the first element of indexed lists */
     char used;
 #if defined(__GNUC__) && __GNUC__ >= 8
     char param[]; /* variable-length member */
@@ -589,6 +636,10 @@ struct projFileAPI_t;
 
 struct projCppContext;
 
+struct pj_grid_tile;
+
+struct pj_operation_cache;
+
 /* proj thread context */
 struct projCtx_t {
     int     last_errno;
@@ -599,6 +650,19 @@ struct projCtx_t {
     struct projCppContext* cpp_context; /* internal context for C++ code */
     int     use_proj4_init_rules; /* -1 = unknown, 0 = no, 1 = yes */
     int     epsg_file_exists; /* -1 = unknown, 0 = no, 1 = yes */
+    int     thread_count; /* max. number of threads used by the batch APIs */
+    int     grid_tiling; /* -1 = by grid size, 0 = never, 1 = always */
+    struct pj_grid_tile *grid_tiles; /* tiles of grid data read on demand, most recently used first */
+    int     grid_tile_count;
+    int     grid_tile_generation;
+    unsigned long grid_cache_hits;      /* grid rows found in memory */
+    unsigned long grid_cache_misses;    /* grid data read from file */
+    unsigned long grid_cache_evictions; /* grid data dropped to make room */
+    int     use_inverse_grids; /* 1 = precomputed inverse grid shifts, 0 = iterate */
+    struct pj_operation_cache *operation_cache; /* PJs made by proj_create_crs_to_crs, most recently used first */
+    int     operation_cache_count;
+    int     operation_cache_max; /* 0 = no cache */
+    int     per_point_operations; /* 1 = proj_create_crs_to_crs keeps all operations found */
 };
 
 /* classic public API */
@@ -676,8 +740,27 @@ typedef struct _pj_gi {
 
     struct _pj_gi *next;
     struct _pj_gi *child;
+    struct _pj_grid_index *child_index; /* spatial index over the children */
+
+    int    ref_count;   /* held by the grid registry and each grid list */
+    size_t data_size;   /* bytes of grid data loaded, ct->cvs and inverse */
+    FLP   *inverse;     /* inverse shifts at the nodes, see pj_gridinfo_inverse() */
+    int    last_used;   /* when last released by a grid list, for eviction */
+    int    over_budget; /* cache generation in which the data did not fit */
 } PJ_GRIDINFO;
 
+typedef struct _pj_grid_index PJ_GRID_INDEX;
+
+/* flags for pj_gridlist_find() */
+#define PJ_GRID_FIND_TOLERANT   1  /* accept points slightly off the grid edges */
+#define PJ_GRID_FIND_LAST       2  /* use the last listed grid that applies, not the first */
+
+/* A cell of a grid: its lower left node, and the values at its corners */
+typedef struct {
+    ILP indx;
+    FLP f00, f10, f01, f11;
+} PJ_GRID_CELL;
+
 typedef struct {
     PJ_Region region;
     int  priority;      /* higher used before lower */
@@ -711,6 +794,11 @@ PROJVALUE PROJ_DLL pj_param(projCtx ctx, paralist *, const char *);
 paralist PROJ_DLL *pj_param_exists (paralist *list, const char *parameter);
 paralist PROJ_DLL *pj_mkparam(const char *);
 paralist *pj_mkparam_ws (const char *str);
+paralist PROJ_DLL *pj_param_lookup (paralist *list, const char *name, size_t length);
+int      PROJ_DLL pj_param_index_create (paralist *list);
+void     PROJ_DLL pj_param_index_free (paralist *list);
+
+const struct PJ_LIST PROJ_DLL *pj_find_operation (const char *id);
 
 
 int PROJ_DLL pj_ell_set(projCtx ctx, paralist *, double *, double *);
@@ -720,10 +808,25 @@ int pj_angular_units_set(paralist *, PJ *);
 paralist *pj_clone_paralist( const paralist* );
 paralist *pj_search_initcache( const char *filekey );
 void      pj_insert_initcache( const char *filekey, const paralist *list);
+
+/* Maximum length of the lines of init files */
+#define PJ_INIT_LINE_LENGTH 1000
+
+struct INIT_FILE;
+const char PROJ_DLL *pj_find_init_section( projCtx ctx, const char *name,
+                                           const char *section, size_t *size,
+                                           struct INIT_FILE **file );
+void PROJ_DLL pj_release_init_file( struct INIT_FILE *file );
+char PROJ_DLL *pj_init_file_gets( char *line, int size, const char *contents,
+                                  size_t contents_size, size_t *offset );
 paralist *pj_expand_init(projCtx ctx, paralist *init);
 
 void     *pj_dealloc_params (projCtx ctx, paralist *start, int errlev);
 
+PAFile    pj_open_lib_ex( projCtx ctx, const char *name, const char *mode,
+                          char *out_full_filename,
+                          size_t out_full_filename_size );
+
 
 double *pj_enfn(double);
 double  pj_mlfn(double, double, double, double *);
@@ -767,8 +870,12 @@ int      bchgen(projUV, projUV, int, int, projUV **, projUV(*)(projUV));
 int      bch2bps(projUV, projUV, projUV **, int, int);
 
 /* nadcon related protos */
-LP             nad_intr(LP, struct CTABLE *);
-LP             nad_cvt(LP, int, struct CTABLE *);
+int            nad_cell_index(const struct CTABLE *, LP, ILP *indx, LP *frct);
+int            nad_cell(projCtx ctx, PJ_GRIDINFO *, ILP indx, PJ_GRID_CELL *);
+LP             nad_cell_value(const PJ_GRID_CELL *, LP frct);
+LP             nad_intr(projCtx ctx, LP, PJ_GRIDINFO *);
+LP             nad_cvt(projCtx ctx, LP, int, PJ_GRIDINFO *);
+LP             nad_inverse(projCtx ctx, LP, PJ_GRIDINFO *);
 struct CTABLE *nad_init(projCtx ctx, char *);
 struct CTABLE *nad_ctable_init( projCtx ctx, PAFile fid );
 int            nad_ctable_load( projCtx ctx, struct CTABLE *, PAFile fid );
@@ -781,6 +888,7 @@ void           nad_free(struct CTABLE *);
 int pj_apply_vgridshift( PJ *defn, const char *listname,
                          PJ_GRIDINFO ***gridlist_p,
                          int *gridlist_count_p,
+                         PJ_GRID_INDEX **index_p,
                          int inverse,
                          long point_count, int point_offset,
                          double *x, double *y, double *z );
@@ -789,15 +897,32 @@ int pj_apply_gridshift_2( PJ *defn, int inverse,
                           double *x, double *y, double *z );
 int pj_apply_gridshift_3( projCtx ctx,
                           PJ_GRIDINFO **gridlist, int gridlist_count,
+                          PJ_GRID_INDEX **index_p,
                           int inverse, long point_count, int point_offset,
                           double *x, double *y, double *z );
 
 PJ_GRIDINFO **pj_gridlist_from_nadgrids( projCtx, const char *, int * );
+void         pj_gridlist_free( PJ_GRIDINFO **gridlist, int grid_count );
+PJ_GRIDINFO **pj_gridlist_copy( projCtx, PJ_GRIDINFO **gridlist, int grid_count );
+void         pj_gridinfo_release( PJ_GRIDINFO * );
+PJ_GRIDINFO *pj_gridlist_evictable( void );
+PJ_GRID_INDEX PROJ_DLL *pj_gridlist_index( PJ_GRIDINFO **grids, int grid_count );
+void PROJ_DLL pj_gridlist_index_free( PJ_GRID_INDEX * );
+PJ_GRIDINFO PROJ_DLL *pj_gridlist_find( PJ_GRID_INDEX **index_p,
+                                        PJ_GRIDINFO **grids, int grid_count,
+                                        LP input, int flags );
 void PROJ_DLL pj_deallocate_grids();
 
 PJ_GRIDINFO *pj_gridinfo_init( projCtx, const char * );
 int          pj_gridinfo_load( projCtx, PJ_GRIDINFO * );
+int          pj_gridinfo_prepare( projCtx, PJ_GRIDINFO * );
+void        *pj_gridinfo_row( projCtx, PJ_GRIDINFO *, int row );
 void         pj_gridinfo_free( projCtx, PJ_GRIDINFO * );
+FLP         *pj_gridinfo_inverse( projCtx, PJ_GRIDINFO * );
+size_t PROJ_DLL pj_gridinfo_memory_used( void );
+void         pj_gridinfo_set_cache_size( projCtx, size_t );
+size_t       pj_gridinfo_get_cache_size( void );
+void         pj_gridinfo_free_tiles( projCtx );
 
 PJ_GridCatalog *pj_gc_findcatalog( projCtx, const char * );
 PJ_GridCatalog *pj_gc_readcatalog( projCtx, const char * );
@@ -829,6 +954,8 @@ extern char const PROJ_DLL pj_release[];
 struct PJ_DATUMS           PROJ_DLL *pj_get_datums_ref( void );
 
 void *pj_default_destructor (PJ *P, int errlev);
+PJ   *pj_default_copier (PJ *Q, const PJ *P);
+PJ   *pj_copy_opaque (PJ *Q, const PJ *P, size_t size);
 
 double PROJ_DLL pj_atof( const char* nptr );
 double pj_strtod( const char *nptr, char **endptr );
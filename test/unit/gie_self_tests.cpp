@@ -38,6 +38,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -227,6 +228,769 @@ TEST(gie, cart_selftest) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, proj_trans_array_batch_kernels) {
+    /* The batch path must give the same results as proj_trans, both for  */
+    /* operations with batch kernels and for those falling back to the   */
+    /* scalar path, and over more than one block of coordinates           */
+    const char *const defs[] = {
+        "+proj=pipeline +step +proj=axisswap +order=2,1 +step "
+        "+proj=unitconvert +xy_in=deg +xy_out=rad +step +proj=cart "
+        "+ellps=GRS80 +step +proj=helmert +x=10 +y=3 +z=1 +rx=0.1 +ry=0.2 "
+        "+rz=0.3 +s=1.5 +convention=position_vector +step +proj=cart "
+        "+ellps=GRS80 +inv +step +proj=utm +zone=32 +ellps=GRS80",
+        "+proj=merc +ellps=GRS80",
+        "+proj=merc +R=6400000",
+        "+proj=tmerc +ellps=GRS80 +lon_0=9",
+        "+proj=lcc +lat_1=40 +lat_2=50 +lat_0=45 +ellps=GRS80",
+        "+proj=robin"};
+    const size_t n = 3 * PJ_TRANS_BLOCK_SIZE + 17;
+
+    for (const char *def : defs) {
+        PJ *P = proj_create(PJ_DEFAULT_CTX, def);
+        ASSERT_TRUE(P != nullptr) << def;
+        const bool degrees = strstr(def, "axisswap") != nullptr;
+
+        std::vector<PJ_COORD> in(n), out(n), generic(n);
+        for (size_t i = 0; i < n; i++) {
+            double lon = 5 + 8.0 * i / n;
+            double lat = 40 + 15.0 * i / n;
+            in[i] = degrees ? proj_coord(lat, lon, 100, 2000)
+                            : proj_coord(proj_torad(lon), proj_torad(lat),
+                                         100, 2000);
+        }
+
+        out = in;
+        proj_errno_reset(P);
+        ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out.data()), 0) << def;
+
+        generic = in;
+        size_t sz = sizeof(PJ_COORD);
+        ASSERT_EQ(proj_trans_generic(P, PJ_FWD, &(generic[0].xyzt.x), sz, n,
+                                     &(generic[0].xyzt.y), sz, n,
+                                     &(generic[0].xyzt.z), sz, n,
+                                     &(generic[0].xyzt.t), sz, n),
+                  n);
+
+        for (size_t i = 0; i < n; i++) {
+            PJ_COORD expected = proj_trans(P, PJ_FWD, in[i]);
+            for (int j = 0; j < 4; j++) {
+                EXPECT_EQ(out[i].v[j], expected.v[j]) << def << " " << i;
+                EXPECT_EQ(generic[i].v[j], expected.v[j]) << def << " " << i;
+            }
+        }
+
+        /* And back again */
+        ASSERT_EQ(proj_trans_array(P, PJ_INV, n, out.data()), 0) << def;
+        for (size_t i = 0; i < n; i++) {
+            PJ_COORD expected = proj_trans(P, PJ_INV, generic[i]);
+            for (int j = 0; j < 4; j++)
+                EXPECT_EQ(out[i].v[j], expected.v[j]) << def << " " << i;
+        }
+
+        proj_destroy(P);
+    }
+
+    /* Failed coordinates are flagged individually, and reported, also when */
+    /* the operation only reports the failure through errno                 */
+    const struct {
+        const char *def;
+        double lon, lat; /* degrees, for a point the operation rejects */
+    } failures[] = {{"+proj=merc +ellps=GRS80", 12, 90},
+                    {"+proj=tmerc +R=6400000", 90, 0},
+                    {"+proj=lcc +lat_1=40 +lat_2=50 +ellps=GRS80", 12, -90}};
+    for (const auto &failure : failures) {
+        PJ *P = proj_create(PJ_DEFAULT_CTX, failure.def);
+        ASSERT_TRUE(P != nullptr) << failure.def;
+        std::vector<PJ_COORD> coord(PJ_TRANS_BLOCK_SIZE);
+        for (size_t i = 0; i < coord.size(); i++)
+            coord[i] = proj_coord(proj_torad(1 + 0.01 * i),
+                                  proj_torad(50 + 0.01 * i), 0, 0);
+        coord[1] = proj_coord(proj_torad(failure.lon),
+                              proj_torad(failure.lat), 0, 0);
+        auto in = coord;
+        EXPECT_NE(proj_trans_array(P, PJ_FWD, coord.size(), coord.data()), 0)
+            << failure.def;
+        for (size_t i = 0; i < coord.size(); i++) {
+            PJ_COORD expected = proj_trans(P, PJ_FWD, in[i]);
+            EXPECT_EQ(coord[i].xy.x, i == 1 ? HUGE_VAL : expected.xy.x)
+                << failure.def << " " << i;
+            EXPECT_EQ(coord[i].xy.y, i == 1 ? HUGE_VAL : expected.xy.y)
+                << failure.def << " " << i;
+        }
+        proj_errno_reset(P);
+        proj_destroy(P);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_trans_generic_multithreaded) {
+    /* Splitting the work over several threads must give the same results */
+    /* as the single threaded case, also for time dependent operations     */
+    PJ_CONTEXT *ctx = proj_context_create();
+    EXPECT_EQ(proj_context_get_thread_count(ctx), 1);
+    proj_context_set_thread_count(ctx, 0);
+    EXPECT_EQ(proj_context_get_thread_count(ctx), 1);
+    proj_context_set_thread_count(ctx, 4);
+    EXPECT_EQ(proj_context_get_thread_count(ctx), 4);
+
+    PJ *P = proj_create(
+        ctx, "+proj=pipeline +step +proj=cart +ellps=GRS80 +step "
+             "+proj=helmert +x=0.1 +y=0.2 +z=0.3 +dx=0.01 +dy=0.02 +dz=0.03 "
+             "+s=0.001 +ds=0.0001 +t_epoch=2010 +convention=position_vector "
+             "+step +proj=cart +ellps=GRS80 +inv +step +proj=utm +zone=32 "
+             "+ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+
+    const size_t n = 4 * PJ_TRANS_THREAD_MIN_POINTS + 123;
+    std::vector<PJ_COORD> in(n), out(n);
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; i++) {
+        double lon = 5 + 8.0 * i / n;
+        double lat = 40 + 15.0 * i / n;
+        in[i] = proj_coord(proj_torad(lon), proj_torad(lat), 100,
+                           2000 + 20.0 * i / n);
+        x[i] = in[i].xyzt.x;
+        y[i] = in[i].xyzt.y;
+    }
+
+    out = in;
+    ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out.data()), 0);
+
+    /* Constant height and time, broadcast along x and y */
+    double z = 100, t = 2015;
+    ASSERT_EQ(proj_trans_generic(P, PJ_FWD, x.data(), sizeof(double), n,
+                                 y.data(), sizeof(double), n, &z, 0, 1, &t, 0,
+                                 1),
+              n);
+
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD expected = proj_trans(P, PJ_FWD, in[i]);
+        for (int j = 0; j < 4; j++)
+            EXPECT_EQ(out[i].v[j], expected.v[j]) << i;
+
+        PJ_COORD c = in[i];
+        c.xyzt.z = 100;
+        c.xyzt.t = 2015;
+        expected = proj_trans(P, PJ_FWD, c);
+        EXPECT_EQ(x[i], expected.xyzt.x) << i;
+        EXPECT_EQ(y[i], expected.xyzt.y) << i;
+        if (i == n - 1) {
+            EXPECT_EQ(z, expected.xyzt.z);
+        }
+    }
+
+    /* Errors from worker threads are reported through P */
+    out = in;
+    out[n - 1] = proj_coord(proj_torad(12), proj_torad(90), 0, 0);
+    PJ *M = proj_create(ctx, "+proj=merc +ellps=GRS80");
+    ASSERT_TRUE(M != nullptr);
+    EXPECT_NE(proj_trans_array(M, PJ_FWD, n, out.data()), 0);
+    EXPECT_NE(proj_errno(M), 0);
+    EXPECT_NE(out[0].xy.x, HUGE_VAL);
+    EXPECT_EQ(out[n - 1].xy.x, HUGE_VAL);
+
+    proj_destroy(M);
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
+static std::string temp_file(const char *name) {
+    const char *temp = getenv("TEMP");
+    if (!temp) {
+        temp = getenv("TMP");
+    }
+    if (!temp) {
+        temp = "/tmp";
+    }
+    return std::string(temp) + "/" + name;
+}
+
+static void put_bytes(std::string &out, const void *data, size_t size,
+                      bool big_endian) {
+    const int one = 1;
+    bool swap = (*(const char *)&one == 1) == big_endian;
+    const char *p = static_cast<const char *>(data);
+    for (size_t i = 0; i < size; i++)
+        out += swap ? p[size - 1 - i] : p[i];
+}
+
+static bool write_file(const std::string &name, const std::string &data) {
+    FILE *f = fopen(name.c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+// ---------------------------------------------------------------------------
+
+static int counted_fopen_calls = 0;
+
+static PAFile counting_fopen(projCtx ctx, const char *filename,
+                             const char *access) {
+    counted_fopen_calls++;
+    return pj_get_default_fileapi()->FOpen(ctx, filename, access);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, grid_tiles) {
+    /* Grids read in tiles on demand must give the same results as grids */
+    /* loaded completely, for horizontal and vertical grids alike        */
+    const int cols = 1100, rows = 30;
+    const std::string hgrid = temp_file("proj_test_tiles.ct2");
+    const std::string vgrid = temp_file("proj_test_tiles.gtx");
+    std::string temp_dir = temp_file("");
+    temp_dir.pop_back();
+
+    std::string ct2(160, '\0'), gtx;
+    double ll_lam = proj_torad(-10), ll_phi = proj_torad(40);
+    double del = proj_torad(0.01);
+    ct2.replace(0, 9, "CTABLE V2");
+    std::string header;
+    put_bytes(header, &ll_lam, 8, false);
+    put_bytes(header, &ll_phi, 8, false);
+    put_bytes(header, &del, 8, false);
+    put_bytes(header, &del, 8, false);
+    put_bytes(header, &cols, 4, false);
+    put_bytes(header, &rows, 4, false);
+    ct2.replace(96, header.size(), header);
+
+    double gtx_header[4] = {40, -10, 0.01, 0.01};
+    for (int i = 0; i < 4; i++)
+        put_bytes(gtx, &gtx_header[i], 8, true);
+    put_bytes(gtx, &rows, 4, true);
+    put_bytes(gtx, &cols, 4, true);
+
+    for (unsigned i = 0; i < rows * cols; i++) {
+        float shift[2] = {(float)(1e-7 * ((i * 7919) % 101)),
+                          (float)(1e-7 * ((i * 104729) % 97))};
+        put_bytes(ct2, &shift[0], 4, false);
+        put_bytes(ct2, &shift[1], 4, false);
+        float height = (float)((i * 31) % 211) / 10;
+        put_bytes(gtx, &height, 4, true);
+    }
+    ASSERT_TRUE(write_file(hgrid, ct2));
+    ASSERT_TRUE(write_file(vgrid, gtx));
+
+    /* Found through the search path */
+    const char *search_path[] = {temp_dir.c_str()};
+    pj_set_searchpath(1, search_path);
+    std::string def = "+proj=pipeline +step +proj=hgridshift "
+                      "+grids=proj_test_tiles.ct2 +step +proj=vgridshift "
+                      "+grids=proj_test_tiles.gtx";
+    std::vector<PJ_COORD> in;
+    for (int i = 0; i < 500; i++)
+        in.push_back(proj_coord(proj_torad(-9.99 + 10.9 * ((i * 37) % 500) / 500),
+                                proj_torad(40.01 + 0.27 * i / 500), 10, 0));
+
+    /* The tiled context goes first, as it would use the loaded grids. */
+    /* Once the grids are found, reading tiles opens their files right  */
+    /* away, without searching them again                               */
+    PJ_CONTEXT *ctx[2] = {proj_context_create(), proj_context_create()};
+    projFileAPI counting_fileapi = *pj_get_default_fileapi();
+    counting_fileapi.FOpen = counting_fopen;
+    pj_ctx_set_fileapi(ctx[0], &counting_fileapi);
+    std::vector<PJ_COORD> out[2][2];
+    for (int k = 0; k < 2; k++) {
+        proj_context_set_grid_tiling(ctx[k], k == 0);
+        PJ *P = proj_create(ctx[k], def.c_str());
+        ASSERT_TRUE(P != nullptr);
+        counted_fopen_calls = 0;
+        for (int dir = 0; dir < 2; dir++) {
+            for (const auto &c : in)
+                out[k][dir].push_back(
+                    proj_trans(P, dir == 0 ? PJ_FWD : PJ_INV, c));
+        }
+        EXPECT_EQ(proj_errno(P), 0);
+        if (k == 0) {
+            EXPECT_EQ(counted_fopen_calls,
+                      (int)proj_context_get_grid_cache_info(ctx[0]).misses);
+        }
+        proj_destroy(P);
+    }
+    pj_set_searchpath(0, nullptr);
+    EXPECT_GT(ctx[0]->grid_tile_count, 2);
+    EXPECT_EQ(ctx[1]->grid_tile_count, 0);
+
+    for (int dir = 0; dir < 2; dir++) {
+        for (size_t i = 0; i < in.size(); i++) {
+            for (int j = 0; j < 3; j++)
+                EXPECT_EQ(out[0][dir][i].v[j], out[1][dir][i].v[j]) << i;
+            EXPECT_NE(out[0][dir][i].v[0], in[i].v[0]) << i;
+            EXPECT_NE(out[0][dir][i].v[2], in[i].v[2]) << i;
+        }
+    }
+
+    proj_context_destroy(ctx[0]);
+    proj_context_destroy(ctx[1]);
+    pj_deallocate_grids();
+    remove(hgrid.c_str());
+    remove(vgrid.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+static bool write_ctable2(const std::string &name, double ll_lon,
+                          double ll_lat, double step, int cols, int rows) {
+    std::string ct2(160, '\0'), header;
+    double ll_lam = proj_torad(ll_lon), ll_phi = proj_torad(ll_lat);
+    double del = proj_torad(step);
+    ct2.replace(0, 9, "CTABLE V2");
+    put_bytes(header, &ll_lam, 8, false);
+    put_bytes(header, &ll_phi, 8, false);
+    put_bytes(header, &del, 8, false);
+    put_bytes(header, &del, 8, false);
+    put_bytes(header, &cols, 4, false);
+    put_bytes(header, &rows, 4, false);
+    ct2.replace(96, header.size(), header);
+    for (unsigned i = 0; i < (unsigned)(rows * cols); i++) {
+        float shift[2] = {(float)(1e-6 * (i % 13)), (float)(1e-6 * (i % 7))};
+        put_bytes(ct2, &shift[0], 4, false);
+        put_bytes(ct2, &shift[1], 4, false);
+    }
+    return write_file(name, ct2);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, grid_registry) {
+    /* Grids are shared by all threads and contexts, and live on as long */
+    /* as some operation uses them, even past pj_deallocate_grids()      */
+    const int cols = 60, rows = 40;
+    const std::string hgrid = temp_file("proj_test_registry.ct2");
+    ASSERT_TRUE(write_ctable2(hgrid, 2, 48, 0.1, cols, rows));
+
+    pj_deallocate_grids();
+    EXPECT_EQ(pj_gridinfo_memory_used(), 0U);
+
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_context_set_thread_count(ctx, 8);
+    std::string def = "+proj=hgridshift +grids=" + hgrid;
+    PJ *P = proj_create(ctx, def.c_str());
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> in, out;
+    for (int i = 0; i < 20000; i++)
+        in.push_back(proj_coord(proj_torad(2.05 + 5.8 * ((i * 37) % 20000) / 20000),
+                                proj_torad(48.05 + 3.8 * i / 20000), 0, 0));
+
+    /* each worker thread sets up its own grid list */
+    for (int k = 0; k < 2; k++) {
+        out = in;
+        proj_trans_generic(P, PJ_FWD, &out[0].xyzt.x, sizeof(PJ_COORD),
+                           out.size(), &out[0].xyzt.y, sizeof(PJ_COORD),
+                           out.size(), nullptr, 0, 0, nullptr, 0, 0);
+        EXPECT_EQ(proj_errno(P), 0);
+        for (size_t i = 0; i < in.size(); i += 97) {
+            PJ_COORD c = proj_trans(P, PJ_FWD, in[i]);
+            EXPECT_EQ(out[i].lp.lam, c.lp.lam) << i;
+            EXPECT_EQ(out[i].lp.phi, c.lp.phi) << i;
+            EXPECT_NE(out[i].lp.lam, in[i].lp.lam) << i;
+        }
+
+        /* loaded once, and kept by P after the registry is emptied */
+        EXPECT_EQ(pj_gridinfo_memory_used(), cols * rows * sizeof(FLP));
+        pj_deallocate_grids();
+    }
+
+    proj_destroy(P);
+    EXPECT_EQ(pj_gridinfo_memory_used(), 0U);
+    proj_context_destroy(ctx);
+    remove(hgrid.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, grid_cache_size) {
+    /* Over the cache size, unused grids are evicted, and grids that still */
+    /* do not fit are read in tiles, with the same results                */
+    const int cols = 40, rows = 30;
+    const size_t grid_size = cols * rows * sizeof(FLP);
+    std::string names[3];
+    for (int g = 0; g < 3; g++) {
+        names[g] = temp_file(("proj_test_cache" + std::to_string(g) + ".ct2")
+                                 .c_str());
+        ASSERT_TRUE(write_ctable2(names[g], 10 * g, 40, 0.1, cols, rows));
+    }
+
+    pj_deallocate_grids();
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_context_set_grid_cache_size(ctx, 2 * grid_size + grid_size / 2);
+    PJ_GRID_CACHE_INFO info = proj_context_get_grid_cache_info(ctx);
+    EXPECT_EQ(info.size, 0U);
+    EXPECT_EQ(info.max_size, 2 * grid_size + grid_size / 2);
+
+    PJ *P[4];
+    PJ_COORD c[4];
+    for (int g = 0; g < 4; g++) {
+        P[g] = proj_create(ctx, ("+proj=hgridshift +grids=" + names[g % 3])
+                                    .c_str());
+        ASSERT_TRUE(P[g] != nullptr);
+        c[g] = proj_trans(P[g], PJ_FWD,
+                          proj_coord(proj_torad(10 * (g % 3) + 1.55),
+                                     proj_torad(41.25), 0, 0));
+        EXPECT_EQ(proj_errno(P[g]), 0);
+
+        info = proj_context_get_grid_cache_info(ctx);
+        if (g < 2)
+            EXPECT_EQ(info.size, (g + 1) * grid_size);
+        else
+            EXPECT_EQ(info.size, 2 * grid_size);
+
+        /* the first grid is unused when the third one is loaded */
+        if (g == 1) {
+            proj_destroy(P[0]);
+            P[0] = nullptr;
+        }
+    }
+
+    /* the first grid was evicted for the third one, and then read in    */
+    /* tiles, as the others are in use                                    */
+    EXPECT_GE(info.evictions, 1U);
+    EXPECT_EQ(info.misses, 3U + 1U);
+    EXPECT_GT(info.hits, 0U);
+    EXPECT_EQ(ctx->grid_tile_count, 1);
+    EXPECT_EQ(c[3].lp.lam, c[0].lp.lam);
+    EXPECT_EQ(c[3].lp.phi, c[0].lp.phi);
+    EXPECT_NE(c[3].lp.lam, proj_torad(1.55));
+
+    /* Grids in use are exempt from the limit: lowering it below their */
+    /* size leaves them loaded, and they go once they are unused       */
+    const unsigned long evictions = info.evictions;
+    proj_context_set_grid_cache_size(ctx, grid_size / 2);
+    info = proj_context_get_grid_cache_info(ctx);
+    EXPECT_EQ(info.size, 2 * grid_size);
+    EXPECT_EQ(info.evictions, evictions);
+    PJ_COORD d = proj_trans(
+        P[1], PJ_FWD, proj_coord(proj_torad(11.55), proj_torad(41.25), 0, 0));
+    EXPECT_EQ(d.lp.lam, c[1].lp.lam);
+    EXPECT_EQ(d.lp.phi, c[1].lp.phi);
+    EXPECT_EQ(proj_context_get_grid_cache_info(ctx).misses, info.misses);
+
+    proj_destroy(P[1]);
+    P[1] = nullptr;
+    proj_context_set_grid_cache_size(ctx, grid_size / 2);
+    info = proj_context_get_grid_cache_info(ctx);
+    EXPECT_EQ(info.size, grid_size);
+    EXPECT_EQ(info.evictions, evictions + 1);
+
+    proj_context_set_grid_cache_size(ctx, 0);
+    for (int g = 1; g < 4; g++)
+        proj_destroy(P[g]);
+    pj_deallocate_grids();
+    EXPECT_EQ(proj_context_get_grid_cache_info(ctx).size, 0U);
+    proj_context_destroy(ctx);
+    for (int g = 0; g < 3; g++)
+        remove(names[g].c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, inverse_grid_shift) {
+    /* The inverse shift undoes the forward one, and the precomputed     */
+    /* inverse shifts come close to it                                   */
+    const int cols = 50, rows = 40;
+    const std::string hgrid = temp_file("proj_test_inverse.ct2");
+    ASSERT_TRUE(write_ctable2(hgrid, 2, 48, 0.1, cols, rows));
+
+    pj_deallocate_grids();
+    PJ_CONTEXT *ctx = proj_context_create();
+    PJ *P = proj_create(ctx, ("+proj=hgridshift +grids=" + hgrid).c_str());
+    ASSERT_TRUE(P != nullptr);
+
+    std::vector<PJ_COORD> in, exact;
+    for (int i = 0; i < 2000; i++)
+        in.push_back(proj_coord(proj_torad(2.05 + 4.8 * ((i * 37) % 2000) / 2000),
+                                proj_torad(48.05 + 3.8 * i / 2000), 0, 0));
+    for (const auto &c : in) {
+        PJ_COORD fwd = proj_trans(P, PJ_FWD, c);
+        PJ_COORD inv = proj_trans(P, PJ_INV, fwd);
+        EXPECT_NEAR(inv.lp.lam, c.lp.lam, 1e-11);
+        EXPECT_NEAR(inv.lp.phi, c.lp.phi, 1e-11);
+        exact.push_back(proj_trans(P, PJ_INV, c));
+    }
+    EXPECT_EQ(pj_gridinfo_memory_used(), cols * rows * sizeof(FLP));
+
+    proj_context_use_inverse_grids(ctx, 1);
+    for (size_t i = 0; i < in.size(); i++) {
+        PJ_COORD inv = proj_trans(P, PJ_INV, in[i]);
+        EXPECT_EQ(proj_errno(P), 0);
+        EXPECT_NEAR(inv.lp.lam, exact[i].lp.lam, 2e-7) << i;
+        EXPECT_NEAR(inv.lp.phi, exact[i].lp.phi, 2e-7) << i;
+    }
+    EXPECT_EQ(pj_gridinfo_memory_used(), 2 * cols * rows * sizeof(FLP));
+
+    /* exact at the nodes */
+    PJ_COORD node = proj_coord(proj_torad(2.5), proj_torad(49), 0, 0);
+    PJ_COORD inv = proj_trans(P, PJ_INV, node);
+    proj_context_use_inverse_grids(ctx, 0);
+    PJ_COORD ref = proj_trans(P, PJ_INV, node);
+    EXPECT_NEAR(inv.lp.lam, ref.lp.lam, 1e-12);
+    EXPECT_NEAR(inv.lp.phi, ref.lp.phi, 1e-12);
+    proj_destroy(P);
+
+    /* longitudes shifted across the antimeridian are wrapped like the */
+    /* iterated ones, also where nothing else wraps them                */
+    const std::string antimeridian = temp_file("proj_test_inverse_am.ct2");
+    ASSERT_TRUE(write_ctable2(antimeridian, 179.5, 48, 0.1, 10, 10));
+    projPJ src = pj_init_plus_ctx(ctx, "+proj=longlat +datum=WGS84");
+    projPJ dst = pj_init_plus_ctx(
+        ctx, ("+proj=longlat +ellps=WGS84 +nadgrids=" + antimeridian).c_str());
+    ASSERT_TRUE(src != nullptr);
+    ASSERT_TRUE(dst != nullptr);
+    double lam[2], phi[2];
+    for (int k = 0; k < 2; k++) {
+        proj_context_use_inverse_grids(ctx, k);
+        double z = 0;
+        lam[k] = M_PI - 1e-9;
+        phi[k] = proj_torad(48.25);
+        EXPECT_EQ(pj_transform(src, dst, 1, 1, &lam[k], &phi[k], &z), 0);
+    }
+    EXPECT_LT(lam[0], 0);
+    EXPECT_NEAR(lam[1], lam[0], 2e-7);
+    EXPECT_NEAR(phi[1], phi[0], 2e-7);
+    pj_free(src);
+    pj_free(dst);
+
+    pj_deallocate_grids();
+    EXPECT_EQ(pj_gridinfo_memory_used(), 0U);
+    proj_context_destroy(ctx);
+    remove(hgrid.c_str());
+    remove(antimeridian.c_str());
+}
+
+// ---------------------------------------------------------------------------
+
+static bool grid_has_point(const PJ_GRIDINFO *gi, LP lp, bool tolerant) {
+    const struct CTABLE *ct = gi->ct;
+    double epsilon =
+        tolerant ? (fabs(ct->del.phi) + fabs(ct->del.lam)) / 10000.0 : 0.0;
+    return !(ct->ll.phi - epsilon > lp.phi || ct->ll.lam - epsilon > lp.lam ||
+             ct->ll.phi + (ct->lim.phi - 1) * ct->del.phi + epsilon < lp.phi ||
+             ct->ll.lam + (ct->lim.lam - 1) * ct->del.lam + epsilon < lp.lam);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, gridlist_find) {
+    /* The indexed lookup must give the grid a scan of the list would give */
+    std::vector<struct CTABLE> tables(64);
+    std::vector<PJ_GRIDINFO> grids(tables.size());
+    std::vector<PJ_GRIDINFO *> list;
+    for (unsigned i = 0; i < tables.size(); i++) {
+        struct CTABLE *ct = &tables[i];
+        memset(ct, 0, sizeof(*ct));
+        memset(&grids[i], 0, sizeof(grids[i]));
+        ct->del.lam = 0.001 * (1 + i % 3);
+        ct->del.phi = 0.001 * (1 + i % 2);
+        ct->ll.lam = 0.01 * ((i * 37) % 50);
+        ct->ll.phi = 0.01 * ((i * 53) % 40);
+        ct->lim.lam = 2 + (i * 11) % 60;
+        ct->lim.phi = 2 + (i * 7) % 40;
+        grids[i].ct = ct;
+        if (i < 48)
+            list.push_back(&grids[i]);
+    }
+    /* the others are nested children of the first grids */
+    for (unsigned i = 48; i < tables.size(); i++) {
+        PJ_GRIDINFO *parent = &grids[(i - 48) % 4];
+        tables[i].ll.lam = parent->ct->ll.lam + 0.002 * (i % 5);
+        tables[i].ll.phi = parent->ct->ll.phi + 0.002 * (i % 3);
+        grids[i].next = parent->child;
+        parent->child = &grids[i];
+    }
+    for (int i = 0; i < 4; i++) {
+        std::vector<PJ_GRIDINFO *> children;
+        for (PJ_GRIDINFO *c = grids[i].child; c; c = c->next)
+            children.push_back(c);
+        grids[i].child_index =
+            pj_gridlist_index(children.data(), (int)children.size());
+    }
+
+    PJ_GRID_INDEX *index = nullptr;
+    for (int flags = 0; flags < 4; flags++) {
+        bool tolerant = (flags & PJ_GRID_FIND_TOLERANT) != 0;
+        for (int i = 0; i < 20000; i++) {
+            LP lp;
+            lp.lam = -0.05 + 1.2 * ((i * 7919) % 20000) / 20000;
+            lp.phi = -0.05 + 1.0 * ((i * 104729) % 20000) / 20000;
+
+            PJ_GRIDINFO *expected = nullptr;
+            for (size_t k = 0; k < list.size(); k++) {
+                PJ_GRIDINFO *gi = list[flags & PJ_GRID_FIND_LAST
+                                           ? list.size() - 1 - k
+                                           : k];
+                if (grid_has_point(gi, lp, tolerant)) {
+                    expected = gi;
+                    break;
+                }
+            }
+            while (expected && expected->child) {
+                PJ_GRIDINFO *c = expected->child;
+                while (c && !grid_has_point(c, lp, tolerant))
+                    c = c->next;
+                if (!c)
+                    break;
+                expected = c;
+            }
+
+            /* the second lookup mostly comes from the last hit */
+            for (int k = 0; k < 2; k++)
+                EXPECT_EQ(pj_gridlist_find(&index, list.data(),
+                                           (int)list.size(), lp, flags),
+                          expected)
+                    << flags << " " << i;
+        }
+    }
+    ASSERT_TRUE(index != nullptr);
+
+    pj_gridlist_index_free(index);
+    for (int i = 0; i < 4; i++)
+        pj_gridlist_index_free(grids[i].child_index);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, init_file_sections) {
+    /* pj_init_file_gets() splits lines the way pj_ctx_fgets() does */
+    const std::string contents("<a> x=1\n\n" + std::string(20, 'y') + "\nz");
+    std::vector<std::string> lines;
+    char line[9];
+    size_t offset = 0;
+    while (pj_init_file_gets(line, sizeof(line), contents.data(),
+                             contents.size(), &offset))
+        lines.push_back(line);
+    ASSERT_EQ(lines.size(), 6U);
+    EXPECT_EQ(lines[0], "<a> x=1\n");
+    EXPECT_EQ(lines[1], "\n");
+    EXPECT_EQ(lines[2], "yyyyyyyy");
+    EXPECT_EQ(lines[4], "yyyy\n");
+    EXPECT_EQ(lines[5], "z");
+
+    /* Sections are looked up in the index of the file */
+    projCtx ctx = pj_get_default_ctx();
+    size_t size = 0;
+    INIT_FILE *file = nullptr, *file2 = nullptr;
+    auto section = pj_find_init_section(ctx, "nad27", "101", &size, &file);
+    ASSERT_TRUE(section != nullptr);
+    ASSERT_TRUE(file != nullptr);
+    EXPECT_EQ(std::string(section, 5), "<101>");
+    EXPECT_EQ(pj_find_init_section(ctx, "nad27", "101", &size, &file2),
+              section);
+    EXPECT_EQ(file2, file);
+    pj_release_init_file(file2);
+    EXPECT_TRUE(pj_find_init_section(ctx, "nad27", "10", &size, &file2) ==
+                nullptr);
+    EXPECT_TRUE(file2 == nullptr);
+    EXPECT_TRUE(pj_find_init_section(ctx, "nosuchfile", "101", &size,
+                                     &file2) == nullptr);
+
+    /* A section stays valid until released, even if the cache is cleared */
+    pj_clear_initcache();
+    EXPECT_EQ(std::string(section, 5), "<101>");
+    pj_release_init_file(file);
+    EXPECT_TRUE(pj_find_init_section(ctx, "nad27", "101", &size, &file) !=
+                nullptr);
+    pj_release_init_file(file);
+
+    /* The file is read outside of the lock by several threads at once, */
+    /* and only one of them gets published                              */
+    struct Lookup {
+        const char *section;
+        INIT_FILE *file;
+    };
+    std::vector<Lookup> lookups(8);
+    pj_clear_initcache();
+    pj_run_in_threads(
+        (int)lookups.size(),
+        [](void *arg) {
+            auto lookup = static_cast<Lookup *>(arg);
+            auto thread_ctx = proj_context_create();
+            size_t thread_size = 0;
+            lookup->section = pj_find_init_section(
+                thread_ctx, "nad27", "101", &thread_size, &lookup->file);
+            proj_context_destroy(thread_ctx);
+        },
+        lookups.data(), sizeof(Lookup));
+    for (const auto &lookup : lookups) {
+        EXPECT_EQ(lookup.section, lookups[0].section);
+        EXPECT_EQ(lookup.file, lookups[0].file);
+        pj_release_init_file(lookup.file);
+    }
+
+    auto P = proj_create(PJ_DEFAULT_CTX, "+init=nad27:101");
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(std::string(proj_pj_info(P).id), "tmerc");
+    proj_destroy(P);
+
+    P = proj_create(PJ_DEFAULT_CTX, "+init=nad27:nosuchsection");
+    EXPECT_TRUE(P == nullptr);
+    EXPECT_NE(proj_context_errno(PJ_DEFAULT_CTX), 0);
+    pj_ctx_set_errno(ctx, 0);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, indexed_lookups) {
+    /* The hashed lookup of operations must give what a scan would give */
+    for (auto op = proj_list_operations(); op->id; ++op) {
+        auto expected = proj_list_operations();
+        while (strcmp(expected->id, op->id) != 0)
+            ++expected;
+        EXPECT_EQ(pj_find_operation(op->id), expected) << op->id;
+    }
+    EXPECT_TRUE(pj_find_operation("tmer") == nullptr);
+    EXPECT_TRUE(pj_find_operation("") == nullptr);
+
+    /* Same for the parameters of a list with a lookup table */
+    const char *names[] = {"k",   "k_0",   "lat_0", "lat_ts", "no_defs",
+                           "lat", "ellps", "x_0",   "step",   "R"};
+    paralist *list = pj_mkparam("proj=tmerc");
+    paralist *last = list;
+    for (int i = 0; i < 200; i++) {
+        std::string param(names[i % 10]);
+        if (i % 3)
+            param += "=" + std::to_string(i);
+        last = last->next = pj_mkparam(param.c_str());
+
+        if (i == 50) {
+            ASSERT_TRUE(pj_param_index_create(list));
+        }
+        if (i % 25 == 0) {
+            for (auto name : names) {
+                paralist *expected = list;
+                while (expected && !(strncmp(expected->param, name,
+                                             strlen(name)) == 0 &&
+                                     (expected->param[strlen(name)] == '=' ||
+                                      expected->param[strlen(name)] == 0)))
+                    expected = expected->next;
+                EXPECT_EQ(pj_param_lookup(list, name, strlen(name)), expected)
+                    << name << " " << i;
+            }
+        }
+    }
+    EXPECT_TRUE(list->index != nullptr);
+    EXPECT_TRUE(pj_param_lookup(list, "la", 2) == nullptr);
+    EXPECT_EQ(pj_param(nullptr, list, "ilat_0").i, 2);
+    EXPECT_STREQ(pj_param(nullptr, list, "sproj").s, "tmerc");
+    EXPECT_TRUE(pj_param_exists(list, "step") == nullptr);
+    EXPECT_TRUE(pj_param_exists(list, "x_0=1") != nullptr);
+
+    pj_param_index_free(list);
+    EXPECT_TRUE(list->index == nullptr);
+    while (list) {
+        paralist *next = list->next;
+        pj_dealloc(list);
+        list = next;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 class gieTest : public ::testing::Test {
 
     static void DummyLogFunction(void *, int, const char *) {}
@@ -319,6 +1083,274 @@ TEST_F(gieTest, proj_create_crs_to_crs_proj_longlat) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(gieTest, proj_create_crs_to_crs_per_point_operation) {
+    /* NAD27 to WGS84 has many regional operations. Outside the area of   */
+    /* use of the first one, each point must be transformed as if the area */
+    /* of use had been restricted to it                                    */
+    auto P =
+        proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4267", "EPSG:4326", NULL);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(P->candidate_count, 0); /* unless asked for */
+    proj_destroy(P);
+
+    proj_context_use_per_point_operations(m_ctxt, 1);
+    P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4326", NULL);
+    ASSERT_TRUE(P != nullptr);
+    ASSERT_GT(P->candidate_count, 1);
+    for (int k = 0; k < P->candidate_count; k++)
+        EXPECT_TRUE(P->candidates[k].op != nullptr) << k;
+
+    /* Lat, long degrees: Alaska, Cuba, Texas */
+    const double points[][2] = {{61, -150}, {22, -80}, {31, -99}};
+    const size_t n = sizeof(points) / sizeof(points[0]);
+    PJ_COORD in[n], out[n];
+    for (size_t i = 0; i < n; i++)
+        in[i] = out[i] = proj_coord(points[i][0], points[i][1], 0, 0);
+    ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out), 0);
+
+    for (size_t i = 0; i < n; i++) {
+        auto area = proj_area_create();
+        proj_area_set_bbox(area, points[i][1] - 0.1, points[i][0] - 0.1,
+                           points[i][1] + 0.1, points[i][0] + 0.1);
+        auto Q = proj_create_crs_to_crs(PJ_DEFAULT_CTX, "EPSG:4267",
+                                        "EPSG:4326", area);
+        proj_area_destroy(area);
+        ASSERT_TRUE(Q != nullptr);
+
+        PJ_COORD expected = proj_trans(Q, PJ_FWD, in[i]);
+        EXPECT_NEAR(out[i].xy.x, expected.xy.x, 1e-12) << i;
+        EXPECT_NEAR(out[i].xy.y, expected.xy.y, 1e-12) << i;
+
+        PJ_COORD a = proj_trans(P, PJ_FWD, in[i]);
+        EXPECT_NEAR(a.xy.x, expected.xy.x, 1e-12) << i;
+        EXPECT_NEAR(a.xy.y, expected.xy.y, 1e-12) << i;
+
+        /* the 3D interfaces pick the same operation (grid shifts have */
+        /* no 2D ones)                                                 */
+        PJ_COORD c = pj_approx_3D_trans(P, PJ_FWD, in[i]);
+        EXPECT_NEAR(c.xy.x, expected.xy.x, 1e-12) << i;
+        EXPECT_NEAR(c.xy.y, expected.xy.y, 1e-12) << i;
+
+        /* and back, picking the operation from the target CRS bounds */
+        a = proj_trans(P, PJ_INV, a);
+        PJ_COORD b = proj_trans(Q, PJ_INV, expected);
+        EXPECT_NEAR(a.xy.x, b.xy.x, 1e-12) << i;
+        EXPECT_NEAR(a.xy.y, b.xy.y, 1e-12) << i;
+        c = pj_approx_3D_trans(P, PJ_INV, expected);
+        EXPECT_NEAR(c.xy.x, b.xy.x, 1e-12) << i;
+        EXPECT_NEAR(c.xy.y, b.xy.y, 1e-12) << i;
+        proj_destroy(Q);
+    }
+
+    /* Alaska and Cuba are not covered by the same operation */
+    auto alaska = proj_trans(P, PJ_FWD, in[0]);
+    auto cuba = proj_trans(P, PJ_FWD, in[1]);
+    EXPECT_GT(fabs((alaska.xy.y - in[0].xy.y) - (cuba.xy.y - in[1].xy.y)),
+              1e-6);
+
+    /* Outside the area of use of all regional operations (here: South   */
+    /* Africa), the operation valid over the whole CRS extents is used, */
+    /* and not some regional one                                        */
+    auto Q = proj_create(PJ_DEFAULT_CTX, proj_pj_info(P).definition);
+    ASSERT_TRUE(Q != nullptr);
+    auto south_africa = proj_coord(-30, 25, 0, 0);
+    auto a = proj_trans(P, PJ_FWD, south_africa);
+    auto b = proj_trans(Q, PJ_FWD, south_africa);
+    EXPECT_EQ(a.xy.x, b.xy.x);
+    EXPECT_EQ(a.xy.y, b.xy.y);
+    EXPECT_NEAR(a.xy.x, south_africa.xy.x, 1e-12);
+    EXPECT_NEAR(a.xy.y, south_africa.xy.y, 1e-12);
+    proj_destroy(Q);
+
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(gieTest, proj_create_crs_to_crs_cache) {
+    /* Cached results are copied for each call, and give the same results */
+    proj_context_set_crs_to_crs_cache_size(m_ctxt, 2);
+    proj_context_use_per_point_operations(m_ctxt, 1);
+    auto P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4326", NULL);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 1);
+
+    auto Q = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4326", NULL);
+    ASSERT_TRUE(Q != nullptr);
+    EXPECT_NE(P, Q);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 1);
+    EXPECT_GT(Q->candidate_count, 1);
+    EXPECT_EQ(P->candidate_count, Q->candidate_count);
+
+    /* Lat, long degrees: Alaska, Cuba, Texas */
+    const double points[][2] = {{61, -150}, {22, -80}, {31, -99}};
+    PJ_COORD a[3], b[3];
+    for (int i = 0; i < 3; i++) {
+        a[i] = proj_trans(P, PJ_FWD, proj_coord(points[i][0], points[i][1], 0, 0));
+    }
+    proj_destroy(P);
+    for (int i = 0; i < 3; i++) {
+        b[i] = proj_trans(Q, PJ_FWD, proj_coord(points[i][0], points[i][1], 0, 0));
+        EXPECT_EQ(a[i].xy.x, b[i].xy.x) << i;
+        EXPECT_EQ(a[i].xy.y, b[i].xy.y) << i;
+    }
+    proj_destroy(Q);
+
+    /* the area of interest is part of the key */
+    auto area = proj_area_create();
+    proj_area_set_bbox(area, -100, 30, -98, 32);
+    P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4326", area);
+    proj_area_destroy(area);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 2);
+    proj_destroy(P);
+
+    /* least recently used entries are dropped */
+    P = proj_create_crs_to_crs(m_ctxt, "EPSG:25832", "EPSG:25833", NULL);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 2);
+    proj_destroy(P);
+
+    EXPECT_TRUE(proj_create_crs_to_crs(m_ctxt, "invalid", "EPSG:25833",
+                                       NULL) == nullptr);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 2);
+
+    /* the grids found may change with the search path and the file API */
+    pj_set_searchpath(0, nullptr);
+    P = proj_create_crs_to_crs(m_ctxt, "EPSG:25832", "EPSG:25833", NULL);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 1);
+    proj_destroy(P);
+    pj_ctx_set_fileapi(m_ctxt, pj_get_default_fileapi());
+    EXPECT_EQ(m_ctxt->operation_cache_count, 0);
+
+    proj_context_set_crs_to_crs_cache_size(m_ctxt, 0);
+    EXPECT_EQ(m_ctxt->operation_cache_count, 0);
+    EXPECT_TRUE(m_ctxt->operation_cache == nullptr);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST_F(gieTest, proj_clone) {
+    /* The copy transforms like the original, in its own context, and */
+    /* outlives it                                                     */
+    auto P = proj_create(PJ_DEFAULT_CTX,
+                         "+proj=pipeline +step +proj=axisswap +order=2,1 "
+                         "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+                         "+step +proj=utm +zone=32 +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    auto Q = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(Q != nullptr);
+    EXPECT_EQ(pj_get_ctx(Q), m_ctxt);
+
+    PJ_COORD a = proj_trans(P, PJ_FWD, proj_coord(55, 12, 0, 0));
+    proj_destroy(P);
+    PJ_COORD b = proj_trans(Q, PJ_FWD, proj_coord(55, 12, 0, 0));
+    EXPECT_EQ(a.xy.x, b.xy.x);
+    EXPECT_EQ(a.xy.y, b.xy.y);
+    b = proj_trans(Q, PJ_INV, b);
+    EXPECT_NEAR(b.xy.x, 55, 1e-10);
+    EXPECT_NEAR(b.xy.y, 12, 1e-10);
+    proj_destroy(Q);
+
+    /* inverted operations, as set up by cct -I */
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=utm +zone=32 +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    P->inverted = 1;
+    Q = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(Q != nullptr);
+    a = proj_trans(P, PJ_FWD, proj_coord(500000, 6100000, 0, 0));
+    b = proj_trans(Q, PJ_FWD, proj_coord(500000, 6100000, 0, 0));
+    EXPECT_EQ(a.lp.lam, b.lp.lam);
+    EXPECT_EQ(a.lp.phi, b.lp.phi);
+    EXPECT_NEAR(proj_todeg(b.lp.lam), 9, 1e-10);
+    proj_destroy(P);
+    proj_destroy(Q);
+
+    /* errors are reported in the context of the copy only */
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    Q = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(Q != nullptr);
+    proj_errno_reset(P);
+    b = proj_trans(Q, PJ_FWD, proj_coord(0, M_PI_2, 0, 0));
+    EXPECT_EQ(b.xy.x, HUGE_VAL);
+    EXPECT_NE(proj_errno(Q), 0);
+    EXPECT_EQ(proj_errno(P), 0);
+    a = proj_trans(P, PJ_FWD, proj_coord(0.1, 0.2, 0, 0));
+    EXPECT_EQ(proj_errno(P), 0);
+    proj_errno_reset(Q);
+    b = proj_trans(Q, PJ_FWD, proj_coord(0.1, 0.2, 0, 0));
+    EXPECT_EQ(proj_errno(Q), 0);
+    EXPECT_EQ(a.xy.x, b.xy.x);
+    EXPECT_EQ(a.xy.y, b.xy.y);
+    proj_destroy(P);
+    proj_destroy(Q);
+
+    /* the candidate operations of proj_create_crs_to_crs: Alaska, Cuba, */
+    /* Texas, South Africa                                               */
+    proj_context_use_per_point_operations(m_ctxt, 1);
+    P = proj_create_crs_to_crs(m_ctxt, "EPSG:4267", "EPSG:4326", NULL);
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_GT(P->candidate_count, 1);
+    Q = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(Q != nullptr);
+    const double points[][2] = {{61, -150}, {22, -80}, {31, -99}, {-30, 25}};
+    for (const auto &point : points) {
+        auto c = proj_coord(point[0], point[1], 0, 0);
+        a = proj_trans(P, PJ_FWD, c);
+        b = proj_trans(Q, PJ_FWD, c);
+        EXPECT_EQ(a.xy.x, b.xy.x) << point[0];
+        EXPECT_EQ(a.xy.y, b.xy.y) << point[0];
+        a = proj_trans(P, PJ_INV, a);
+        b = proj_trans(Q, PJ_INV, b);
+        EXPECT_EQ(a.xy.x, b.xy.x) << point[0];
+        EXPECT_EQ(a.xy.y, b.xy.y) << point[0];
+    }
+    proj_destroy(P);
+    proj_destroy(Q);
+
+    /* the steps of a pipeline are copied, not set up again: once the grid */
+    /* registry is emptied, setting up the grid shift would open its file  */
+    const std::string hgrid = temp_file("proj_test_clone.ct2");
+    ASSERT_TRUE(write_ctable2(hgrid, 2, 48, 0.1, 60, 40));
+    const std::string def =
+        "+proj=pipeline +step +proj=unitconvert +xy_in=deg +xy_out=rad "
+        "+step +proj=hgridshift +grids=" +
+        hgrid + " +step +proj=utm +zone=31 +ellps=GRS80";
+    P = proj_create(PJ_DEFAULT_CTX, def.c_str());
+    ASSERT_TRUE(P != nullptr);
+    pj_deallocate_grids();
+
+    projFileAPI counting_fileapi = *pj_get_default_fileapi();
+    counting_fileapi.FOpen = counting_fopen;
+    pj_ctx_set_fileapi(m_ctxt, &counting_fileapi);
+    counted_fopen_calls = 0;
+    Q = proj_clone(m_ctxt, P);
+    ASSERT_TRUE(Q != nullptr);
+    EXPECT_EQ(counted_fopen_calls, 0);
+    proj_destroy(proj_create(m_ctxt, def.c_str()));
+    EXPECT_GT(counted_fopen_calls, 0);
+
+    a = proj_trans(P, PJ_FWD, proj_coord(3, 49, 0, 0));
+    proj_destroy(P);
+    b = proj_trans(Q, PJ_FWD, proj_coord(3, 49, 0, 0));
+    EXPECT_EQ(a.xy.x, b.xy.x);
+    EXPECT_EQ(a.xy.y, b.xy.y);
+    b = proj_trans(Q, PJ_INV, b);
+    EXPECT_NEAR(b.xy.x, 3, 1e-10);
+    EXPECT_NEAR(b.xy.y, 49, 1e-10);
+    proj_destroy(Q);
+    pj_ctx_set_fileapi(m_ctxt, pj_get_default_fileapi());
+    pj_deallocate_grids();
+    remove(hgrid.c_str());
+
+    EXPECT_TRUE(proj_clone(m_ctxt, nullptr) == nullptr);
+    EXPECT_EQ(proj_context_errno(m_ctxt), PJD_ERR_INVALID_ARG);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, info_functions) {
     PJ_INFO info;
     PJ_PROJ_INFO pj_info;
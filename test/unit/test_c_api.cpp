@@ -2169,6 +2169,35 @@ TEST_F(CApi, proj_obj_cs_get_axis_info) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_obj_create_crs_list_from_database) {
+    {
+        const char *codes[] = {"4326", "-1", nullptr};
+        EXPECT_EQ(proj_obj_create_crs_list_from_database(m_ctxt, "EPSG",
+                                                         codes, nullptr),
+                  nullptr);
+    }
+    {
+        const char *codes[] = {"32631", "4326", "6871", nullptr};
+        auto res = proj_obj_create_crs_list_from_database(m_ctxt, "EPSG",
+                                                          codes, nullptr);
+        ASSERT_NE(res, nullptr);
+        ObjListKeeper keeper_res(res);
+        ASSERT_EQ(proj_obj_list_get_count(res), 3);
+        const PJ_OBJ_TYPE types[] = {PJ_OBJ_TYPE_PROJECTED_CRS,
+                                     PJ_OBJ_TYPE_GEOGRAPHIC_2D_CRS,
+                                     PJ_OBJ_TYPE_COMPOUND_CRS};
+        for (int i = 0; i < 3; ++i) {
+            auto crs = proj_obj_list_get(m_ctxt, res, i);
+            ASSERT_NE(crs, nullptr);
+            ObjectKeeper keeper(crs);
+            EXPECT_EQ(proj_obj_get_type(crs), types[i]);
+            EXPECT_EQ(std::string(proj_obj_get_id_code(crs, 0)), codes[i]);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_context_get_database_metadata) {
     EXPECT_TRUE(proj_context_get_database_metadata(m_ctxt, "IGNF.VERSION") !=
                 nullptr);
@@ -2176,6 +2205,50 @@ TEST_F(CApi, proj_context_get_database_metadata) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_context_database_cache) {
+    // With an auxiliary database, the caches are not shared with the other
+    // tests
+    const char *aux_db_list[] = {":memory:", nullptr};
+    ASSERT_TRUE(
+        proj_context_set_database_path(m_ctxt, nullptr, aux_db_list, nullptr));
+
+    auto info =
+        proj_context_get_database_cache_info(m_ctxt, PJ_DATABASE_CACHE_CRS);
+    EXPECT_EQ(info.max_size, 128U);
+    EXPECT_EQ(info.size, 0U);
+
+    const char *codes[] = {"4326", "4258", "32631", "i_do_not_exist",
+                           nullptr};
+    EXPECT_EQ(proj_context_warm_database_cache(m_ctxt, "EPSG", codes,
+                                               PJ_OBJ_CATEGORY_CRS, nullptr),
+              3);
+    info = proj_context_get_database_cache_info(m_ctxt, PJ_DATABASE_CACHE_CRS);
+    EXPECT_EQ(info.size, 3U);
+    // The base CRS of EPSG:32631 is EPSG:4326
+    EXPECT_EQ(info.hits, 1U);
+    EXPECT_EQ(info.evictions, 0U);
+
+    auto crs = proj_obj_create_from_database(
+        m_ctxt, "EPSG", "4258", PJ_OBJ_CATEGORY_CRS, false, nullptr);
+    ASSERT_NE(crs, nullptr);
+    ObjectKeeper keeper_crs(crs);
+    info = proj_context_get_database_cache_info(m_ctxt, PJ_DATABASE_CACHE_CRS);
+    EXPECT_EQ(info.hits, 2U);
+
+    ASSERT_TRUE(proj_context_set_database_cache_size(
+        m_ctxt, PJ_DATABASE_CACHE_CRS, 1));
+    info = proj_context_get_database_cache_info(m_ctxt, PJ_DATABASE_CACHE_CRS);
+    EXPECT_EQ(info.max_size, 1U);
+    EXPECT_EQ(info.size, 1U);
+    EXPECT_EQ(info.evictions, 2U);
+
+    info = proj_context_get_database_cache_info(m_ctxt,
+                                                PJ_DATABASE_CACHE_EXTENT);
+    EXPECT_GT(info.size, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_obj_clone) {
     auto obj =
         proj_obj_create_from_proj_string(m_ctxt, "+proj=longlat", nullptr);
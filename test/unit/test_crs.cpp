@@ -2192,6 +2192,54 @@ TEST(crs, projectedCRS_identify_db) {
         EXPECT_EQ(res.front().first->getEPSGCode(), 6646);
         EXPECT_EQ(res.front().second, 70);
     }
+    {
+        // EPSG:22780 without name and identifier. Found through the
+        // fingerprint of its definition.
+        auto obj = WKTParser().attachDatabaseContext(dbContext).createFromWKT(
+            "PROJCS[\"unknown\",GEOGCS[\"Deir ez Zor\","
+            "DATUM[\"Deir_ez_Zor\","
+            "SPHEROID[\"Clarke 1880 (IGN)\",6378249.2,293.466021293627]],"
+            "PRIMEM[\"Greenwich\",0],"
+            "UNIT[\"degree\",0.0174532925199433]],"
+            "PROJECTION[\"Oblique_Stereographic\"],"
+            "PARAMETER[\"latitude_of_origin\",34.2],"
+            "PARAMETER[\"central_meridian\",39.15],"
+            "PARAMETER[\"scale_factor\",0.9995341],"
+            "PARAMETER[\"false_easting\",0],"
+            "PARAMETER[\"false_northing\",0],"
+            "UNIT[\"metre\",1],AXIS[\"Easting\",EAST],"
+            "AXIS[\"Northing\",NORTH]]");
+        auto crs = nn_dynamic_pointer_cast<ProjectedCRS>(obj);
+        ASSERT_TRUE(crs != nullptr);
+        auto res = crs->identify(factoryEPSG);
+        ASSERT_EQ(res.size(), 1);
+        EXPECT_EQ(res.front().first->getEPSGCode(), 22780);
+        EXPECT_EQ(res.front().second, 90);
+    }
+    {
+        // EPSG:32119 without name, with the standard parallels switched
+        auto obj = WKTParser().attachDatabaseContext(dbContext).createFromWKT(
+            "PROJCS[\"unknown\",GEOGCS[\"NAD83\","
+            "DATUM[\"North_American_Datum_1983\","
+            "SPHEROID[\"GRS 1980\",6378137,298.257222101]],"
+            "PRIMEM[\"Greenwich\",0],"
+            "UNIT[\"degree\",0.0174532925199433]],"
+            "PROJECTION[\"Lambert_Conformal_Conic_2SP\"],"
+            "PARAMETER[\"standard_parallel_1\",34.33333333333334],"
+            "PARAMETER[\"standard_parallel_2\",36.16666666666666],"
+            "PARAMETER[\"latitude_of_origin\",33.75],"
+            "PARAMETER[\"central_meridian\",-79],"
+            "PARAMETER[\"false_easting\",609601.22],"
+            "PARAMETER[\"false_northing\",0],"
+            "UNIT[\"metre\",1],AXIS[\"Easting\",EAST],"
+            "AXIS[\"Northing\",NORTH]]");
+        auto crs = nn_dynamic_pointer_cast<ProjectedCRS>(obj);
+        ASSERT_TRUE(crs != nullptr);
+        auto res = crs->identify(factoryEPSG);
+        ASSERT_EQ(res.size(), 1);
+        EXPECT_EQ(res.front().first->getEPSGCode(), 32119);
+        EXPECT_EQ(res.front().second, 90);
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -39,6 +39,10 @@
 
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <set>
+#include <thread>
+
 #ifdef _MSC_VER
 #include <stdio.h>
 #else
@@ -631,6 +635,34 @@ TEST(factory, AuthorityFactory_createCoordinateReferenceSystem) {
     EXPECT_TRUE(nn_dynamic_pointer_cast<CompoundCRS>(
         factory->createCoordinateReferenceSystem("6871")));
 }
+
+// ---------------------------------------------------------------------------
+
+TEST(factory, AuthorityFactory_createCoordinateReferenceSystems) {
+    // With an auxiliary database, the caches are not shared with the other
+    // tests, so that the objects are built by the set-based queries.
+    auto factory = AuthorityFactory::create(
+        DatabaseContext::create(std::string(), {":memory:"}), "EPSG");
+    auto refFactory =
+        AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    const std::vector<std::string> codes{"6871", "32631", "4326", "4979",
+                                         "4978", "3855", "32631"};
+    auto res = factory->createCoordinateReferenceSystems(codes);
+    ASSERT_EQ(res.size(), codes.size());
+    for (size_t i = 0; i < codes.size(); ++i) {
+        ASSERT_EQ(res[i]->identifiers().size(), 1U);
+        EXPECT_EQ(res[i]->identifiers()[0]->code(), codes[i]);
+        EXPECT_TRUE(res[i]->isEquivalentTo(
+            refFactory->createCoordinateReferenceSystem(codes[i]).get()))
+            << codes[i];
+    }
+    EXPECT_TRUE(nn_dynamic_pointer_cast<CompoundCRS>(res[0]));
+    EXPECT_TRUE(nn_dynamic_pointer_cast<VerticalCRS>(res[5]));
+
+    EXPECT_TRUE(factory->createCoordinateReferenceSystems({}).empty());
+    EXPECT_THROW(factory->createCoordinateReferenceSystems({"4326", "-1"}),
+                 NoSuchAuthorityCodeException);
+}
 // ---------------------------------------------------------------------------
 
 TEST(factory, AuthorityFactory_createCoordinateOperation_helmert_3) {
@@ -1737,6 +1769,159 @@ TEST(factory, AuthorityFactory_createFromCoordinateReferenceSystemCodes) {
 
 // ---------------------------------------------------------------------------
 
+#ifndef _WIN32
+TEST(factory,
+     AuthorityFactory_createFromCoordinateReferenceSystemCodes_persistent) {
+    const char *temp = getenv("TEMP");
+    if (!temp) {
+        temp = getenv("TMP");
+    }
+    if (!temp) {
+        temp = "/tmp";
+    }
+    const std::string cacheName(std::string(temp) +
+                                "/proj_test_operation_cache.db");
+    const std::string dbName(std::string(temp) +
+                             "/proj_test_operation_cache_proj.db");
+    const std::string gridName(std::string(temp) + "/conus");
+
+    // Restores the environment and removes the files when leaving the test,
+    // including on a failed assertion
+    struct Cleanup {
+        std::vector<std::string> files{};
+        std::string projLib{};
+        bool hadProjLib = false;
+
+        Cleanup(const std::vector<std::string> &filesIn) : files(filesIn) {
+            const char *val = getenv("PROJ_LIB");
+            hadProjLib = val != nullptr;
+            if (val) {
+                projLib = val;
+            }
+            for (const auto &file : files) {
+                unlink(file.c_str());
+            }
+        }
+
+        ~Cleanup() {
+            unsetenv("PROJ_OPERATION_CACHE");
+            if (hadProjLib) {
+                setenv("PROJ_LIB", projLib.c_str(), 1);
+            } else {
+                unsetenv("PROJ_LIB");
+            }
+            for (const auto &file : files) {
+                unlink(file.c_str());
+            }
+        }
+    } cleanup({cacheName, cacheName + "-wal", cacheName + "-shm", dbName,
+               gridName});
+
+    // Work on a copy of proj.db, so that it can be modified
+    {
+        sqlite3 *src = nullptr;
+        sqlite3 *dst = nullptr;
+        sqlite3_open_v2(DatabaseContext::create()->getPath().c_str(), &src,
+                        SQLITE_OPEN_READONLY, nullptr);
+        sqlite3_open(dbName.c_str(), &dst);
+        auto backup = sqlite3_backup_init(dst, "main", src, "main");
+        ASSERT_TRUE(backup != nullptr);
+        EXPECT_EQ(sqlite3_backup_step(backup, -1), SQLITE_DONE);
+        sqlite3_backup_finish(backup);
+        sqlite3_close(dst);
+        sqlite3_close(src);
+    }
+    // Grids are looked for in temp
+    setenv("PROJ_LIB", temp, 1);
+    setenv("PROJ_OPERATION_CACHE", cacheName.c_str(), 1);
+
+    auto createList = [&dbName](const char *sourceCRSCode,
+                                const char *targetCRSCode) {
+        auto factory = AuthorityFactory::create(
+            DatabaseContext::create(dbName), "EPSG");
+        return factory->createFromCoordinateReferenceSystemCodes(
+            "EPSG", sourceCRSCode, "EPSG", targetCRSCode, true, true, false);
+    };
+    const auto hasOperation =
+        [](const std::vector<CoordinateOperationNNPtr> &list,
+           const char *name) {
+            for (const auto &op : list) {
+                if (op->nameStr() == name) {
+                    return true;
+                }
+            }
+            return false;
+        };
+    const auto execute = [](const std::string &filename, const char *sql) {
+        sqlite3 *db = nullptr;
+        sqlite3_open(filename.c_str(), &db);
+        const bool ok =
+            sqlite3_exec(db, sql, nullptr, nullptr, nullptr) == SQLITE_OK &&
+            sqlite3_changes(db) == 1;
+        sqlite3_close(db);
+        return ok;
+    };
+
+    EXPECT_EQ(createList("4179", "4258").size(), 3U);
+
+    // Entries are read back from the file by new contexts, without going
+    // through the database
+    EXPECT_TRUE(execute(cacheName,
+                        "UPDATE crs_to_crs_operations SET operations = "
+                        "replace(operations, "
+                        "'\"Pulkovo 1942(58) to ETRS89 (1)\"', "
+                        "'\"Cached\"')"));
+    {
+        auto list = createList("4179", "4258");
+        ASSERT_EQ(list.size(), 3U);
+        EXPECT_TRUE(hasOperation(list, "Cached"));
+        EXPECT_FALSE(hasOperation(list, "Pulkovo 1942(58) to ETRS89 (1)"));
+        for (const auto &op : list) {
+            if (op->nameStr() == "Cached") {
+                EXPECT_EQ(op->getEPSGCode(), 1644);
+            }
+        }
+    }
+
+    // And discarded when the fingerprint of proj.db changes
+    EXPECT_TRUE(execute(cacheName, "UPDATE metadata SET value = 'other' "
+                                   "WHERE key = 'fingerprint'"));
+    EXPECT_EQ(createList("4179", "4258").size(), 3U);
+
+    // Including when only its content changes, within the same second
+    EXPECT_TRUE(execute(dbName, "UPDATE helmert_transformation SET "
+                                "deprecated = 1 WHERE auth_name = 'EPSG' "
+                                "AND code = '1644'"));
+    {
+        auto list = createList("4179", "4258");
+        EXPECT_EQ(list.size(), 2U);
+        EXPECT_FALSE(hasOperation(list, "Pulkovo 1942(58) to ETRS89 (1)"));
+    }
+
+    // Entries are computed again when the availability of the grids they
+    // depend on changes
+    const auto sizeWithoutGrid = createList("4267", "4269").size();
+    EXPECT_FALSE(hasOperation(createList("4267", "4269"),
+                              "NAD27 to NAD83 (1)"));
+    FILE *grid = fopen(gridName.c_str(), "wb");
+    ASSERT_TRUE(grid != nullptr);
+    fclose(grid);
+    {
+        auto list = createList("4267", "4269");
+        EXPECT_EQ(list.size(), sizeWithoutGrid + 1);
+        EXPECT_TRUE(hasOperation(list, "NAD27 to NAD83 (1)"));
+    }
+    unlink(gridName.c_str());
+    {
+        auto list = createList("4267", "4269");
+        EXPECT_EQ(list.size(), sizeWithoutGrid);
+        EXPECT_FALSE(hasOperation(list, "NAD27 to NAD83 (1)"));
+    }
+}
+#endif
+
+// ---------------------------------------------------------------------------
+
 TEST(
     factory,
     AuthorityFactory_createFromCoordinateReferenceSystemCodes_anonymous_authority) {
@@ -1762,6 +1947,111 @@ TEST(
 
 // ---------------------------------------------------------------------------
 
+TEST(factory,
+     AuthorityFactory_createFromCRSCodesWithIntermediates_area_of_interest) {
+    auto factory = AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    // With an auxiliary database, the area index of proj.db is not used
+    auto factoryNoIndex = AuthorityFactory::create(
+        DatabaseContext::create(std::string(), {":memory:"}), "EPSG");
+
+    const auto getNames =
+        [](const std::vector<CoordinateOperationNNPtr> &list) {
+            std::vector<std::string> names;
+            for (const auto &op : list) {
+                names.push_back(op->nameStr());
+            }
+            return names;
+        };
+    // What the intersects_bbox() SQL function tells of the areas of use of
+    // the two steps and the area of interest
+    const auto intersects = [](const CoordinateOperationNNPtr &op,
+                               const GeographicBoundingBoxNNPtr &bbox) {
+        auto concat = dynamic_cast<const ConcatenatedOperation *>(op.get());
+        EXPECT_TRUE(concat != nullptr);
+        if (!concat) {
+            return false;
+        }
+        for (const auto &step : concat->operations()) {
+            const auto &domains = step->domains();
+            EXPECT_EQ(domains.size(), 1U);
+            if (domains.size() != 1) {
+                return false;
+            }
+            const auto &extent = domains[0]->domainOfValidity();
+            EXPECT_TRUE(extent != nullptr);
+            if (!extent) {
+                return false;
+            }
+            const auto &geogElements = extent->geographicElements();
+            EXPECT_EQ(geogElements.size(), 1U);
+            if (geogElements.size() != 1) {
+                return false;
+            }
+            auto stepBbox = dynamic_cast<const GeographicBoundingBox *>(
+                geogElements[0].get());
+            EXPECT_TRUE(stepBbox != nullptr);
+            if (!stepBbox || !stepBbox->intersects(bbox)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const std::vector<std::pair<const char *, const char *>> pairs{
+        {"4230", "4258"}, // ED50 to ETRS89
+        {"4230", "4326"}, // ED50 to WGS 84
+        {"4807", "4171"}, // NTF (Paris) to RGF93
+        {"4283", "4202"}, // GDA94 to AGD66
+        {"4267", "4326"}, // NAD27 to WGS 84
+    };
+    // Bounds that do not coincide with those of areas of use, which the
+    // R*Tree stores with a single precision
+    const std::vector<GeographicBoundingBoxNNPtr> bboxes{
+        GeographicBoundingBox::create(2.35, 48.85, 2.36, 48.86),
+        GeographicBoundingBox::create(-4.7, 36.3, 3.3, 43.7),
+        GeographicBoundingBox::create(140.5, -29.5, 140.7, -29.3),
+        GeographicBoundingBox::create(-100.5, 40.5, -90.5, 45.5),
+        // Crossing the antimeridian
+        GeographicBoundingBox::create(170.5, -50.5, -170.5, -40.5),
+        // No operation there
+        GeographicBoundingBox::create(100.5, 0.5, 100.7, 0.7),
+    };
+    size_t filteredOutCount = 0;
+    size_t keptCount = 0;
+    for (const auto &pair : pairs) {
+        const auto all = factory->createFromCRSCodesWithIntermediates(
+            "EPSG", pair.first, "EPSG", pair.second, true, false, true, {});
+        for (const auto &bbox : bboxes) {
+            const auto areaOfInterest =
+                Extent::create(optional<std::string>(), {bbox}, {}, {})
+                    .as_nullable();
+            std::vector<CoordinateOperationNNPtr> expected;
+            for (const auto &op : all) {
+                if (intersects(op, bbox)) {
+                    expected.push_back(op);
+                }
+            }
+            filteredOutCount += all.size() - expected.size();
+            keptCount += expected.size();
+            EXPECT_EQ(getNames(factory->createFromCRSCodesWithIntermediates(
+                          "EPSG", pair.first, "EPSG", pair.second, true,
+                          false, true, {}, areaOfInterest)),
+                      getNames(expected))
+                << pair.first << " " << pair.second;
+            EXPECT_EQ(
+                getNames(factoryNoIndex->createFromCRSCodesWithIntermediates(
+                    "EPSG", pair.first, "EPSG", pair.second, true, false,
+                    true, {}, areaOfInterest)),
+                getNames(all))
+                << pair.first << " " << pair.second;
+        }
+    }
+    EXPECT_GT(filteredOutCount, 0U);
+    EXPECT_GT(keptCount, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(FactoryWithTmpDatabase,
        AuthorityFactory_test_with_fake_EPSG_and_OTHER_database) {
     createStructure();
@@ -1959,6 +2249,230 @@ TEST_F(
 
 // ---------------------------------------------------------------------------
 
+TEST_F(
+    FactoryWithTmpDatabase,
+    AuthorityFactory_createFromCRSCodesWithIntermediates_discard_superseded) {
+    createStructure();
+    populateWithFakeEPSG();
+    createSourceTargetPivotCRS();
+
+    createTransformationForPivotTesting("SOURCE", "PIVOT");
+    createTransformationForPivotTesting("PIVOT", "TARGET");
+    // SOURCE_PIVOT is superseded by SOURCE_PIVOT_2, and by the deprecated
+    // SOURCE_PIVOT_3
+    ASSERT_TRUE(execute("CREATE TEMP TABLE tmp AS SELECT * FROM "
+                        "helmert_transformation WHERE code = 'SOURCE_PIVOT'; "
+                        "UPDATE tmp SET code = 'SOURCE_PIVOT_2'; "
+                        "INSERT INTO helmert_transformation SELECT * FROM tmp; "
+                        "UPDATE tmp SET code = 'SOURCE_PIVOT_3', "
+                        "deprecated = 1; "
+                        "INSERT INTO helmert_transformation SELECT * FROM tmp; "
+                        "DROP TABLE tmp;"))
+        << last_error();
+    for (const auto &code : {"SOURCE_PIVOT_2", "SOURCE_PIVOT_3"}) {
+        ASSERT_TRUE(execute(std::string("INSERT INTO supersession VALUES("
+                                        "'helmert_transformation','OTHER',"
+                                        "'SOURCE_PIVOT',"
+                                        "'helmert_transformation','OTHER','") +
+                            code + "',NULL);"))
+            << last_error();
+    }
+
+    auto factory = AuthorityFactory::create(DatabaseContext::create(m_ctxt),
+                                            std::string());
+    auto res = factory->createFromCRSCodesWithIntermediates(
+        "NS_SOURCE", "SOURCE", "NS_TARGET", "TARGET", false, false, false, {});
+    EXPECT_EQ(res.size(), 2);
+
+    res = factory->createFromCRSCodesWithIntermediates(
+        "NS_SOURCE", "SOURCE", "NS_TARGET", "TARGET", false, false, true, {});
+    ASSERT_EQ(res.size(), 1);
+    auto concat = nn_dynamic_pointer_cast<ConcatenatedOperation>(res[0]);
+    ASSERT_TRUE(concat != nullptr);
+    EXPECT_EQ(concat->operations()[0]->identifiers()[0]->code(),
+              "SOURCE_PIVOT_2");
+}
+
+// ---------------------------------------------------------------------------
+
+static void intersectsBbox(sqlite3_context *pContext, int /* argc */,
+                           sqlite3_value **argv) {
+    for (int i = 0; i < 8; i++) {
+        if (sqlite3_value_type(argv[i]) == SQLITE_NULL) {
+            sqlite3_result_null(pContext);
+            return;
+        }
+    }
+    auto bbox1 = Extent::createFromBBOX(
+        sqlite3_value_double(argv[1]), sqlite3_value_double(argv[0]),
+        sqlite3_value_double(argv[3]), sqlite3_value_double(argv[2]));
+    auto bbox2 = Extent::createFromBBOX(
+        sqlite3_value_double(argv[5]), sqlite3_value_double(argv[4]),
+        sqlite3_value_double(argv[7]), sqlite3_value_double(argv[6]));
+    sqlite3_result_int(pContext, bbox1->intersects(bbox2) ? 1 : 0);
+}
+
+TEST(factory,
+     AuthorityFactory_createFromCRSCodesWithIntermediates_NAD27_NAD83) {
+    auto factory = AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open_v2(factory->databaseContext()->getPath().c_str(),
+                              &db, SQLITE_OPEN_READONLY, nullptr),
+              SQLITE_OK);
+    sqlite3_create_function(db, "intersects_bbox", 8, SQLITE_UTF8, nullptr,
+                            intersectsBbox, nullptr, nullptr);
+
+    // The operations between two CRS through an intermediate one, built from
+    // the self-joins of coordinate_operation_view that the operation graph
+    // replaced, for the four ways of chaining two operations
+    const auto getExpected = [&factory, db](const std::string &sourceCode,
+                                            const std::string &targetCode,
+                                            size_t &supersededCount) {
+        struct JoinCase {
+            const char *on1;
+            const char *on2;
+            const char *where1;
+            const char *where2;
+        };
+        const JoinCase cases[] = {{"target", "source", "source", "target"},
+                                  {"target", "target", "source", "source"},
+                                  {"source", "source", "target", "target"},
+                                  {"source", "target", "target", "source"}};
+        std::multiset<std::string> expected;
+        for (const auto &joinCase : cases) {
+            const std::string on1(joinCase.on1);
+            const std::string on2(joinCase.on2);
+            const std::string where1(joinCase.where1);
+            const std::string where2(joinCase.where2);
+            const std::string sql(
+                "SELECT v1.code, v2.code, "
+                "ss1.replacement_auth_name, ss1.replacement_code, "
+                "ss2.replacement_auth_name, ss2.replacement_code "
+                "FROM coordinate_operation_view v1 "
+                "JOIN coordinate_operation_view v2 ON "
+                "v1." + on1 + "_crs_auth_name = v2." + on2 + "_crs_auth_name "
+                "AND v1." + on1 + "_crs_code = v2." + on2 + "_crs_code "
+                "LEFT JOIN supersession ss1 ON "
+                "ss1.superseded_table_name = v1.table_name AND "
+                "ss1.superseded_auth_name = v1.auth_name AND "
+                "ss1.superseded_code = v1.code AND "
+                "ss1.superseded_table_name = ss1.replacement_table_name "
+                "LEFT JOIN supersession ss2 ON "
+                "ss2.superseded_table_name = v2.table_name AND "
+                "ss2.superseded_auth_name = v2.auth_name AND "
+                "ss2.superseded_code = v2.code AND "
+                "ss2.superseded_table_name = ss2.replacement_table_name "
+                "JOIN area a1 ON v1.area_of_use_auth_name = a1.auth_name "
+                "AND v1.area_of_use_code = a1.code "
+                "JOIN area a2 ON v2.area_of_use_auth_name = a2.auth_name "
+                "AND v2.area_of_use_code = a2.code "
+                "WHERE v1." + where1 + "_crs_auth_name = 'EPSG' "
+                "AND v1." + where1 + "_crs_code = ? "
+                "AND v2." + where2 + "_crs_auth_name = 'EPSG' "
+                "AND v2." + where2 + "_crs_code = ? "
+                "AND v1.deprecated = 0 AND v2.deprecated = 0 "
+                "AND intersects_bbox(a1.south_lat, a1.west_lon, "
+                "a1.north_lat, a1.east_lon, a2.south_lat, a2.west_lon, "
+                "a2.north_lat, a2.east_lon) = 1 "
+                "AND v1.auth_name = 'EPSG' AND v2.auth_name = 'EPSG'");
+            sqlite3_stmt *stmt = nullptr;
+            EXPECT_EQ(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr),
+                      SQLITE_OK)
+                << sqlite3_errmsg(db);
+            sqlite3_bind_text(stmt, 1, sourceCode.c_str(), -1,
+                              SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, targetCode.c_str(), -1,
+                              SQLITE_TRANSIENT);
+            std::vector<std::vector<std::string>> rows;
+            std::set<std::string> ops1;
+            std::set<std::string> ops2;
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                std::vector<std::string> row;
+                for (int i = 0; i < 6; i++) {
+                    const auto text = sqlite3_column_text(stmt, i);
+                    row.emplace_back(
+                        text ? reinterpret_cast<const char *>(text) : "");
+                }
+                ops1.insert(row[0]);
+                ops2.insert(row[1]);
+                rows.emplace_back(std::move(row));
+            }
+            sqlite3_finalize(stmt);
+
+            for (const auto &row : rows) {
+                // Skip the operations superseded by others of the result
+                if ((row[2] == "EPSG" && ops1.count(row[3]) > 0) ||
+                    (row[4] == "EPSG" && ops2.count(row[5]) > 0)) {
+                    ++supersededCount;
+                    continue;
+                }
+                // And the concatenated operations that go through the source
+                // or target CRS
+                bool irrelevantPivot = false;
+                std::vector<CoordinateOperationNNPtr> steps;
+                for (int i = 0; i < 2; i++) {
+                    auto op = factory->createCoordinateOperation(row[i], true);
+                    auto concat =
+                        dynamic_cast<const ConcatenatedOperation *>(op.get());
+                    if (concat) {
+                        const auto &ops = concat->operations();
+                        for (size_t j = 0; j + 1 < ops.size(); j++) {
+                            const auto &ids =
+                                ops[j]->targetCRS()->identifiers();
+                            if (ids.size() == 1 &&
+                                (ids[0]->code() == sourceCode ||
+                                 ids[0]->code() == targetCode)) {
+                                irrelevantPivot = true;
+                            }
+                        }
+                    }
+                    // The first operation is inverted when its source is the
+                    // intermediate CRS, and the second one when its target is
+                    const bool inverse =
+                        i == 0 ? on1 == "source" : on2 == "target";
+                    steps.emplace_back(inverse ? op->inverse() : op);
+                }
+                if (!irrelevantPivot) {
+                    expected.insert(
+                        ConcatenatedOperation::createComputeMetadata(steps,
+                                                                     false)
+                            ->nameStr());
+                }
+            }
+        }
+        return expected;
+    };
+    const auto getResult = [&factory](const std::string &sourceCode,
+                                      const std::string &targetCode) {
+        std::multiset<std::string> res;
+        for (const auto &op : factory->createFromCRSCodesWithIntermediates(
+                 "EPSG", sourceCode, "EPSG", targetCode, true, false, true,
+                 {})) {
+            res.insert(op->nameStr());
+        }
+        return res;
+    };
+
+    // NAD27 to NAD83: only superseded by operations of other tables, which
+    // are not discarded
+    size_t supersededCount = 0;
+    auto expected = getExpected("4267", "4269", supersededCount);
+    EXPECT_EQ(supersededCount, 0U);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(getResult("4267", "4269"), expected);
+
+    // NAD27(CGQ77) to WGS 84, through NAD83: NAD27(CGQ77) to NAD83 (1) is
+    // superseded by NAD27(CGQ77) to NAD83 (2)
+    expected = getExpected("4609", "4326", supersededCount);
+    EXPECT_GT(supersededCount, 0U);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(getResult("4609", "4326"), expected);
+
+    sqlite3_close(db);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(FactoryWithTmpDatabase, AuthorityFactory_proj_based_transformation) {
     createStructure();
     populateWithFakeEPSG();
@@ -2401,6 +2915,100 @@ TEST(factory, attachExtraDatabases_none) {
 
 // ---------------------------------------------------------------------------
 
+TEST(factory, DatabaseContext_shared) {
+    auto ctxt1 = DatabaseContext::create();
+    auto ctxt2 = DatabaseContext::create();
+    EXPECT_EQ(ctxt1->getPath(), ctxt2->getPath());
+
+    // Objects built through a context are cached for the other one
+    auto crs1 =
+        AuthorityFactory::create(ctxt1, "EPSG")->createGeodeticCRS("4326");
+    auto crs2 =
+        AuthorityFactory::create(ctxt2, "EPSG")->createGeodeticCRS("4326");
+    EXPECT_EQ(crs1.get(), crs2.get());
+
+    // Nested queries use their own connection
+    auto factory = AuthorityFactory::create(ctxt2, "EPSG");
+    EXPECT_FALSE(factory->createFromCoordinateReferenceSystemCodes("4326",
+                                                                    "32631")
+                     .empty());
+
+    // A context with auxiliary databases does not share its caches
+    auto ctxt3 = DatabaseContext::create(std::string(), {":memory:"});
+    auto crs3 =
+        AuthorityFactory::create(ctxt3, "EPSG")->createGeodeticCRS("4326");
+    EXPECT_NE(crs1.get(), crs3.get());
+    EXPECT_TRUE(crs1->isEquivalentTo(crs3.get()));
+
+    // The handle given to the caller stays usable while the context lives
+    auto handle = static_cast<sqlite3 *>(ctxt1->getSqliteHandle());
+    ASSERT_TRUE(handle != nullptr);
+    sqlite3_stmt *stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(handle, "SELECT COUNT(*) FROM geodetic_crs",
+                                 -1, &stmt, nullptr),
+              SQLITE_OK);
+    EXPECT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    sqlite3_finalize(stmt);
+    EXPECT_FALSE(AuthorityFactory::create(ctxt1, "EPSG")
+                     ->createGeodeticCRS("4979")
+                     ->nameStr()
+                     .empty());
+
+    // Contexts created and used concurrently by several threads share the
+    // connections and the caches of the database
+    const std::vector<std::string> codes{"4326",  "4979", "32631",
+                                         "2154",  "3857", "27700",
+                                         "4258",  "5703"};
+    std::vector<std::string> expected;
+    for (const auto &code : codes) {
+        expected.emplace_back(AuthorityFactory::create(ctxt3, "EPSG")
+                                  ->createCoordinateReferenceSystem(code)
+                                  ->nameStr());
+    }
+    const size_t expectedOpCount =
+        AuthorityFactory::create(ctxt3, "EPSG")
+            ->createFromCoordinateReferenceSystemCodes("4258", "27700")
+            .size();
+    constexpr size_t N_THREADS = 8;
+    std::vector<std::string> errors(N_THREADS);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < N_THREADS; ++i) {
+        threads.emplace_back([&codes, &expected, expectedOpCount, &errors,
+                              i]() {
+            try {
+                for (size_t k = 0; k < 4 * codes.size(); ++k) {
+                    const size_t j = (i + k) % codes.size();
+                    auto threadFactory = AuthorityFactory::create(
+                        DatabaseContext::create(), "EPSG");
+                    if (threadFactory
+                            ->createCoordinateReferenceSystem(codes[j])
+                            ->nameStr() != expected[j]) {
+                        errors[i] = "wrong name for " + codes[j];
+                        return;
+                    }
+                    if (threadFactory
+                            ->createFromCoordinateReferenceSystemCodes(
+                                "4258", "27700")
+                            .size() != expectedOpCount) {
+                        errors[i] = "wrong operation count";
+                        return;
+                    }
+                }
+            } catch (const std::exception &e) {
+                errors[i] = e.what();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto &error : errors) {
+        EXPECT_EQ(error, std::string());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 #ifndef SQLITE_OPEN_URI
 static int MyUnlink(const std::string &filename) {
 #ifdef _MSC_VER
@@ -2761,6 +3369,122 @@ TEST(factory, createObjectsFromName) {
 
 // ---------------------------------------------------------------------------
 
+TEST(factory, createObjectsFromName_name_index) {
+    auto ctxt = DatabaseContext::create();
+    const auto lower = [](std::string str) {
+        for (auto &ch : str) {
+            ch = static_cast<char>(::tolower(ch));
+        }
+        return str;
+    };
+    std::vector<std::string> names;
+    std::vector<std::string> searchedNames{
+        "1984",
+        "WGS 84",
+        "wgs 1984",
+        "Lambert-93",
+        "NTF (Paris)",
+        "Nouvelle Triangulation Fran\xc3\xa7"
+        "aise",
+        "European 1950",
+        "zone 31",
+        "i_dont_exist",
+        // Shorter than the trigrams of the index
+        "84",
+        "NZ"};
+    sqlite3 *db = nullptr;
+    ASSERT_EQ(sqlite3_open_v2(ctxt->getPath().c_str(), &db,
+                              SQLITE_OPEN_READONLY, nullptr),
+              SQLITE_OK);
+    sqlite3_stmt *stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(
+                  db, "SELECT name, table_name FROM object_view WHERE "
+                      "deprecated = 0 AND table_name IN ('prime_meridian', "
+                      "'ellipsoid', 'geodetic_datum', 'vertical_datum', "
+                      "'geodetic_crs', 'projected_crs', 'vertical_crs', "
+                      "'compound_crs', 'conversion', "
+                      "'helmert_transformation', 'grid_transformation', "
+                      "'other_transformation', 'concatenated_operation')",
+                  -1, &stmt, nullptr),
+              SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        names.emplace_back(
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+        if (names.size() % 50 == 0 &&
+            strcmp(reinterpret_cast<const char *>(
+                       sqlite3_column_text(stmt, 1)),
+                   "geodetic_datum") == 0) {
+            searchedNames.emplace_back(names.back());
+        }
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+
+    auto factory = AuthorityFactory::create(ctxt, std::string());
+    auto factoryEPSG = AuthorityFactory::create(ctxt, "EPSG");
+    const std::vector<AuthorityFactory::ObjectType> datumType{
+        AuthorityFactory::ObjectType::GEODETIC_REFERENCE_FRAME};
+    for (const auto &searchedName : searchedNames) {
+        // All the objects whose name contains the searched one are found
+        std::set<std::string> got;
+        for (const auto &obj : factory->createObjectsFromName(searchedName)) {
+            got.insert(obj->nameStr());
+        }
+        const auto lowerSearchedName(lower(searchedName));
+        for (const auto &name : names) {
+            if (lower(name).find(lowerSearchedName) != std::string::npos) {
+                EXPECT_EQ(got.count(name), 1U) << searchedName << ": " << name;
+            }
+        }
+
+        // Geodetic datums of all authorities are matched by canonicalizing
+        // all their names rather than through the name index, and only on
+        // the canonical name when one is equal to the searched one
+        std::set<std::string> expectedCodes;
+        for (const auto &obj :
+             factory->createObjectsFromName(searchedName, datumType)) {
+            if (*obj->identifiers()[0]->codeSpace() == "EPSG") {
+                expectedCodes.insert(obj->identifiers()[0]->code());
+            }
+        }
+        // When only other authorities match, the deprecated EPSG datums
+        // are looked for
+        if (expectedCodes.empty()) {
+            continue;
+        }
+        std::set<std::string> gotCodes;
+        for (const auto &obj :
+             factoryEPSG->createObjectsFromName(searchedName, datumType)) {
+            gotCodes.insert(obj->identifiers()[0]->code());
+        }
+        EXPECT_TRUE(std::includes(gotCodes.begin(), gotCodes.end(),
+                                  expectedCodes.begin(), expectedCodes.end()))
+            << searchedName;
+    }
+
+    // With a limit, the objects are among the ones of shortest names of the
+    // unlimited search
+    for (const auto &searchedName : {"WGS 84", "1984", "84", "zone 31"}) {
+        std::vector<std::string> all;
+        for (const auto &obj : factory->createObjectsFromName(searchedName)) {
+            all.push_back(obj->nameStr());
+        }
+        ASSERT_GT(all.size(), 3U) << searchedName;
+        const auto limited =
+            factory->createObjectsFromName(searchedName, {}, true, 3);
+        EXPECT_EQ(limited.size(), 3U) << searchedName;
+        for (const auto &obj : limited) {
+            EXPECT_TRUE(std::find(all.begin(), all.end(), obj->nameStr()) !=
+                        all.end())
+                << searchedName << ": " << obj->nameStr();
+            EXPECT_LE(obj->nameStr().size(), all[2].size())
+                << searchedName << ": " << obj->nameStr();
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(factory, getMetadata) {
     auto ctxt = DatabaseContext::create();
     EXPECT_EQ(ctxt->getMetadata("i_do_not_exist"), nullptr);
@@ -159,6 +159,24 @@ TEST(io, wkt_parsing_with_printed_quotes) {
 
 // ---------------------------------------------------------------------------
 
+TEST(io, wkt_parsing_nested_siblings) {
+
+    auto n = WKTNode::createFrom(
+        "A[B[C[\"x\"\"y\"],D],E[F[G[1,2]]],H,I[\"z\"]]");
+    ASSERT_EQ(n->children().size(), 4U);
+    EXPECT_EQ(n->children()[0]->children().size(), 2U);
+    EXPECT_EQ(n->children()[0]->children()[0]->children()[0]->value(),
+              "\"x\"y\"");
+    EXPECT_EQ(n->children()[1]->children()[0]->children()[0]->children().size(),
+              2U);
+    EXPECT_TRUE(n->children()[2]->children().empty());
+    EXPECT_EQ(n->children()[3]->children()[0]->value(), "\"z\"");
+    EXPECT_EQ(n->toString(),
+              "A[B[C[\"x\"\"y\"],D],E[F[G[1,2]]],H,I[\"z\"]]");
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(wkt_parse, sphere) {
     auto obj = WKTParser().createFromWKT(
         "ELLIPSOID[\"Sphere\",6378137,0,LENGTHUNIT[\"metre\",1]]");
@@ -4208,6 +4208,68 @@ TEST(operation, geogCRS_to_geogCRS_context_filter_bbox) {
 
 // ---------------------------------------------------------------------------
 
+TEST(operation, geogCRS_to_geogCRS_context_filter_bbox_area_index) {
+    // With an auxiliary database, the area index of proj.db is not used
+    auto authFactory =
+        AuthorityFactory::create(DatabaseContext::create(), "EPSG");
+    auto authFactoryNoIndex = AuthorityFactory::create(
+        DatabaseContext::create(std::string(), {":memory:"}), "EPSG");
+
+    const auto getNames = [](const AuthorityFactoryNNPtr &factory,
+                             const char *sourceCode, const char *targetCode,
+                             const ExtentPtr &areaOfInterest,
+                             CoordinateOperationContext::SpatialCriterion
+                                 spatialCriterion) {
+        auto ctxt =
+            CoordinateOperationContext::create(factory, areaOfInterest, 0.0);
+        ctxt->setSpatialCriterion(spatialCriterion);
+        ctxt->setGridAvailabilityUse(
+            CoordinateOperationContext::GridAvailabilityUse::
+                IGNORE_GRID_AVAILABILITY);
+        std::vector<std::string> names;
+        for (const auto &op :
+             CoordinateOperationFactory::create()->createOperations(
+                 factory->createCoordinateReferenceSystem(sourceCode),
+                 factory->createCoordinateReferenceSystem(targetCode), ctxt)) {
+            names.push_back(op->nameStr());
+        }
+        return names;
+    };
+
+    const std::vector<std::pair<const char *, const char *>> pairs{
+        {"4230", "4258"}, // ED50 to ETRS89
+        {"4230", "4326"}, // ED50 to WGS 84
+        {"4807", "4171"}, // NTF (Paris) to RGF93
+        {"4283", "4202"}, // GDA94 to AGD66
+    };
+    const std::vector<ExtentPtr> areas{
+        Extent::createFromBBOX(2, 49, 3, 50).as_nullable(),
+        Extent::createFromBBOX(-5, 36, 3, 43).as_nullable(),
+        Extent::createFromBBOX(140, -30, 141, -29).as_nullable(),
+        // Crossing the antimeridian
+        Extent::createFromBBOX(170, -50, -170, -40).as_nullable(),
+        // No operation there
+        Extent::createFromBBOX(100, 0, 101, 1).as_nullable(),
+    };
+    for (const auto &pair : pairs) {
+        for (const auto &area : areas) {
+            for (const auto spatialCriterion :
+                 {CoordinateOperationContext::SpatialCriterion::
+                      STRICT_CONTAINMENT,
+                  CoordinateOperationContext::SpatialCriterion::
+                      PARTIAL_INTERSECTION}) {
+                EXPECT_EQ(getNames(authFactory, pair.first, pair.second, area,
+                                   spatialCriterion),
+                          getNames(authFactoryNoIndex, pair.first, pair.second,
+                                   area, spatialCriterion))
+                    << pair.first << " " << pair.second;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(operation, geogCRS_to_geogCRS_context_incompatible_area) {
     auto authFactory =
         AuthorityFactory::create(DatabaseContext::create(), "EPSG");